@@ -644,6 +644,7 @@ include ./config/arch/$(__CPU_ARCH__)/cpu_flags.h
 #*/
 
 #define ARCH_noarch
+#include "noarch/ethloop_flags.h"
 #include "noarch/spiee_flags.h"
 #include "noarch/loop_flags.h"
 #include "noarch/tty_flags.h"
@@ -1064,6 +1065,15 @@ __ENABLE_SPIEE__=_NO_
 __ENABLE_SND__=_NO_
 #*/
 
+#/*--
+# this:PutWidgets("ETHLOOP", "arch/noarch/ethloop_flags.h")
+# this:SetToolTip("Software loopback Ethernet device")
+#--*/
+#define __ENABLE_ETHLOOP__ _NO_
+#/*
+__ENABLE_ETHLOOP__=_NO_
+#*/
+
 #// MODULE LIST END
 #//-----------------------------------------------------------------------------
 #/*-- save current configuration if CPU was changed
@@ -73,6 +73,16 @@ this:SetToolTip("When option is disabled, file system uses the sector buffer in
 --*/
 #define __FATFS_BUFFERED_FILE_ENABLE__ _YES_
 
+/*--
+this:AddWidget("Spinbox", 0, 1024, "Cluster map size per file [fragments]")
+this:SetToolTip("Maximum number of cluster chain fragments mapped for each opened file. "..
+                "The map is created at first seek in a large file and makes seek time "..
+                "independent of file size (FAT chain is not followed). Maps are released "..
+                "when system is running out of memory. Use 0 to disable. "..
+                "Size can be changed at mount by using 'clmt=<fragments>' option.")
+--*/
+#define __FATFS_CLUSTER_MAP_SIZE__ 32
+
 #endif /* _FATFS_FLAGS_H_ */
 /*==============================================================================
   End of file
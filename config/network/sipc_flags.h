@@ -66,6 +66,33 @@
 #--*/
 #define __NETWORK_SIPC_RECV_BUF_SIZE__ 2048
 
+#/*--
+# this:AddWidget("Spinbox", 1, 32, "Transmit window [packets]")
+# this:SetToolTip("Number of DATA packets sent without waiting for acknowledge.\n"..
+#                 "Window is negotiated with remote side at connection, value 1\n"..
+#                 "selects stop-and-wait transfer.")
+#--*/
+#define __NETWORK_SIPC_WINDOW_SIZE__ 8
+
+#/*--
+# this:AddWidget("Spinbox", 10, 10000, "Retransmission timeout [ms]")
+#--*/
+#define __NETWORK_SIPC_RETRANSMIT_TIMEOUT__ 250
+
+#/*--
+# this:AddWidget("Spinbox", 128, 65536, "Interface receive buffer [B]")
+# this:SetToolTip("Buffer of received frames. Buffer must hold the largest frame\n"..
+#                 "(MTU + 10 B header), MTU is limited to this size.")
+#--*/
+#define __NETWORK_SIPC_FRAME_BUF_SIZE__ 1024
+
+#/*--
+# this:AddWidget("Spinbox", 0, 64, "Packet pool [packets]")
+# this:SetToolTip("Number of preallocated MTU-size buffers for received packets.\n"..
+#                 "Heap is used when pool is empty.")
+#--*/
+#define __NETWORK_SIPC_PACKET_POOL_SIZE__ 8
+
 #endif /* _SIPC_FLAGS_H_ */
 #/*=============================================================================
 #  End of file
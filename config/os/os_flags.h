@@ -250,6 +250,14 @@ this:SetToolTip("The allocation block size is a minimal memory block that can be
 --*/
 #define __HEAP_BLOCK_SIZE__ 4
 
+/*--
+this:AddWidget("Spinbox", 0, 4096, "Program small allocation chunk [bytes]")
+this:SetToolTip("Size of the memory chunk taken from the kernel by the program's malloc() "..
+                "to serve small allocations without system calls. Value 0 disables "..
+                "the user-space allocator and each malloc() call goes to the kernel.")
+--*/
+#define __OS_MALLOC_CHUNK_SIZE__ 512
+
 /*--
 --this:AddExtraWidget("Void", "VoidOption")
 this:AddWidget("Spinbox", 1, 250, "System log columns")
@@ -267,10 +275,37 @@ this:SetToolTip("This option determine how many rows is stored in buffer. " ..
 
 /*--
 this:AddWidget("Spinbox", 10, 600, "Cache synchronization interval [s]")
-this:SetToolTip("This option determine period of cache synchronization with storage.")
+this:SetToolTip("This option determine maximum age of data not synchronized with storage. "..
+                "Only file systems modified since last synchronization are written back.")
 --*/
 #define __OS_SYSTEM_CACHE_SYNC_PERIOD__ 30
 
+/*--
+this:AddWidget("Spinbox", 0, 1048576, "Dirty data high-water mark [bytes]")
+this:SetToolTip("This option determine amount of written and not synchronized data "..
+                "that forces write-back of all modified file systems before "..
+                "synchronization interval expires. Use 0 to disable.")
+--*/
+#define __OS_SYSTEM_DIRTY_HIGH_WATER__ 32768
+
+/*--
+this:AddWidget("Spinbox", 0, 4096, "File system block cache size [blocks]")
+this:SetToolTip("This option determine default number of device blocks cached by each "..
+                "mounted file system (fatfs, ext4fs, eefs). Cached blocks are released "..
+                "when system is running out of memory. Use 0 to disable cache. "..
+                "Size can be changed at mount by using 'cache=<blocks>' option.")
+--*/
+#define __OS_SYSTEM_BLOCK_CACHE_SIZE__ 16
+
+/*--
+this:AddWidget("Spinbox", 0, 256, "File system read-ahead window [blocks]")
+this:SetToolTip("This option determine maximum number of blocks read ahead when "..
+                "file system reads device sequentially. Window is limited to half "..
+                "of block cache size. Use 0 to disable read-ahead. "..
+                "Window can be changed at mount by using 'ra=<blocks>' option.")
+--*/
+#define __OS_SYSTEM_BLOCK_CACHE_READAHEAD__ 8
+
 /*--
 this:AddWidget("Spinbox", 0, 16777216, "Network memory limit [bytes]")
 this:SetToolTip("This option enables memory limit for network subsystem. Use 0 for no limit.")
@@ -304,6 +339,17 @@ this:SetToolTip("Enable/Disable block overflow check of heap memory.")
 --*/
 #define __OS_HEAP_OVERFLOW_CHECK__ _NO_
 
+/*--
+this:AddWidget("Combobox", "Heap allocator")
+this:AddItem("First fit (the lowest RAM usage)", "0")
+this:AddItem("Segregated fit (constant allocation time)", "1")
+this:SetToolTip("First fit allocator searches the list of all memory blocks, so the allocation "..
+                "time grows with heap fragmentation. Segregated fit allocator keeps free "..
+                "blocks in size class lists and allocates in constant time. Size class "..
+                "table is placed at the end of each memory region (about 100-400 bytes).")
+--*/
+#define __OS_HEAP_ALLOCATOR__ 1
+
 
 /*--
 this:AddExtraWidget("Label", "LabelMisc", "\nMiscellaneous", -1, "bold")
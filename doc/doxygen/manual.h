@@ -84,6 +84,7 @@ drivers configuration, and starting needed applications/daemons.
 \li \subpage page-drivers
 
 \section sec-drivers Drivers
+\li \subpage drv-ethloop
 \li \subpage drv-snd
 \li \subpage drv-spiee
 \li \subpage drv-pwm
@@ -0,0 +1,151 @@
+/*==============================================================================
+File    checksum.h
+
+Author  Daniel Zorychta
+
+Brief   Checksum library.
+
+        Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/**
+@defgroup CHECKSUM_H_ CHECKSUM_H_
+
+Detailed Doxygen description.
+*/
+/**@{*/
+
+#ifndef _LIB_CHECKSUM_H_
+#define _LIB_CHECKSUM_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <lib/checksum.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+/** Fletcher-16 incremental calculation context. */
+typedef _fletcher16_t fletcher16_t;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief  Function initialize Fletcher-16 checksum calculation.
+ * @param  chks         checksum context
+ */
+//==============================================================================
+static inline void fletcher16_init(fletcher16_t *chks)
+{
+        _builtinfunc(fletcher16_init, chks);
+}
+
+//==============================================================================
+/**
+ * @brief  Function update Fletcher-16 checksum by selected data.
+ * @param  chks         checksum context
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ */
+//==============================================================================
+static inline void fletcher16_update(fletcher16_t *chks, const void *data, size_t bytes)
+{
+        _builtinfunc(fletcher16_update, chks, data, bytes);
+}
+
+//==============================================================================
+/**
+ * @brief  Function finish Fletcher-16 checksum calculation.
+ * @param  chks         checksum context
+ * @return Checksum.
+ */
+//==============================================================================
+static inline uint16_t fletcher16_final(const fletcher16_t *chks)
+{
+        return _builtinfunc(fletcher16_final, chks);
+}
+
+//==============================================================================
+/**
+ * @brief  Function calculate Fletcher-16 checksum.
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ * @return Checksum.
+ */
+//==============================================================================
+static inline uint16_t fletcher16(const void *data, size_t bytes)
+{
+        return _builtinfunc(fletcher16, data, bytes);
+}
+
+//==============================================================================
+/**
+ * @brief  Function calculate Fletcher-32 checksum.
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ * @return Checksum.
+ */
+//==============================================================================
+static inline uint32_t fletcher32(const void *data, size_t bytes)
+{
+        return _builtinfunc(fletcher32, data, bytes);
+}
+
+//==============================================================================
+/**
+ * @brief  Function calculate CRC-32C checksum. Calculation can be continued
+ *         by passing previous result as crc argument.
+ * @param  crc          previous CRC value (0 at start)
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ * @return CRC value.
+ */
+//==============================================================================
+static inline uint32_t crc32c(uint32_t crc, const void *data, size_t bytes)
+{
+        return _builtinfunc(crc32c, crc, data, bytes);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LIB_CHECKSUM_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
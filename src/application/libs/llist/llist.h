@@ -296,7 +296,8 @@ static inline int llist_swap(llist_t *list, int j, int k)
 
 //==============================================================================
 /**
- * @brief  Sort elements of the list
+ * @brief  Sort elements of the list. Sort is stable, equal elements keep
+ *         their order
  * @param  list         list object
  * @return None
  */
@@ -332,7 +333,8 @@ static inline void llist_reverse(llist_t *list)
 
 //==============================================================================
 /**
- * @brief  Get element from the list at selected position
+ * @brief  Get element from the list at selected position. Last accessed
+ *         position is cached, thus access to neighbour position is fast
  * @param  list         list object
  * @param  position     begin position
  * @return Pointer to data, or NULL on error
@@ -106,14 +106,15 @@ int main(int argc, char *argv[])
                 syslog_clear();
 
         } else {
-                struct timeval t = {0, 0};
+                struct timeval t;
+                u32_t seq = 0;
 
                 ioctl(fileno(stdin), IOCTL_VFS__NON_BLOCKING_RD_MODE);
 
                 do {
                         char str[128];
 
-                        while (syslog_read(str, sizeof(str), &t, &t)) {
+                        while (syslog_read(str, sizeof(str), &seq, &t)) {
                                 printf("[%u.%06u] %s\n", t.tv_sec, t.tv_usec, str);
                         }
 
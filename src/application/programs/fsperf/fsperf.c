@@ -0,0 +1,1025 @@
+/*==============================================================================
+File    fsperf.c
+
+Author  Daniel Zorychta
+
+Brief   File system performance measurement program
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mount.h>
+#include <sys/ioctl.h>
+#include <dnx/os.h>
+#include <dnx/misc.h>
+#include <dnx/thread.h>
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define BLOCK_SIZE              512
+#define RANDOM_READS            1024
+#define PATH_OPS                1000
+#define DISK_SECTORS            128
+#define DISK_SIZE               (DISK_SECTORS * BLOCK_SIZE)
+#define CACHE_FILE_SIZE         (16 * 1024)
+#define CACHE_READ_PASSES       4
+#define CACHE_STAT_OPS          200
+#define CACHE_BLOCKS            32
+#define READAHEAD_BLOCKS        8
+#define READAHEAD_CHUNK         64
+#define CLMT_FILE_SIZE          (48 * 1024)
+#define CLMT_FRAGMENTS          32
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        const char *name;
+        int (*func)(int argc, char *argv[]);
+        const char *usage;
+} test_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+static int test_file(int argc, char *argv[]);
+static int test_dir(int argc, char *argv[]);
+static int test_path(int argc, char *argv[]);
+static int test_bcache(int argc, char *argv[]);
+static int test_readahead(int argc, char *argv[]);
+static int test_clmt(int argc, char *argv[]);
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static const test_t TEST[] = {
+        {.name = "file", .func = test_file, .usage = "[dir-path]"},
+        {.name = "dir",  .func = test_dir,  .usage = "[dir-path]"},
+        {.name = "path", .func = test_path, .usage = "[dir-path]"},
+        {.name = "bcache", .func = test_bcache, .usage = "[loop-device] [mount-point]"},
+        {.name = "readahead", .func = test_readahead, .usage = "[loop-device] [mount-point]"},
+        {.name = "clmt", .func = test_clmt, .usage = "[loop-device] [mount-point]"},
+};
+
+GLOBAL_VARIABLES_SECTION {
+        char path[128];
+        char name[160];
+        FILE *loop;
+        u8_t *disk;
+        bool host_stop;
+        u32_t dev_reads;
+        u32_t dev_writes;
+};
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+PROGRAM_PARAMS(fsperf, STACK_DEPTH_LOW);
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * Main program function.
+ *
+ * @param argc      argument count
+ * @param argv      arguments
+ */
+//==============================================================================
+int main(int argc, char *argv[])
+{
+        if (argc >= 2) {
+                for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                        if (strcmp(argv[1], TEST[i].name) == 0) {
+                                return TEST[i].func(argc - 1, &argv[1]);
+                        }
+                }
+        }
+
+        printf("Usage: %s <test> [args]\n", argv[0]);
+        for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                printf("  %s %s\n", TEST[i].name, TEST[i].usage);
+        }
+
+        return EXIT_FAILURE;
+}
+
+//==============================================================================
+/**
+ * @brief  Print transfer result.
+ *
+ * @param  label        result label
+ * @param  bytes        number of transferred bytes
+ * @param  ms           transfer time
+ */
+//==============================================================================
+static void print_throughput(const char *label, size_t bytes, u64_t ms)
+{
+        u32_t kibps = (ms > 0) ? (u32_t)((u64_t)bytes * 1000 / 1024 / ms) : 0;
+
+        printf("%-24s %8u B  %6u ms  %8u KiB/s\n",
+               label, (uint)bytes, (uint)ms, (uint)kibps);
+}
+
+//==============================================================================
+/**
+ * @brief  Print operation latency result.
+ *
+ * @param  label        result label
+ * @param  ops          number of operations
+ * @param  ms           total time
+ */
+//==============================================================================
+static void print_latency(const char *label, size_t ops, u64_t ms)
+{
+        u32_t us = (ops > 0) ? (u32_t)(ms * 1000 / ops) : 0;
+
+        printf("%-24s %8u op  %6u ms  %8u us/op\n",
+               label, (uint)ops, (uint)ms, (uint)us);
+}
+
+//==============================================================================
+/**
+ * @brief  Print number of VFS heap allocations per operation.
+ *
+ * @param  label        result label
+ * @param  ops          number of operations
+ * @param  before       VFS statistics before test
+ * @param  after        VFS statistics after test
+ */
+//==============================================================================
+static void print_allocs(const char *label, size_t ops,
+                         const vfsstat_t *before, const vfsstat_t *after)
+{
+        u32_t allocs = after->heap_allocs - before->heap_allocs;
+        u32_t paths  = after->path_heap_allocs - before->path_heap_allocs;
+
+        printf("%-24s %8u op  %6u alloc  %4u.%02u alloc/op  %u path alloc\n",
+               label, (uint)ops, (uint)allocs,
+               (uint)(allocs / ops), (uint)((allocs * 100 / ops) % 100),
+               (uint)paths);
+}
+
+//==============================================================================
+/**
+ * @brief  Sequential write, sequential read, and random read of files of
+ *         growing size. Time per byte should not depend on file size.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_file(int argc, char *argv[])
+{
+        static const size_t FILE_SIZE[] = {16 * 1024, 64 * 1024, 256 * 1024};
+
+        snprintf(global->path, sizeof(global->path), "%s/fsperf.bin",
+                 (argc >= 2) ? argv[1] : "/tmp");
+
+        u8_t *buf = malloc(BLOCK_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        memset(buf, 0xAA, BLOCK_SIZE);
+
+        int status = EXIT_SUCCESS;
+
+        for (size_t i = 0; i < ARRAY_SIZE(FILE_SIZE) && status == EXIT_SUCCESS; i++) {
+
+                size_t size = FILE_SIZE[i];
+                char   label[32];
+
+                FILE *f = fopen(global->path, "w+");
+                if (!f) {
+                        perror(global->path);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                // sequential write
+                size_t total  = 0;
+                u64_t  tstart = get_time_ms();
+                while (total < size) {
+                        size_t n = fwrite(buf, 1, BLOCK_SIZE, f);
+                        if (n == 0) {
+                                perror(global->path);
+                                status = EXIT_FAILURE;
+                                break;
+                        }
+                        total += n;
+                }
+                snprintf(label, sizeof(label), "%u KiB seq. write", (uint)(size / 1024));
+                print_throughput(label, total, get_time_ms() - tstart);
+
+                // sequential read
+                rewind(f);
+                total  = 0;
+                tstart = get_time_ms();
+                size_t n;
+                while ((n = fread(buf, 1, BLOCK_SIZE, f)) > 0) {
+                        total += n;
+                }
+                snprintf(label, sizeof(label), "%u KiB seq. read", (uint)(size / 1024));
+                print_throughput(label, total, get_time_ms() - tstart);
+
+                // random read
+                srand(size);
+                total  = 0;
+                tstart = get_time_ms();
+                for (int r = 0; r < RANDOM_READS; r++) {
+                        fseek(f, (rand() % (size / BLOCK_SIZE)) * BLOCK_SIZE, SEEK_SET);
+                        total += fread(buf, 1, BLOCK_SIZE, f);
+                }
+                snprintf(label, sizeof(label), "%u KiB rand. read", (uint)(size / 1024));
+                print_throughput(label, total, get_time_ms() - tstart);
+
+                fclose(f);
+                remove(global->path);
+        }
+
+        free(buf);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Lookup of existing and not existing entries in directories of
+ *         10, 100, and 1000 entries.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_dir(int argc, char *argv[])
+{
+        static const size_t ENTRIES[] = {10, 100, 1000};
+
+        snprintf(global->path, sizeof(global->path), "%s/fsperf.d",
+                 (argc >= 2) ? argv[1] : "/tmp");
+
+        int status = EXIT_SUCCESS;
+
+        for (size_t i = 0; i < ARRAY_SIZE(ENTRIES) && status == EXIT_SUCCESS; i++) {
+
+                size_t entries = ENTRIES[i];
+                char   label[32];
+
+                if (mkdir(global->path, 0777) != 0) {
+                        perror(global->path);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                // create
+                u64_t tstart = get_time_ms();
+                for (size_t n = 0; n < entries; n++) {
+                        snprintf(global->name, sizeof(global->name), "%s/file%u",
+                                 global->path, (uint)n);
+
+                        FILE *f = fopen(global->name, "w");
+                        if (f) {
+                                fclose(f);
+                        } else {
+                                perror(global->name);
+                                status = EXIT_FAILURE;
+                                break;
+                        }
+                }
+                snprintf(label, sizeof(label), "%u entries, create", (uint)entries);
+                print_latency(label, entries, get_time_ms() - tstart);
+
+                // positive lookup
+                struct stat st;
+                tstart = get_time_ms();
+                for (size_t n = 0; n < entries; n++) {
+                        snprintf(global->name, sizeof(global->name), "%s/file%u",
+                                 global->path, (uint)n);
+                        stat(global->name, &st);
+                }
+                snprintf(label, sizeof(label), "%u entries, stat", (uint)entries);
+                print_latency(label, entries, get_time_ms() - tstart);
+
+                // negative lookup
+                tstart = get_time_ms();
+                for (size_t n = 0; n < entries; n++) {
+                        snprintf(global->name, sizeof(global->name), "%s/none%u",
+                                 global->path, (uint)n);
+                        stat(global->name, &st);
+                }
+                snprintf(label, sizeof(label), "%u entries, stat ENOENT", (uint)entries);
+                print_latency(label, entries, get_time_ms() - tstart);
+
+                // remove
+                tstart = get_time_ms();
+                for (size_t n = 0; n < entries; n++) {
+                        snprintf(global->name, sizeof(global->name), "%s/file%u",
+                                 global->path, (uint)n);
+                        remove(global->name);
+                }
+                snprintf(label, sizeof(label), "%u entries, remove", (uint)entries);
+                print_latency(label, entries, get_time_ms() - tstart);
+
+                remove(global->path);
+        }
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Path resolution cost of stat() and fopen()/fclose() for short path
+ *         and for long path (with redundant "./" elements). Short path should
+ *         be resolved without heap allocation.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_path(int argc, char *argv[])
+{
+        snprintf(global->path, sizeof(global->path), "%s/fsperf.p",
+                 (argc >= 2) ? argv[1] : "/tmp");
+
+        if (mkdir(global->path, 0777) != 0) {
+                perror(global->path);
+                return EXIT_FAILURE;
+        }
+
+        int status = EXIT_SUCCESS;
+
+        for (int kind = 0; kind < 2 && status == EXIT_SUCCESS; kind++) {
+
+                const char *kind_name = (kind == 0) ? "short" : "long";
+                char        label[32];
+
+                size_t len = snprintf(global->name, sizeof(global->name), "%s/", global->path);
+                while (kind == 1 && len < sizeof(global->name) - 8) {
+                        strcat(global->name, "./");
+                        len += 2;
+                }
+                strcat(global->name, "file");
+
+                FILE *f = fopen(global->name, "w");
+                if (f) {
+                        fclose(f);
+                } else {
+                        perror(global->name);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                // stat
+                vfsstat_t before, after;
+                struct stat st;
+
+                get_VFS_statistics(&before);
+                u64_t tstart = get_time_ms();
+                for (size_t n = 0; n < PATH_OPS; n++) {
+                        stat(global->name, &st);
+                }
+                u64_t tdiff = get_time_ms() - tstart;
+                get_VFS_statistics(&after);
+
+                snprintf(label, sizeof(label), "%s path, stat", kind_name);
+                print_latency(label, PATH_OPS, tdiff);
+                print_allocs(label, PATH_OPS, &before, &after);
+
+                // open and close
+                get_VFS_statistics(&before);
+                tstart = get_time_ms();
+                for (size_t n = 0; n < PATH_OPS; n++) {
+                        f = fopen(global->name, "r");
+                        if (f) {
+                                fclose(f);
+                        }
+                }
+                tdiff = get_time_ms() - tstart;
+                get_VFS_statistics(&after);
+
+                snprintf(label, sizeof(label), "%s path, fopen", kind_name);
+                print_latency(label, PATH_OPS, tdiff);
+                print_allocs(label, PATH_OPS, &before, &after);
+
+                remove(global->name);
+        }
+
+        remove(global->path);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Create FAT12 file system on RAM disk: boot sector, single FAT
+ *         sector, and single root directory sector (16 entries).
+ *
+ * @param  disk         RAM disk (DISK_SIZE bytes)
+ */
+//==============================================================================
+static void format_fat12(u8_t *disk)
+{
+        memset(disk, 0, DISK_SIZE);
+
+        static const u8_t JMP_BOOT[] = {0xEB, 0x3C, 0x90};
+        memcpy(&disk[0], JMP_BOOT, sizeof(JMP_BOOT));
+        memcpy(&disk[3], "DNXRTOS ", 8);
+        disk[11] = BLOCK_SIZE & 0xFF;           // bytes per sector
+        disk[12] = BLOCK_SIZE >> 8;
+        disk[13] = 1;                           // sectors per cluster
+        disk[14] = 1;                           // reserved sectors
+        disk[16] = 1;                           // number of FATs
+        disk[17] = 16;                          // root directory entries
+        disk[19] = DISK_SECTORS & 0xFF;         // total sectors
+        disk[20] = DISK_SECTORS >> 8;
+        disk[21] = 0xF8;                        // media descriptor
+        disk[22] = 1;                           // sectors per FAT
+        disk[38] = 0x29;                        // extended boot signature
+        memcpy(&disk[43], "FSPERF     ", 11);
+        memcpy(&disk[54], "FAT12   ", 8);
+        disk[510] = 0x55;
+        disk[511] = 0xAA;
+
+        // FAT: media descriptor and end of chain marker
+        disk[BLOCK_SIZE + 0] = 0xF8;
+        disk[BLOCK_SIZE + 1] = 0xFF;
+        disk[BLOCK_SIZE + 2] = 0xFF;
+}
+
+//==============================================================================
+/**
+ * @brief  Loop device host thread. Serves requests from RAM disk and counts
+ *         device reads and writes.
+ *
+ * @param  arg          unused
+ */
+//==============================================================================
+static void loop_host(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+        while (!global->host_stop) {
+                LOOP_request_t rq;
+                if (ioctl(fileno(global->loop), IOCTL_LOOP__HOST_WAIT_FOR_REQUEST, &rq) != 0) {
+                        continue;
+                }
+
+                switch (rq.cmd) {
+                case LOOP_CMD__TRANSMISSION_CLIENT2HOST: {
+                        LOOP_buffer_t buf;
+                        buf.data = &global->disk[min(rq.arg.rw.seek, DISK_SIZE)];
+                        buf.size = min(rq.arg.rw.size, DISK_SIZE - min(rq.arg.rw.seek, DISK_SIZE));
+                        buf.err  = ESUCC;
+                        ioctl(fileno(global->loop), IOCTL_LOOP__HOST_READ_DATA_FROM_CLIENT, &buf);
+                        global->dev_writes++;
+                        break;
+                }
+
+                case LOOP_CMD__TRANSMISSION_HOST2CLIENT: {
+                        LOOP_buffer_t buf;
+                        buf.data = &global->disk[min(rq.arg.rw.seek, DISK_SIZE)];
+                        buf.size = min(rq.arg.rw.size, DISK_SIZE - min(rq.arg.rw.seek, DISK_SIZE));
+                        buf.err  = ESUCC;
+                        ioctl(fileno(global->loop), IOCTL_LOOP__HOST_WRITE_DATA_TO_CLIENT, &buf);
+                        global->dev_reads++;
+                        break;
+                }
+
+                case LOOP_CMD__IOCTL_REQUEST: {
+                        LOOP_ioctl_response_t resp = {.err = ENOTSUP};
+                        ioctl(fileno(global->loop), IOCTL_LOOP__HOST_SET_IOCTL_STATUS, &resp);
+                        break;
+                }
+
+                case LOOP_CMD__DEVICE_STAT: {
+                        LOOP_stat_response_t resp = {.size = DISK_SIZE, .err = ESUCC};
+                        ioctl(fileno(global->loop), IOCTL_LOOP__HOST_SET_DEVICE_STATS, &resp);
+                        break;
+                }
+
+                case LOOP_CMD__FLUSH_BUFFERS: {
+                        int err = ESUCC;
+                        ioctl(fileno(global->loop), IOCTL_LOOP__HOST_FLUSH_DONE, &err);
+                        break;
+                }
+
+                default:
+                case LOOP_CMD__IDLE:
+                        break;
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Print block cache result.
+ *
+ * @param  label        result label
+ * @param  ms           test time
+ * @param  before       VFS statistics before test
+ * @param  after        VFS statistics after test
+ */
+//==============================================================================
+static void print_cache(const char *label, u64_t ms,
+                        const vfsstat_t *before, const vfsstat_t *after)
+{
+        printf("%-24s %6u ms  %5u dev rd  %5u dev wr  %5u hit  %5u miss  %5u wb\n",
+               label, (uint)ms, (uint)global->dev_reads, (uint)global->dev_writes,
+               (uint)(after->bcache_hits - before->bcache_hits),
+               (uint)(after->bcache_misses - before->bcache_misses),
+               (uint)(after->bcache_writebacks - before->bcache_writebacks));
+}
+
+//==============================================================================
+/**
+ * @brief  File write, repeated file read, and repeated stat() on FAT file
+ *         system mounted on selected loop device.
+ *
+ * @param  mnt          mount point
+ * @param  buf          buffer (BLOCK_SIZE)
+ * @param  cache        cache size (label)
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int bcache_workload(const char *mnt, u8_t *buf, int cache)
+{
+        snprintf(global->name, sizeof(global->name), "%s/fsperf.bin", mnt);
+
+        vfsstat_t before, after;
+        char      label[32];
+        int       status = EXIT_FAILURE;
+
+        // write
+        get_VFS_statistics(&before);
+        global->dev_reads  = 0;
+        global->dev_writes = 0;
+        u64_t tstart = get_time_ms();
+
+        FILE *f = fopen(global->name, "w");
+        if (!f) {
+                perror(global->name);
+                return EXIT_FAILURE;
+        }
+
+        for (size_t total = 0; total < CACHE_FILE_SIZE; total += BLOCK_SIZE) {
+                if (fwrite(buf, 1, BLOCK_SIZE, f) != BLOCK_SIZE) {
+                        perror(global->name);
+                        fclose(f);
+                        goto finish;
+                }
+        }
+
+        fclose(f);
+        sync();
+
+        get_VFS_statistics(&after);
+        snprintf(label, sizeof(label), "cache=%d write", cache);
+        print_cache(label, get_time_ms() - tstart, &before, &after);
+
+        // read
+        get_VFS_statistics(&before);
+        global->dev_reads  = 0;
+        global->dev_writes = 0;
+        tstart = get_time_ms();
+
+        for (int pass = 0; pass < CACHE_READ_PASSES; pass++) {
+                f = fopen(global->name, "r");
+                if (!f) {
+                        perror(global->name);
+                        goto finish;
+                }
+
+                while (fread(buf, 1, BLOCK_SIZE, f) == BLOCK_SIZE) {
+                        continue;
+                }
+                fclose(f);
+        }
+
+        get_VFS_statistics(&after);
+        snprintf(label, sizeof(label), "cache=%d read x%d", cache, CACHE_READ_PASSES);
+        print_cache(label, get_time_ms() - tstart, &before, &after);
+
+        // stat
+        get_VFS_statistics(&before);
+        global->dev_reads  = 0;
+        global->dev_writes = 0;
+        tstart = get_time_ms();
+
+        struct stat st;
+        for (int n = 0; n < CACHE_STAT_OPS; n++) {
+                stat(global->name, &st);
+        }
+
+        get_VFS_statistics(&after);
+        snprintf(label, sizeof(label), "cache=%d stat x%d", cache, CACHE_STAT_OPS);
+        print_cache(label, get_time_ms() - tstart, &before, &after);
+
+        status = EXIT_SUCCESS;
+
+        finish:
+        remove(global->name);
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Create RAM disk with FAT file system and start loop device host.
+ *
+ * @param  dev          loop device path
+ * @param  tid          host thread
+ *
+ * @return On success true is returned, otherwise false.
+ */
+//==============================================================================
+static bool loop_start(const char *dev, tid_t *tid)
+{
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        *tid = 0;
+
+        global->disk = malloc(DISK_SIZE);
+        if (!global->disk) {
+                perror(NULL);
+                return false;
+        }
+
+        format_fat12(global->disk);
+
+        global->loop = fopen(dev, "r+");
+        if (!global->loop) {
+                perror(dev);
+                return false;
+        }
+
+        if (ioctl(fileno(global->loop), IOCTL_LOOP__HOST_OPEN) != 0) {
+                perror(dev);
+                return false;
+        }
+
+        global->host_stop = false;
+        *tid = thread_create(loop_host, &THREAD_ATTR, NULL);
+        if (!*tid) {
+                perror(NULL);
+                return false;
+        }
+
+        return true;
+}
+
+//==============================================================================
+/**
+ * @brief  Stop loop device host and release RAM disk.
+ *
+ * @param  dev          loop device path
+ * @param  tid          host thread
+ */
+//==============================================================================
+static void loop_stop(const char *dev, tid_t tid)
+{
+        if (tid) {
+                // stat request wakes up host to finish
+                struct stat st;
+                global->host_stop = true;
+                stat(dev, &st);
+                thread_join(tid);
+        }
+
+        if (global->loop) {
+                ioctl(fileno(global->loop), IOCTL_LOOP__HOST_CLOSE);
+                fclose(global->loop);
+                global->loop = NULL;
+        }
+
+        free(global->disk);
+        global->disk = NULL;
+}
+
+//==============================================================================
+/**
+ * @brief  Block cache effect on FAT file system mounted on RAM disk served by
+ *         loop device host (this program). Each workload is run without cache
+ *         and with cache; device request counts are reported by the host.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_bcache(int argc, char *argv[])
+{
+        static const int CACHE[] = {0, CACHE_BLOCKS};
+
+        const char *dev    = (argc >= 2) ? argv[1] : "/dev/loop0";
+        const char *mnt    = (argc >= 3) ? argv[2] : "/mnt";
+        int         status = EXIT_FAILURE;
+        tid_t       tid    = 0;
+
+        u8_t *buf = malloc(BLOCK_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        memset(buf, 0xAA, BLOCK_SIZE);
+
+        if (loop_start(dev, &tid)) {
+                status = EXIT_SUCCESS;
+        }
+
+        for (size_t i = 0; i < ARRAY_SIZE(CACHE) && status == EXIT_SUCCESS; i++) {
+                char opts[32];
+                snprintf(opts, sizeof(opts), "cache=%d,ra=0", CACHE[i]);
+
+                if (mount("fatfs", dev, mnt, opts) != 0) {
+                        perror(mnt);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                status = bcache_workload(mnt, buf, CACHE[i]);
+
+                if (umount(mnt) != 0) {
+                        perror(mnt);
+                        status = EXIT_FAILURE;
+                }
+        }
+
+        loop_stop(dev, tid);
+        free(buf);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Sequential read of file in small chunks from FAT file system
+ *         mounted on RAM disk served by loop device host (this program).
+ *         File is read without and with read-ahead (cold cache). Read-ahead
+ *         should turn single-block device reads into multi-block reads. RAM
+ *         disk is released at the end, so the file is not removed.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_readahead(int argc, char *argv[])
+{
+        static const int RA[] = {0, READAHEAD_BLOCKS};
+
+        const char *dev    = (argc >= 2) ? argv[1] : "/dev/loop0";
+        const char *mnt    = (argc >= 3) ? argv[2] : "/mnt";
+        int         status = EXIT_FAILURE;
+        tid_t       tid    = 0;
+        FILE       *f      = NULL;
+        char        opts[32];
+
+        u8_t *buf = malloc(BLOCK_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        memset(buf, 0x55, BLOCK_SIZE);
+
+        if (!loop_start(dev, &tid)) {
+                goto finish;
+        }
+
+        snprintf(global->name, sizeof(global->name), "%s/fsperf.bin", mnt);
+        snprintf(opts, sizeof(opts), "cache=%d", CACHE_BLOCKS);
+
+        if (mount("fatfs", dev, mnt, opts) != 0) {
+                perror(mnt);
+                goto finish;
+        }
+
+        f = fopen(global->name, "w");
+        if (f) {
+                for (size_t total = 0; total < CACHE_FILE_SIZE; total += BLOCK_SIZE) {
+                        fwrite(buf, 1, BLOCK_SIZE, f);
+                }
+
+                fclose(f);
+        } else {
+                perror(global->name);
+        }
+
+        umount(mnt);
+
+        status = f ? EXIT_SUCCESS : EXIT_FAILURE;
+
+        for (size_t i = 0; i < ARRAY_SIZE(RA) && status == EXIT_SUCCESS; i++) {
+                snprintf(opts, sizeof(opts), "cache=%d,ra=%d", CACHE_BLOCKS, RA[i]);
+
+                if (mount("fatfs", dev, mnt, opts) != 0) {
+                        perror(mnt);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                vfsstat_t before, after;
+                get_VFS_statistics(&before);
+                global->dev_reads  = 0;
+                global->dev_writes = 0;
+                u64_t tstart = get_time_ms();
+
+                size_t total = 0;
+                f = fopen(global->name, "r");
+                if (f) {
+                        size_t n;
+                        while ((n = fread(buf, 1, READAHEAD_CHUNK, f)) > 0) {
+                                total += n;
+                        }
+
+                        fclose(f);
+                } else {
+                        perror(global->name);
+                        status = EXIT_FAILURE;
+                }
+
+                u64_t tdiff = get_time_ms() - tstart;
+                get_VFS_statistics(&after);
+
+                char label[32];
+                snprintf(label, sizeof(label), "ra=%d seq. read", RA[i]);
+                print_throughput(label, total, tdiff);
+                print_cache(label, tdiff, &before, &after);
+                printf("%-24s %6u blocks read ahead\n", label,
+                       (uint)(after.bcache_readahead - before.bcache_readahead));
+
+                if (umount(mnt) != 0) {
+                        perror(mnt);
+                        status = EXIT_FAILURE;
+                }
+        }
+
+        finish:
+        loop_stop(dev, tid);
+        free(buf);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Random block reads of large file from FAT file system mounted on
+ *         RAM disk served by loop device host (this program). File is read
+ *         without and with cluster map (fast seek). Without map each seek
+ *         follows FAT chain from the beginning of file. Block cache is
+ *         disabled to show device requests of FatFs. RAM disk is released at
+ *         the end, so the file is not removed.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_clmt(int argc, char *argv[])
+{
+        static const int CLMT[] = {0, CLMT_FRAGMENTS};
+
+        const char *dev    = (argc >= 2) ? argv[1] : "/dev/loop0";
+        const char *mnt    = (argc >= 3) ? argv[2] : "/mnt";
+        int         status = EXIT_FAILURE;
+        tid_t       tid    = 0;
+        FILE       *f      = NULL;
+        char        opts[32];
+
+        u8_t *buf = malloc(BLOCK_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        memset(buf, 0x5A, BLOCK_SIZE);
+
+        if (!loop_start(dev, &tid)) {
+                goto finish;
+        }
+
+        snprintf(global->name, sizeof(global->name), "%s/fsperf.bin", mnt);
+
+        if (mount("fatfs", dev, mnt, "cache=0,ra=0") != 0) {
+                perror(mnt);
+                goto finish;
+        }
+
+        f = fopen(global->name, "w");
+        if (f) {
+                for (size_t total = 0; total < CLMT_FILE_SIZE; total += BLOCK_SIZE) {
+                        fwrite(buf, 1, BLOCK_SIZE, f);
+                }
+
+                fclose(f);
+        } else {
+                perror(global->name);
+        }
+
+        umount(mnt);
+
+        status = f ? EXIT_SUCCESS : EXIT_FAILURE;
+
+        for (size_t i = 0; i < ARRAY_SIZE(CLMT) && status == EXIT_SUCCESS; i++) {
+                snprintf(opts, sizeof(opts), "cache=0,ra=0,clmt=%d", CLMT[i]);
+
+                if (mount("fatfs", dev, mnt, opts) != 0) {
+                        perror(mnt);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                global->dev_reads  = 0;
+                global->dev_writes = 0;
+                u64_t tstart = get_time_ms();
+
+                size_t total = 0;
+                f = fopen(global->name, "r");
+                if (f) {
+                        srand(CLMT_FILE_SIZE);
+
+                        for (int r = 0; r < RANDOM_READS; r++) {
+                                fseek(f, (rand() % (CLMT_FILE_SIZE / BLOCK_SIZE)) * BLOCK_SIZE, SEEK_SET);
+                                total += fread(buf, 1, BLOCK_SIZE, f);
+                        }
+
+                        fclose(f);
+                } else {
+                        perror(global->name);
+                        status = EXIT_FAILURE;
+                }
+
+                u64_t tdiff = get_time_ms() - tstart;
+
+                char label[32];
+                snprintf(label, sizeof(label), "clmt=%d rand. read", CLMT[i]);
+                print_throughput(label, total, tdiff);
+                print_latency(label, RANDOM_READS, tdiff);
+                printf("%-24s %6u dev rd\n", label, (uint)global->dev_reads);
+
+                if (umount(mnt) != 0) {
+                        perror(mnt);
+                        status = EXIT_FAILURE;
+                }
+        }
+
+        finish:
+        loop_stop(dev, tid);
+        free(buf);
+
+        return status;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
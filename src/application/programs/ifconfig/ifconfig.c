@@ -280,12 +280,17 @@ static void SIPC_status(void)
                        "  Status: %s\n"
                        "  MTU: %u B\n"
                        "  RX packets: %u (%u %s)\n"
-                       "  TX packets: %u (%u %s)\n",
+                       "  TX packets: %u (%u %s)\n"
+                       "  TX retries: %u\n"
+                       "  RX pool: %u packets (%u heap), %u descriptors (%u heap)\n",
 
                        SIPC_STATE[ifstat.state],
                        ifstat.MTU,
                        (uint)ifstat.rx_packets, cast(uint, ifstat.rx_bytes), rx_unit,
-                       (uint)ifstat.tx_packets, cast(uint, ifstat.tx_bytes), tx_unit
+                       (uint)ifstat.tx_packets, cast(uint, ifstat.tx_bytes), tx_unit,
+                       (uint)ifstat.tx_retries,
+                       (uint)ifstat.packet_pool_allocs, (uint)ifstat.packet_heap_allocs,
+                       (uint)ifstat.desc_pool_allocs, (uint)ifstat.desc_heap_allocs
                );
         }
 }
@@ -293,10 +293,11 @@ static void print_system_log_messages(void)
          *    at system startup. It can be used in debug purposes. It can be
          *    also disabled if not needed. Function run in thread.
          */
-        struct timeval t = {0, 0};
+        struct timeval t;
+        u32_t seq = 0;
 
         while (true) {
-                if (syslog_read(global->str, sizeof(global->str), &t, &t)) {
+                if (syslog_read(global->str, sizeof(global->str), &seq, &t)) {
                         printf("[%u.%06u] %s\n", t.tv_sec, t.tv_usec, global->str);
                 } else {
                         break;
@@ -0,0 +1,1381 @@
+/*==============================================================================
+File    ioperf.c
+
+Author  Daniel Zorychta
+
+Brief   I/O performance measurement program
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <dnx/os.h>
+#include <dnx/misc.h>
+#include <dnx/thread.h>
+#include <dnx/net.h>
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define PIPE_TRANSFER_SIZE      (1024 * 1024)
+#define PIPE_BUFFER_SIZE        4096
+#define STDIO_LINES             10000
+#define PRINTF_CALLS            10000
+#define RELAY_ROUNDS            200
+#define RELAY_IDLE_MS           2500
+#define RELAY_PERIOD_MS         10
+#define VECTOR_RECORDS          2000
+#define VECTOR_PAYLOAD          24
+#define VECTOR_BATCH            16
+#define SIPC_TRANSFER_KIB       64
+#define SIPC_BUFFER_SIZE        1024
+#define SIPC_TIMEOUT_MS         5000
+#define SIPC_DRAIN_MS           500
+#define SIPC_HEADER_SIZE        10
+#define SIPC_FRAME_PAYLOAD      64
+#define SIPC_RX_FRAMES          500
+#define TCP_TRANSFER_KIB        256
+#define TCP_BUFFER_SIZE         4096
+#define TCP_TIMEOUT_MS          5000
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        const char *name;
+        int (*func)(int argc, char *argv[]);
+        const char *usage;
+} test_t;
+
+typedef struct {
+        u32_t seq;
+        u32_t len;
+} record_hdr_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+static int test_pipe(int argc, char *argv[]);
+static int test_stdio(int argc, char *argv[]);
+static int test_printf(int argc, char *argv[]);
+static int test_poll(int argc, char *argv[]);
+static int test_vector(int argc, char *argv[]);
+static int test_sipc(int argc, char *argv[]);
+static int test_sipcrx(int argc, char *argv[]);
+static int test_tcp(int argc, char *argv[]);
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static const test_t TEST[] = {
+        {.name = "pipe",   .func = test_pipe,   .usage = "[fifo-path]"},
+        {.name = "stdio",  .func = test_stdio,  .usage = "[file-path]"},
+        {.name = "printf", .func = test_printf, .usage = "[file-path]"},
+        {.name = "poll",   .func = test_poll,   .usage = "[fifo-path]"},
+        {.name = "vector", .func = test_vector, .usage = "[file-path]"},
+        {.name = "sipc",   .func = test_sipc,   .usage = "[port] [KiB]"},
+        {.name = "sipcrx", .func = test_sipcrx, .usage = "[interface-path] [port]"},
+        {.name = "tcp",    .func = test_tcp,    .usage = "[port] [KiB]"},
+};
+
+GLOBAL_VARIABLES_SECTION {
+        const char *fifo_path;
+        size_t      chunk;
+        size_t      written;
+        char        relay_in[32];
+        char        relay_out[32];
+        bool        relay_poll;
+        bool        relay_stop;
+
+        struct {
+                size_t bytes;
+                u64_t  ms;
+        } result[2][2][3];      // [file, tty][fprintf, fputc][buffer mode]
+
+        record_hdr_t hdr[VECTOR_BATCH];
+        u8_t         payload[VECTOR_BATCH][VECTOR_PAYLOAD];
+        struct iovec iov[VECTOR_BATCH * 2];
+
+        SOCKET      *sipc_socket;
+        size_t       sipc_received;
+        bool         sipc_stop;
+
+        size_t       tcp_received;
+        bool         tcp_stop;
+};
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+PROGRAM_PARAMS(ioperf, STACK_DEPTH_LOW);
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * Main program function.
+ *
+ * @param argc      argument count
+ * @param argv      arguments
+ */
+//==============================================================================
+int main(int argc, char *argv[])
+{
+        if (argc >= 2) {
+                for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                        if (strcmp(argv[1], TEST[i].name) == 0) {
+                                return TEST[i].func(argc - 1, &argv[1]);
+                        }
+                }
+        }
+
+        printf("Usage: %s <test> [args]\n", argv[0]);
+        for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                printf("  %s %s\n", TEST[i].name, TEST[i].usage);
+        }
+
+        return EXIT_FAILURE;
+}
+
+//==============================================================================
+/**
+ * @brief  Print transfer result.
+ *
+ * @param  label        result label
+ * @param  bytes        number of transferred bytes
+ * @param  ms           transfer time
+ */
+//==============================================================================
+static void print_throughput(const char *label, size_t bytes, u64_t ms)
+{
+        u32_t kibps = (ms > 0) ? (u32_t)((u64_t)bytes * 1000 / 1024 / ms) : 0;
+
+        printf("%-24s %8u B  %6u ms  %8u KiB/s\n",
+               label, (uint)bytes, (uint)ms, (uint)kibps);
+}
+
+//==============================================================================
+/**
+ * @brief  Print operation latency result.
+ *
+ * @param  label        result label
+ * @param  ops          number of operations
+ * @param  ms           total time
+ */
+//==============================================================================
+static void print_latency(const char *label, size_t ops, u64_t ms)
+{
+        u32_t us = (ops > 0) ? (u32_t)(ms * 1000 / ops) : 0;
+
+        printf("%-24s %8u op  %6u ms  %8u us/op\n",
+               label, (uint)ops, (uint)ms, (uint)us);
+}
+
+//==============================================================================
+/**
+ * @brief  Pipe writer thread.
+ *
+ * @param  arg          unused
+ */
+//==============================================================================
+static void pipe_writer(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+        global->written = 0;
+
+        u8_t *buf = malloc(global->chunk);
+        if (buf) {
+                memset(buf, 0x55, global->chunk);
+
+                FILE *f = fopen(global->fifo_path, "w");
+                if (f) {
+                        while (global->written < PIPE_TRANSFER_SIZE) {
+                                size_t n = fwrite(buf, 1, global->chunk, f);
+                                if (n == 0) {
+                                        break;
+                                }
+
+                                global->written += n;
+                        }
+
+                        fclose(f);
+                }
+
+                free(buf);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Push 1 MiB through FIFO in 1, 64, and 4096 byte chunks.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_pipe(int argc, char *argv[])
+{
+        static const size_t CHUNK[] = {1, 64, 4096};
+
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        global->fifo_path = (argc >= 2) ? argv[1] : "/tmp/ioperf.fifo";
+
+        u8_t *buf = malloc(PIPE_BUFFER_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        int status = EXIT_SUCCESS;
+
+        for (size_t i = 0; i < ARRAY_SIZE(CHUNK); i++) {
+
+                global->chunk = CHUNK[i];
+
+                if (mkfifo(global->fifo_path, 0666) != 0) {
+                        perror(global->fifo_path);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                FILE *f = fopen(global->fifo_path, "r");
+                if (!f) {
+                        perror(global->fifo_path);
+                        remove(global->fifo_path);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                u64_t  tstart = get_time_ms();
+                size_t total  = 0;
+
+                tid_t tid = thread_create(pipe_writer, &THREAD_ATTR, NULL);
+                if (tid) {
+                        size_t n;
+                        while ((n = fread(buf, 1, PIPE_BUFFER_SIZE, f)) > 0) {
+                                total += n;
+                        }
+
+                        thread_join(tid);
+                } else {
+                        perror(NULL);
+                        status = EXIT_FAILURE;
+                }
+
+                u64_t tstop = get_time_ms();
+
+                fclose(f);
+                remove(global->fifo_path);
+
+                if (status == EXIT_SUCCESS) {
+                        char label[32];
+                        snprintf(label, sizeof(label), "pipe, %u B chunks", (uint)CHUNK[i]);
+                        print_throughput(label, total, tstop - tstart);
+
+                        if (total != global->written) {
+                                printf("Data lost: written %u B\n", (uint)global->written);
+                                status = EXIT_FAILURE;
+                        }
+                } else {
+                        break;
+                }
+        }
+
+        free(buf);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Write lines to stream by using fprintf() or fputc().
+ *
+ * @param  f            stream
+ * @param  by_char      true: lines are written by fputc()
+ *
+ * @return Number of written bytes.
+ */
+//==============================================================================
+static size_t write_lines(FILE *f, bool by_char)
+{
+        static const char LINE[] = "ioperf stdio test line\n";
+
+        size_t total = 0;
+
+        for (uint n = 0; n < STDIO_LINES; n++) {
+                if (by_char) {
+                        for (size_t i = 0; i < sizeof(LINE) - 1; i++) {
+                                if (fputc(LINE[i], f) != EOF) {
+                                        total++;
+                                }
+                        }
+                } else {
+                        int r = fprintf(f, "%5u: %s", n, LINE);
+                        if (r > 0) {
+                                total += r;
+                        }
+                }
+        }
+
+        fflush(f);
+
+        return total;
+}
+
+//==============================================================================
+/**
+ * @brief  Write 10k lines by fprintf() and fputc() to regular file and to
+ *         stdout (terminal) in each stream buffer mode. Results are printed
+ *         at the end to do not mix them with terminal output.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_stdio(int argc, char *argv[])
+{
+        static const struct {
+                int         mode;
+                const char *name;
+        } MODE[] = {
+                {.mode = _IONBF, .name = "unbuf"},
+                {.mode = _IOLBF, .name = "line"},
+                {.mode = _IOFBF, .name = "full"},
+        };
+
+        const char *path = (argc >= 2) ? argv[1] : "/tmp/ioperf.txt";
+
+        for (int target = 0; target < 2; target++) {
+                for (int by_char = 0; by_char < 2; by_char++) {
+                        for (size_t m = 0; m < ARRAY_SIZE(MODE); m++) {
+
+                                FILE *f = (target == 0) ? fopen(path, "w") : stdout;
+                                if (!f) {
+                                        perror(path);
+                                        return EXIT_FAILURE;
+                                }
+
+                                setvbuf(f, NULL, MODE[m].mode, 0);
+
+                                u64_t tstart = get_time_ms();
+                                global->result[target][by_char][m].bytes = write_lines(f, by_char);
+                                global->result[target][by_char][m].ms    = get_time_ms() - tstart;
+
+                                if (target == 0) {
+                                        fclose(f);
+                                }
+                        }
+                }
+        }
+
+        setvbuf(stdout, NULL, _IOLBF, 0);
+        remove(path);
+
+        for (int target = 0; target < 2; target++) {
+                for (int by_char = 0; by_char < 2; by_char++) {
+                        for (size_t m = 0; m < ARRAY_SIZE(MODE); m++) {
+                                char label[32];
+                                snprintf(label, sizeof(label), "%s, %s, %s",
+                                         (target == 0) ? "file" : "tty",
+                                         by_char ? "fputc" : "fprintf",
+                                         MODE[m].name);
+
+                                print_throughput(label,
+                                                 global->result[target][by_char][m].bytes,
+                                                 global->result[target][by_char][m].ms);
+                        }
+                }
+        }
+
+        return EXIT_SUCCESS;
+}
+
+//==============================================================================
+/**
+ * @brief  Two pass formatting: text size is calculated, buffer allocated, text
+ *         formatted again and written (reference of former vfprintf()).
+ *
+ * @param  f            stream
+ * @param  format       format
+ * @param  ...          arguments
+ *
+ * @return Number of written characters.
+ */
+//==============================================================================
+static int two_pass_fprintf(FILE *f, const char *format, ...)
+{
+        va_list arg;
+        va_start(arg, format);
+        int size = vsnprintf(NULL, 0, format, arg) + 1;
+        va_end(arg);
+
+        int n = 0;
+
+        char *str = calloc(1, size);
+        if (str) {
+                va_start(arg, format);
+                n = vsnprintf(str, size, format, arg);
+                va_end(arg);
+
+                fwrite(str, sizeof(char), n, f);
+                free(str);
+        }
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Time per formatted line: snprintf() only, former two pass
+ *         fprintf(), and single pass fprintf().
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_printf(int argc, char *argv[])
+{
+        static const char FORMAT[] = "%5u: %s 0x%08X %d\n";
+
+        const char *path = (argc >= 2) ? argv[1] : "/tmp/ioperf.txt";
+
+        FILE *f = fopen(path, "w");
+        if (!f) {
+                perror(path);
+                return EXIT_FAILURE;
+        }
+
+        char line[64];
+
+        u64_t tstart = get_time_ms();
+        for (uint n = 0; n < PRINTF_CALLS; n++) {
+                snprintf(line, sizeof(line), FORMAT, n, "printf", n, -(int)n);
+        }
+        u64_t t_snprintf = get_time_ms() - tstart;
+
+        tstart = get_time_ms();
+        for (uint n = 0; n < PRINTF_CALLS; n++) {
+                two_pass_fprintf(f, FORMAT, n, "printf", n, -(int)n);
+        }
+        u64_t t_two_pass = get_time_ms() - tstart;
+
+        tstart = get_time_ms();
+        for (uint n = 0; n < PRINTF_CALLS; n++) {
+                fprintf(f, FORMAT, n, "printf", n, -(int)n);
+        }
+        u64_t t_fprintf = get_time_ms() - tstart;
+
+        fclose(f);
+        remove(path);
+
+        print_latency("snprintf", PRINTF_CALLS, t_snprintf);
+        print_latency("fprintf, two pass", PRINTF_CALLS, t_two_pass);
+        print_latency("fprintf, single pass", PRINTF_CALLS, t_fprintf);
+
+        return EXIT_SUCCESS;
+}
+
+//==============================================================================
+/**
+ * @brief  Echo relay thread. Data is copied from input FIFO to output FIFO.
+ *         Relay waits for data by using poll() or by reading input in
+ *         non-blocking mode periodically (as network servers did before).
+ *
+ * @param  arg          unused
+ */
+//==============================================================================
+static void relay(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+        FILE *fin  = fopen(global->relay_in, "r");
+        FILE *fout = fopen(global->relay_out, "w");
+
+        if (fin && fout) {
+                setvbuf(fin, NULL, _IONBF, 0);
+                setvbuf(fout, NULL, _IONBF, 0);
+
+                if (!global->relay_poll) {
+                        ioctl(fileno(fin), IOCTL_VFS__NON_BLOCKING_RD_MODE);
+                }
+
+                struct pollfd fds = {.fd = fin, .events = POLLIN};
+                u8_t buf[16];
+
+                while (!global->relay_stop) {
+                        if (global->relay_poll) {
+                                if (  (poll(&fds, 1, -1) < 0)
+                                   || (fds.revents & (POLLHUP | POLLERR | POLLNVAL)) ) {
+                                        break;
+                                }
+                        }
+
+                        size_t n = fread(buf, 1, sizeof(buf), fin);
+                        if (n > 0) {
+                                fwrite(buf, 1, n, fout);
+
+                        } else if (!global->relay_poll) {
+                                // other sources are served here by the same thread
+                                msleep(RELAY_PERIOD_MS);
+                        }
+                }
+        }
+
+        if (fin) {
+                fclose(fin);
+        }
+
+        if (fout) {
+                fclose(fout);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Measure echo relay round trip latency and relay CPU usage when
+ *         relay is idle.
+ *
+ * @param  use_poll     true: relay uses poll()
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int relay_run(bool use_poll)
+{
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        int   status = EXIT_FAILURE;
+        FILE *tx     = NULL;
+        FILE *rx     = NULL;
+        tid_t tid    = 0;
+
+        global->relay_poll = use_poll;
+        global->relay_stop = false;
+
+        if (  (mkfifo(global->relay_in, 0666) != 0)
+           || (mkfifo(global->relay_out, 0666) != 0) ) {
+                perror(NULL);
+                goto finish;
+        }
+
+        tx = fopen(global->relay_in, "w");
+        rx = fopen(global->relay_out, "r");
+        if (!tx || !rx) {
+                perror(NULL);
+                goto finish;
+        }
+
+        setvbuf(tx, NULL, _IONBF, 0);
+        setvbuf(rx, NULL, _IONBF, 0);
+
+        tid = thread_create(relay, &THREAD_ATTR, NULL);
+        if (!tid) {
+                perror(NULL);
+                goto finish;
+        }
+
+        u64_t tstart = get_time_ms();
+        uint  rounds = 0;
+
+        for (; rounds < RELAY_ROUNDS; rounds++) {
+                u8_t c = rounds;
+                u8_t e = ~c;
+
+                if (  (fwrite(&c, 1, 1, tx) != 1)
+                   || (fread(&e, 1, 1, rx) != 1)
+                   || (e != c) ) {
+                        break;
+                }
+        }
+
+        u64_t tstop = get_time_ms();
+
+        // relay is idle, CPU load is calculated every second
+        msleep(RELAY_IDLE_MS);
+
+        thread_stat_t stat;
+        memset(&stat, 0, sizeof(stat));
+        thread_stat(getpid(), tid, &stat);
+
+        const char *label = use_poll ? "relay, poll()" : "relay, periodic read";
+        print_latency(label, rounds, tstop - tstart);
+        printf("%-24s %5u.%u %% CPU  %6u syscalls/s\n",
+               "  idle", stat.CPU_load / 10, stat.CPU_load % 10, (uint)stat.syscalls);
+
+        if (rounds == RELAY_ROUNDS) {
+                status = EXIT_SUCCESS;
+        } else {
+                printf("Echo lost at round %u\n", rounds);
+        }
+
+        finish:
+        global->relay_stop = true;
+
+        if (tx) {
+                ioctl(fileno(tx), IOCTL_PIPE__CLOSE);
+        }
+
+        if (tid) {
+                thread_join(tid);
+        }
+
+        if (tx) {
+                fclose(tx);
+        }
+
+        if (rx) {
+                fclose(rx);
+        }
+
+        remove(global->relay_in);
+        remove(global->relay_out);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Compare echo relay that waits in poll() with relay that reads
+ *         input periodically.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_poll(int argc, char *argv[])
+{
+        const char *path = (argc >= 2) ? argv[1] : "/tmp/ioperf.fifo";
+
+        snprintf(global->relay_in, sizeof(global->relay_in), "%s.in", path);
+        snprintf(global->relay_out, sizeof(global->relay_out), "%s.out", path);
+
+        int status = relay_run(false);
+        if (status == EXIT_SUCCESS) {
+                status = relay_run(true);
+        }
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Write records (header and payload) to file. Records are written
+ *         by two fwrite() calls, or by writev() calls with selected number
+ *         of records in single vector.
+ *
+ * @param  f            file (unbuffered)
+ * @param  batch        records per writev() call (0: fwrite() is used)
+ *
+ * @return Number of written records.
+ */
+//==============================================================================
+static size_t write_records(FILE *f, size_t batch)
+{
+        size_t records = 0;
+
+        while (records < VECTOR_RECORDS) {
+                size_t n = min(max(batch, 1), VECTOR_RECORDS - records);
+
+                for (size_t i = 0; i < n; i++) {
+                        global->hdr[i].seq = records + i;
+                        global->hdr[i].len = VECTOR_PAYLOAD;
+                        memset(global->payload[i], (records + i) & 0xFF, VECTOR_PAYLOAD);
+
+                        global->iov[i * 2].iov_base     = &global->hdr[i];
+                        global->iov[i * 2].iov_len      = sizeof(record_hdr_t);
+                        global->iov[i * 2 + 1].iov_base = global->payload[i];
+                        global->iov[i * 2 + 1].iov_len  = VECTOR_PAYLOAD;
+                }
+
+                if (batch == 0) {
+                        if (  (fwrite(&global->hdr[0], sizeof(record_hdr_t), 1, f) != 1)
+                           || (fwrite(global->payload[0], VECTOR_PAYLOAD, 1, f) != 1) ) {
+                                break;
+                        }
+
+                } else {
+                        ssize_t size = n * (sizeof(record_hdr_t) + VECTOR_PAYLOAD);
+
+                        if (writev(f, global->iov, n * 2) != size) {
+                                break;
+                        }
+                }
+
+                records += n;
+        }
+
+        return records;
+}
+
+//==============================================================================
+/**
+ * @brief  Read records by readv() and check its sequence.
+ *
+ * @param  f            file
+ *
+ * @return Number of correct records.
+ */
+//==============================================================================
+static size_t read_records(FILE *f)
+{
+        size_t records = 0;
+
+        while (records < VECTOR_RECORDS) {
+                size_t n = min(VECTOR_BATCH, VECTOR_RECORDS - records);
+
+                for (size_t i = 0; i < n; i++) {
+                        global->iov[i * 2].iov_base     = &global->hdr[i];
+                        global->iov[i * 2].iov_len      = sizeof(record_hdr_t);
+                        global->iov[i * 2 + 1].iov_base = global->payload[i];
+                        global->iov[i * 2 + 1].iov_len  = VECTOR_PAYLOAD;
+                }
+
+                ssize_t size = n * (sizeof(record_hdr_t) + VECTOR_PAYLOAD);
+
+                if (readv(f, global->iov, n * 2) != size) {
+                        return records;
+                }
+
+                for (size_t i = 0; i < n; i++) {
+                        if (  (global->hdr[i].seq != records)
+                           || (global->payload[i][VECTOR_PAYLOAD - 1] != (records & 0xFF)) ) {
+                                return records;
+                        }
+
+                        records++;
+                }
+        }
+
+        return records;
+}
+
+//==============================================================================
+/**
+ * @brief  Many small records (header and payload) written with and without
+ *         vectored I/O. Each fwrite() of unbuffered stream is a system call
+ *         and file system call; writev() passes entire vector at once.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_vector(int argc, char *argv[])
+{
+        static const struct {
+                size_t      batch;
+                const char *name;
+        } MODE[] = {
+                {.batch = 0,            .name = "fwrite hdr+payload"},
+                {.batch = 1,            .name = "writev 1 record"},
+                {.batch = VECTOR_BATCH, .name = "writev 16 records"},
+        };
+
+        const char *path   = (argc >= 2) ? argv[1] : "/tmp/ioperf.rec";
+        int         status = EXIT_SUCCESS;
+
+        for (size_t m = 0; (m < ARRAY_SIZE(MODE)) && (status == EXIT_SUCCESS); m++) {
+
+                FILE *f = fopen(path, "w+");
+                if (!f) {
+                        perror(path);
+                        return EXIT_FAILURE;
+                }
+
+                setvbuf(f, NULL, _IONBF, 0);
+
+                u64_t  tstart  = get_time_ms();
+                size_t records = write_records(f, MODE[m].batch);
+                print_latency(MODE[m].name, records, get_time_ms() - tstart);
+
+                rewind(f);
+
+                tstart = get_time_ms();
+                size_t checked = read_records(f);
+
+                if (m == ARRAY_SIZE(MODE) - 1) {
+                        print_latency("readv 16 records", checked, get_time_ms() - tstart);
+                }
+
+                if ((records != VECTOR_RECORDS) || (checked != VECTOR_RECORDS)) {
+                        printf("Record %u is not correct\n", (uint)min(records, checked));
+                        status = EXIT_FAILURE;
+                }
+
+                fclose(f);
+        }
+
+        remove(path);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  SIPC reader thread. Data sent to loopback interface is received by
+ *         the same socket.
+ *
+ * @param  arg          unused
+ */
+//==============================================================================
+static void sipc_reader(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+        global->sipc_received = 0;
+
+        u8_t *buf = malloc(SIPC_BUFFER_SIZE);
+        if (buf) {
+                while (!global->sipc_stop) {
+                        int n = socket_read(global->sipc_socket, buf, SIPC_BUFFER_SIZE);
+                        if (n > 0) {
+                                global->sipc_received += n;
+                        }
+                }
+
+                free(buf);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  SIPC zero-copy reader thread. Received packets are counted directly
+ *         in socket buffer by peek and released by consume.
+ *
+ * @param  arg          unused
+ */
+//==============================================================================
+static void sipc_peek_reader(void *arg)
+{
+        UNUSED_ARG1(arg);
+
+        global->sipc_received = 0;
+
+        while (!global->sipc_stop) {
+                const void *data = NULL;
+                int n = socket_peek(global->sipc_socket, &data);
+                if (n > 0) {
+                        global->sipc_received += n;
+                        socket_consume(global->sipc_socket, n);
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Send data through SIPC socket connected to selected port and print
+ *         throughput and retransmission statistics. Remote side is another
+ *         stack connected to interface or the same stack when interface is
+ *         a loopback (e.g. FIFO), link latency and errors are that of the
+ *         interface. Transfer mode (windowed or stop-and-wait) is negotiated
+ *         at connection.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_sipc(int argc, char *argv[])
+{
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        NET_SIPC_sockaddr_t addr = {.port = (argc >= 2) ? atoi(argv[1]) : 1};
+        size_t size = ((argc >= 3) ? (size_t)atoi(argv[2]) : SIPC_TRANSFER_KIB) * 1024;
+
+        u8_t *buf = malloc(SIPC_BUFFER_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        memset(buf, 0x55, SIPC_BUFFER_SIZE);
+
+        int status = EXIT_FAILURE;
+
+        global->sipc_socket = socket_open(NET_FAMILY__SIPC, NET_PROTOCOL__STREAM);
+        if (!global->sipc_socket) {
+                perror("SIPC");
+                goto finish;
+        }
+
+        socket_set_send_timeout(global->sipc_socket, SIPC_TIMEOUT_MS);
+        socket_set_recv_timeout(global->sipc_socket, 100);
+
+        u64_t tstart = get_time_ms();
+
+        if (socket_connect(global->sipc_socket, &addr) != 0) {
+                perror("SIPC");
+                goto finish;
+        }
+
+        print_latency("connect", 1, get_time_ms() - tstart);
+
+        NET_SIPC_status_t stat[2];
+        ifstatus(NET_FAMILY__SIPC, &stat[0]);
+
+        global->sipc_stop = false;
+        tid_t tid = thread_create(sipc_reader, &THREAD_ATTR, NULL);
+
+        size_t sent = 0;
+        tstart = get_time_ms();
+
+        while (sent < size) {
+                int n = socket_write(global->sipc_socket, buf, min(size - sent, SIPC_BUFFER_SIZE));
+                if (n <= 0) {
+                        perror("SIPC");
+                        break;
+                }
+
+                sent += n;
+        }
+
+        u64_t tstop = get_time_ms();
+
+        ifstatus(NET_FAMILY__SIPC, &stat[1]);
+
+        if (tid) {
+                msleep(SIPC_DRAIN_MS);
+                global->sipc_stop = true;
+                thread_join(tid);
+        }
+
+        print_throughput("send", sent, tstop - tstart);
+
+        printf("TX packets: %u, retries: %u, RX packets: %u, loopback: %u B\n",
+               (uint)(stat[1].tx_packets - stat[0].tx_packets),
+               (uint)(stat[1].tx_retries - stat[0].tx_retries),
+               (uint)(stat[1].rx_packets - stat[0].rx_packets),
+               (uint)global->sipc_received);
+
+        if (sent == size) {
+                status = EXIT_SUCCESS;
+        }
+
+        finish:
+        if (global->sipc_socket) {
+                socket_close(global->sipc_socket);
+        }
+
+        free(buf);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Calculate SIPC frame checksum (Fletcher-16).
+ *
+ * @param  data         data
+ * @param  len          data length
+ *
+ * @return Checksum.
+ */
+//==============================================================================
+static u16_t sipc_checksum(const u8_t *data, size_t len)
+{
+        u32_t sum1 = 0xff, sum2 = 0xff;
+
+        while (len--) {
+                sum1 = (sum1 + *data++) % 255;
+                sum2 = (sum2 + sum1) % 255;
+        }
+
+        return ((sum2 ? sum2 : 0xff) << 8) | (sum1 ? sum1 : 0xff);
+}
+
+//==============================================================================
+/**
+ * @brief  Build SIPC DATA frame.
+ *
+ * @param  frame        frame buffer
+ * @param  seq          sequence
+ * @param  port         port
+ *
+ * @return Frame length.
+ */
+//==============================================================================
+static size_t sipc_frame(u8_t *frame, u16_t seq, u8_t port)
+{
+        u8_t *hdr     = &frame[4];
+        u8_t *payload = &frame[SIPC_HEADER_SIZE];
+
+        hdr[0] = SIPC_FRAME_PAYLOAD & 0xFF;
+        hdr[1] = SIPC_FRAME_PAYLOAD >> 8;
+        hdr[2] = seq & 0xFF;
+        hdr[3] = seq >> 8;
+        hdr[4] = port;
+        hdr[5] = 0;     // DATA
+
+        memset(payload, seq, SIPC_FRAME_PAYLOAD);
+
+        u16_t checksum = sipc_checksum(hdr, 6) ^ sipc_checksum(payload, SIPC_FRAME_PAYLOAD);
+
+        frame[0] = 0xAA;
+        frame[1] = 0x55;
+        frame[2] = checksum & 0xFF;
+        frame[3] = checksum >> 8;
+
+        return SIPC_HEADER_SIZE + SIPC_FRAME_PAYLOAD;
+}
+
+//==============================================================================
+/**
+ * @brief  Write DATA frames mixed with random noise to SIPC interface and
+ *         measure receive throughput of socket bound to selected port. The
+ *         interface have to be a loopback (e.g. FIFO created before network
+ *         start) to receive written frames. Noise level is number of noise
+ *         bytes per 100 frame bytes. Data is received without copying by
+ *         socket_peek() and socket_consume().
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_sipcrx(int argc, char *argv[])
+{
+        static const uint NOISE[] = {0, 10, 50, 100};
+
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        const char *path = (argc >= 2) ? argv[1] : "/dev/nc";
+        NET_SIPC_sockaddr_t addr = {.port = (argc >= 3) ? atoi(argv[2]) : 2};
+
+        u8_t *buf = malloc(SIPC_BUFFER_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        int status = EXIT_FAILURE;
+
+        global->sipc_socket = socket_open(NET_FAMILY__SIPC, NET_PROTOCOL__STREAM);
+        if (!global->sipc_socket) {
+                perror("SIPC");
+                goto finish;
+        }
+
+        socket_set_recv_timeout(global->sipc_socket, 100);
+
+        if (socket_bind(global->sipc_socket, &addr) != 0) {
+                perror("SIPC");
+                goto finish;
+        }
+
+        status = EXIT_SUCCESS;
+        srand(SIPC_RX_FRAMES);
+
+        for (size_t n = 0; (status == EXIT_SUCCESS) && (n < ARRAY_SIZE(NOISE)); n++) {
+
+                FILE *f = fopen(path, "w");
+                if (!f) {
+                        perror(path);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+
+                NET_SIPC_status_t stat[2];
+                ifstatus(NET_FAMILY__SIPC, &stat[0]);
+
+                global->sipc_stop = false;
+                tid_t tid = thread_create(sipc_peek_reader, &THREAD_ATTR, NULL);
+
+                u64_t tstart = get_time_ms();
+
+                for (u16_t seq = 0; seq < SIPC_RX_FRAMES; seq++) {
+                        size_t len   = sipc_frame(buf, seq, addr.port);
+                        size_t noise = len * NOISE[n] / 100;
+
+                        while (noise--) {
+                                fputc(rand() & 0xFF, f);
+                        }
+
+                        fwrite(buf, 1, len, f);
+                }
+
+                // flush frame buffer if noise started false frame
+                memset(buf, 0, SIPC_BUFFER_SIZE);
+                fwrite(buf, 1, SIPC_BUFFER_SIZE, f);
+                fflush(f);
+
+                size_t expected = SIPC_RX_FRAMES * SIPC_FRAME_PAYLOAD;
+
+                while (  (global->sipc_received < expected)
+                      && (get_time_ms() - tstart < SIPC_TIMEOUT_MS) ) {
+                        msleep(10);
+                }
+
+                u64_t tstop = get_time_ms();
+
+                if (tid) {
+                        global->sipc_stop = true;
+                        thread_join(tid);
+                }
+
+                fclose(f);
+
+                ifstatus(NET_FAMILY__SIPC, &stat[1]);
+
+                char label[32];
+                snprintf(label, sizeof(label), "rx, noise %u%%", NOISE[n]);
+                print_throughput(label, global->sipc_received, tstop - tstart);
+
+                printf("Pool: %u packets (%u heap), %u descriptors (%u heap)\n",
+                       (uint)(stat[1].packet_pool_allocs - stat[0].packet_pool_allocs),
+                       (uint)(stat[1].packet_heap_allocs - stat[0].packet_heap_allocs),
+                       (uint)(stat[1].desc_pool_allocs - stat[0].desc_pool_allocs),
+                       (uint)(stat[1].desc_heap_allocs - stat[0].desc_heap_allocs));
+
+                if (global->sipc_received != expected) {
+                        printf("Data lost: expected %u B\n", (uint)expected);
+                        status = EXIT_FAILURE;
+                }
+        }
+
+        finish:
+        if (global->sipc_socket) {
+                socket_close(global->sipc_socket);
+        }
+
+        free(buf);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  TCP reader thread. Accepts single connection on listening socket and
+ *         counts received bytes.
+ *
+ * @param  arg          listening socket
+ */
+//==============================================================================
+static void tcp_reader(void *arg)
+{
+        SOCKET *sock = NULL;
+
+        global->tcp_received = 0;
+
+        if (socket_accept(arg, &sock) == 0) {
+                socket_set_recv_timeout(sock, 100);
+
+                u8_t *buf = malloc(TCP_BUFFER_SIZE);
+                if (buf) {
+                        while (!global->tcp_stop) {
+                                int n = socket_read(sock, buf, TCP_BUFFER_SIZE);
+                                if (n > 0) {
+                                        global->tcp_received += n;
+                                }
+                        }
+
+                        free(buf);
+                }
+
+                socket_close(sock);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  TCP bulk transfer to own address. Without Ethernet hardware the
+ *         interface can be a loopback device (ETHLOOP), then throughput is
+ *         limited only by the TCP/IP stack and the Ethernet glue.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_tcp(int argc, char *argv[])
+{
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        u16_t  port = (argc >= 2) ? atoi(argv[1]) : 5001;
+        size_t size = ((argc >= 3) ? (size_t)atoi(argv[2]) : TCP_TRANSFER_KIB) * 1024;
+
+        NET_INET_status_t stat[2];
+        if (ifstatus(NET_FAMILY__INET, &stat[0]) != 0) {
+                perror("INET");
+                return EXIT_FAILURE;
+        }
+
+        u8_t *buf = malloc(TCP_BUFFER_SIZE);
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        memset(buf, 0x55, TCP_BUFFER_SIZE);
+
+        int     status = EXIT_FAILURE;
+        tid_t   tid    = 0;
+        SOCKET *client = NULL;
+
+        SOCKET *server = socket_open(NET_FAMILY__INET, NET_PROTOCOL__TCP);
+        if (!server) {
+                perror("INET");
+                goto finish;
+        }
+
+        NET_INET_sockaddr_t addr = {.addr = NET_INET_IPv4_ANY, .port = port};
+
+        socket_set_recv_timeout(server, TCP_TIMEOUT_MS);
+
+        if (socket_bind(server, &addr) != 0 || socket_listen(server) != 0) {
+                perror("INET");
+                goto finish;
+        }
+
+        global->tcp_stop = false;
+        tid = thread_create(tcp_reader, &THREAD_ATTR, server);
+        if (!tid) {
+                perror(NULL);
+                goto finish;
+        }
+
+        client = socket_open(NET_FAMILY__INET, NET_PROTOCOL__TCP);
+        if (!client) {
+                perror("INET");
+                goto finish;
+        }
+
+        socket_set_send_timeout(client, TCP_TIMEOUT_MS);
+
+        addr.addr = stat[0].address;
+
+        u64_t tstart = get_time_ms();
+
+        if (socket_connect(client, &addr) != 0) {
+                perror("INET");
+                goto finish;
+        }
+
+        print_latency("connect", 1, get_time_ms() - tstart);
+
+        size_t sent = 0;
+        tstart = get_time_ms();
+
+        while (sent < size) {
+                int n = socket_write(client, buf, min(size - sent, TCP_BUFFER_SIZE));
+                if (n <= 0) {
+                        perror("INET");
+                        break;
+                }
+
+                sent += n;
+        }
+
+        u64_t tsent = get_time_ms();
+
+        while ((global->tcp_received < sent) && (get_time_ms() - tsent < TCP_TIMEOUT_MS)) {
+                msleep(1);
+        }
+
+        u64_t trecv = get_time_ms();
+
+        ifstatus(NET_FAMILY__INET, &stat[1]);
+
+        print_throughput("send", sent, tsent - tstart);
+        print_throughput("receive", global->tcp_received, trecv - tstart);
+
+        printf("TX packets: %u, RX packets: %u\n",
+               (uint)(stat[1].tx_packets - stat[0].tx_packets),
+               (uint)(stat[1].rx_packets - stat[0].rx_packets));
+
+        if ((sent == size) && (global->tcp_received == size)) {
+                status = EXIT_SUCCESS;
+        }
+
+        finish:
+        global->tcp_stop = true;
+
+        if (client) {
+                socket_close(client);
+        }
+
+        if (tid) {
+                thread_join(tid);
+        }
+
+        if (server) {
+                socket_close(server);
+        }
+
+        free(buf);
+
+        return status;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -0,0 +1,524 @@
+/*==============================================================================
+File    libperf.c
+
+Author  Daniel Zorychta
+
+Brief   Library containers performance measurement program
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <dnx/os.h>
+#include <dnx/misc.h>
+#include <btree.h>
+#include <llist.h>
+#include <checksum.h>
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define BTREE_KEYS              1000
+#define LLIST_ELEMENTS          10000
+#define CHECKSUM_KiB            256
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        const char *name;
+        int (*func)(int argc, char *argv[]);
+        const char *usage;
+} test_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+static int test_btree(int argc, char *argv[]);
+static int test_llist(int argc, char *argv[]);
+static int test_checksum(int argc, char *argv[]);
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static const test_t TEST[] = {
+        {.name = "btree", .func = test_btree, .usage = "[keys]"},
+        {.name = "llist", .func = test_llist, .usage = "[elements]"},
+        {.name = "checksum", .func = test_checksum, .usage = "[KiB]"},
+};
+
+GLOBAL_VARIABLES_SECTION {
+};
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+PROGRAM_PARAMS(libperf, STACK_DEPTH_LOW);
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * Main program function.
+ *
+ * @param argc      argument count
+ * @param argv      arguments
+ */
+//==============================================================================
+int main(int argc, char *argv[])
+{
+        if (argc >= 2) {
+                for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                        if (strcmp(argv[1], TEST[i].name) == 0) {
+                                return TEST[i].func(argc - 1, &argv[1]);
+                        }
+                }
+        }
+
+        printf("Usage: %s <test> [args]\n", argv[0]);
+        for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                printf("  %s %s\n", TEST[i].name, TEST[i].usage);
+        }
+
+        return EXIT_FAILURE;
+}
+
+//==============================================================================
+/**
+ * @brief  Print operation latency result.
+ *
+ * @param  label        result label
+ * @param  ops          number of operations
+ * @param  ms           total time
+ */
+//==============================================================================
+static void print_latency(const char *label, size_t ops, u64_t ms)
+{
+        u32_t ns = (ops > 0) ? (u32_t)(ms * 1000000 / ops) : 0;
+
+        printf("%-24s %8u op  %6u ms  %8u ns/op\n",
+               label, (uint)ops, (uint)ms, (uint)ns);
+}
+
+//==============================================================================
+/**
+ * @brief  Print checksum throughput result.
+ *
+ * @param  label        result label
+ * @param  bytes        number of processed bytes
+ * @param  ms           processing time
+ * @param  ref_ms       processing time of reference implementation
+ */
+//==============================================================================
+static void print_throughput(const char *label, size_t bytes, u64_t ms, u64_t ref_ms)
+{
+        u32_t kibps = (ms > 0) ? (u32_t)((u64_t)bytes * 1000 / 1024 / ms) : 0;
+        u32_t gain  = (ms > 0) ? (u32_t)(ref_ms * 100 / ms) : 0;
+
+        printf("%-24s %8u B  %6u ms  %8u KiB/s  %3u.%02ux\n",
+               label, (uint)bytes, (uint)ms, (uint)kibps,
+               (uint)(gain / 100), (uint)(gain % 100));
+}
+
+//==============================================================================
+/**
+ * @brief  Compare two integer keys (BTree functor).
+ *
+ * @param  a            key a
+ * @param  b            key b
+ *
+ * @return Comparison result.
+ */
+//==============================================================================
+static int compare_key(const void *a, const void *b)
+{
+        u32_t x = *(const u32_t*)a;
+        u32_t y = *(const u32_t*)b;
+
+        return (x > y) - (x < y);
+}
+
+//==============================================================================
+/**
+ * @brief  Function return key of selected order.
+ *
+ * @param  n            key number
+ * @param  keys         number of keys
+ * @param  sorted       sorted or pseudo-random order
+ *
+ * @return Key value.
+ */
+//==============================================================================
+static u32_t key_at(size_t n, size_t keys, bool sorted)
+{
+        // 7919 is prime, thus the sequence is a permutation of 0..keys-1
+        return sorted ? n : (u32_t)(((u64_t)n * 7919) % keys);
+}
+
+//==============================================================================
+/**
+ * @brief  BTree insert, search and remove of sorted and random keys. Sorted
+ *         keys (timestamps, PIDs, block numbers) must not degrade the tree.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_btree(int argc, char *argv[])
+{
+        size_t keys = (argc >= 2) ? (size_t)atoi(argv[1]) : BTREE_KEYS;
+
+        if ((keys == 0) || ((keys % 7919) == 0)) {
+                printf("Invalid number of keys\n");
+                return EXIT_FAILURE;
+        }
+
+        for (int sorted = 1; sorted >= 0; sorted--) {
+
+                btree_t *tree = btree_new(sizeof(u32_t), compare_key, NULL);
+                if (!tree) {
+                        perror(NULL);
+                        return EXIT_FAILURE;
+                }
+
+                const char *order = sorted ? "sorted" : "random";
+                char        label[32];
+                int         err   = 0;
+
+                u64_t tstart = get_time_ms();
+                for (size_t n = 0; (n < keys) && !err; n++) {
+                        u32_t key = key_at(n, keys, sorted);
+                        err = btree_insert(tree, &key);
+                }
+
+                snprintf(label, sizeof(label), "%s insert", order);
+                print_latency(label, keys, get_time_ms() - tstart);
+
+                tstart = get_time_ms();
+                for (size_t n = 0; (n < keys) && !err; n++) {
+                        u32_t key = key_at(n, keys, sorted);
+                        err = btree_search(tree, &key, &key);
+                }
+
+                snprintf(label, sizeof(label), "%s search", order);
+                print_latency(label, keys, get_time_ms() - tstart);
+
+                tstart = get_time_ms();
+                for (size_t n = 0; (n < keys) && !err; n++) {
+                        u32_t key = key_at(n, keys, sorted);
+                        err = btree_remove(tree, &key);
+                }
+
+                snprintf(label, sizeof(label), "%s remove", order);
+                print_latency(label, keys, get_time_ms() - tstart);
+
+                btree_delete(tree);
+
+                if (err) {
+                        printf("BTree error: %s\n", strerror(err));
+                        return EXIT_FAILURE;
+                }
+        }
+
+        return EXIT_SUCCESS;
+}
+
+//==============================================================================
+/**
+ * @brief  List sort, indexed and iterator scan of selected list size. Small
+ *         lists are repeated to reach LLIST_ELEMENTS elements in total.
+ *
+ * @param  elements     number of elements in the list
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int llist_run(size_t elements)
+{
+        size_t    rounds = max(1, LLIST_ELEMENTS / elements);
+        llist_t **list   = calloc(rounds, sizeof(llist_t*));
+        int       status = EXIT_FAILURE;
+        char      label[32];
+
+        if (!list) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        for (size_t r = 0; r < rounds; r++) {
+                list[r] = llist_new(compare_key, NULL);
+                if (!list[r]) {
+                        printf("Not enough memory\n");
+                        goto finish;
+                }
+
+                for (size_t n = 0; n < elements; n++) {
+                        u32_t key = key_at(n, elements, false);
+                        if (!llist_push_emplace_back(list[r], sizeof(key), &key)) {
+                                printf("Not enough memory\n");
+                                goto finish;
+                        }
+                }
+        }
+
+        size_t ops = rounds * elements;
+
+        u64_t tstart = get_time_ms();
+        for (size_t r = 0; r < rounds; r++) {
+                llist_sort(list[r]);
+        }
+
+        snprintf(label, sizeof(label), "%u sort", (uint)elements);
+        print_latency(label, ops, get_time_ms() - tstart);
+
+        u32_t prev = 0;
+        tstart = get_time_ms();
+        for (size_t r = 0; r < rounds; r++) {
+                for (int i = 0; i < llist_size(list[r]); i++) {
+                        u32_t key = *(u32_t*)llist_at(list[r], i);
+                        if ((i > 0) && (key < prev)) {
+                                printf("List is not sorted\n");
+                                goto finish;
+                        }
+                        prev = key;
+                }
+        }
+
+        snprintf(label, sizeof(label), "%u indexed scan", (uint)elements);
+        print_latency(label, ops, get_time_ms() - tstart);
+
+        size_t count = 0;
+        tstart = get_time_ms();
+        for (size_t r = 0; r < rounds; r++) {
+                llist_foreach(u32_t*, key, list[r]) {
+                        count += (*key < elements);
+                }
+        }
+
+        snprintf(label, sizeof(label), "%u iterator scan", (uint)elements);
+        print_latency(label, count, get_time_ms() - tstart);
+
+        status = EXIT_SUCCESS;
+
+        finish:
+        for (size_t r = 0; r < rounds; r++) {
+                if (list[r]) {
+                        llist_delete(list[r]);
+                }
+        }
+
+        free(list);
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  List sort and scan at 10, 1k and 10k elements. Indexed access in
+ *         ascending order must be linear thanks to cached list position.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_llist(int argc, char *argv[])
+{
+        static const size_t SIZE[] = {10, 1000, 10000};
+
+        if (argc >= 2) {
+                size_t elements = (size_t)atoi(argv[1]);
+
+                if ((elements == 0) || ((elements % 7919) == 0)) {
+                        printf("Invalid number of elements\n");
+                        return EXIT_FAILURE;
+                }
+
+                return llist_run(elements);
+        }
+
+        for (size_t i = 0; i < ARRAY_SIZE(SIZE); i++) {
+                if (llist_run(SIZE[i]) != EXIT_SUCCESS) {
+                        return EXIT_FAILURE;
+                }
+        }
+
+        return EXIT_SUCCESS;
+}
+
+//==============================================================================
+/**
+ * @brief  Byte-wise Fletcher-16 used by SIPC and EEFS before the checksum
+ *         library (reference implementation).
+ *
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ *
+ * @return Checksum.
+ */
+//==============================================================================
+static u16_t fletcher16_ref(const u8_t *data, size_t bytes)
+{
+        u16_t sum1 = 0xff, sum2 = 0xff;
+
+        while (bytes) {
+                size_t tlen = ((bytes >= 20) ? 20 : bytes);
+                bytes -= tlen;
+                do {
+                        sum2 += sum1 += *data++;
+                        tlen--;
+                } while (tlen);
+
+                sum1 = (sum1 & 0xff) + (sum1 >> 8);
+                sum2 = (sum2 & 0xff) + (sum2 >> 8);
+        }
+
+        sum1 = (sum1 & 0xff) + (sum1 >> 8);
+        sum2 = (sum2 & 0xff) + (sum2 >> 8);
+
+        return (sum2 << 8) | sum1;
+}
+
+//==============================================================================
+/**
+ * @brief  Checksum throughput at EEFS block (128 B), SIPC packet (1 KiB) and
+ *         4 KiB buffers, aligned and unaligned. Library Fletcher-16 result
+ *         must be bit-exact with the byte-wise reference implementation.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_checksum(int argc, char *argv[])
+{
+        static const size_t SIZE[]   = {128, 1024, 4096};
+        static const size_t OFFSET[] = {0, 1};
+
+        size_t total = ((argc >= 2) ? (size_t)atoi(argv[1]) : CHECKSUM_KiB) * 1024;
+
+        if (total < SIZE[ARRAY_SIZE(SIZE) - 1]) {
+                printf("Invalid data size\n");
+                return EXIT_FAILURE;
+        }
+
+        if (  (crc32c(0, "123456789", 9) != 0xE3069283)
+           || (fletcher32("abcde", 5) != 0xF04FC729) ) {
+                printf("Check value mismatch\n");
+                return EXIT_FAILURE;
+        }
+
+        u8_t *buf = malloc(SIZE[ARRAY_SIZE(SIZE) - 1] + sizeof(u32_t));
+        if (!buf) {
+                perror(NULL);
+                return EXIT_FAILURE;
+        }
+
+        u32_t seed = 0x12345678;
+        for (size_t i = 0; i < SIZE[ARRAY_SIZE(SIZE) - 1] + sizeof(u32_t); i++) {
+                seed   = seed * 1103515245 + 12345;
+                buf[i] = seed >> 16;
+        }
+
+        int status = EXIT_SUCCESS;
+
+        for (size_t s = 0; s < ARRAY_SIZE(SIZE); s++) {
+                for (size_t o = 0; o < ARRAY_SIZE(OFFSET); o++) {
+
+                        const u8_t    *data   = buf + OFFSET[o];
+                        size_t         size   = SIZE[s];
+                        size_t         rounds = total / size;
+                        size_t         bytes  = rounds * size;
+                        volatile u32_t acc    = 0;
+                        char           label[32];
+
+                        for (size_t n = 0; n <= size; n += 7) {
+                                if (fletcher16(data, n) != fletcher16_ref(data, n)) {
+                                        printf("Fletcher-16 mismatch at %u B\n", (uint)n);
+                                        status = EXIT_FAILURE;
+                                        goto finish;
+                                }
+                        }
+
+                        u64_t tstart = get_time_ms();
+                        for (size_t r = 0; r < rounds; r++) {
+                                acc += fletcher16_ref(data, size);
+                        }
+                        u64_t ref_ms = get_time_ms() - tstart;
+
+                        snprintf(label, sizeof(label), "%u%s fletcher16 ref",
+                                 (uint)size, OFFSET[o] ? "u" : "");
+                        print_throughput(label, bytes, ref_ms, ref_ms);
+
+                        tstart = get_time_ms();
+                        for (size_t r = 0; r < rounds; r++) {
+                                acc += fletcher16(data, size);
+                        }
+
+                        snprintf(label, sizeof(label), "%u%s fletcher16",
+                                 (uint)size, OFFSET[o] ? "u" : "");
+                        print_throughput(label, bytes, get_time_ms() - tstart, ref_ms);
+
+                        tstart = get_time_ms();
+                        for (size_t r = 0; r < rounds; r++) {
+                                acc += fletcher32(data, size);
+                        }
+
+                        snprintf(label, sizeof(label), "%u%s fletcher32",
+                                 (uint)size, OFFSET[o] ? "u" : "");
+                        print_throughput(label, bytes, get_time_ms() - tstart, ref_ms);
+
+                        tstart = get_time_ms();
+                        for (size_t r = 0; r < rounds; r++) {
+                                acc += crc32c(0, data, size);
+                        }
+
+                        snprintf(label, sizeof(label), "%u%s crc32c",
+                                 (uint)size, OFFSET[o] ? "u" : "");
+                        print_throughput(label, bytes, get_time_ms() - tstart, ref_ms);
+                }
+        }
+
+        finish:
+        free(buf);
+
+        return status;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
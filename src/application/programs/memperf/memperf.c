@@ -0,0 +1,455 @@
+/*==============================================================================
+File    memperf.c
+
+Author  Daniel Zorychta
+
+Brief   Memory allocation performance measurement program
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <dnx/os.h>
+#include <dnx/misc.h>
+#include <dnx/thread.h>
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define CYCLES                  10000
+#define TRACE_SLOTS             64
+#define TRACE_BATCH             256
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        const char *name;
+        int (*func)(int argc, char *argv[]);
+        const char *usage;
+} test_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+static int test_small(int argc, char *argv[]);
+static int test_large(int argc, char *argv[]);
+static int test_res(int argc, char *argv[]);
+static int test_heap(int argc, char *argv[]);
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static const test_t TEST[] = {
+        {.name = "small", .func = test_small, .usage = "[cycles]"},
+        {.name = "large", .func = test_large, .usage = "[cycles]"},
+        {.name = "res",   .func = test_res,   .usage = "[cycles]"},
+        {.name = "heap",  .func = test_heap,  .usage = "[operations]"},
+};
+
+static const size_t LIVE_SET[] = {0, 16, 128, 1024};
+static const size_t LIVE_RES[] = {16, 256, 1024, 4096};
+
+GLOBAL_VARIABLES_SECTION {
+};
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+PROGRAM_PARAMS(memperf, STACK_DEPTH_LOW);
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * Main program function.
+ *
+ * @param argc      argument count
+ * @param argv      arguments
+ */
+//==============================================================================
+int main(int argc, char *argv[])
+{
+        if (argc >= 2) {
+                for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                        if (strcmp(argv[1], TEST[i].name) == 0) {
+                                return TEST[i].func(argc - 1, &argv[1]);
+                        }
+                }
+        }
+
+        printf("Usage: %s <test> [args]\n", argv[0]);
+        for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                printf("  %s %s\n", TEST[i].name, TEST[i].usage);
+        }
+
+        return EXIT_FAILURE;
+}
+
+//==============================================================================
+/**
+ * @brief  Print operation latency result and process memory usage.
+ *
+ * @param  label        result label
+ * @param  ops          number of operations
+ * @param  ms           total time
+ */
+//==============================================================================
+static void print_latency(const char *label, size_t ops, u64_t ms)
+{
+        u32_t ns = (ops > 0) ? (u32_t)(ms * 1000000 / ops) : 0;
+
+        process_stat_t stat;
+        memset(&stat, 0, sizeof(stat));
+        process_stat(getpid(), &stat);
+
+        printf("%-20s %8u op  %6u ms  %8u ns/op  %6u B  %4u blk\n",
+               label, (uint)ops, (uint)ms, (uint)ns,
+               (uint)stat.memory_usage, (uint)stat.memory_block_count);
+}
+
+//==============================================================================
+/**
+ * @brief  Allocate and free blocks of random size while selected number of
+ *         blocks is kept allocated.
+ *
+ * @param  cycles       number of malloc/free pairs
+ * @param  min_size     minimal block size
+ * @param  max_size     maximal block size
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int alloc_free(size_t cycles, size_t min_size, size_t max_size)
+{
+        int status = EXIT_SUCCESS;
+
+        for (size_t i = 0; i < ARRAY_SIZE(LIVE_SET) && status == EXIT_SUCCESS; i++) {
+
+                size_t live_cnt = LIVE_SET[i];
+                void **live     = calloc(max(live_cnt, 1), sizeof(void*));
+                if (!live) {
+                        perror(NULL);
+                        return EXIT_FAILURE;
+                }
+
+                for (size_t n = 0; n < live_cnt; n++) {
+                        live[n] = malloc(min_size + (rand() % (max_size - min_size + 1)));
+                        if (!live[n]) {
+                                perror(NULL);
+                                status = EXIT_FAILURE;
+                                break;
+                        }
+                }
+
+                char label[32];
+                snprintf(label, sizeof(label), "live %u", (uint)live_cnt);
+
+                u64_t tstart = get_time_ms();
+
+                for (size_t n = 0; n < cycles && status == EXIT_SUCCESS; n++) {
+                        size_t size = min_size + (rand() % (max_size - min_size + 1));
+
+                        void *mem = malloc(size);
+                        if (!mem) {
+                                perror(NULL);
+                                status = EXIT_FAILURE;
+                                break;
+                        }
+
+                        if (live_cnt > 0) {
+                                // replace random live block to fragment free lists
+                                size_t idx = rand() % live_cnt;
+                                free(live[idx]);
+                                live[idx] = mem;
+                        } else {
+                                free(mem);
+                        }
+                }
+
+                if (status == EXIT_SUCCESS) {
+                        print_latency(label, cycles, get_time_ms() - tstart);
+                }
+
+                for (size_t n = 0; n < live_cnt; n++) {
+                        free(live[n]);
+                }
+
+                free(live);
+        }
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Small block (8-128 bytes) allocation cost. Blocks are served by
+ *         the program arena without system calls.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_small(int argc, char *argv[])
+{
+        size_t cycles = (argc >= 2) ? (size_t)atoi(argv[1]) : CYCLES;
+
+        return alloc_free(cycles, 8, 128);
+}
+
+//==============================================================================
+/**
+ * @brief  Large block (256-1024 bytes) allocation cost. Blocks are allocated
+ *         by the kernel, test is a reference for small block results.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_large(int argc, char *argv[])
+{
+        size_t cycles = (argc >= 2) ? (size_t)atoi(argv[1]) : CYCLES;
+
+        return alloc_free(cycles, 256, 1024);
+}
+
+//==============================================================================
+/**
+ * @brief  Resource register/release cost with thousands of live resources.
+ *         The oldest resource is released in each cycle, which is the worst
+ *         case for the list search. Time per cycle should not depend on the
+ *         number of live resources. Test stops at the live set that does not
+ *         fit in memory.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_res(int argc, char *argv[])
+{
+        size_t cycles = (argc >= 2) ? (size_t)atoi(argv[1]) : CYCLES;
+        int    status = EXIT_SUCCESS;
+        bool   fits   = true;
+
+        for (size_t i = 0; i < ARRAY_SIZE(LIVE_RES) && fits && status == EXIT_SUCCESS; i++) {
+
+                size_t    live_cnt = LIVE_RES[i];
+                size_t    created  = 0;
+                mutex_t **live     = calloc(live_cnt, sizeof(mutex_t*));
+                if (!live) {
+                        printf("live %u: not enough free memory\n", (uint)live_cnt);
+                        break;
+                }
+
+                for (; created < live_cnt; created++) {
+                        live[created] = mutex_new(MUTEX_TYPE_NORMAL);
+                        if (!live[created]) {
+                                break;
+                        }
+                }
+
+                if (created < live_cnt) {
+                        printf("live %u: not enough free memory\n", (uint)live_cnt);
+                        fits = false;
+
+                } else {
+                        char label[32];
+                        snprintf(label, sizeof(label), "live %u", (uint)live_cnt);
+
+                        u64_t tstart = get_time_ms();
+
+                        for (size_t n = 0; n < cycles; n++) {
+                                size_t idx = n % live_cnt;
+
+                                mutex_delete(live[idx]);
+                                live[idx] = mutex_new(MUTEX_TYPE_NORMAL);
+                                if (!live[idx]) {
+                                        perror(NULL);
+                                        status = EXIT_FAILURE;
+                                        break;
+                                }
+                        }
+
+                        if (status == EXIT_SUCCESS) {
+                                print_latency(label, cycles, get_time_ms() - tstart);
+                        }
+                }
+
+                for (size_t n = 0; n < live_cnt; n++) {
+                        if (live[n]) {
+                                mutex_delete(live[n]);
+                        }
+                }
+
+                free(live);
+        }
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Function compare two latency values (qsort() callback).
+ *
+ * @param  a            value a
+ * @param  b            value b
+ *
+ * @return Comparison result.
+ */
+//==============================================================================
+static int compare_u32(const void *a, const void *b)
+{
+        u32_t x = *(const u32_t*)a;
+        u32_t y = *(const u32_t*)b;
+
+        return (x > y) - (x < y);
+}
+
+//==============================================================================
+/**
+ * @brief  Function find the largest block that can be allocated.
+ *
+ * @param  limit        search limit
+ *
+ * @return Size of the largest block.
+ */
+//==============================================================================
+static size_t largest_block(size_t limit)
+{
+        size_t lo = 0;
+        size_t hi = limit;
+
+        while (lo < hi) {
+                size_t mid = lo + (hi - lo + 1) / 2;
+
+                void *mem = malloc(mid);
+                if (mem) {
+                        free(mem);
+                        lo = mid;
+                } else {
+                        hi = mid - 1;
+                }
+        }
+
+        return lo;
+}
+
+//==============================================================================
+/**
+ * @brief  Kernel heap allocation latency and fragmentation. Deterministic
+ *         trace of random malloc/free operations (197-1024 bytes, blocks
+ *         bypass the program arena) is replayed. System clock resolution is
+ *         1 ms, so single operation can not be timed: time is measured per
+ *         batch of operations and p50/p99 of batch average time is reported
+ *         (it is not per-operation percentile). Fragmentation
+ *         is the part of free memory that can not be allocated as single
+ *         block at the end of the trace.
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_heap(int argc, char *argv[])
+{
+        size_t ops     = (argc >= 2) ? (size_t)atoi(argv[1]) : (CYCLES * 10);
+        size_t batches = max(ops / TRACE_BATCH, 1);
+        int    status  = EXIT_SUCCESS;
+
+        u32_t *lat  = calloc(batches, sizeof(u32_t));
+        void **slot = calloc(TRACE_SLOTS, sizeof(void*));
+
+        if (!lat || !slot) {
+                perror(NULL);
+                status = EXIT_FAILURE;
+                goto finish;
+        }
+
+        srand(1);
+
+        for (size_t b = 0; b < batches; b++) {
+
+                u64_t tstart = get_time_ms();
+
+                for (size_t n = 0; n < TRACE_BATCH; n++) {
+                        size_t idx = rand() % TRACE_SLOTS;
+
+                        if (slot[idx]) {
+                                free(slot[idx]);
+                                slot[idx] = NULL;
+                        } else {
+                                slot[idx] = malloc(197 + (rand() % (1024 - 197 + 1)));
+                        }
+                }
+
+                lat[b] = (u32_t)((get_time_ms() - tstart) * 1000000 / TRACE_BATCH);
+        }
+
+        qsort(lat, batches, sizeof(u32_t), compare_u32);
+
+        size_t free_mem = get_free_memory();
+        size_t largest  = largest_block(free_mem);
+        u32_t  frag     = (free_mem > 0) ? (u32_t)(100 - ((u64_t)largest * 100 / free_mem)) : 0;
+
+        printf("%-20s %8u op  %u-op batch avg: p50 %6u ns/op  p99 %6u ns/op\n",
+               "trace", (uint)(batches * TRACE_BATCH), (uint)TRACE_BATCH,
+               (uint)lat[batches / 2], (uint)lat[(batches * 99) / 100]);
+
+        printf("%-20s %8u B free  %8u B largest  %3u%% fragmentation\n",
+               "heap", (uint)free_mem, (uint)largest, (uint)frag);
+
+        finish:
+        if (slot) {
+                for (size_t n = 0; n < TRACE_SLOTS; n++) {
+                        free(slot[n]);
+                }
+
+                free(slot);
+        }
+
+        free(lat);
+
+        return status;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
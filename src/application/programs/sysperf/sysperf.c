@@ -0,0 +1,313 @@
+/*==============================================================================
+File    sysperf.c
+
+Author  Daniel Zorychta
+
+Brief   System call performance measurement program
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dnx/os.h>
+#include <dnx/misc.h>
+#include <dnx/thread.h>
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define ROUND_TRIPS             100000
+#define PRINTK_WRITERS          4
+#define PRINTK_MAX_WRITERS      8
+#define PRINTK_MESSAGES         1000
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        const char *name;
+        int (*func)(int argc, char *argv[]);
+        const char *usage;
+} test_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+static int test_syscall(int argc, char *argv[]);
+static int test_printk(int argc, char *argv[]);
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static const test_t TEST[] = {
+        {.name = "syscall", .func = test_syscall, .usage = "[round-trips] [file-path]"},
+        {.name = "printk",  .func = test_printk,  .usage = "[writers] [messages]"},
+};
+
+GLOBAL_VARIABLES_SECTION {
+        volatile bool start;
+        size_t messages;
+};
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+PROGRAM_PARAMS(sysperf, STACK_DEPTH_LOW);
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * Main program function.
+ *
+ * @param argc      argument count
+ * @param argv      arguments
+ */
+//==============================================================================
+int main(int argc, char *argv[])
+{
+        if (argc >= 2) {
+                for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                        if (strcmp(argv[1], TEST[i].name) == 0) {
+                                return TEST[i].func(argc - 1, &argv[1]);
+                        }
+                }
+        }
+
+        printf("Usage: %s <test> [args]\n", argv[0]);
+        for (size_t i = 0; i < ARRAY_SIZE(TEST); i++) {
+                printf("  %s %s\n", TEST[i].name, TEST[i].usage);
+        }
+
+        return EXIT_FAILURE;
+}
+
+//==============================================================================
+/**
+ * @brief  Print stage latency and cost added to the stage below.
+ *
+ * @param  label        stage label
+ * @param  ops          number of operations
+ * @param  ms           total time
+ * @param  prev_ns      latency of the stage below
+ *
+ * @return Stage latency in nanoseconds.
+ */
+//==============================================================================
+static u32_t print_stage(const char *label, size_t ops, u64_t ms, u32_t prev_ns)
+{
+        u32_t ns    = (ops > 0) ? (u32_t)(ms * 1000000 / ops) : 0;
+        u32_t delta = (ns > prev_ns) ? (ns - prev_ns) : 0;
+
+        printf("%-24s %8u op  %6u ms  %8u ns/op  +%u ns\n",
+               label, (uint)ops, (uint)ms, (uint)ns, (uint)delta);
+
+        return ns;
+}
+
+//==============================================================================
+/**
+ * @brief  System call round-trip split into stages. Each stage reports the
+ *         cost added to the stage below it:
+ *         - loop: measurement overhead,
+ *         - mutex: direct kernel call with object validation (over loop),
+ *         - getpid: syscall entry, client lookup, and exit (over loop),
+ *         - fstat: file validation and file system call (over getpid).
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_syscall(int argc, char *argv[])
+{
+        size_t ops    = (argc >= 2) ? (size_t)atoi(argv[1]) : ROUND_TRIPS;
+        FILE  *file   = (argc >= 3) ? fopen(argv[2], "r") : stdout;
+        int    status = EXIT_FAILURE;
+
+        if (!file) {
+                perror(argv[2]);
+                return EXIT_FAILURE;
+        }
+
+        mutex_t *mtx = mutex_new(MUTEX_TYPE_NORMAL);
+        if (!mtx) {
+                perror(NULL);
+                goto finish;
+        }
+
+        volatile size_t count = 0;
+        u64_t tstart = get_time_ms();
+        for (size_t n = 0; n < ops; n++) {
+                count++;
+        }
+        u32_t loop_ns = print_stage("loop", count, get_time_ms() - tstart, 0);
+
+        tstart = get_time_ms();
+        for (size_t n = 0; n < ops; n++) {
+                mutex_lock(mtx, MAX_DELAY_MS);
+                mutex_unlock(mtx);
+        }
+        print_stage("mutex lock/unlock", ops, get_time_ms() - tstart, loop_ns);
+
+        tstart = get_time_ms();
+        for (size_t n = 0; n < ops; n++) {
+                count += getpid();
+        }
+        u32_t getpid_ns = print_stage("getpid", ops, get_time_ms() - tstart, loop_ns);
+
+        struct stat buf;
+        tstart = get_time_ms();
+        for (size_t n = 0; n < ops; n++) {
+                if (fstat(file, &buf) != 0) {
+                        perror("fstat");
+                        goto finish;
+                }
+        }
+        print_stage("fstat", ops, get_time_ms() - tstart, getpid_ns);
+
+        status = EXIT_SUCCESS;
+
+        finish:
+        if (mtx) {
+                mutex_delete(mtx);
+        }
+
+        if (file != stdout) {
+                fclose(file);
+        }
+
+        return status;
+}
+
+//==============================================================================
+/**
+ * @brief  Kernel log writer thread.
+ *
+ * @param  arg          writer number
+ */
+//==============================================================================
+static void printk_writer(void *arg)
+{
+        int id = (int)(uintptr_t)arg;
+
+        while (!global->start) {
+                msleep(1);
+        }
+
+        for (size_t n = 0; n < global->messages; n++) {
+                _builtinfunc(printk, "sysperf: writer %d message %u (%s)", id, (uint)n, "load");
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Kernel log write latency with single writer and with concurrent
+ *         writers, and read time of entire log (syslog_read() cursor).
+ *
+ * @param  argc         argument count
+ * @param  argv         arguments
+ *
+ * @return Program exit status.
+ */
+//==============================================================================
+static int test_printk(int argc, char *argv[])
+{
+        static const thread_attr_t THREAD_ATTR = {
+                .stack_depth = STACK_DEPTH_LOW,
+                .priority    = PRIORITY_NORMAL,
+                .detached    = false
+        };
+
+        size_t writers = (argc >= 2) ? (size_t)atoi(argv[1]) : PRINTK_WRITERS;
+        global->messages = (argc >= 3) ? (size_t)atoi(argv[2]) : PRINTK_MESSAGES;
+
+        writers = max(1, min(writers, PRINTK_MAX_WRITERS));
+
+        char  label[32];
+        tid_t tid[PRINTK_MAX_WRITERS];
+        int   status = EXIT_SUCCESS;
+
+        // single writer
+        u64_t tstart = get_time_ms();
+        for (size_t n = 0; n < global->messages; n++) {
+                _builtinfunc(printk, "sysperf: writer %d message %u (%s)", 0, (uint)n, "load");
+        }
+        u32_t single_ns = print_stage("printk 1 writer", global->messages,
+                                      get_time_ms() - tstart, 0);
+
+        // concurrent writers
+        global->start = false;
+
+        size_t created = 0;
+        for (; created < writers; created++) {
+                tid[created] = thread_create(printk_writer, &THREAD_ATTR,
+                                             (void*)(uintptr_t)(created + 1));
+                if (!tid[created]) {
+                        perror(NULL);
+                        status = EXIT_FAILURE;
+                        break;
+                }
+        }
+
+        tstart = get_time_ms();
+        global->start = true;
+
+        for (size_t i = 0; i < created; i++) {
+                thread_join(tid[i]);
+        }
+
+        snprintf(label, sizeof(label), "printk %u writers", (uint)created);
+        print_stage(label, created * global->messages, get_time_ms() - tstart, single_ns);
+
+        // read entire log
+        char           str[128];
+        struct timeval t;
+        u32_t          seq   = 0;
+        size_t         count = 0;
+
+        tstart = get_time_ms();
+        while (syslog_read(str, sizeof(str), &seq, &t)) {
+                count++;
+        }
+        print_stage("syslog_read", count, get_time_ms() - tstart, 0);
+
+        return status;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <poll.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <dnx/net.h>
@@ -48,7 +49,7 @@
 #define PIPE_NAME_LEN                   24
 #define TELNET_CFG_BYTE                 0xFF
 #define PROGRAM_NAME                    "dsh"
-#define RECEIVE_TIMOUT                  100
+#define PROCESS_CHECK_PERIOD            500
 #define SEND_TIMEOUT                    3000
 #define TELNET_PORT                     23
 
@@ -197,35 +198,43 @@ static void telnet_thread(void *arg)
         if (proc == 0)
                 goto exit;
 
-        socket_set_recv_timeout(sock, RECEIVE_TIMOUT);
         socket_set_send_timeout(sock, SEND_TIMEOUT);
+        ioctl(fileno(fout), IOCTL_VFS__NON_BLOCKING_RD_MODE);
+
+        struct pollfd fds[2] = {
+                {.fd = sock, .events = POLLIN},
+                {.fd = fout, .events = POLLIN}
+        };
 
         // handle telnet connection
         while (true) {
-                // receive input packet from telnet client
-                errno = 0;
-                int len = socket_read(sock, buf, BUF_SIZE);
-
-                if ((len == -1) && (errno != ETIME)) {
+                // wait for client data or program output, timeout is used
+                // only to check if program is finished
+                if (poll(fds, 2, PROCESS_CHECK_PERIOD) < 0) {
                         break;
                 }
 
                 // write incoming data to running program
-                if (len > 0 && buf[0] != TELNET_CFG_BYTE) {
-                        replace_CRLF_by_LF(buf, len);
-                        len = strnlen(buf, len);
-                        fwrite(buf, 1, len, fin);
+                if (fds[0].revents) {
+                        int len = socket_read(sock, buf, BUF_SIZE);
+                        if (len <= 0) {
+                                break;
+                        }
 
+                        if (buf[0] != TELNET_CFG_BYTE) {
+                                replace_CRLF_by_LF(buf, len);
+                                len = strnlen(buf, len);
+                                fwrite(buf, 1, len, fin);
+                        }
                 }
 
                 // send data from running program
-                do {
-                        ioctl(fileno(fout), IOCTL_VFS__NON_BLOCKING_RD_MODE);
-                        len = fread(buf, 1, BUF_SIZE, fout);
+                if (fds[1].revents & POLLIN) {
+                        int len = fread(buf, 1, BUF_SIZE, fout);
                         if (len > 0) {
-                                len = socket_write(sock, buf, len);
+                                socket_write(sock, buf, len);
                         }
-                } while (len > 0);
+                }
 
                 // check if program is finished
                 if (process_wait(proc, NULL, 0) == 0) {
@@ -458,6 +458,108 @@ int _driver_read(dev_t id, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function write multiple buffers to driver. Driver is found once for
+ *        entire vector. Writing is stopped at first short write.
+ *
+ * @param id            module id
+ * @param iov           data sources
+ * @param iovcnt        number of buffers
+ * @param fpos          file position
+ * @param wrcnt         number of written bytes
+ * @param fattr         file attributes
+ *
+ * @return One of errno value (errno.h). Error is not reported if part of data
+ *         was written.
+ */
+//==============================================================================
+int _driver_writev(dev_t id, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr fattr)
+{
+        u16_t modno;
+        void *mem;
+
+        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        if (!err) {
+                for (int i = 0; !err && (i < iovcnt); i++) {
+                        fpos_t pos = *fpos + *wrcnt;
+                        size_t n   = 0;
+
+                        if (iov[i].iov_len == 0) {
+                                continue;
+                        }
+
+                        err = _drvreg_module_table[modno].IF.drv_write(mem, iov[i].iov_base,
+                                                                       iov[i].iov_len, &pos,
+                                                                       &n, fattr);
+                        if (!err) {
+                                *wrcnt += n;
+
+                                if (n < iov[i].iov_len) {
+                                        break;
+                                }
+                        }
+                }
+
+                if (*wrcnt > 0) {
+                        err = ESUCC;
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function read driver to multiple buffers. Driver is found once for
+ *        entire vector. Reading is stopped at first short read.
+ *
+ * @param id            module id
+ * @param iov           data destinations
+ * @param iovcnt        number of buffers
+ * @param fpos          file position
+ * @param rdcnt         number of read bytes
+ * @param fattr         file attributes
+ *
+ * @return One of errno value (errno.h). Error is not reported if part of data
+ *         was read.
+ */
+//==============================================================================
+int _driver_readv(dev_t id, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr fattr)
+{
+        u16_t modno;
+        void *mem;
+
+        int err = driver__get_module_no_and_mem(id, &modno, &mem);
+        if (!err) {
+                for (int i = 0; !err && (i < iovcnt); i++) {
+                        fpos_t pos = *fpos + *rdcnt;
+                        size_t n   = 0;
+
+                        if (iov[i].iov_len == 0) {
+                                continue;
+                        }
+
+                        err = _drvreg_module_table[modno].IF.drv_read(mem, iov[i].iov_base,
+                                                                      iov[i].iov_len, &pos,
+                                                                      &n, fattr);
+                        if (!err) {
+                                *rdcnt += n;
+
+                                if (n < iov[i].iov_len) {
+                                        break;
+                                }
+                        }
+                }
+
+                if (*rdcnt > 0) {
+                        err = ESUCC;
+                }
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief IO control
@@ -174,6 +174,28 @@ allocated and added to the buffer. The single chain will contain only small part
 of data. One should keep in mind that total_size field in first chain should be
 updated when new chain link is added, this field in other chain links is
 ignored by driver.
+
+\subsubsection drv-ETH-ddesc-pktsg Scatter-gather packet transmitting
+A packet which is built from several buffers (e.g. protocol headers and data
+stored in different places) can be sent at once without merging buffers by
+application. Each segment is described by @ref ETH_packet_t object and entire
+segment list by @ref ETH_packet_sg_t object (@ref IOCTL_ETH__SEND_PACKET_SG).
+The sum of all segment sizes is a packet size. Example:
+\code
+ETH_packet_t seg[2];
+seg[0].payload      = header;
+seg[0].payload_size = sizeof(header);
+seg[1].payload      = data_ptr;
+seg[1].payload_size = data_len;
+
+ETH_packet_sg_t pkt;
+pkt.segment  = seg;
+pkt.segments = ARRAY_SIZE(seg);
+
+if (ioctl(fileno(eth), IOCTL_ETH__SEND_PACKET_SG, &pkt) != 0) {
+        // ... error handling
+}
+\endcode
 @{
 */
 
@@ -246,6 +268,13 @@ extern "C" {
  */
 #define IOCTL_ETH__GET_LINK_STATUS                   _IOR(ETH, 0x07, ETH_link_status_t*)
 
+/**
+ * @brief  Send packet built from segments (scatter-gather).
+ * @param  [WR] @ref ETH_packet_sg_t*          segment list reference.
+ * @return On success 0 is returned, otherwise -1 and @ref errno code is set.
+ */
+#define IOCTL_ETH__SEND_PACKET_SG                    _IOW(ETH, 0x08, ETH_packet_sg_t*)
+
 /*==============================================================================
   Exported object types
 ==============================================================================*/
@@ -257,6 +286,14 @@ typedef struct {
         u16_t  payload_size;    /*!< Payload size.*/
 } ETH_packet_t;
 
+/**
+ * Type represent packet built from segments.
+ */
+typedef struct {
+        const ETH_packet_t *segment;    /*!< Segment list.*/
+        size_t              segments;   /*!< Number of segments.*/
+} ETH_packet_sg_t;
+
 /**
  * Type represent link status.
  */
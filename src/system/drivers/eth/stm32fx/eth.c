@@ -85,6 +85,7 @@ struct eth {
 ==============================================================================*/
 static bool   is_Ethernet_started       (void);
 static void   send_packet               (size_t size);
+static int    send_segments             (struct eth *hdl, const ETH_packet_t *seg, size_t segments);
 static size_t wait_for_packet           (struct eth *hdl, uint32_t timeout);
 static void   give_Rx_buffer_to_DMA     (void);
 static bool   is_buffer_owned_by_DMA    (ETH_DMADESCTypeDef *DMA_descriptor);
@@ -509,33 +510,16 @@ API_MOD_IOCTL(ETH, void *device_handle, int request, void *arg)
 
         case IOCTL_ETH__SEND_PACKET:
                 if (arg) {
-                        if (sys_mutex_lock(hdl->tx_access, MAX_DELAY_MS) == ESUCC) {
-                                ETH_packet_t *pkt = arg;
-
-                                while (is_buffer_owned_by_DMA(DMATxDescToSet)) {
-                                        sys_sleep_ms(1);
-                                }
-
-                                if (  !is_buffer_owned_by_DMA(DMATxDescToSet)
-                                   && pkt->payload
-                                   && pkt->payload_size <= ETH_MAX_PACKET_SIZE) {
-
-                                        u8_t *buffer = get_buffer_address(DMATxDescToSet);
-
-                                        memcpy(buffer, pkt->payload, pkt->payload_size);
-
-                                        send_packet(pkt->payload_size);
-
-                                        err = ESUCC;
-                                } else {
-                                        printk("ETH: payload size too big or NULL");
-                                        err = EAGAIN;
-                                }
+                        err = send_segments(hdl, arg, 1);
+                } else {
+                        err = EINVAL;
+                }
+                break;
 
-                                sys_mutex_unlock(hdl->tx_access);
-                        } else {
-                                err = EAGAIN;
-                        }
+        case IOCTL_ETH__SEND_PACKET_SG:
+                if (arg) {
+                        ETH_packet_sg_t *pkt = arg;
+                        err = send_segments(hdl, pkt->segment, pkt->segments);
                 } else {
                         err = EINVAL;
                 }
@@ -705,6 +689,62 @@ static void send_packet(size_t size)
         sys_critical_section_end();
 }
 
+//==============================================================================
+/**
+ * @brief  Function gather packet segments in the current Tx buffer and send
+ *         packet.
+ *
+ * @param  hdl          driver context
+ * @param  seg          segment list
+ * @param  segments     number of segments
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int send_segments(struct eth *hdl, const ETH_packet_t *seg, size_t segments)
+{
+        if (!seg) {
+                return EINVAL;
+        }
+
+        size_t size = 0;
+
+        for (size_t i = 0; i < segments; i++) {
+                if (!seg[i].payload && seg[i].payload_size) {
+                        return EINVAL;
+                }
+
+                size += seg[i].payload_size;
+        }
+
+        if (size == 0 || size > ETH_MAX_PACKET_SIZE) {
+                printk("ETH: payload size too big or NULL");
+                return EAGAIN;
+        }
+
+        int err = sys_mutex_lock(hdl->tx_access, MAX_DELAY_MS);
+        if (!err) {
+                while (is_buffer_owned_by_DMA(DMATxDescToSet)) {
+                        sys_sleep_ms(1);
+                }
+
+                u8_t *buffer = get_buffer_address(DMATxDescToSet);
+
+                for (size_t i = 0; i < segments; i++) {
+                        memcpy(buffer, seg[i].payload, seg[i].payload_size);
+                        buffer += seg[i].payload_size;
+                }
+
+                send_packet(size);
+
+                sys_mutex_unlock(hdl->tx_access);
+        } else {
+                err = EAGAIN;
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function waits for a packet and return a size of recived packet
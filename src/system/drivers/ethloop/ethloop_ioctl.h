@@ -0,0 +1,118 @@
+/*==============================================================================
+File    ethloop_ioctl.h
+
+Author  Daniel Zorychta
+
+Brief   Software loopback Ethernet device
+
+        Copyright (C) 2026 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/**
+@defgroup drv-ethloop ETHLOOP Driver
+
+\section drv-ethloop-desc Description
+Driver emulates Ethernet MAC peripheral in software. Each transmitted frame is
+queued and then received by the same device, thus the TCP/IP stack communicates
+with itself. Driver can be used to measure the network stack performance
+(e.g. TCP bulk transfer to own address) without Ethernet hardware.
+
+Driver handles the same ioctl() requests as ETH driver (@ref drv-ETH), thus
+the device file can be used as network interface file.
+
+\section drv-ethloop-sup-arch Supported architectures
+\li noarch
+
+\section drv-ethloop-ddesc Details
+\subsection drv-ethloop-ddesc-num Meaning of major and minor numbers
+Only major 0 and minor 0 are supported.
+
+\subsection drv-ethloop-ddesc-init Driver initialization
+To initialize driver the following code can be used:
+
+@code
+driver_init("ETHLOOP", 0, 0, "/dev/eth0");
+@endcode
+
+\subsection drv-ethloop-ddesc-release Driver release
+To release driver the following code can be used:
+@code
+driver_release("ETHLOOP", 0, 0);
+@endcode
+
+\subsection drv-ethloop-ddesc-cfg Driver configuration
+Number of buffered frames is configured by using configuration files in the
+<tt>./config</tt> directory or by using Configtool. The TCP/IP stack should
+generate checksums by software because there is no hardware that inserts
+checksums.
+
+\subsection drv-ethloop-ddesc-write Data write
+Written buffer is sent as frame (or frames if buffer is bigger than maximum
+frame size).
+
+\subsection drv-ethloop-ddesc-read Data read
+Read operation returns single frame. Buffer should be a size of maximum frame
+size (1524 bytes).
+
+@{
+*/
+
+#ifndef _ETHLOOP_IOCTL_H_
+#define _ETHLOOP_IOCTL_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "drivers/ioctl_macros.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+/* driver uses ETH requests, see eth_ioctl.h */
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ETHLOOP_IOCTL_H_ */
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -0,0 +1,571 @@
+/*==============================================================================
+File    ethloop.c
+
+Author  Daniel Zorychta
+
+Brief   Software loopback Ethernet device
+
+        Copyright (C) 2026 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "drivers/driver.h"
+#include "noarch/ethloop_cfg.h"
+#include "../ethloop_ioctl.h"
+#include "eth/eth_ioctl.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define MAX_PACKET_SIZE         1524
+#define QUEUE_LEN               _ETHLOOP_CFG__QUEUE_LEN
+#define TX_TIMEOUT              1000
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        u16_t size;
+        u8_t  data[MAX_PACKET_SIZE];
+} frame_t;
+
+typedef struct {
+        mutex_t    *access;
+        sem_t      *rx_ready;
+        sem_t      *tx_ready;
+        dev_lock_t  dev_lock;
+        bool        started;
+        u8_t        MAC[6];
+        size_t      head;
+        size_t      count;
+        frame_t     frame[QUEUE_LEN];
+} ETHLOOP_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+static int    send_segments  (ETHLOOP_t *hdl, const ETH_packet_t *seg, size_t segments, u32_t timeout);
+static int    receive_packet (ETHLOOP_t *hdl, ETH_packet_t *pkt);
+static size_t get_packet_size(ETHLOOP_t *hdl);
+static size_t wait_for_packet(ETHLOOP_t *hdl, u32_t timeout);
+
+/*==============================================================================
+  Local object
+==============================================================================*/
+MODULE_NAME(ETHLOOP);
+
+/*==============================================================================
+  Exported object
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief Initialize device.
+ *
+ * @param[out]          **device_handle        device allocated memory
+ * @param[in ]            major                major device number
+ * @param[in ]            minor                minor device number
+ * @param[in ]            config               optional module configuration
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_INIT(ETHLOOP, void **device_handle, u8_t major, u8_t minor, const void *config)
+{
+        UNUSED_ARG1(config);
+
+        if (major != 0 || minor != 0) {
+                return ENODEV;
+        }
+
+        int err = sys_zalloc(sizeof(ETHLOOP_t), device_handle);
+        if (!err) {
+                ETHLOOP_t *hdl = *device_handle;
+
+                err = sys_mutex_create(MUTEX_TYPE_NORMAL, &hdl->access);
+                if (err != ESUCC)
+                        goto finish;
+
+                err = sys_semaphore_create(1, 0, &hdl->rx_ready);
+                if (err != ESUCC)
+                        goto finish;
+
+                err = sys_semaphore_create(1, 0, &hdl->tx_ready);
+                if (err != ESUCC)
+                        goto finish;
+
+                /* locally administered address */
+                hdl->MAC[0] = 0x02;
+
+                finish:
+                if (err != ESUCC) {
+                        if (hdl->access)
+                                sys_mutex_destroy(hdl->access);
+
+                        if (hdl->rx_ready)
+                                sys_semaphore_destroy(hdl->rx_ready);
+
+                        if (hdl->tx_ready)
+                                sys_semaphore_destroy(hdl->tx_ready);
+
+                        sys_free(device_handle);
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Release device.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_RELEASE(ETHLOOP, void *device_handle)
+{
+        ETHLOOP_t *hdl = device_handle;
+
+        int err = sys_device_lock(&hdl->dev_lock);
+        if (!err) {
+                sys_mutex_destroy(hdl->access);
+                sys_semaphore_destroy(hdl->rx_ready);
+                sys_semaphore_destroy(hdl->tx_ready);
+                sys_free(&device_handle);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Open device.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ * @param[in ]           flags                  file operation flags (O_RDONLY, O_WRONLY, O_RDWR)
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_OPEN(ETHLOOP, void *device_handle, u32_t flags)
+{
+        UNUSED_ARG1(flags);
+
+        ETHLOOP_t *hdl = device_handle;
+
+        return sys_device_lock(&hdl->dev_lock);
+}
+
+//==============================================================================
+/**
+ * @brief Close device.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ * @param[in ]           force                  device force close (true)
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_CLOSE(ETHLOOP, void *device_handle, bool force)
+{
+        ETHLOOP_t *hdl = device_handle;
+
+        int err = sys_device_get_access(&hdl->dev_lock);
+        if (!err) {
+                err = sys_device_unlock(&hdl->dev_lock, force);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Write data to device.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ * @param[in ]          *src                    data source
+ * @param[in ]           count                  number of bytes to write
+ * @param[in ][out]     *fpos                   file position
+ * @param[out]          *wrcnt                  number of written bytes
+ * @param[in ]           fattr                  file attributes
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_WRITE(ETHLOOP,
+              void             *device_handle,
+              const u8_t       *src,
+              size_t            count,
+              fpos_t           *fpos,
+              size_t           *wrcnt,
+              struct vfs_fattr  fattr)
+{
+        UNUSED_ARG1(fpos);
+
+        ETHLOOP_t *hdl = device_handle;
+
+        int err = ESUCC;
+
+        *wrcnt = 0;
+
+        while (count && !err) {
+                ETH_packet_t pkt;
+                pkt.payload      = cast(void*, src);
+                pkt.payload_size = min(count, MAX_PACKET_SIZE);
+
+                err = send_segments(hdl, &pkt, 1, fattr.non_blocking_wr ? 0 : TX_TIMEOUT);
+                if (!err) {
+                        *wrcnt += pkt.payload_size;
+                        src    += pkt.payload_size;
+                        count  -= pkt.payload_size;
+                }
+        }
+
+        return (*wrcnt > 0) ? ESUCC : err;
+}
+
+//==============================================================================
+/**
+ * @brief Read data from device.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ * @param[out]          *dst                    data destination
+ * @param[in ]           count                  number of bytes to read
+ * @param[in ][out]     *fpos                   file position
+ * @param[out]          *rdcnt                  number of read bytes
+ * @param[in ]           fattr                  file attributes
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_READ(ETHLOOP,
+             void            *device_handle,
+             u8_t            *dst,
+             size_t           count,
+             fpos_t          *fpos,
+             size_t          *rdcnt,
+             struct vfs_fattr fattr)
+{
+        UNUSED_ARG1(fpos);
+
+        ETHLOOP_t *hdl = device_handle;
+
+        if (count < MAX_PACKET_SIZE) {
+                return EINVAL;
+        }
+
+        *rdcnt = wait_for_packet(hdl, fattr.non_blocking_rd ? 0 : MAX_DELAY_MS);
+        if (*rdcnt == 0) {
+                return fattr.non_blocking_rd ? EAGAIN : ETIME;
+        }
+
+        ETH_packet_t pkt = {.payload = dst, .payload_size = *rdcnt};
+
+        return receive_packet(hdl, &pkt);
+}
+
+//==============================================================================
+/**
+ * @brief IO control.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ * @param[in ]           request                request
+ * @param[in ][out]     *arg                    request's argument
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_IOCTL(ETHLOOP, void *device_handle, int request, void *arg)
+{
+        ETHLOOP_t *hdl = device_handle;
+
+        int err = EINVAL;
+
+        switch (request) {
+        case IOCTL_ETH__WAIT_FOR_PACKET:
+                if (arg) {
+                        ETH_packet_wait_t *pw = cast(ETH_packet_wait_t*, arg);
+                        pw->pkt_size = wait_for_packet(hdl, pw->timeout);
+                        err = ESUCC;
+                }
+                break;
+
+        case IOCTL_ETH__SET_MAC_ADDR:
+                if (arg) {
+                        memcpy(hdl->MAC, arg, sizeof(hdl->MAC));
+                        err = ESUCC;
+                }
+                break;
+
+        case IOCTL_ETH__GET_MAC_ADDR:
+                if (arg) {
+                        memcpy(arg, hdl->MAC, sizeof(hdl->MAC));
+                        err = ESUCC;
+                }
+                break;
+
+        case IOCTL_ETH__SEND_PACKET:
+                if (arg) {
+                        err = send_segments(hdl, arg, 1, TX_TIMEOUT);
+                }
+                break;
+
+        case IOCTL_ETH__SEND_PACKET_SG:
+                if (arg) {
+                        ETH_packet_sg_t *pkt = arg;
+                        err = send_segments(hdl, pkt->segment, pkt->segments, TX_TIMEOUT);
+                }
+                break;
+
+        case IOCTL_ETH__RECEIVE_PACKET:
+                if (arg) {
+                        err = receive_packet(hdl, arg);
+                }
+                break;
+
+        case IOCTL_ETH__ETHERNET_START:
+        case IOCTL_ETH__ETHERNET_STOP:
+                err = sys_mutex_lock(hdl->access, MAX_DELAY_MS);
+                if (!err) {
+                        hdl->started = (request == IOCTL_ETH__ETHERNET_START);
+                        hdl->head    = 0;
+                        hdl->count   = 0;
+                        sys_mutex_unlock(hdl->access);
+                        sys_semaphore_signal(hdl->tx_ready);
+                }
+                break;
+
+        case IOCTL_ETH__GET_LINK_STATUS:
+                if (arg) {
+                        *cast(ETH_link_status_t*, arg) = ETH_LINK_STATUS__CONNECTED;
+                        err = ESUCC;
+                }
+                break;
+
+        default:
+                err = EBADRQC;
+                break;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Flush device.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_FLUSH(ETHLOOP, void *device_handle)
+{
+        UNUSED_ARG1(device_handle);
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief Device information.
+ *
+ * @param[in ]          *device_handle          device allocated memory
+ * @param[out]          *device_stat            device status
+ *
+ * @return One of errno value (errno.h).
+ */
+//==============================================================================
+API_MOD_STAT(ETHLOOP, void *device_handle, struct vfs_dev_stat *device_stat)
+{
+        UNUSED_ARG1(device_handle);
+
+        device_stat->st_size = 0;
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Function gather packet segments in the free queue frame. If queue
+ *         is full then function waits until receiver take a frame.
+ *
+ * @param  hdl          driver context
+ * @param  seg          segment list
+ * @param  segments     number of segments
+ * @param  timeout      free frame wait timeout
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int send_segments(ETHLOOP_t *hdl, const ETH_packet_t *seg, size_t segments, u32_t timeout)
+{
+        if (!seg) {
+                return EINVAL;
+        }
+
+        size_t size = 0;
+
+        for (size_t i = 0; i < segments; i++) {
+                if (!seg[i].payload && seg[i].payload_size) {
+                        return EINVAL;
+                }
+
+                size += seg[i].payload_size;
+        }
+
+        if (size == 0 || size > MAX_PACKET_SIZE) {
+                return EINVAL;
+        }
+
+        int err;
+
+        while (!(err = sys_mutex_lock(hdl->access, MAX_DELAY_MS))) {
+
+                if (!hdl->started) {
+                        err = EIO;
+
+                } else if (hdl->count < QUEUE_LEN) {
+                        frame_t *frame = &hdl->frame[(hdl->head + hdl->count) % QUEUE_LEN];
+                        u8_t    *data  = frame->data;
+
+                        for (size_t i = 0; i < segments; i++) {
+                                memcpy(data, seg[i].payload, seg[i].payload_size);
+                                data += seg[i].payload_size;
+                        }
+
+                        frame->size = size;
+                        hdl->count++;
+
+                        sys_semaphore_signal(hdl->rx_ready);
+
+                } else {
+                        err = EAGAIN;
+                }
+
+                sys_mutex_unlock(hdl->access);
+
+                if (err == EAGAIN) {
+                        if (sys_semaphore_wait(hdl->tx_ready, timeout) == ESUCC) {
+                                continue;
+                        }
+                }
+
+                break;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function copy the oldest queued frame to the packet buffer and
+ *         release frame.
+ *
+ * @param  hdl          driver context
+ * @param  pkt          packet buffer
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int receive_packet(ETHLOOP_t *hdl, ETH_packet_t *pkt)
+{
+        if (!pkt->payload) {
+                return EINVAL;
+        }
+
+        int err = sys_mutex_lock(hdl->access, MAX_DELAY_MS);
+        if (!err) {
+                if (hdl->count > 0) {
+                        frame_t *frame = &hdl->frame[hdl->head];
+
+                        memcpy(pkt->payload, frame->data, min(pkt->payload_size, frame->size));
+
+                        hdl->head = (hdl->head + 1) % QUEUE_LEN;
+                        hdl->count--;
+
+                        sys_semaphore_signal(hdl->tx_ready);
+                } else {
+                        err = EIO;
+                }
+
+                sys_mutex_unlock(hdl->access);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return size of the oldest queued frame.
+ *
+ * @param  hdl          driver context
+ *
+ * @return Frame size, 0 if queue is empty.
+ */
+//==============================================================================
+static size_t get_packet_size(ETHLOOP_t *hdl)
+{
+        size_t size = 0;
+
+        if (sys_mutex_lock(hdl->access, MAX_DELAY_MS) == ESUCC) {
+                if (hdl->count > 0) {
+                        size = hdl->frame[hdl->head].size;
+                }
+
+                sys_mutex_unlock(hdl->access);
+        }
+
+        return size;
+}
+
+//==============================================================================
+/**
+ * @brief  Function waits for a packet and return a size of received packet.
+ *
+ * @param  hdl          driver context
+ * @param  timeout      packet wait timeout
+ *
+ * @return Size of received packet, 0 on timeout.
+ */
+//==============================================================================
+static size_t wait_for_packet(ETHLOOP_t *hdl, u32_t timeout)
+{
+        size_t size = get_packet_size(hdl);
+
+        if (size == 0) {
+                sys_semaphore_wait(hdl->rx_ready, timeout);
+                size = get_packet_size(hdl);
+        }
+
+        return size;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -493,6 +493,19 @@ API_MOD_IOCTL(TTY, void *device_handle, int request, void *arg)
                 }
                 break;
 
+        case IOCTL_VFS__POLL:
+                if (arg) {
+                        struct vfs_poll *poll = arg;
+                        size_t items = 0;
+                        sys_queue_get_number_of_items(tty->queue_out, &items);
+
+                        poll->object  = tty->queue_out;
+                        poll->revents = (items ? POLLIN : 0) | POLLOUT;
+                        poll->revents &= poll->events;
+                        err = ESUCC;
+                }
+                break;
+
         default:
                 err = EBADRQC;
                 break;
@@ -749,6 +762,8 @@ static void copy_string_to_queue(const char *str, queue_t *queue, bool lfend, ui
                 const char lf = '\n';
                 sys_queue_send(queue, &lf, timeout);
         }
+
+        sys_poll_notify(queue);
 }
 
 //==============================================================================
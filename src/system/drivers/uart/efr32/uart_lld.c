@@ -370,6 +370,11 @@ static void IRQ_Rx_handle(u8_t major)
         // set receive semaphore to number of received bytes
         bool yield = received > 0;
 
+        // wake up threads that wait in poll() for data
+        if (received) {
+                sys_poll_notify_from_ISR(_UART_mem[major], NULL);
+        }
+
         while (received--) {
                 sys_semaphore_signal_from_ISR(_UART_mem[major]->data_read_sem, NULL);
         }
@@ -657,6 +657,11 @@ static void IRQ_handle(u8_t major)
                 }
         }
 
+        // wake up threads that wait in poll() for data
+        if (received) {
+                sys_poll_notify_from_ISR(_UART_mem[major], NULL);
+        }
+
         // set receive semaphore to number of received bytes
         while (received--) {
                 sys_semaphore_signal_from_ISR(_UART_mem[major]->data_read_sem, NULL);
@@ -364,6 +364,19 @@ API_MOD_IOCTL(UART, void *device_handle, int request, void *arg)
                         }
                         break;
 
+                case IOCTL_VFS__POLL: {
+                        struct vfs_poll *poll = arg;
+                        if (poll) {
+                                poll->object  = hdl;
+                                poll->revents = (hdl->Rx_FIFO.buffer_level ? POLLIN : 0) | POLLOUT;
+                                poll->revents &= poll->events;
+                                err = ESUCC;
+                        } else {
+                                err = EINVAL;
+                        }
+                        break;
+                }
+
                 default:
                         err = EBADRQC;
                         break;
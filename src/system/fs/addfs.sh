@@ -74,6 +74,8 @@ function create_registration_file()
         echo '    extern API_FS_CLOSE('$fs', void*, void*, bool);'
         echo '    extern API_FS_WRITE('$fs', void*, void*, const u8_t*, size_t, fpos_t*, size_t*, struct vfs_fattr);'
         echo '    extern API_FS_READ('$fs', void*, void*, u8_t*, size_t, fpos_t*, size_t*, struct vfs_fattr);'
+        echo '    extern API_FS_WRITEV('$fs', void*, void*, const struct iovec*, int, fpos_t*, size_t*, struct vfs_fattr) __attribute__((weak));'
+        echo '    extern API_FS_READV('$fs', void*, void*, const struct iovec*, int, fpos_t*, size_t*, struct vfs_fattr) __attribute__((weak));'
         echo '    extern API_FS_IOCTL('$fs', void*, void*, int, void*);'
         echo '    extern API_FS_FLUSH('$fs', void*, void*);'
         echo '    extern API_FS_SYNC('$fs', void*);'
@@ -122,6 +124,8 @@ function create_registration_file()
         echo '                 .fs_ioctl   = _'$fs'_ioctl,'
         echo '                 .fs_flush   = _'$fs'_flush,'
         echo '                 .fs_write   = _'$fs'_write,'
+        echo '                 .fs_writev  = _'$fs'_writev,'
+        echo '                 .fs_readv   = _'$fs'_readv,'
         echo '                 .fs_sync    = _'$fs'_sync,'
         echo '                 .fs_mknod   = _'$fs'_mknod,'
         echo '                 .fs_opendir = _'$fs'_opendir,'
@@ -0,0 +1,1112 @@
+/*=========================================================================*//**
+@file    bcache.c
+
+@author  Daniel Zorychta
+
+@brief   Block cache of file system backing devices.
+
+@note    Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Cache keeps fixed-size blocks of a file system backing device (file or
+ * device node). Blocks are found by hash table and kept on the LRU list (the
+ * most recently used block at the head). Block memory is accounted under the
+ * _MM_CACHE purpose and clean blocks are released by _bcache_shrink() when
+ * kernel allocator is out of memory.
+ *
+ * File systems read files block by block, thus sequential reads are detected
+ * by following a few read streams (next expected block). When a sequential
+ * stream misses the cache, the missing blocks and a read-ahead window are read
+ * by single device request. The window doubles with each sequential request
+ * and its limit is lowered when read-ahead blocks are evicted unused.
+ *
+ * File systems can register own shrinkers to release auxiliary caches (e.g.
+ * cluster maps) when clean blocks are not enough to satisfy allocation.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+#include <sys/types.h>
+#include <string.h>
+#include "dnx/misc.h"
+#include "libc/errno.h"
+#include "kernel/kwrapper.h"
+#include "mm/mm.h"
+#include "fs/vfs.h"
+#include "fs/bcache.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define MAX_BUCKETS             256
+#define MAX_FLUSH_RUN           8       // blocks written by single request at flush (stack usage)
+#define RA_STREAMS              4
+#define RA_MIN_WINDOW           2
+#define MAX_SHRINKERS           4
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        u64_t         next;             /*!< next expected block */
+        u32_t         stamp;            /*!< last use (0: stream not used) */
+        u32_t         window;           /*!< current read-ahead window */
+} ra_stream_t;
+
+typedef struct block {
+        struct block *hnext;            /*!< next block in hash bucket */
+        struct block *prev;             /*!< more recently used block */
+        struct block *next;             /*!< less recently used block */
+        u64_t         blk;              /*!< block number */
+        bool          dirty;            /*!< block not written to device */
+        bool          ra;               /*!< read ahead and not used yet */
+        u8_t          data[];           /*!< block data */
+} block_t;
+
+struct bcache {
+        struct bcache  *self;           /*!< object validation */
+        struct bcache  *next;           /*!< next cache in global list */
+        FILE           *dev;            /*!< backing device */
+        mutex_t        *mtx;            /*!< cache access mutex */
+        size_t          blksize;        /*!< block size */
+        size_t          max_blocks;     /*!< cache capacity in blocks */
+        bool            write_through;  /*!< write blocks to device immediately */
+        u64_t           dev_blocks;     /*!< device capacity in blocks (0: unknown) */
+        size_t          ra_max;         /*!< maximum read-ahead window (0: disabled) */
+        size_t          ra_limit;       /*!< current read-ahead window limit */
+        u32_t           ra_clock;       /*!< stream use counter */
+        ra_stream_t     stream[RA_STREAMS]; /*!< sequential read streams */
+        block_t        *head;           /*!< most recently used block */
+        block_t        *tail;           /*!< least recently used block */
+        _bcache_stats_t stats;          /*!< cache statistics */
+        size_t          buckets;        /*!< number of hash buckets (power of 2) */
+        block_t        *bucket[];       /*!< hash table */
+};
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static struct {
+        mutex_t        *mtx;            /*!< cache list mutex */
+        bcache_t       *list;           /*!< registered caches */
+        _bcache_stats_t retired;        /*!< statistics of destroyed caches */
+
+        struct {
+                _bcache_shrinker_t fn;  /*!< release function */
+                void              *arg; /*!< release function argument */
+        } shrinker[MAX_SHRINKERS];      /*!< registered auxiliary cache shrinkers */
+} BC;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Create global cache list mutex if not exist.
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int init(void)
+{
+        if (!BC.mtx) {
+                mutex_t *mtx = NULL;
+                int err = _mutex_create(MUTEX_TYPE_NORMAL, &mtx);
+                if (err) {
+                        return err;
+                }
+
+                _kernel_scheduler_lock();
+                if (!BC.mtx) {
+                        BC.mtx = mtx;
+                        mtx    = NULL;
+                }
+                _kernel_scheduler_unlock();
+
+                if (mtx) {
+                        _mutex_destroy(mtx);
+                }
+        }
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Check if cache is valid.
+ *
+ * @param  this         cache object
+ *
+ * @return true if valid, otherwise false.
+ */
+//==============================================================================
+static bool is_valid(bcache_t *this)
+{
+        return this && this->self == this;
+}
+
+//==============================================================================
+/**
+ * @brief  Return hash bucket of selected block.
+ *
+ * @param  this         cache object
+ * @param  blk          block number
+ *
+ * @return Pointer to bucket head.
+ */
+//==============================================================================
+static block_t **bucket_of(bcache_t *this, u64_t blk)
+{
+        return &this->bucket[blk & (this->buckets - 1)];
+}
+
+//==============================================================================
+/**
+ * @brief  Find cached block.
+ *
+ * @param  this         cache object
+ * @param  blk          block number
+ *
+ * @return Block object or NULL if block is not cached.
+ */
+//==============================================================================
+static block_t *lookup(bcache_t *this, u64_t blk)
+{
+        for (block_t *b = *bucket_of(this, blk); b; b = b->hnext) {
+                if (b->blk == blk) {
+                        return b;
+                }
+        }
+
+        return NULL;
+}
+
+//==============================================================================
+/**
+ * @brief  Remove block from hash table and LRU list.
+ *
+ * @param  this         cache object
+ * @param  b            block
+ */
+//==============================================================================
+static void unlink_block(bcache_t *this, block_t *b)
+{
+        for (block_t **p = bucket_of(this, b->blk); *p; p = &(*p)->hnext) {
+                if (*p == b) {
+                        *p = b->hnext;
+                        break;
+                }
+        }
+
+        if (b->prev) {
+                b->prev->next = b->next;
+        } else {
+                this->head = b->next;
+        }
+
+        if (b->next) {
+                b->next->prev = b->prev;
+        } else {
+                this->tail = b->prev;
+        }
+
+        b->hnext = NULL;
+        b->prev  = NULL;
+        b->next  = NULL;
+}
+
+//==============================================================================
+/**
+ * @brief  Insert block to hash table and at the head of LRU list.
+ *
+ * @param  this         cache object
+ * @param  b            block
+ */
+//==============================================================================
+static void link_block(bcache_t *this, block_t *b)
+{
+        block_t **bucket = bucket_of(this, b->blk);
+        b->hnext = *bucket;
+        *bucket  = b;
+
+        b->prev = NULL;
+        b->next = this->head;
+
+        if (this->head) {
+                this->head->prev = b;
+        } else {
+                this->tail = b;
+        }
+
+        this->head = b;
+}
+
+//==============================================================================
+/**
+ * @brief  Move block at the head of LRU list.
+ *
+ * @param  this         cache object
+ * @param  b            block
+ */
+//==============================================================================
+static void touch(bcache_t *this, block_t *b)
+{
+        if (this->head != b) {
+                b->prev->next = b->next;
+
+                if (b->next) {
+                        b->next->prev = b->prev;
+                } else {
+                        this->tail = b->prev;
+                }
+
+                b->prev          = NULL;
+                b->next          = this->head;
+                this->head->prev = b;
+                this->head       = b;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Read blocks from device.
+ *
+ * @param  this         cache object
+ * @param  blk          first block number
+ * @param  count        number of blocks
+ * @param  dst          destination buffer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int dev_read(bcache_t *this, u64_t blk, size_t count, void *dst)
+{
+        struct iovec iov    = {.iov_base = dst, .iov_len = count * this->blksize};
+        fpos_t       offset = blk * this->blksize;
+        size_t       rdcnt  = 0;
+
+        int err = _vfs_freadv(&iov, 1, &offset, &rdcnt, this->dev);
+        if (!err && (rdcnt != iov.iov_len)) {
+                err = EIO;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Write blocks to device.
+ *
+ * @param  this         cache object
+ * @param  blk          first block number
+ * @param  iov          block buffers (consecutive blocks)
+ * @param  iovcnt       number of buffers
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int dev_write(bcache_t *this, u64_t blk, const struct iovec *iov, int iovcnt)
+{
+        fpos_t offset = blk * this->blksize;
+        size_t size   = 0;
+        size_t wrcnt  = 0;
+
+        for (int i = 0; i < iovcnt; i++) {
+                size += iov[i].iov_len;
+        }
+
+        int err = _vfs_fwritev(iov, iovcnt, &offset, &wrcnt, this->dev);
+        if (!err && (wrcnt != size)) {
+                err = EIO;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Write dirty block to device.
+ *
+ * @param  this         cache object
+ * @param  b            block
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int write_back(bcache_t *this, block_t *b)
+{
+        struct iovec iov = {.iov_base = b->data, .iov_len = this->blksize};
+
+        int err = dev_write(this, b->blk, &iov, 1);
+        if (!err) {
+                b->dirty = false;
+                this->stats.writebacks++;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Get free block for selected block number. New block is allocated
+ *         if capacity allows, otherwise the least recently used block is
+ *         reused (written back first if dirty). Block is not linked.
+ *
+ * @param  this         cache object
+ * @param  blk          block number
+ * @param  b            free block (NULL if cache cannot hold a block)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int get_free_block(bcache_t *this, u64_t blk, block_t **b)
+{
+        *b = NULL;
+
+        if (this->stats.blocks < this->max_blocks) {
+                if (_kmalloc(_MM_CACHE, sizeof(block_t) + this->blksize,
+                             NULL, 0, 0, cast(void**, b)) == ESUCC) {
+                        this->stats.blocks++;
+                }
+        }
+
+        if (!*b && this->tail) {
+                block_t *victim = this->tail;
+
+                if (victim->dirty) {
+                        int err = write_back(this, victim);
+                        if (err) {
+                                return err;
+                        }
+                }
+
+                if (victim->ra) {
+                        this->ra_limit = max(RA_MIN_WINDOW, this->ra_limit / 2);
+                }
+
+                unlink_block(this, victim);
+                this->stats.evictions++;
+                *b = victim;
+        }
+
+        if (*b) {
+                (*b)->blk   = blk;
+                (*b)->dirty = false;
+                (*b)->ra    = false;
+                (*b)->hnext = NULL;
+                (*b)->prev  = NULL;
+                (*b)->next  = NULL;
+        }
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief  Free block memory.
+ *
+ * @param  this         cache object
+ * @param  b            block (unlinked)
+ */
+//==============================================================================
+static void free_block(bcache_t *this, block_t *b)
+{
+        _kfree(_MM_CACHE, cast(void**, &b));
+        this->stats.blocks--;
+}
+
+//==============================================================================
+/**
+ * @brief  Store blocks read from device in cache.
+ *
+ * @param  this         cache object
+ * @param  blk          first block number
+ * @param  count        number of blocks
+ * @param  src          blocks data
+ * @param  ra           blocks are read ahead
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int insert_blocks(bcache_t *this, u64_t blk, size_t count, const u8_t *src, bool ra)
+{
+        int err = ESUCC;
+
+        for (size_t n = 0; !err && (n < count) && this->max_blocks; n++) {
+                block_t *b;
+                err = get_free_block(this, blk + n, &b);
+                if (!err && b) {
+                        memcpy(b->data, &src[n * this->blksize], this->blksize);
+                        b->ra = ra;
+                        link_block(this, b);
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Update read streams by read request and return read-ahead window.
+ *
+ * @param  this         cache object
+ * @param  blk          first requested block
+ * @param  count        number of requested blocks
+ *
+ * @return Number of blocks to read ahead (0 if request is not sequential).
+ */
+//==============================================================================
+static size_t update_streams(bcache_t *this, u64_t blk, size_t count)
+{
+        if ((this->ra_max == 0) || (this->max_blocks == 0)) {
+                return 0;
+        }
+
+        ra_stream_t *stream = NULL;
+        ra_stream_t *oldest = &this->stream[0];
+
+        for (size_t i = 0; i < RA_STREAMS; i++) {
+                ra_stream_t *s = &this->stream[i];
+
+                if (s->stamp && (s->next == blk)) {
+                        stream = s;
+                        break;
+                }
+
+                if (s->stamp < oldest->stamp) {
+                        oldest = s;
+                }
+        }
+
+        size_t window = 0;
+
+        if (stream) {
+                window = stream->window ? stream->window * 2 : RA_MIN_WINDOW;
+                window = min(window, this->ra_limit);
+        } else {
+                stream = oldest;
+        }
+
+        stream->next   = blk + count;
+        stream->window = window;
+        stream->stamp  = ++this->ra_clock;
+
+        return window;
+}
+
+//==============================================================================
+/**
+ * @brief  Read missing blocks together with read-ahead blocks by single device
+ *         request. Read-ahead stops at first cached block and at device end,
+ *         and is not used if device size is unknown. If the read-ahead
+ *         request fails then only the requested blocks are read.
+ *         Blocks are read to temporary buffer because device drivers transfer
+ *         multiple blocks (e.g. SD CMD18) only to contiguous memory.
+ *
+ * @param  this         cache object
+ * @param  blk          first missing block
+ * @param  count        number of missing blocks
+ * @param  dst          destination of missing blocks
+ * @param  ra           read-ahead window
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int read_ahead(bcache_t *this, u64_t blk, size_t count, u8_t *dst, size_t ra)
+{
+        // read-ahead is not used if device size is unknown (end of device)
+        size_t n = 0;
+        while ((n < ra) && (this->dev_blocks > 0)
+              && (blk + count + n < this->dev_blocks)
+              && !lookup(this, blk + count + n)) {
+                n++;
+        }
+
+        u8_t *stage = NULL;
+        if (n > 0) {
+                _kmalloc(_MM_CACHE, (count + n) * this->blksize, NULL, 0, 0,
+                         cast(void**, &stage));
+        }
+
+        int err;
+
+        if (stage) {
+                err = dev_read(this, blk, count + n, stage);
+                if (err) {
+                        // read-ahead is optional, requested blocks only are read
+                        err = dev_read(this, blk, count, dst);
+                        if (!err) {
+                                err = insert_blocks(this, blk, count, dst, false);
+                        }
+
+                } else {
+                        memcpy(dst, stage, count * this->blksize);
+                        this->stats.readahead += n;
+
+                        err = insert_blocks(this, blk, count, stage, false);
+                        if (!err) {
+                                err = insert_blocks(this, blk + count, n,
+                                                    &stage[count * this->blksize], true);
+                        }
+                }
+
+                _kfree(_MM_CACHE, cast(void**, &stage));
+
+        } else {
+                err = dev_read(this, blk, count, dst);
+                if (!err) {
+                        err = insert_blocks(this, blk, count, dst, false);
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Write all dirty blocks to device. Consecutive dirty blocks are
+ *         written by single device request. Cache mutex must be locked.
+ *
+ * @param  this         cache object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int flush(bcache_t *this)
+{
+        int  err   = ESUCC;
+        bool again = true;
+
+        // runs longer than MAX_FLUSH_RUN are continued in the next pass
+        while (again) {
+                again = false;
+
+                for (block_t *b = this->head; b; b = b->next) {
+
+                        if (!b->dirty) {
+                                continue;
+                        }
+
+                        // run is written from its first block only
+                        block_t *prev = (b->blk > 0) ? lookup(this, b->blk - 1) : NULL;
+                        if (prev && prev->dirty) {
+                                continue;
+                        }
+
+                        struct iovec iov[MAX_FLUSH_RUN];
+                        block_t     *run[MAX_FLUSH_RUN];
+                        int          n = 0;
+
+                        for (block_t *r = b; r && r->dirty && (n < MAX_FLUSH_RUN); r = lookup(this, r->blk + 1)) {
+                                run[n]          = r;
+                                iov[n].iov_base = r->data;
+                                iov[n].iov_len  = this->blksize;
+                                n++;
+                        }
+
+                        int result = dev_write(this, b->blk, iov, n);
+                        if (!result) {
+                                for (int i = 0; i < n; i++) {
+                                        run[i]->dirty = false;
+                                }
+
+                                this->stats.writebacks += n;
+                                again |= (n == MAX_FLUSH_RUN);
+                        } else {
+                                err = result;
+                        }
+                }
+        }
+
+        if (!err) {
+                err = _vfs_fflush(this->dev);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function create block cache on top of device file.
+ *
+ * @param  dev          backing device (file)
+ * @param  blksize      block size in bytes
+ * @param  max_blocks   cache capacity in blocks (0 - requests go to device)
+ * @param  write_through write blocks to device immediately
+ * @param  bcache       created cache
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_create(FILE *dev, size_t blksize, size_t max_blocks,
+                   bool write_through, bcache_t **bcache)
+{
+        if (!dev || !blksize || !bcache) {
+                return EINVAL;
+        }
+
+        int err = init();
+        if (err) {
+                return err;
+        }
+
+        size_t buckets = 1;
+        while ((buckets < MAX_BUCKETS) && (buckets * 2 <= max_blocks)) {
+                buckets *= 2;
+        }
+
+        err = _kzalloc(_MM_CACHE, sizeof(bcache_t) + buckets * sizeof(block_t*),
+                           NULL, 0, 0, cast(void**, bcache));
+        if (!err) {
+                bcache_t *this = *bcache;
+
+                err = _mutex_create(MUTEX_TYPE_NORMAL, &this->mtx);
+                if (!err) {
+                        this->dev           = dev;
+                        this->blksize       = blksize;
+                        this->max_blocks    = max_blocks;
+                        this->write_through = write_through;
+                        this->buckets       = buckets;
+                        this->self          = this;
+
+                        struct stat st;
+                        if (_vfs_fstat(dev, &st) == ESUCC) {
+                                this->dev_blocks = st.st_size / blksize;
+                        }
+
+                        _mutex_lock(BC.mtx, MAX_DELAY_MS);
+                        this->next = BC.list;
+                        BC.list    = this;
+                        _mutex_unlock(BC.mtx);
+                } else {
+                        _kfree(_MM_CACHE, cast(void**, bcache));
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function flush and destroy block cache. Backing device is not closed.
+ *
+ * @param  bcache       cache object
+ *
+ * @return One of errno value (flush result).
+ */
+//==============================================================================
+int _bcache_destroy(bcache_t *bcache)
+{
+        if (!is_valid(bcache)) {
+                return EINVAL;
+        }
+
+        _mutex_lock(BC.mtx, MAX_DELAY_MS);
+        for (bcache_t **p = &BC.list; *p; p = &(*p)->next) {
+                if (*p == bcache) {
+                        *p = bcache->next;
+                        break;
+                }
+        }
+
+        BC.retired.hits       += bcache->stats.hits;
+        BC.retired.misses     += bcache->stats.misses;
+        BC.retired.writebacks += bcache->stats.writebacks;
+        BC.retired.evictions  += bcache->stats.evictions;
+        BC.retired.readahead  += bcache->stats.readahead;
+        _mutex_unlock(BC.mtx);
+
+        _mutex_lock(bcache->mtx, MAX_DELAY_MS);
+        int err = flush(bcache);
+
+        while (bcache->head) {
+                block_t *b = bcache->head;
+                unlink_block(bcache, b);
+                free_block(bcache, b);
+        }
+        _mutex_unlock(bcache->mtx);
+
+        _mutex_destroy(bcache->mtx);
+        bcache->self = NULL;
+        _kfree(_MM_CACHE, cast(void**, &bcache));
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function set maximum read-ahead window of sequential reads. Window
+ *         is limited to half of cache capacity.
+ *
+ * @param  bcache       cache object
+ * @param  max_blocks   maximum read-ahead window in blocks (0: disabled)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_set_readahead(bcache_t *bcache, size_t max_blocks)
+{
+        if (!is_valid(bcache)) {
+                return EINVAL;
+        }
+
+        int err = _mutex_lock(bcache->mtx, MAX_DELAY_MS);
+        if (!err) {
+                bcache->ra_max   = min(max_blocks, bcache->max_blocks / 2);
+                bcache->ra_limit = bcache->ra_max;
+                _mutex_unlock(bcache->mtx);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function read blocks. Cached blocks are copied from cache, each run
+ *         of missing blocks is read from device by single request and stored
+ *         in cache.
+ *
+ * @param  bcache       cache object
+ * @param  blk          first block number
+ * @param  count        number of blocks
+ * @param  dst          destination buffer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_read(bcache_t *bcache, u64_t blk, size_t count, void *dst)
+{
+        if (!is_valid(bcache) || !dst) {
+                return EINVAL;
+        }
+
+        int err = _mutex_lock(bcache->mtx, MAX_DELAY_MS);
+        if (!err) {
+                u8_t  *buf = dst;
+                size_t i   = 0;
+                size_t ra  = update_streams(bcache, blk, count);
+
+                while (!err && (i < count)) {
+                        block_t *b = lookup(bcache, blk + i);
+                        if (b) {
+                                memcpy(&buf[i * bcache->blksize], b->data, bcache->blksize);
+                                touch(bcache, b);
+                                bcache->stats.hits++;
+
+                                if (b->ra) {
+                                        b->ra = false;
+                                        bcache->ra_limit = min(bcache->ra_max, bcache->ra_limit + 1);
+                                }
+
+                                i++;
+                                continue;
+                        }
+
+                        size_t run = 1;
+                        while ((i + run < count) && !lookup(bcache, blk + i + run)) {
+                                run++;
+                        }
+
+                        bcache->stats.misses += run;
+
+                        // read-ahead is done for short sequential requests only
+                        if ((ra > 0) && (i + run == count) && (run <= ra)) {
+                                err = read_ahead(bcache, blk + i, run, &buf[i * bcache->blksize], ra);
+                        } else {
+                                err = dev_read(bcache, blk + i, run, &buf[i * bcache->blksize]);
+                                if (!err) {
+                                        err = insert_blocks(bcache, blk + i, run, &buf[i * bcache->blksize], false);
+                                }
+                        }
+
+                        i += run;
+                }
+
+                _mutex_unlock(bcache->mtx);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function write blocks. In write-back mode blocks are stored in cache
+ *         and written to device at flush or eviction. In write-through mode (or
+ *         when cache cannot hold a block) data is written to device at once.
+ *
+ * @param  bcache       cache object
+ * @param  blk          first block number
+ * @param  count        number of blocks
+ * @param  src          source buffer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_write(bcache_t *bcache, u64_t blk, size_t count, const void *src)
+{
+        if (!is_valid(bcache) || !src) {
+                return EINVAL;
+        }
+
+        int err = _mutex_lock(bcache->mtx, MAX_DELAY_MS);
+        if (!err) {
+                const u8_t *buf = src;
+
+                if (bcache->write_through || (bcache->max_blocks == 0)) {
+                        struct iovec iov = {.iov_base = const_cast(void*, buf),
+                                            .iov_len  = count * bcache->blksize};
+                        err = dev_write(bcache, blk, &iov, 1);
+                }
+
+                for (size_t i = 0; !err && (i < count) && bcache->max_blocks; i++) {
+                        const u8_t *data = &buf[i * bcache->blksize];
+
+                        block_t *b = lookup(bcache, blk + i);
+                        if (b) {
+                                touch(bcache, b);
+                        } else {
+                                err = get_free_block(bcache, blk + i, &b);
+                                if (!err && b) {
+                                        link_block(bcache, b);
+                                }
+                        }
+
+                        if (!err && b) {
+                                memcpy(b->data, data, bcache->blksize);
+                                b->dirty = !bcache->write_through;
+
+                        } else if (!err && !bcache->write_through) {
+                                struct iovec iov = {.iov_base = const_cast(void*, data),
+                                                    .iov_len  = bcache->blksize};
+                                err = dev_write(bcache, blk + i, &iov, 1);
+                        }
+                }
+
+                _mutex_unlock(bcache->mtx);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function write all dirty blocks to device.
+ *
+ * @param  bcache       cache object
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_flush(bcache_t *bcache)
+{
+        if (!is_valid(bcache)) {
+                return EINVAL;
+        }
+
+        int err = _mutex_lock(bcache->mtx, MAX_DELAY_MS);
+        if (!err) {
+                err = flush(bcache);
+                _mutex_unlock(bcache->mtx);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function return statistics of selected cache or, if cache is NULL,
+ *         sum of all caches (including destroyed ones).
+ *
+ * @param  bcache       cache object (can be NULL)
+ * @param  stats        statistics
+ */
+//==============================================================================
+void _bcache_get_stats(bcache_t *bcache, _bcache_stats_t *stats)
+{
+        if (!stats) {
+                return;
+        }
+
+        if (bcache) {
+                *stats = is_valid(bcache) ? bcache->stats : (_bcache_stats_t){0};
+
+        } else if (BC.mtx && (_mutex_lock(BC.mtx, MAX_DELAY_MS) == ESUCC)) {
+                *stats = BC.retired;
+
+                for (bcache_t *bc = BC.list; bc; bc = bc->next) {
+                        stats->hits       += bc->stats.hits;
+                        stats->misses     += bc->stats.misses;
+                        stats->writebacks += bc->stats.writebacks;
+                        stats->evictions  += bc->stats.evictions;
+                        stats->readahead  += bc->stats.readahead;
+                        stats->blocks     += bc->stats.blocks;
+                }
+
+                _mutex_unlock(BC.mtx);
+
+        } else {
+                *stats = BC.retired;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function register auxiliary cache shrinker. Shrinker is called
+ *         when memory is exhausted and clean blocks are not enough. Shrinker
+ *         is called with global cache lock held, so it must not block.
+ *
+ * @param  fn           release function (returns number of released bytes)
+ * @param  arg          release function argument
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_register_shrinker(_bcache_shrinker_t fn, void *arg)
+{
+        if (!fn) {
+                return EINVAL;
+        }
+
+        int err = init();
+        if (!err) {
+                err = _mutex_lock(BC.mtx, MAX_DELAY_MS);
+                if (!err) {
+                        err = ENOSPC;
+
+                        for (int i = 0; i < MAX_SHRINKERS; i++) {
+                                if (BC.shrinker[i].fn == NULL) {
+                                        BC.shrinker[i].fn  = fn;
+                                        BC.shrinker[i].arg = arg;
+                                        err = ESUCC;
+                                        break;
+                                }
+                        }
+
+                        _mutex_unlock(BC.mtx);
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function unregister auxiliary cache shrinker. When function returns
+ *         shrinker is not executed anymore.
+ *
+ * @param  fn           release function
+ * @param  arg          release function argument
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _bcache_unregister_shrinker(_bcache_shrinker_t fn, void *arg)
+{
+        int err = ENOENT;
+
+        if (BC.mtx && (_mutex_lock(BC.mtx, MAX_DELAY_MS) == ESUCC)) {
+
+                for (int i = 0; i < MAX_SHRINKERS; i++) {
+                        if ((BC.shrinker[i].fn == fn) && (BC.shrinker[i].arg == arg)) {
+                                BC.shrinker[i].fn  = NULL;
+                                BC.shrinker[i].arg = NULL;
+                                err = ESUCC;
+                                break;
+                        }
+                }
+
+                _mutex_unlock(BC.mtx);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release clean blocks of all caches, the least recently
+ *         used first, and then auxiliary caches of registered shrinkers.
+ *         Called by memory allocator when memory is exhausted. Caches that
+ *         are in use are skipped (function never blocks).
+ *
+ * @param  size         requested number of bytes to release
+ *
+ * @return Number of released bytes.
+ */
+//==============================================================================
+size_t _bcache_shrink(size_t size)
+{
+        size_t freed = 0;
+
+        if (BC.mtx && (_mutex_lock(BC.mtx, 0) == ESUCC)) {
+
+                for (bcache_t *bc = BC.list; bc && (freed < size); bc = bc->next) {
+
+                        if (_mutex_lock(bc->mtx, 0) == ESUCC) {
+
+                                block_t *b = bc->tail;
+                                while (b && (freed < size)) {
+                                        block_t *prev = b->prev;
+
+                                        if (!b->dirty) {
+                                                unlink_block(bc, b);
+                                                free_block(bc, b);
+                                                bc->stats.evictions++;
+                                                freed += sizeof(block_t) + bc->blksize;
+                                        }
+
+                                        b = prev;
+                                }
+
+                                _mutex_unlock(bc->mtx);
+                        }
+                }
+
+                for (int i = 0; (i < MAX_SHRINKERS) && (freed < size); i++) {
+                        if (BC.shrinker[i].fn) {
+                                freed += BC.shrinker[i].fn(BC.shrinker[i].arg, size - freed);
+                        }
+                }
+
+                _mutex_unlock(BC.mtx);
+        }
+
+        return freed;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
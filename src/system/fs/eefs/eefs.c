@@ -246,6 +246,7 @@ typedef struct {
  */
 typedef struct {
         FILE        *srcdev;
+        bcache_t    *bcache;
         mutex_t     *lock_mtx;
         dir_desc_t  *open_dirs;
         file_desc_t *open_files;
@@ -258,7 +259,6 @@ typedef struct {
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
-static uint16_t fletcher16(uint8_t const *data, size_t bytes);
 static int block_read(EEFS_t *hdl, block_buf_t *blk);
 static int block_write(EEFS_t *hdl, block_buf_t *blk);
 static bool is_entry_item_used(dir_entry_t *entry);
@@ -320,6 +320,22 @@ API_FS_INIT(eefs, void **fs_handle, const char *src_path, const char *opts)
                         goto finish;
                 }
 
+                err = sys_bcache_create(hdl->srcdev, BLOCK_SIZE,
+                                        sys_stropt_get_int(opts, "cache",
+                                                           __OS_SYSTEM_BLOCK_CACHE_SIZE__),
+                                        sys_stropt_is_flag(opts, "sync"),
+                                        &hdl->bcache);
+                if (err) {
+                        goto finish;
+                }
+
+                err = sys_bcache_set_readahead(hdl->bcache,
+                                               sys_stropt_get_int(opts, "ra",
+                                                                  __OS_SYSTEM_BLOCK_CACHE_READAHEAD__));
+                if (err) {
+                        goto finish;
+                }
+
                 hdl->block.num = MAIN_BLOCK_ADDR;
                 err = block_read(hdl, &hdl->block);
                 if (!err) {
@@ -350,6 +366,10 @@ API_FS_INIT(eefs, void **fs_handle, const char *src_path, const char *opts)
                 if (err) {
                         DBG("init error %d", err);
 
+                        if (hdl->bcache) {
+                                sys_bcache_destroy(hdl->bcache);
+                        }
+
                         if (hdl->srcdev) {
                                 sys_fclose(hdl->srcdev);
                         }
@@ -382,6 +402,7 @@ API_FS_RELEASE(eefs, void *fs_handle)
         if (!err) {
                 if ((hdl->open_files == NULL) && (hdl->open_dirs == NULL)) {
 
+                        sys_bcache_destroy(hdl->bcache);
                         sys_fclose(hdl->srcdev);
 
                         mutex_t *mtx = hdl->lock_mtx;
@@ -1377,43 +1398,9 @@ API_FS_FLUSH(eefs, void *fs_handle, void *fhdl)
 //==============================================================================
 API_FS_SYNC(eefs, void *fs_handle)
 {
-        UNUSED_ARG1(fs_handle);
-
-        return ESUCC;
-}
-
-//==============================================================================
-/**
- * @brief  Function calculate fletcher 16 checksum.
- *
- * @param  data         buffer
- * @param  bytes        buffer size
- *
- * @return Checksum.
- */
-//==============================================================================
-static uint16_t fletcher16(uint8_t const *data, size_t bytes)
-{
-        uint16_t sum1 = 0xff, sum2 = 0xff;
-        size_t tlen;
-
-        while (bytes) {
-                tlen = ((bytes >= 20) ? 20 : bytes);
-                bytes -= tlen;
-                do {
-                        sum2 += sum1 += *data++;
-                        tlen--;
-                } while (tlen);
-
-                sum1 = (sum1 & 0xff) + (sum1 >> 8);
-                sum2 = (sum2 & 0xff) + (sum2 >> 8);
-        }
-
-        /* Second reduction step to reduce sums to 8 bits */
-        sum1 = (sum1 & 0xff) + (sum1 >> 8);
-        sum2 = (sum2 & 0xff) + (sum2 >> 8);
+        EEFS_t *hdl = fs_handle;
 
-        return (sum2 << 8) | sum1;
+        return sys_bcache_flush(hdl->bcache);
 }
 
 //==============================================================================
@@ -1430,12 +1417,10 @@ static int block_read(EEFS_t *hdl, block_buf_t *blk)
 {
         memset(&blk->buf, 0, 128);
 
-        size_t rdcnt = 0;
-        sys_fseek(hdl->srcdev, blk->num * BLOCK_SIZE, SEEK_SET);
-        int err = sys_fread(&blk->buf, BLOCK_SIZE, &rdcnt, hdl->srcdev);
+        int err = sys_bcache_read(hdl->bcache, blk->num, 1, &blk->buf);
 
         if (!err) {
-                u16_t chsum  = fletcher16(blk->buf.chsum.buf, sizeof(blk->buf.chsum.buf));
+                u16_t chsum  = sys_fletcher16(blk->buf.chsum.buf, sizeof(blk->buf.chsum.buf));
                       chsum ^= blk->num;
 
                 err = (chsum == blk->buf.chsum.checksum) ? ESUCC : EILSEQ;
@@ -1464,13 +1449,11 @@ static int block_write(EEFS_t *hdl, block_buf_t *blk)
                 return EROFS;
 
         } else {
-                blk->buf.chsum.checksum = fletcher16(blk->buf.chsum.buf,
-                                                     sizeof(blk->buf.chsum.buf))
+                blk->buf.chsum.checksum = sys_fletcher16(blk->buf.chsum.buf,
+                                                         sizeof(blk->buf.chsum.buf))
                                         ^ blk->num;
 
-                size_t wrcnt = 0;
-                sys_fseek(hdl->srcdev, blk->num * BLOCK_SIZE, SEEK_SET);
-                return sys_fwrite(&blk->buf, BLOCK_SIZE, &wrcnt, hdl->srcdev);
+                return sys_bcache_write(hdl->bcache, blk->num, 1, &blk->buf);
         }
 }
 
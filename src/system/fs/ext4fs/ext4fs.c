@@ -45,6 +45,7 @@ typedef struct {
         struct ext4_blockdev_iface bdif;
         struct ext4_blockdev       bd;
         FILE                      *dev;
+        bcache_t                  *bcache;
         mutex_t                   *fs_mutex;
         u8_t                       buf[SECTOR_SIZE];
         u32_t                      open_files;
@@ -114,6 +115,18 @@ API_FS_INIT(ext4fs, void **fs_handle, const char *src_path, const char *opts)
                 err = sys_mutex_create(MUTEX_TYPE_RECURSIVE, cast(mutex_t**, &hdl->fs_mutex));
                 if (err) goto finish;
 
+                err = sys_bcache_create(hdl->dev, SECTOR_SIZE,
+                                        sys_stropt_get_int(opts, "cache",
+                                                           __OS_SYSTEM_BLOCK_CACHE_SIZE__),
+                                        sys_stropt_is_flag(opts, "sync"),
+                                        &hdl->bcache);
+                if (err) goto finish;
+
+                err = sys_bcache_set_readahead(hdl->bcache,
+                                               sys_stropt_get_int(opts, "ra",
+                                                                  __OS_SYSTEM_BLOCK_CACHE_READAHEAD__));
+                if (err) goto finish;
+
                 hdl->bdif.open     = bopen;
                 hdl->bdif.bread    = bread;
                 hdl->bdif.bwrite   = bwrite;
@@ -148,6 +161,10 @@ API_FS_INIT(ext4fs, void **fs_handle, const char *src_path, const char *opts)
                                 sys_mutex_destroy(hdl->fs_mutex);
                         }
 
+                        if (hdl->bcache) {
+                                sys_bcache_destroy(hdl->bcache);
+                        }
+
                         if (hdl->dev) {
                                 sys_fclose(cast(FILE*, hdl->dev));
                         }
@@ -182,6 +199,7 @@ API_FS_RELEASE(ext4fs, void *fs_handle)
                 err = ext4_umount(hdl->mp);
                 if (err) goto finish;
 
+                sys_bcache_destroy(hdl->bcache);
                 sys_mutex_destroy(hdl->fs_mutex);
                 sys_fclose(cast(FILE*, hdl->dev));
                 sys_free(&fs_handle);
@@ -768,6 +786,10 @@ API_FS_SYNC(ext4fs, void *fs_handle)
                 ext4_cache_write_back(__EXT4FS_CFG_WR_BUF_STRATEGY__, hdl->mp);
         }
 
+        if (!err) {
+                err = sys_bcache_flush(hdl->bcache);
+        }
+
         return err;
 }
 
@@ -847,9 +869,7 @@ static int bread(struct ext4_blockdev *bdev, void *buf, uint64_t blk_id, uint32_
 {
         ext4fs_t *hdl = bdev->bdif->p_user;
 
-        size_t rdcnt = 0;
-        sys_fseek(hdl->dev, blk_id * bdev->bdif->ph_bsize, SEEK_SET);
-        return sys_fread(buf, bdev->bdif->ph_bsize * blk_cnt, &rdcnt, hdl->dev);
+        return sys_bcache_read(hdl->bcache, blk_id, blk_cnt, buf);
 }
 
 //==============================================================================
@@ -868,9 +888,7 @@ static int bwrite(struct ext4_blockdev *bdev, const void *buf, uint64_t blk_id,
 {
         ext4fs_t *hdl = bdev->bdif->p_user;
 
-        size_t wrcnt = 0;
-        sys_fseek(hdl->dev, blk_id * bdev->bdif->ph_bsize, SEEK_SET);
-        return sys_fwrite(buf, bdev->bdif->ph_bsize * blk_cnt, &wrcnt, hdl->dev);
+        return sys_bcache_write(hdl->bcache, blk_id, blk_cnt, buf);
 }
 
 //==============================================================================
@@ -35,7 +35,11 @@
 /*==============================================================================
   Local symbolic constants/macros
 ==============================================================================*/
-#define MUTEX_TIMEOUT   5000
+#define MUTEX_TIMEOUT           5000
+#define CLMT_MIN_CLUSTERS       8       // files with less clusters are not mapped
+#define CLMT_INIT_FRAGMENTS     8       // fragments allocated at first map creation
+#define CLMT_SPARE_FRAGMENTS    4       // fragments reserved for appended clusters
+#define CLMT_ITEMS(_frags)      (2 * (_frags) + 2)
 
 /*==============================================================================
   Local types, enums definitions
@@ -45,13 +49,22 @@ struct fatdir {
         char name[(FF_MAX_LFN + 1) * sizeof(TCHAR)];
 };
 
+struct fatfile {
+        FIL       fil;
+        DWORD    *clmt;                 // cluster link map table (NULL: not created)
+        size_t    clmt_items;           // size of cluster link map table
+        bool      clmt_failed;          // file is too fragmented to be mapped
+};
+
 struct fatfs {
-        FILE    *fsfile;
-        FATFS    fatfs;
-        llist_t *file_list;
-        mutex_t *mutex;
-        int      opened_dirs;
-        bool     read_only;
+        FILE     *fsfile;
+        bcache_t *bcache;
+        FATFS     fatfs;
+        llist_t  *file_list;
+        mutex_t  *mutex;
+        int       opened_dirs;
+        size_t    clmt_max;             // maximum number of mapped fragments per file
+        bool      read_only;
 };
 
 /*==============================================================================
@@ -60,6 +73,10 @@ struct fatfs {
 static int    faterr_2_errno(FRESULT fresult);
 static time_t time_fat2unix(uint32_t fattime);
 static int    cmp_ptr(const void *a, const void *b);
+static void   create_map(struct fatfs *hdl, struct fatfile *file);
+static size_t drop_map(struct fatfile *file);
+static int    seek(struct fatfs *hdl, struct fatfile *file, fpos_t pos);
+static size_t release_maps(void *arg, size_t size);
 
 /*==============================================================================
   Local object definitions
@@ -86,13 +103,12 @@ static int    cmp_ptr(const void *a, const void *b);
 //==============================================================================
 API_FS_INIT(fatfs, void **fs_handle, const char *src_path, const char *opts)
 {
-        UNUSED_ARG1(opts);
-
         int err = sys_zalloc(sizeof(struct fatfs), fs_handle);
         if (!err) {
                 struct fatfs *hdl = *fs_handle;
 
                 hdl->read_only = sys_stropt_is_flag(opts, "ro");
+                hdl->clmt_max  = sys_stropt_get_int(opts, "clmt", __FATFS_CLUSTER_MAP_SIZE__);
 
                 err = sys_llist_create(cmp_ptr, NULL, &hdl->file_list);
 
@@ -105,13 +121,33 @@ API_FS_INIT(fatfs, void **fs_handle, const char *src_path, const char *opts)
                 }
 
                 if (!err) {
-                        err = faterr_2_errno(f_mount(&hdl->fatfs, hdl->fsfile, 1));
+                        err = sys_bcache_create(hdl->fsfile, FF_MIN_SS,
+                                                sys_stropt_get_int(opts, "cache",
+                                                                   __OS_SYSTEM_BLOCK_CACHE_SIZE__),
+                                                sys_stropt_is_flag(opts, "sync"),
+                                                &hdl->bcache);
+                }
+
+                if (!err) {
+                        err = sys_bcache_set_readahead(hdl->bcache,
+                                                       sys_stropt_get_int(opts, "ra",
+                                                                          __OS_SYSTEM_BLOCK_CACHE_READAHEAD__));
+                }
+
+                if (!err) {
+                        err = faterr_2_errno(f_mount(&hdl->fatfs, hdl->bcache, 1));
                 }
 
                 if (!err) {
                         if (hdl->read_only) {
                                 printk("FATFS: read only file system");
                         }
+
+                        if (hdl->clmt_max > 0) {
+                                if (sys_bcache_register_shrinker(release_maps, hdl) != ESUCC) {
+                                        hdl->clmt_max = 0;
+                                }
+                        }
                 }
 
                 if (err) {
@@ -123,6 +159,10 @@ API_FS_INIT(fatfs, void **fs_handle, const char *src_path, const char *opts)
                                 sys_llist_destroy(hdl->file_list);
                         }
 
+                        if (hdl->bcache) {
+                                sys_bcache_destroy(hdl->bcache);
+                        }
+
                         if (hdl->fsfile) {
                                 sys_fclose(hdl->fsfile);
                         }
@@ -151,6 +191,11 @@ API_FS_RELEASE(fatfs, void *fs_handle)
         if ((hdl->opened_dirs == 0) && (sys_llist_size(hdl->file_list) == 0)) {
                 err = faterr_2_errno(f_unmount(&hdl->fatfs));
                 if (!err or hdl->read_only) {
+                        if (hdl->clmt_max > 0) {
+                                sys_bcache_unregister_shrinker(release_maps, hdl);
+                        }
+
+                        sys_bcache_destroy(hdl->bcache);
                         sys_fclose(hdl->fsfile);
                         sys_mutex_destroy(hdl->mutex);
                         sys_llist_destroy(hdl->file_list);
@@ -179,12 +224,13 @@ API_FS_OPEN(fatfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
 {
         struct fatfs *hdl = fs_handle;
 
-        int err = sys_zalloc(sizeof(FIL), fhdl);
+        int err = sys_zalloc(sizeof(struct fatfile), fhdl);
         if (err) {
                 return err;
         }
 
-        FIL *fat_file = *fhdl;
+        struct fatfile *file = *fhdl;
+        FIL *fat_file = &file->fil;
 
         u8_t fat_mode = 0;
 
@@ -234,7 +280,7 @@ API_FS_OPEN(fatfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
         }
 
         if (sys_mutex_lock(hdl->mutex, MUTEX_TIMEOUT) == 0) {
-                sys_llist_push_back(hdl->file_list, fat_file);
+                sys_llist_push_back(hdl->file_list, file);
                 sys_mutex_unlock(hdl->mutex);
         }
 
@@ -258,14 +304,19 @@ API_FS_CLOSE(fatfs, void *fs_handle, void *fhdl, bool force)
 
         struct fatfs *hdl = fs_handle;
 
-        FIL *fatfile = fhdl;
+        struct fatfile *file = fhdl;
 
         int err = sys_mutex_lock(hdl->mutex, MUTEX_TIMEOUT);
         if (!err) {
-                err = faterr_2_errno(f_close(fatfile));
+                err = faterr_2_errno(f_close(&file->fil));
                 if (!err or hdl->read_only) {
-                        int pos = sys_llist_find_begin(hdl->file_list, fatfile);
+                        int pos = sys_llist_find_begin(hdl->file_list, file);
                         sys_llist_take(hdl->file_list, pos);
+
+                        if (file->clmt) {
+                                sys_free(cast(void**, &file->clmt));
+                        }
+
                         sys_free(&fhdl);
                         err = 0;
                 }
@@ -302,16 +353,13 @@ API_FS_WRITE(fatfs,
 {
         UNUSED_ARG1(fattr);
 
-        struct fatfs *hdl = fs_handle;
-        FIL *fat_file = fhdl;
-        int  err      = EROFS;
+        struct fatfs   *hdl      = fs_handle;
+        struct fatfile *file     = fhdl;
+        FIL            *fat_file = &file->fil;
+        int             err      = EROFS;
 
         if (not hdl->read_only) {
-                if (f_tell(fat_file) != (u32_t)*fpos) {
-                        err = faterr_2_errno(f_lseek(fat_file, (u32_t)*fpos));
-                } else {
-                        err = ESUCC;
-                }
+                err = seek(hdl, file, *fpos);
 
                 if (!err) {
                         uint n = 0;
@@ -349,14 +397,13 @@ API_FS_READ(fatfs,
             size_t          *rdcnt,
             struct vfs_fattr fattr)
 {
-        UNUSED_ARG2(fs_handle, fattr);
+        UNUSED_ARG1(fattr);
 
-        FIL *fat_file = fhdl;
-        int  err      = ESUCC;
+        struct fatfs   *hdl      = fs_handle;
+        struct fatfile *file     = fhdl;
+        FIL            *fat_file = &file->fil;
 
-        if (f_tell(fat_file) != (u32_t)*fpos) {
-                err = faterr_2_errno(f_lseek(fat_file, (u32_t)*fpos));
-        }
+        int err = seek(hdl, file, *fpos);
 
         if (!err) {
                 uint n = 0;
@@ -369,6 +416,113 @@ API_FS_READ(fatfs,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Write multiple buffers to the file. File position is set once for
+ *        entire vector.
+ *
+ * @param[in ]          *fs_handle              file system allocated memory
+ * @param[in ]          *fhdl                   file handle
+ * @param[in ]          *iov                    data sources
+ * @param[in ]           iovcnt                 number of buffers
+ * @param[in ]          *fpos                   position in file
+ * @param[out]          *wrcnt                  number of written bytes
+ * @param[in ]           fattr                  file attributes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+API_FS_WRITEV(fatfs,
+              void               *fs_handle,
+              void               *fhdl,
+              const struct iovec *iov,
+              int                 iovcnt,
+              fpos_t             *fpos,
+              size_t             *wrcnt,
+              struct vfs_fattr    fattr)
+{
+        UNUSED_ARG1(fattr);
+
+        struct fatfs   *hdl      = fs_handle;
+        struct fatfile *file     = fhdl;
+        FIL            *fat_file = &file->fil;
+        int             err      = EROFS;
+
+        if (not hdl->read_only) {
+                err = seek(hdl, file, *fpos);
+
+                for (int i = 0; !err && (i < iovcnt); i++) {
+                        uint n = 0;
+                        err = faterr_2_errno(f_write(fat_file, iov[i].iov_base, iov[i].iov_len, &n));
+                        if (!err) {
+                                *wrcnt += n;
+
+                                if (n < iov[i].iov_len) {
+                                        break;
+                                }
+                        }
+                }
+
+                if (*wrcnt > 0) {
+                        err = ESUCC;
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Read file to multiple buffers. File position is set once for entire
+ *        vector.
+ *
+ * @param[in ]          *fs_handle              file system allocated memory
+ * @param[in ]          *fhdl                   file handle
+ * @param[out]          *iov                    data destinations
+ * @param[in ]           iovcnt                 number of buffers
+ * @param[in ]          *fpos                   position in file
+ * @param[out]          *rdcnt                  number of read bytes
+ * @param[in ]           fattr                  file attributes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+API_FS_READV(fatfs,
+             void               *fs_handle,
+             void               *fhdl,
+             const struct iovec *iov,
+             int                 iovcnt,
+             fpos_t             *fpos,
+             size_t             *rdcnt,
+             struct vfs_fattr    fattr)
+{
+        UNUSED_ARG1(fattr);
+
+        struct fatfs   *hdl      = fs_handle;
+        struct fatfile *file     = fhdl;
+        FIL            *fat_file = &file->fil;
+
+        int err = seek(hdl, file, *fpos);
+
+        for (int i = 0; !err && (i < iovcnt); i++) {
+                uint n = 0;
+                err = faterr_2_errno(f_read(fat_file, iov[i].iov_base, iov[i].iov_len, &n));
+                if (!err) {
+                        *rdcnt += n;
+
+                        if (n < iov[i].iov_len) {
+                                break;
+                        }
+                }
+        }
+
+        if (*rdcnt > 0) {
+                err = ESUCC;
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief IO operations on files
@@ -405,8 +559,8 @@ API_FS_FLUSH(fatfs, void *fs_handle, void *fhdl)
 {
         UNUSED_ARG1(fs_handle);
 
-        FIL *fat_file = fhdl;
-        return faterr_2_errno(f_sync(fat_file));
+        struct fatfile *file = fhdl;
+        return faterr_2_errno(f_sync(&file->fil));
 }
 
 //==============================================================================
@@ -687,7 +841,8 @@ API_FS_FSTAT(fatfs, void *fs_handle, void *fhdl, struct stat *stat)
 {
         UNUSED_ARG1(fs_handle);
 
-        FIL *fat_file = fhdl;
+        struct fatfile *file     = fhdl;
+        FIL            *fat_file = &file->fil;
 
         stat->st_dev   = 0;
         stat->st_gid   = 0;
@@ -797,10 +952,12 @@ API_FS_SYNC(fatfs, void *fs_handle)
                 int err = sys_mutex_lock(hdl->mutex, MUTEX_TIMEOUT);
                 if (!err) {
 
-                        sys_llist_foreach(FIL*, f, hdl->file_list) {
-                                f_sync(f);
+                        sys_llist_foreach(struct fatfile*, f, hdl->file_list) {
+                                f_sync(&f->fil);
                         }
 
+                        err = sys_bcache_flush(hdl->bcache);
+
                         sys_mutex_unlock(hdl->mutex);
                 }
 
@@ -810,6 +967,169 @@ API_FS_SYNC(fatfs, void *fs_handle)
         }
 }
 
+//==============================================================================
+/**
+ * @brief Function create cluster link map table of file. Map is created only
+ *        for files that occupy many clusters. If file is fragmented more than
+ *        allowed map size then map is not created and chain is followed at
+ *        each seek. File system mutex must be locked.
+ *
+ * @param hdl           file system handle
+ * @param file          file
+ */
+//==============================================================================
+static void create_map(struct fatfs *hdl, struct fatfile *file)
+{
+        FIL  *fat_file = &file->fil;
+        u64_t clusize  = cast(u64_t, hdl->fatfs.csize) * FF_MAX_SS;
+        u64_t clusters = (f_size(fat_file) + clusize - 1) / clusize;
+
+        if (file->clmt || file->clmt_failed || (clusters < CLMT_MIN_CLUSTERS)) {
+                return;
+        }
+
+        size_t frags = min(hdl->clmt_max, CLMT_INIT_FRAGMENTS);
+
+        for (int attempt = 0; attempt < 2; attempt++) {
+                size_t items = CLMT_ITEMS(frags);
+                DWORD *tbl   = NULL;
+
+                if (sys_malloc(items * sizeof(DWORD), cast(void**, &tbl)) != ESUCC) {
+                        return;
+                }
+
+                tbl[0] = items;
+                fat_file->cltbl = tbl;
+
+                FRESULT fr = f_lseek(fat_file, CREATE_LINKMAP);
+                if (fr == FR_OK) {
+                        tbl[0]           = items;       // table size is used to append clusters
+                        file->clmt       = tbl;
+                        file->clmt_items = items;
+                        return;
+                }
+
+                DWORD required  = tbl[0];
+                fat_file->cltbl = NULL;
+                sys_free(cast(void**, &tbl));
+
+                if (fr != FR_NOT_ENOUGH_CORE) {
+                        return;
+                }
+
+                size_t needed = (required - 2) / 2;
+                if (needed > hdl->clmt_max) {
+                        file->clmt_failed = true;
+                        return;
+                }
+
+                frags = min(hdl->clmt_max, needed + CLMT_SPARE_FRAGMENTS);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function release cluster link map table of file. File system mutex
+ *        must be locked.
+ *
+ * @param file          file
+ *
+ * @return Number of released bytes.
+ */
+//==============================================================================
+static size_t drop_map(struct fatfile *file)
+{
+        size_t size = 0;
+
+        if (file->clmt) {
+                size = file->clmt_items * sizeof(DWORD);
+                file->fil.cltbl  = NULL;
+                file->clmt_items = 0;
+                sys_free(cast(void**, &file->clmt));
+        }
+
+        return size;
+}
+
+//==============================================================================
+/**
+ * @brief Function set file position. Cluster map is created lazily at first
+ *        seek in a large file, so seek does not follow FAT chain from the
+ *        beginning of file. Map that was filled up by appended clusters is
+ *        recreated.
+ *
+ * @param hdl           file system handle
+ * @param file          file
+ * @param pos           new position
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int seek(struct fatfs *hdl, struct fatfile *file, fpos_t pos)
+{
+        FIL    *fat_file = &file->fil;
+        FSIZE_t ofs      = pos;
+
+        if (f_tell(fat_file) == ofs) {
+                return ESUCC;
+        }
+
+        if ((hdl->clmt_max > 0) && (sys_mutex_lock(hdl->mutex, MUTEX_TIMEOUT) == ESUCC)) {
+
+                // map is full (disabled by append) or file is expanded by seek
+                if ((fat_file->cltbl != file->clmt) || (ofs > f_size(fat_file))) {
+                        drop_map(file);
+                }
+
+                if (ofs <= f_size(fat_file)) {
+                        create_map(hdl, file);
+                }
+
+                sys_mutex_unlock(hdl->mutex);
+        }
+
+        return faterr_2_errno(f_lseek(fat_file, ofs));
+}
+
+//==============================================================================
+/**
+ * @brief Function release cluster maps of opened files. Called by block cache
+ *        when system is running out of memory. Function never blocks: file
+ *        system that is in use is skipped.
+ *
+ * @param arg           file system handle
+ * @param size          requested number of bytes to release
+ *
+ * @return Number of released bytes.
+ */
+//==============================================================================
+static size_t release_maps(void *arg, size_t size)
+{
+        struct fatfs *hdl   = arg;
+        size_t        freed = 0;
+
+        if (sys_mutex_lock(hdl->mutex, 0) == ESUCC) {
+
+                // volume lock guarantees that maps are not used by FatFs
+                if (sys_mutex_lock(hdl->fatfs.sobj, 0) == ESUCC) {
+
+                        sys_llist_foreach(struct fatfile*, file, hdl->file_list) {
+                                if (freed >= size) {
+                                        break;
+                                }
+
+                                freed += drop_map(file);
+                        }
+
+                        sys_mutex_unlock(hdl->fatfs.sobj);
+                }
+
+                sys_mutex_unlock(hdl->mutex);
+        }
+
+        return freed;
+}
+
 //==============================================================================
 /**
  * @brief Function handle libfat errors and translate to errno
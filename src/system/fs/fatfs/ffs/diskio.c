@@ -21,7 +21,7 @@
 /*-----------------------------------------------------------------------*/
 
 DSTATUS disk_status (
-	FILE *pdrv		/* Physical drive nmuber to identify the drive */
+	bcache_t *pdrv		/* Physical drive nmuber to identify the drive */
 )
 {
         UNUSED_ARG1(pdrv);
@@ -35,7 +35,7 @@ DSTATUS disk_status (
 /*-----------------------------------------------------------------------*/
 
 DSTATUS disk_initialize (
-	FILE *pdrv				/* Physical drive nmuber to identify the drive */
+	bcache_t *pdrv				/* Physical drive nmuber to identify the drive */
 )
 {
         UNUSED_ARG1(pdrv);
@@ -49,16 +49,14 @@ DSTATUS disk_initialize (
 /*-----------------------------------------------------------------------*/
 
 DRESULT disk_read (
-	FILE *pdrv,		/* Physical drive nmuber to identify the drive */
+	bcache_t *pdrv,		/* Physical drive nmuber to identify the drive */
 	BYTE *buff,		/* Data buffer to store read data */
 	LBA_t sector,	/* Start sector in LBA */
 	UINT count		/* Number of sectors to read */
 )
 {
-        size_t rdcnt = 0;
-        sys_fseek(pdrv, sector * FF_MIN_SS, SEEK_SET);
-        return sys_fread(buff, count * FF_MIN_SS, &rdcnt, pdrv) == ESUCC ?
-                         RES_OK : RES_ERROR;
+        return sys_bcache_read(pdrv, sector, count, buff) == ESUCC ?
+                               RES_OK : RES_ERROR;
 }
 
 
@@ -70,16 +68,14 @@ DRESULT disk_read (
 #if FF_FS_READONLY == 0
 
 DRESULT disk_write (
-	FILE *pdrv,			/* Physical drive nmuber to identify the drive */
+	bcache_t *pdrv,			/* Physical drive nmuber to identify the drive */
 	const BYTE *buff,	/* Data to be written */
 	LBA_t sector,		/* Start sector in LBA */
 	UINT count			/* Number of sectors to write */
 )
 {
-        size_t wrcnt = 0;
-        sys_fseek(pdrv, sector * FF_MIN_SS, SEEK_SET);
-        return sys_fwrite(buff, count * FF_MIN_SS, &wrcnt, pdrv) == ESUCC ?
-                          RES_OK : RES_ERROR;
+        return sys_bcache_write(pdrv, sector, count, buff) == ESUCC ?
+                                RES_OK : RES_ERROR;
 }
 
 #endif
@@ -90,12 +86,16 @@ DRESULT disk_write (
 /*-----------------------------------------------------------------------*/
 
 DRESULT disk_ioctl (
-	FILE *pdrv,		/* Physical drive nmuber (0..) */
+	bcache_t *pdrv,		/* Physical drive nmuber (0..) */
 	BYTE cmd,		/* Control code */
 	void *buff		/* Buffer to send/receive control data */
 )
 {
-        UNUSED_ARG3(pdrv, cmd, buff);
+        UNUSED_ARG1(buff);
+
+        if (cmd == CTRL_SYNC) {
+                return sys_bcache_flush(pdrv) == ESUCC ? RES_OK : RES_ERROR;
+        }
 
         return RES_OK;
 }
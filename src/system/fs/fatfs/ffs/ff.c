@@ -1662,6 +1662,35 @@ static DWORD clmt_clust (	/* <2:Error, >=2:Cluster number */
 	return cl + *tbl;	/* Return the cluster number */
 }
 
+
+#if !FF_FS_READONLY
+/*-----------------------------------------------------------------------*/
+/* FAT handling - Append a cluster stretched by write to the link map    */
+/*-----------------------------------------------------------------------*/
+/* The first item of the table has to keep the table size (in items).    */
+
+static void clmt_append (
+	FIL* fp,		/* Pointer to the file object */
+	DWORD clst		/* Cluster appended to the chain */
+)
+{
+	DWORD ulen, *tbl, *frag = 0;
+
+
+	tbl = fp->cltbl + 1; ulen = 2;	/* Top of CLMT and used items */
+	while (*tbl) {			/* Find the last fragment */
+		frag = tbl; tbl += 2; ulen += 2;
+	}
+	if (frag && frag[1] + frag[0] == clst) {	/* Contiguous to the last fragment? */
+		frag[0]++;
+	} else if (ulen + 2 <= *fp->cltbl) {	/* Room for a new fragment? */
+		tbl[0] = 1; tbl[1] = clst; tbl[2] = 0;
+	} else {
+		fp->cltbl = 0;		/* Table is full, disable fast seek mode */
+	}
+}
+#endif
+
 #endif	/* FF_USE_FASTSEEK */
 
 
@@ -3632,7 +3661,7 @@ static FRESULT validate (	/* Returns FR_OK or FR_INVALID_OBJECT */
 
 FRESULT f_mount (
 	FATFS* fs,			/* Pointer to the filesystem object (NULL:unmount)*/
-	FILE* pdrv,	/* Logical drive number to be mounted/unmounted */
+	bcache_t* pdrv,	/* Logical drive number to be mounted/unmounted */
 	BYTE opt			/* Mode option 0:Do not mount (delayed mount), 1:Mount immediately */
 )
 {
@@ -4010,6 +4039,10 @@ FRESULT f_write (
 #if FF_USE_FASTSEEK
 					if (fp->cltbl) {
 						clst = clmt_clust(fp, fp->fptr);	/* Get cluster# from the CLMT */
+						if (clst == 0) {		/* Beyond the CLMT (appending)? */
+							clst = create_chain(&fp->obj, fp->clust);	/* Stretch cluster chain */
+							if (clst >= 2 && clst != 0xFFFFFFFF) clmt_append(fp, clst);	/* and the CLMT */
+						}
 					} else
 #endif
 					{
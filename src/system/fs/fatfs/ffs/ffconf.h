@@ -42,8 +42,9 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
-#define FF_USE_FASTSEEK	0
-/* This option switches fast seek function. (0:Disable or 1:Enable) */
+#define FF_USE_FASTSEEK	1
+/* This option switches fast seek function. (0:Disable or 1:Enable)
+/  Cluster link map tables are created and extended automatically by fatfs.c */
 
 
 #define FF_USE_EXPAND	0
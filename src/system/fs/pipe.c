@@ -34,7 +34,10 @@
 #include "dnx/misc.h"
 #include "libc/errno.h"
 #include "kernel/kwrapper.h"
+#include "kernel/kpoll.h"
+#include "fs/vfs.h"
 #include "fs/pipe.h"
+#include <string.h>
 
 /*==============================================================================
   Local macros
@@ -46,9 +49,16 @@
   Local object types
 ==============================================================================*/
 struct pipe {
-        queue_t     *queue;
-        struct pipe *self;
-        u32_t        flag;
+        mutex_t     *mtx;               /*!< ring buffer access mutex */
+        sem_t       *rd_sem;            /*!< data available or pipe closed event */
+        sem_t       *wr_sem;            /*!< free space available event */
+        struct pipe *self;              /*!< object validation */
+        u32_t        flag;              /*!< pipe flags */
+        size_t       head;              /*!< write index */
+        size_t       tail;              /*!< read index */
+        size_t       level;             /*!< number of bytes in buffer */
+        size_t       wr_pending;        /*!< number of writers waiting for space */
+        u8_t         buf[];             /*!< ring buffer */
 };
 
 /*==============================================================================
@@ -61,6 +71,8 @@ struct pipe {
 #if __OS_ENABLE_MKFIFO__ == _YES_
 static const u32_t PIPE_READ_TIMEOUT  = MAX_DELAY_MS;
 static const u32_t PIPE_WRITE_TIMEOUT = MAX_DELAY_MS;
+static const u32_t PIPE_SHORT_TIMEOUT = 10;
+static const size_t PIPE_SIZE         = __OS_PIPE_LENGTH__;
 #endif
 
 /*==============================================================================
@@ -87,6 +99,56 @@ static bool is_valid(pipe_t *this)
 {
         return this && this->self == this;
 }
+
+//==============================================================================
+/**
+ * @brief  Copy data from ring buffer. Pipe mutex must be locked.
+ *
+ * @param  this         pipe object
+ * @param  dst          destination buffer
+ * @param  count        max number of bytes to copy
+ *
+ * @return Number of copied bytes.
+ */
+//==============================================================================
+static size_t ring_get(pipe_t *this, u8_t *dst, size_t count)
+{
+        size_t n = min(count, this->level);
+
+        size_t span = min(n, PIPE_SIZE - this->tail);
+        memcpy(dst, &this->buf[this->tail], span);
+        memcpy(&dst[span], this->buf, n - span);
+
+        this->tail   = (this->tail + n) % PIPE_SIZE;
+        this->level -= n;
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief  Copy data to ring buffer. Pipe mutex must be locked.
+ *
+ * @param  this         pipe object
+ * @param  src          source buffer
+ * @param  count        max number of bytes to copy
+ *
+ * @return Number of copied bytes.
+ */
+//==============================================================================
+static size_t ring_put(pipe_t *this, const u8_t *src, size_t count)
+{
+        size_t n = min(count, PIPE_SIZE - this->level);
+
+        size_t span = min(n, PIPE_SIZE - this->head);
+        memcpy(&this->buf[this->head], src, span);
+        memcpy(this->buf, &src[span], n - span);
+
+        this->head   = (this->head + n) % PIPE_SIZE;
+        this->level += n;
+
+        return n;
+}
 #endif
 
 //==============================================================================
@@ -104,14 +166,32 @@ int _pipe_create(pipe_t **pipe)
         int err = EINVAL;
 
         if (pipe) {
-                err = _kmalloc(_MM_KRN, sizeof(pipe_t), NULL, 0, 0, cast(void**, pipe));
+                err = _kzalloc(_MM_KRN, sizeof(pipe_t) + PIPE_SIZE,
+                               NULL, 0, 0, cast(void**, pipe));
                 if (!err) {
+                        pipe_t *this = *pipe;
+
+                        err = _mutex_create(MUTEX_TYPE_NORMAL, &this->mtx);
+                        if (err) goto finish;
+
+                        err = _semaphore_create(1, 0, &this->rd_sem);
+                        if (err) goto finish;
+
+                        err = _semaphore_create(1, 0, &this->wr_sem);
+                        if (err) goto finish;
+
+                        this->self = this;
+
+                        finish:
+                        if (err) {
+                                if (this->mtx) {
+                                        _mutex_destroy(this->mtx);
+                                }
+
+                                if (this->rd_sem) {
+                                        _semaphore_destroy(this->rd_sem);
+                                }
 
-                        err = _queue_create(__OS_PIPE_LENGTH__, sizeof(u8_t), &(*pipe)->queue);
-                        if (err == ESUCC) {
-                                (*pipe)->self = *pipe;
-                                (*pipe)->flag = 0;
-                        } else {
                                 _kfree(_MM_KRN, cast(void**, pipe));
                         }
                 }
@@ -137,7 +217,9 @@ int _pipe_destroy(pipe_t *pipe)
 {
 #if __OS_ENABLE_MKFIFO__ == _YES_
         if (is_valid(pipe)) {
-                _queue_destroy(pipe->queue);
+                _mutex_destroy(pipe->mtx);
+                _semaphore_destroy(pipe->rd_sem);
+                _semaphore_destroy(pipe->wr_sem);
                 pipe->self = NULL;
                 _kfree(_MM_KRN, cast(void**, &pipe));
                 return ESUCC;
@@ -164,7 +246,8 @@ int _pipe_get_length(pipe_t *pipe, size_t *len)
 {
 #if __OS_ENABLE_MKFIFO__ == _YES_
         if (len && is_valid(pipe)) {
-                return _queue_get_number_of_items(pipe->queue, len);
+                *len = pipe->level;
+                return ESUCC;
         } else {
                 return EINVAL;
         }
@@ -178,6 +261,11 @@ int _pipe_get_length(pipe_t *pipe, size_t *len)
 /**
  * @brief Read data from pipe
  *
+ * Function copies all available data at once. If buffer is empty then
+ * function waits for data. When writer is blocked on full buffer then
+ * reading is continued until requested count is reached or writer stops
+ * delivering data for a short time.
+ *
  * @param pipe          a pipe object
  * @param buf           a destination buffer
  * @param count         a count of bytes to read
@@ -193,19 +281,37 @@ int _pipe_read(pipe_t *pipe, u8_t *buf, size_t count, size_t *rdcnt, bool non_bl
         if (is_valid(pipe) && buf && count) {
 
                 size_t n = 0;
-                for (; n < count; n++) {
 
-                        size_t noitm = 0;
-                        _queue_get_number_of_items(pipe->queue, &noitm);
+                while (n < count) {
+                        if (_mutex_lock(pipe->mtx, PIPE_READ_TIMEOUT) != ESUCC) {
+                                break;
+                        }
+
+                        size_t got     = ring_get(pipe, &buf[n], count - n);
+                        bool   eof     = (pipe->flag & CLOSED) && (pipe->level == 0);
+                        bool   writing = pipe->wr_pending > 0;
+                        bool   more    = pipe->level > 0;
+
+                        _mutex_unlock(pipe->mtx);
+
+                        n += got;
+
+                        if (got) {
+                                _semaphore_signal(pipe->wr_sem);
+                                _kpoll_notify(pipe);
+                        }
 
-                        if ((pipe->flag & CLOSED) && noitm == 0) {
-                                u8_t null = '\0';
-                                _queue_send(pipe->queue, &null, PIPE_WRITE_TIMEOUT);
+                        if (more or eof) {
+                                // wake up other readers, EOF is signaled to all of them
+                                _semaphore_signal(pipe->rd_sem);
+                        }
+
+                        if (eof or (n == count) or (n > 0 and not writing)) {
                                 break;
                         }
 
-                        u32_t tout = non_blocking || n ? 10 : PIPE_READ_TIMEOUT;
-                        if (_queue_receive(pipe->queue, &buf[n], tout) != ESUCC) {
+                        u32_t tout = non_blocking || n ? PIPE_SHORT_TIMEOUT : PIPE_READ_TIMEOUT;
+                        if (_semaphore_wait(pipe->rd_sem, tout) != ESUCC) {
                                 break;
                         }
                 }
@@ -223,7 +329,10 @@ int _pipe_read(pipe_t *pipe, u8_t *buf, size_t count, size_t *rdcnt, bool non_bl
 
 //==============================================================================
 /**
- * @brief Read data from pipe
+ * @brief Write data to pipe
+ *
+ * Function copies as many data as fit in buffer at once and waits for free
+ * space only when buffer is full.
  *
  * @param pipe          a pipe object
  * @param buf           a destination buffer
@@ -240,17 +349,49 @@ int _pipe_write(pipe_t *pipe, const u8_t *buf, size_t count, size_t *wrcnt, bool
         if (is_valid(pipe) && buf && count) {
 
                 size_t n = 0;
-                for (; n < count; n++) {
 
-                        size_t noitm = 0;
-                        _queue_get_number_of_items(pipe->queue, &noitm);
+                while (n < count) {
+                        if (_mutex_lock(pipe->mtx, PIPE_WRITE_TIMEOUT) != ESUCC) {
+                                break;
+                        }
 
-                        if ((pipe->flag & CLOSED) && noitm == 0) {
+                        if ((pipe->flag & CLOSED) && pipe->level == 0) {
+                                _mutex_unlock(pipe->mtx);
                                 break;
                         }
 
-                        u32_t tout = non_blocking ? 10 : PIPE_WRITE_TIMEOUT;
-                        if (_queue_send(pipe->queue, &buf[n], tout) != ESUCC) {
+                        size_t put   = ring_put(pipe, &buf[n], count - n);
+                        bool   space = pipe->level < PIPE_SIZE;
+
+                        n += put;
+
+                        if (n < count) {
+                                pipe->wr_pending++;
+                        }
+
+                        _mutex_unlock(pipe->mtx);
+
+                        if (put) {
+                                _semaphore_signal(pipe->rd_sem);
+                                _kpoll_notify(pipe);
+                        }
+
+                        if (n == count) {
+                                if (space) {
+                                        // wake up other writers
+                                        _semaphore_signal(pipe->wr_sem);
+                                }
+                                break;
+                        }
+
+                        u32_t tout = non_blocking ? PIPE_SHORT_TIMEOUT : PIPE_WRITE_TIMEOUT;
+                        int err = _semaphore_wait(pipe->wr_sem, tout);
+
+                        _mutex_lock(pipe->mtx, PIPE_WRITE_TIMEOUT);
+                        pipe->wr_pending--;
+                        _mutex_unlock(pipe->mtx);
+
+                        if (err) {
                                 break;
                         }
                 }
@@ -283,8 +424,9 @@ int _pipe_close(pipe_t *pipe)
                 if (not (pipe->flag & PERMANENT)) {
                         pipe->flag |= CLOSED;
 
-                        u8_t nul = '\0';
-                        _queue_send(pipe->queue, &nul, 10);
+                        _semaphore_signal(pipe->rd_sem);
+                        _semaphore_signal(pipe->wr_sem);
+                        _kpoll_notify(pipe);
                 }
 
                 return ESUCC;
@@ -310,7 +452,18 @@ int _pipe_clear(pipe_t *pipe)
 {
 #if __OS_ENABLE_MKFIFO__ == _YES_
         if (is_valid(pipe)) {
-                return _queue_reset(pipe->queue);
+                int err = _mutex_lock(pipe->mtx, PIPE_WRITE_TIMEOUT);
+                if (!err) {
+                        pipe->head  = 0;
+                        pipe->tail  = 0;
+                        pipe->level = 0;
+                        _mutex_unlock(pipe->mtx);
+
+                        _semaphore_signal(pipe->wr_sem);
+                        _kpoll_notify(pipe);
+                }
+
+                return err;
         } else {
                 return EINVAL;
         }
@@ -344,6 +497,51 @@ int _pipe_permanent(pipe_t *pipe)
 #endif
 }
 
+//==============================================================================
+/**
+ * @brief  Examine pipe readiness. Pipe object is notified when data is
+ *         written, read, cleared, or when pipe is closed.
+ *
+ * @param  pipe         a pipe object
+ * @param  poll         readiness request
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _pipe_poll(pipe_t *pipe, struct vfs_poll *poll)
+{
+#if __OS_ENABLE_MKFIFO__ == _YES_
+        if (is_valid(pipe) && poll) {
+                size_t level  = pipe->level;
+                bool   closed = pipe->flag & CLOSED;
+
+                poll->object  = pipe;
+                poll->revents = 0;
+
+                if (level > 0 || closed) {
+                        poll->revents |= POLLIN;
+                }
+
+                if (level < PIPE_SIZE) {
+                        poll->revents |= POLLOUT;
+                }
+
+                if (closed && level == 0) {
+                        poll->revents |= POLLHUP;
+                }
+
+                poll->revents &= poll->events;
+
+                return ESUCC;
+        } else {
+                return EINVAL;
+        }
+#else
+        UNUSED_ARG2(pipe, poll);
+        return ENOTSUP;
+#endif
+}
+
 /*==============================================================================
   End of file
 ==============================================================================*/
@@ -40,6 +40,7 @@
 #define PATH_ROOT_BIN                   "/bin"
 #define PATH_ROOT_PID                   "/pid"
 #define PATH_ROOT_CPUINFO               "/cpuinfo"
+#define PATH_ROOT_KMSG                  "/kmsg"
 
 #define FILE_BUFFER                     384
 #define PID_STR_LEN                     12
@@ -58,12 +59,14 @@ enum path_content {
         FILE_CONTENT_BIN,
         FILE_CONTENT_PID,
         FILE_CONTENT_CPUINFO,
+        FILE_CONTENT_KMSG,
         _FILE_CONTENT_COUNT
 };
 
 struct file_info {
         enum path_content content;
         int16_t           arg;
+        u32_t             seq;
 };
 
 struct dir_info {
@@ -81,6 +84,7 @@ static int    add_file_to_list   (struct procfs *hdl, int16_t arg, enum path_con
 static size_t get_file_content   (struct file_info *file, u8_t *buff, size_t size, i32_t seek);
 static void   buf_snprintf(u8_t *buf, size_t *size, size_t *clen, i32_t *seek, const char *fmt, ...);
 static size_t get_file_size(struct file_info *file);
+static size_t read_kmsg(struct file_info *file, u8_t *dst, size_t size);
 
 /*==============================================================================
   Local object definitions
@@ -276,6 +280,10 @@ API_FS_OPEN(procfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path
         } else if (isstreq(mpath, PATH_ROOT_CPUINFO)) {
                 err = add_file_to_list(hdl, 0, FILE_CONTENT_CPUINFO, fhdl);
 
+        // "/kmsg" path
+        } else if (isstreq(mpath, PATH_ROOT_KMSG)) {
+                err = add_file_to_list(hdl, 0, FILE_CONTENT_KMSG, fhdl);
+
         } else {
                 err = ENOENT;
         }
@@ -373,7 +381,11 @@ API_FS_READ(procfs,
         struct file_info *file = fhdl;
         int               err  = ENOENT;
 
-        if (file && file->content < _FILE_CONTENT_COUNT) {
+        if (file && file->content == FILE_CONTENT_KMSG) {
+                *rdcnt = read_kmsg(file, dst, count);
+                err = 0;
+
+        } else if (file && file->content < _FILE_CONTENT_COUNT) {
                 *rdcnt = get_file_content(file, dst, count, *fpos);
                 err = 0;
         }
@@ -592,7 +604,7 @@ API_FS_OPENDIR(procfs, void *fs_handle, const char *path, DIR *dir)
 
                 if (isstreq(opath, PATH_ROOT)) {
                         dirinfo->dir_name = PATH_ROOT;
-                        dir->d_items      = 3;
+                        dir->d_items      = 4;
 
                 } else if (isstreq(opath, PATH_ROOT_PID"/")) {
                         dirinfo->dir_name = PATH_ROOT_PID;
@@ -816,6 +828,11 @@ static int procfs_readdir_root(struct procfs *hdl, DIR *dir)
                 break;
         }
 
+        case 3:
+                dir->dirent.d_name = "kmsg";
+                dir->dirent.mode   = S_IRUSR | S_IRGRP | S_IROTH | S_IFREG;
+                break;
+
         default:
                 err = ENOENT;
                 break;
@@ -1031,6 +1048,58 @@ static size_t get_file_content(struct file_info *file, u8_t *buff, size_t size,
         return clen;
 }
 
+//==============================================================================
+/**
+ * @brief  Function read kernel log messages as text lines. File is a stream:
+ *         each opened file has own message cursor, so subsequent reads return
+ *         new messages only (file position is not used). Only whole lines are
+ *         returned unless line does not fit to empty buffer.
+ *
+ * @param  file         file information
+ * @param  dst          destination buffer
+ * @param  size         buffer size
+ *
+ * @return number of bytes written to buffer
+ */
+//==============================================================================
+static size_t read_kmsg(struct file_info *file, u8_t *dst, size_t size)
+{
+        size_t clen = 0;
+
+#if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
+        char msg[__OS_SYSTEM_MSG_COLS__];
+        char line[__OS_SYSTEM_MSG_COLS__ + 24];
+
+        while (clen < size) {
+                u32_t          seq = file->seq;
+                struct timeval t;
+
+                if (sys_printk_read(msg, sizeof(msg), &seq, &t) == 0) {
+                        break;
+                }
+
+                size_t len = sys_snprintf(line, sizeof(line), "[%u.%06u] %s\n",
+                                          cast(uint, t.tv_sec), cast(uint, t.tv_usec), msg);
+
+                if (len > size - clen) {
+                        if (clen > 0) {
+                                break;
+                        } else {
+                                len = size;
+                        }
+                }
+
+                memcpy(&dst[clen], line, len);
+                clen     += len;
+                file->seq = seq;
+        }
+#else
+        UNUSED_ARG3(file, dst, size);
+#endif
+
+        return clen;
+}
+
 //==============================================================================
 /**
  * @brief  Function fill buffer with text according to file position and buffer size.
@@ -38,16 +38,23 @@
 #define PIPE_LENGTH                     __OS_STREAM_BUFFER_LENGTH__
 #define PIPE_WRITE_TIMEOUT              1
 #define PIPE_READ_TIMEOUT               MAX_DELAY
-#define DATA_CHAIN_SIZE                 __RAMFS_FILE_CHAIN_SIZE__
+#define CHUNK_SIZE                      __RAMFS_FILE_CHAIN_SIZE__
+#define CHUNK_INDEX_SIZE                32
+#define DENTRY_TABLE_INIT_SIZE          16
 
 /*==============================================================================
   Local types, enums definitions
 ==============================================================================*/
-/** regular file data chain */
-typedef struct data_chain {
-        struct data_chain *next;
-        u8_t buf[DATA_CHAIN_SIZE];
-} data_chain_t;
+/** regular file chunk index block */
+typedef struct {
+        u8_t *chunk[CHUNK_INDEX_SIZE];
+} chunk_index_t;
+
+/** regular file chunk table (chunk n: index[n / CHUNK_INDEX_SIZE]) */
+typedef struct {
+        size_t         length;                  //!< number of index block slots
+        chunk_index_t *index[];                 //!< index blocks
+} chunk_table_t;
 
 /** node structure */
 typedef struct node {
@@ -58,11 +65,13 @@ typedef struct node {
         size_t           size;                  //!< file size
         time_t           mtime;                 //!< time of last modification
         time_t           ctime;                 //!< time of creation
+        struct node     *parent;                //!< parent directory
+        struct node     *dentry_next;           //!< next node in dentry table bucket
 
         union {
                 pipe_t       *pipe_t;
                 llist_t      *llist_t;
-                data_chain_t *data_chain_t;
+                chunk_table_t *chunk_table_t;
                 dev_t         dev_t;
         } data;
 } node_t;
@@ -80,16 +89,23 @@ struct RAMFS {
         mutex_t         *resource_mtx;          //!< lock mutex
         llist_t         *opended_files;         //!< list with opened files
         size_t           file_count;            //!< number of files
+        node_t         **dentry;                //!< (parent, name) hash table
+        size_t           dentry_size;           //!< number of dentry table buckets
 };
 
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
-static int  new_node                    (struct RAMFS *hdl, node_t *parent, char *filename, mode_t mode, i32_t *item, node_t **child);
-static int  delete_node                 (struct RAMFS *hdl, node_t *base, node_t *target, u32_t position);
-static int  get_node                    (const char *path, node_t *startnode, i32_t deep, i32_t *item, node_t **node);
+static int  new_node                    (struct RAMFS *hdl, node_t *parent, char *filename, mode_t mode, node_t **child);
+static int  delete_node                 (struct RAMFS *hdl, node_t *base, node_t *target);
+static int  get_node                    (struct RAMFS *hdl, const char *path, i32_t deep, node_t **node);
+static u32_t dentry_hash                (node_t *parent, const char *name, size_t len);
+static node_t *dentry_lookup            (struct RAMFS *hdl, node_t *parent, const char *name, size_t len);
+static int  dentry_insert               (struct RAMFS *hdl, node_t *node);
+static void dentry_remove               (struct RAMFS *hdl, node_t *node);
 static uint get_path_deep               (const char *path);
 static int  add_node_to_open_files_list (struct RAMFS *hdl, node_t *parent, node_t *child);
+static int  get_chunk                   (node_t *node, size_t n, bool create, u8_t **chunk);
 static void clear_regular_file          (node_t *node);
 static int  write_regular_file          (node_t *node, const u8_t *src, size_t count, fpos_t fpos, size_t *wrcnt);
 static int  read_regular_file           (node_t *node, u8_t *dst, size_t count, fpos_t fpos, size_t *rdcnt);
@@ -124,10 +140,18 @@ API_FS_INIT(ramfs, void **fs_handle, const char *src_path, const char *opts)
                 if (err)
                         goto finish;
 
-                err = sys_llist_create(NULL, NULL, cast(llist_t**, &hdl->root_dir.data.llist_t));
+                err = sys_llist_create(sys_llist_functor_cmp_pointers, NULL,
+                                       cast(llist_t**, &hdl->root_dir.data.llist_t));
+                if (err)
+                        goto finish;
+
+                err = sys_zalloc(DENTRY_TABLE_INIT_SIZE * sizeof(node_t*),
+                                 cast(void**, &hdl->dentry));
                 if (err)
                         goto finish;
 
+                hdl->dentry_size = DENTRY_TABLE_INIT_SIZE;
+
                 err = sys_llist_create(sys_llist_functor_cmp_pointers, NULL, &hdl->opended_files);
                 if (err)
                         goto finish;
@@ -147,6 +171,9 @@ API_FS_INIT(ramfs, void **fs_handle, const char *src_path, const char *opts)
                         if (hdl->opended_files)
                                 sys_llist_destroy(hdl->opended_files);
 
+                        if (hdl->dentry)
+                                sys_free(cast(void**, &hdl->dentry));
+
                         sys_free(fs_handle);
                 }
         }
@@ -195,7 +222,7 @@ API_FS_MKNOD(ramfs, void *fs_handle, const char *path, const dev_t dev)
 
                 // parent node must exist
                 node_t *parent;
-                err = get_node(path, &hdl->root_dir, -1, NULL, &parent);
+                err = get_node(hdl, path, -1, &parent);
                 if (!err) {
                         // create new node
                         char *basename = strrchr(path, '/') + 1;
@@ -208,7 +235,7 @@ API_FS_MKNOD(ramfs, void *fs_handle, const char *path, const dev_t dev)
                                 node_t *child;
                                 err = new_node(hdl, parent, child_name,
                                                S_IRWXU | S_IRGRP | S_IROTH | S_IFDEV,
-                                               NULL, &child);
+                                               &child);
                                 if (!err) {
                                         child->data.dev_t = dev;
                                 } else {
@@ -243,7 +270,7 @@ API_FS_MKDIR(ramfs, void *fs_handle, const char *path, mode_t mode)
 
                 // parent node must exist
                 node_t *parent;
-                err = get_node(path, &hdl->root_dir, -1, NULL, &parent);
+                err = get_node(hdl, path, -1, &parent);
                 if (!err) {
                         // create new node
                         char *basename = strrchr(path, '/') + 1;
@@ -256,7 +283,7 @@ API_FS_MKDIR(ramfs, void *fs_handle, const char *path, mode_t mode)
                                 node_t *child;
                                 err = new_node(hdl, parent, child_name,
                                                S_IPMT(mode) | S_IFDIR,
-                                               NULL, &child);
+                                               &child);
                                 if (err) {
                                         sys_free(cast(void**, &child_name));
                                 }
@@ -289,7 +316,7 @@ API_FS_MKFIFO(ramfs, void *fs_handle, const char *path, mode_t mode)
 
                 // parent node must exist
                 node_t *parent;
-                err = get_node(path, &hdl->root_dir, -1, NULL, &parent);
+                err = get_node(hdl, path, -1, &parent);
                 if (!err) {
                         // create new node
                         char *basename = strrchr(path, '/') + 1;
@@ -302,7 +329,7 @@ API_FS_MKFIFO(ramfs, void *fs_handle, const char *path, mode_t mode)
                                 node_t *child;
                                 err = new_node(hdl, parent, child_name,
                                                S_IPMT(mode) | S_IFIFO,
-                                               NULL, &child);
+                                               &child);
                                 if (err) {
                                         sys_free(cast(void**, &child_name));
                                 }
@@ -334,7 +361,7 @@ API_FS_OPENDIR(ramfs, void *fs_handle, const char *path, DIR *dir)
         if (!err) {
 
                 node_t *parent;
-                err = get_node(path, &hdl->root_dir, 0, NULL, &parent);
+                err = get_node(hdl, path, 0, &parent);
                 if (!err) {
                         if (S_ISDIR(parent->mode)) {
                                 dir->d_items    = sys_llist_size(parent->data.llist_t);
@@ -439,13 +466,13 @@ API_FS_REMOVE(ramfs, void *fs_handle, const char *path)
         if (!err) {
 
                 node_t *parent;
-                err = get_node(path, &hdl->root_dir, -1, NULL, &parent);
+                err = get_node(hdl, path, -1, &parent);
                 if (err){
                         goto finish;
                 }
 
-                i32_t item; node_t *child;
-                err = get_node(path, &hdl->root_dir, 0, &item, &child);
+                node_t *child;
+                err = get_node(hdl, path, 0, &child);
                 if (err) {
                         goto finish;
                 }
@@ -475,7 +502,7 @@ API_FS_REMOVE(ramfs, void *fs_handle, const char *path)
 
                 /* remove node if possible */
                 if (remove_file == true) {
-                        err = delete_node(hdl, parent, child, item);
+                        err = delete_node(hdl, parent, child);
                 } else {
                         err = ESUCC;
                 }
@@ -510,20 +537,33 @@ API_FS_RENAME(ramfs, void *fs_handle, const char *old_name, const char *new_name
         if (!err) {
 
                 node_t *target;
-                err = get_node(old_name, &hdl->root_dir, 0, NULL, &target);
+                err = get_node(hdl, old_name, 0, &target);
                 if (!err) {
-                        char *basename = strrchr(new_name, '/') + 1;
+                        char   *basename = strrchr(new_name, '/') + 1;
+                        node_t *existing = dentry_lookup(hdl, target->parent, basename, strlen(basename));
 
-                        char *newname;
-                        err = sys_zalloc(strsize(basename), cast(void**, &newname));
-                        if (!err) {
-                                strcpy(newname, basename);
+                        if (existing == target) {
+                                err = ESUCC;    // renamed to itself
 
-                                if (target->name) {
-                                        sys_free(cast(void**, target->name));
-                                }
+                        } else if (existing) {
+                                err = EEXIST;
 
-                                target->name = newname;
+                        } else {
+                                char *newname;
+                                err = sys_zalloc(strsize(basename), cast(void**, &newname));
+                                if (!err) {
+                                        strcpy(newname, basename);
+
+                                        dentry_remove(hdl, target);
+
+                                        if (target->name) {
+                                                sys_free(cast(void**, &target->name));
+                                        }
+
+                                        target->name = newname;
+
+                                        dentry_insert(hdl, target);
+                                }
                         }
                 }
 
@@ -552,7 +592,7 @@ API_FS_CHMOD(ramfs, void *fs_handle, const char *path, mode_t mode)
         if (!err) {
 
                 node_t *target;
-                err = get_node(path, &hdl->root_dir, 0, NULL, &target);
+                err = get_node(hdl, path, 0, &target);
                 if (!err) {
                         target->mode = S_IFMT(target->mode) | S_IPMT(mode);
                 }
@@ -583,7 +623,7 @@ API_FS_CHOWN(ramfs, void *fs_handle, const char *path, uid_t owner, gid_t group)
         if (!err) {
 
                 node_t *target;
-                err = get_node(path, &hdl->root_dir, 0, NULL, &target);
+                err = get_node(hdl, path, 0, &target);
                 if (!err) {
                         target->uid = owner;
                         target->gid = group;
@@ -665,7 +705,7 @@ API_FS_STAT(ramfs, void *fs_handle, const char *path, struct stat *stat)
         if (!err) {
 
                 node_t *target;
-                err = get_node(path, &hdl->root_dir, 0, NULL, &target);
+                err = get_node(hdl, path, 0, &target);
                 if (!err) {
                         if ( (strlch(path) == '/' && S_ISDIR(target->mode))
                            || strlch(path) != '/') {
@@ -734,14 +774,14 @@ API_FS_OPEN(ramfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
 
                 // open file parent
                 node_t *parent;
-                err = get_node(path, &hdl->root_dir, -1, NULL, &parent);
+                err = get_node(hdl, path, -1, &parent);
                 if (err) {
                         goto finish;
                 }
 
                 // try to open selected file, if not exist then try create if O_CREAT flag is set
-                i32_t item; node_t *child;
-                err = get_node(path, &hdl->root_dir, 0, &item, &child);
+                node_t *child;
+                err = get_node(hdl, path, 0, &child);
                 if (err == ENOENT) {
                         // check that file should be created
                         if (!(flags & O_CREAT)) {
@@ -758,8 +798,7 @@ API_FS_OPEN(ramfs, void *fs_handle, void **fhdl, fpos_t *fpos, const char *path,
 
                         strcpy(file_name, basename);
 
-                        err = new_node(hdl, parent, file_name, 0666 | S_IFREG,
-                                       &item, &child);
+                        err = new_node(hdl, parent, file_name, 0666 | S_IFREG, &child);
                         if (err) {
                                 sys_free(cast(void**, &file_name));
                                 goto finish;
@@ -856,8 +895,7 @@ API_FS_CLOSE(ramfs, void *fs_handle, void *fhdl, bool force)
                                         if (remove) {
                                                 err = delete_node(hdl,
                                                                   opened_file->parent,
-                                                                  opened_file->child,
-                                                                  pos);
+                                                                  opened_file->child);
                                         }
                                 } else {
                                         err = ESUCC;
@@ -1012,6 +1050,144 @@ API_FS_READ(ramfs,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Write multiple buffers to the file
+ *
+ * @param[in ]          *fs_handle              file system allocated memory
+ * @param[in ]          *fhdl                   file handle
+ * @param[in ]          *iov                    data sources
+ * @param[in ]           iovcnt                 number of buffers
+ * @param[in ]          *fpos                   position in file
+ * @param[out]          *wrcnt                  number of written bytes
+ * @param[in ]           fattr                  file attributes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+API_FS_WRITEV(ramfs,
+              void               *fs_handle,
+              void               *fhdl,
+              const struct iovec *iov,
+              int                 iovcnt,
+              fpos_t             *fpos,
+              size_t             *wrcnt,
+              struct vfs_fattr    fattr)
+{
+        struct RAMFS *hdl = fs_handle;
+
+        int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
+        if (!err) {
+
+                err = ENOENT;
+
+                struct opened_file_info *opened_file = fhdl;
+                if (opened_file && opened_file->child) {
+                        node_t *node = opened_file->child;
+
+                        sys_gettime(&node->mtime);
+
+                        if (S_ISDEV(node->mode)) {
+                                dev_t dev = node->data.dev_t;
+                                sys_mutex_unlock(hdl->resource_mtx);
+                                return sys_driver_writev(dev, iov, iovcnt, fpos, wrcnt, fattr);
+
+                        } else if (S_ISREG(node->mode)) {
+                                err = ESUCC;
+
+                                for (int i = 0; !err && (i < iovcnt); i++) {
+                                        err = write_regular_file(node, iov[i].iov_base,
+                                                                 iov[i].iov_len,
+                                                                 *fpos + *wrcnt, wrcnt);
+                                }
+
+                                if (*wrcnt > 0) {
+                                        err = ESUCC;
+                                }
+
+                        } else {
+                                // pipe is written buffer by buffer by VFS
+                                err = ENOTSUP;
+                        }
+                }
+
+                sys_mutex_unlock(hdl->resource_mtx);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Read file to multiple buffers
+ *
+ * @param[in ]          *fs_handle              file system allocated memory
+ * @param[in ]          *fhdl                   file handle
+ * @param[out]          *iov                    data destinations
+ * @param[in ]           iovcnt                 number of buffers
+ * @param[in ]          *fpos                   position in file
+ * @param[out]          *rdcnt                  number of read bytes
+ * @param[in ]           fattr                  file attributes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+API_FS_READV(ramfs,
+             void               *fs_handle,
+             void               *fhdl,
+             const struct iovec *iov,
+             int                 iovcnt,
+             fpos_t             *fpos,
+             size_t             *rdcnt,
+             struct vfs_fattr    fattr)
+{
+        struct RAMFS *hdl = fs_handle;
+
+        int err = sys_mutex_lock(hdl->resource_mtx, MTX_TIMEOUT);
+        if (!err) {
+
+                err = ENOENT;
+
+                struct opened_file_info *opened_file = fhdl;
+                if (opened_file && opened_file->child) {
+                        node_t *node = opened_file->child;
+
+                        if (S_ISDEV(node->mode)) {
+                                dev_t dev = node->data.dev_t;
+                                sys_mutex_unlock(hdl->resource_mtx);
+                                return sys_driver_readv(dev, iov, iovcnt, fpos, rdcnt, fattr);
+
+                        } else if (S_ISREG(node->mode)) {
+                                err = ESUCC;
+
+                                for (int i = 0; !err && (i < iovcnt); i++) {
+                                        size_t n = 0;
+                                        err = read_regular_file(node, iov[i].iov_base,
+                                                                iov[i].iov_len,
+                                                                *fpos + *rdcnt, &n);
+                                        *rdcnt += n;
+
+                                        if (n < iov[i].iov_len) {
+                                                break;
+                                        }
+                                }
+
+                                if (*rdcnt > 0) {
+                                        err = ESUCC;
+                                }
+
+                        } else {
+                                // pipe is read buffer by buffer by VFS
+                                err = ENOTSUP;
+                        }
+                }
+
+                sys_mutex_unlock(hdl->resource_mtx);
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief IO operations on files
@@ -1061,10 +1237,19 @@ API_FS_IOCTL(ramfs, void *fs_handle, void *fhdl, int request, void *arg)
                                         return sys_pipe_permanent(pipe);
                                 }
 
+                                case IOCTL_VFS__POLL: {
+                                        pipe_t *pipe = opened_file->child->data.pipe_t;
+                                        sys_mutex_unlock(hdl->resource_mtx);
+                                        return sys_pipe_poll(pipe, arg);
+                                }
+
                                 default:
                                         err = EBADRQC;
                                         break;
                                 }
+
+                        } else {
+                                err = EBADRQC;
                         }
                 }
 
@@ -1130,12 +1315,11 @@ API_FS_SYNC(ramfs, void *fs_handle)
  *
  * @param[in] *base             base node
  * @param[in] *target           target node
- * @param[in]  position         item in base node that point to target
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-static int delete_node(struct RAMFS *hdl, node_t *base, node_t *target, u32_t position)
+static int delete_node(struct RAMFS *hdl, node_t *base, node_t *target)
 {
         if (S_ISDIR(target->mode)) {
                 if (sys_llist_size(target->data.llist_t) > 0) {
@@ -1155,11 +1339,13 @@ static int delete_node(struct RAMFS *hdl, node_t *base, node_t *target, u32_t po
                 clear_regular_file(target);
         }
 
+        dentry_remove(hdl, target);
+
         if (target->name) {
                 sys_free(cast(void**, &target->name));
         }
 
-        sys_llist_erase(base->data.llist_t, position);
+        sys_llist_erase(base->data.llist_t, sys_llist_find_begin(base->data.llist_t, target));
 
         hdl->file_count--;
 
@@ -1198,31 +1384,25 @@ static uint get_path_deep(const char *path)
 
 //==============================================================================
 /**
- * @brief Function find node by path
+ * @brief Function find node by path. Each path component is resolved by
+ *        (parent, name) hash table.
  *
+ * @param[in]  hdl              file system handle
  * @param[in]  path             path
- * @param[in]  startnode        start node
- * @param[out] extPath          external path begin (pointer from path)
  * @param[in]  deep             deep control
- * @param[out] item             node is n-item of list which was found
  * @param[out] node             found node
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-static int get_node(const char *path, node_t *startnode, i32_t deep, i32_t *item, node_t **node)
+static int get_node(struct RAMFS *hdl, const char *path, i32_t deep, node_t **node)
 {
-        if (!path || !startnode) {
+        if (!path) {
                 return ENOENT;
         }
 
-        if (!S_ISDIR(startnode->mode)) {
-                return ENOTDIR;
-        }
-
-        node_t *current_node = startnode;
+        node_t *current_node = &hdl->root_dir;
         int     dir_deep     = get_path_deep(path);
-        int     err          = ENOENT;
 
         /* go to selected node -----------------------------------------------*/
         while (dir_deep + deep > 0) {
@@ -1233,52 +1413,147 @@ static int get_node(const char *path, node_t *startnode, i32_t deep, i32_t *item
                         path++;
                 }
 
+                if (!S_ISDIR(current_node->mode)) {
+                        return ENOTDIR;
+                }
+
                 char *path_end    = strchr(path, '/');
                 uint  path_length = !path_end ? strlen(path) : (size_t)path_end - (size_t)path;
 
-                /* get number of list items */
-                int list_size = sys_llist_size(current_node->data.llist_t);
+                current_node = dentry_lookup(hdl, current_node, path, path_length);
+                if (current_node == NULL) {
+                        return ENOENT;
+                }
 
-                /* find that object exist ------------------------------------*/
-                int i = 0;
-                while (list_size > 0) {
-                        node_t *next_node = sys_llist_at(current_node->data.llist_t, i++);
+                dir_deep--;
+        }
 
-                        if (next_node == NULL) {
-                                dir_deep = 1 - deep;
-                                break;
-                        }
+        *node = current_node;
 
-                        if (  strlen(next_node->name) == path_length
-                           && strncmp(next_node->name, path, path_length) == 0 ) {
+        return ESUCC;
+}
 
-                                current_node = next_node;
+//==============================================================================
+/**
+ * @brief Function calculate hash of (parent, name) pair (FNV-1a).
+ *
+ * @param[in]  parent           parent node
+ * @param[in]  name             node name (not necessary null terminated)
+ * @param[in]  len              name length
+ *
+ * @return Hash value.
+ */
+//==============================================================================
+static u32_t dentry_hash(node_t *parent, const char *name, size_t len)
+{
+        u32_t hash = 2166136261U ^ cast(u32_t, cast(uintptr_t, parent));
 
-                                if (item) {
-                                        *item = i - 1;
-                                }
+        while (len--) {
+                hash ^= cast(u8_t, *name++);
+                hash *= 16777619U;
+        }
 
-                                break;
-                        }
+        return hash;
+}
 
-                        list_size--;
-                }
+//==============================================================================
+/**
+ * @brief Function find child of selected directory.
+ *
+ * @param[in]  hdl              file system handle
+ * @param[in]  parent           parent node
+ * @param[in]  name             node name (not necessary null terminated)
+ * @param[in]  len              name length
+ *
+ * @return Found node or NULL if not exist.
+ */
+//==============================================================================
+static node_t *dentry_lookup(struct RAMFS *hdl, node_t *parent, const char *name, size_t len)
+{
+        u32_t   hash = dentry_hash(parent, name, len);
+        node_t *node = hdl->dentry[hash & (hdl->dentry_size - 1)];
+
+        for (; node; node = node->dentry_next) {
+                if (  node->parent == parent
+                   && strncmp(node->name, name, len) == 0
+                   && node->name[len] == '\0') {
 
-                /* directory does not found or error */
-                if (list_size == 0 || current_node == NULL) {
-                        current_node = NULL;
                         break;
                 }
-
-                dir_deep--;
         }
 
-        if (current_node) {
-                *node  = current_node;
-                err = ESUCC;
+        return node;
+}
+
+//==============================================================================
+/**
+ * @brief Function add node to dentry table. Table grows twice when number
+ *        of nodes exceeds number of buckets.
+ *
+ * @param[in]  hdl              file system handle
+ * @param[in]  node             node to add (parent and name must be set)
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int dentry_insert(struct RAMFS *hdl, node_t *node)
+{
+        if (hdl->file_count >= hdl->dentry_size) {
+
+                size_t   size = hdl->dentry_size * 2;
+                node_t **table;
+
+                if (sys_zalloc(size * sizeof(node_t*), cast(void**, &table)) == ESUCC) {
+
+                        for (size_t i = 0; i < hdl->dentry_size; i++) {
+                                node_t *n = hdl->dentry[i];
+
+                                while (n) {
+                                        node_t *next = n->dentry_next;
+                                        u32_t   hash = dentry_hash(n->parent, n->name, strlen(n->name));
+
+                                        n->dentry_next = table[hash & (size - 1)];
+                                        table[hash & (size - 1)] = n;
+                                        n = next;
+                                }
+                        }
+
+                        sys_free(cast(void**, &hdl->dentry));
+                        hdl->dentry      = table;
+                        hdl->dentry_size = size;
+                }
+
+                // when table cannot grow, lookup is slower but still correct
         }
 
-        return err;
+        u32_t hash = dentry_hash(node->parent, node->name, strlen(node->name));
+
+        node->dentry_next = hdl->dentry[hash & (hdl->dentry_size - 1)];
+        hdl->dentry[hash & (hdl->dentry_size - 1)] = node;
+
+        return ESUCC;
+}
+
+//==============================================================================
+/**
+ * @brief Function remove node from dentry table.
+ *
+ * @param[in]  hdl              file system handle
+ * @param[in]  node             node to remove
+ */
+//==============================================================================
+static void dentry_remove(struct RAMFS *hdl, node_t *node)
+{
+        u32_t    hash = dentry_hash(node->parent, node->name, strlen(node->name));
+        node_t **link = &hdl->dentry[hash & (hdl->dentry_size - 1)];
+
+        for (; *link; link = &(*link)->dentry_next) {
+                if (*link == node) {
+                        *link = node->dentry_next;
+                        node->dentry_next = NULL;
+                        break;
+                }
+        }
 }
 
 //==============================================================================
@@ -1290,7 +1565,6 @@ static int get_node(const char *path, node_t *startnode, i32_t deep, i32_t *item
  * @param[in]  parent           parent node
  * @param[in]  filename         filename (must be earlier allocated)
  * @param[in]  mode             mode (permissions, file type)
- * @param[out] item             new node number in base node (can be NULL)
  * @param[out] child            new node
  *
  * @return One of errno value (errno.h)
@@ -1300,7 +1574,6 @@ static int new_node(struct RAMFS *hdl,
                     node_t       *parent,
                     char         *filename,
                     mode_t        mode,
-                    i32_t        *item,
                     node_t      **child)
 {
         if (!parent || !filename) {
@@ -1311,10 +1584,8 @@ static int new_node(struct RAMFS *hdl,
                 return ENOTDIR;
         }
 
-        sys_llist_foreach(node_t*, node, parent->data.llist_t) {
-                if (strncmp(node->name, filename, 255) == 0) {
-                        return EEXIST;
-                }
+        if (dentry_lookup(hdl, parent, filename, strlen(filename))) {
+                return EEXIST;
         }
 
         node_t *node;
@@ -1325,6 +1596,7 @@ static int new_node(struct RAMFS *hdl,
                 sys_gettime(&tm);
 
                 node->name         = filename;
+                node->parent       = parent;
                 node->data.llist_t = NULL;
                 node->gid          = 0;
                 node->uid          = 0;
@@ -1334,7 +1606,8 @@ static int new_node(struct RAMFS *hdl,
                 node->size         = 0;
 
                 if (S_ISDIR(mode)) {
-                        err = sys_llist_create(NULL, NULL, cast(llist_t**, &node->data));
+                        err = sys_llist_create(sys_llist_functor_cmp_pointers, NULL,
+                                               cast(llist_t**, &node->data));
 
                 } else if (S_ISFIFO(mode)) {
                         err = sys_pipe_create(cast(pipe_t**, &node->data));
@@ -1342,9 +1615,7 @@ static int new_node(struct RAMFS *hdl,
 
                 if (!err) {
                         if (sys_llist_push_back(parent->data.llist_t, node)) {
-                                if (item) {
-                                        *item = sys_llist_size(parent->data.llist_t) - 1;
-                                }
+                                dentry_insert(hdl, node);
 
                                 *child = node;
 
@@ -1403,6 +1674,75 @@ static int add_node_to_open_files_list(struct RAMFS *hdl,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function returns selected chunk of regular file. Chunks are indexed
+ *        by 2-level table, so access to any file position costs O(1).
+ *
+ * @param node                  file node
+ * @param n                     chunk number (file position / CHUNK_SIZE)
+ * @param create                create chunk if does not exist
+ * @param chunk                 chunk (NULL if not exist and not created)
+ *
+ * @retval One of errno value (errno.h)
+ */
+//==============================================================================
+static int get_chunk(node_t *node, size_t n, bool create, u8_t **chunk)
+{
+        int            err   = ESUCC;
+        chunk_table_t *table = node->data.chunk_table_t;
+        size_t         i     = n / CHUNK_INDEX_SIZE;
+        size_t         j     = n % CHUNK_INDEX_SIZE;
+
+        *chunk = NULL;
+
+        if (!table || i >= table->length) {
+                if (!create) {
+                        return ESUCC;
+                }
+
+                // table grows twice to keep amortized O(1) cost of file append
+                size_t length = table ? max(i + 1, 2 * table->length) : i + 1;
+
+                chunk_table_t *new_table;
+                err = sys_zalloc(sizeof(chunk_table_t) + length * sizeof(chunk_index_t*),
+                                 cast(void**, &new_table));
+                if (err) {
+                        return err;
+                }
+
+                new_table->length = length;
+
+                if (table) {
+                        memcpy(new_table->index, table->index,
+                               table->length * sizeof(chunk_index_t*));
+
+                        sys_free(cast(void**, &table));
+                }
+
+                table = new_table;
+                node->data.chunk_table_t = table;
+        }
+
+        if (!table->index[i]) {
+                if (create) {
+                        err = sys_zalloc(sizeof(chunk_index_t), cast(void**, &table->index[i]));
+                } else {
+                        return ESUCC;
+                }
+        }
+
+        if (!err && !table->index[i]->chunk[j] && create) {
+                err = sys_zalloc(CHUNK_SIZE, cast(void**, &table->index[i]->chunk[j]));
+        }
+
+        if (!err) {
+                *chunk = table->index[i]->chunk[j];
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief Function clear data of regular file.
@@ -1412,16 +1752,28 @@ static int add_node_to_open_files_list(struct RAMFS *hdl,
 //==============================================================================
 static void clear_regular_file(node_t *node)
 {
-        data_chain_t *chain = node->data.data_chain_t;
+        chunk_table_t *table = node->data.chunk_table_t;
+
+        if (table) {
+                for (size_t i = 0; i < table->length; i++) {
+                        chunk_index_t *index = table->index[i];
+
+                        if (index) {
+                                for (size_t j = 0; j < CHUNK_INDEX_SIZE; j++) {
+                                        if (index->chunk[j]) {
+                                                sys_free(cast(void**, &index->chunk[j]));
+                                        }
+                                }
+
+                                sys_free(cast(void**, &index));
+                        }
+                }
 
-        while (chain) {
-                data_chain_t *next = chain->next;
-                sys_free(cast(void**, &chain));
-                chain = next;
+                sys_free(cast(void**, &table));
         }
 
         node->size = 0;
-        node->data.data_chain_t = NULL;
+        node->data.chunk_table_t = NULL;
 }
 
 //==============================================================================
@@ -1440,60 +1792,33 @@ static void clear_regular_file(node_t *node)
 static int write_regular_file(node_t *node, const u8_t *src,
                               size_t count, fpos_t fpos, size_t *wrcnt)
 {
-        int           err   = ESUCC;
-        data_chain_t *chain = node->data.data_chain_t;
-        size_t        depth = fpos / DATA_CHAIN_SIZE;
-        size_t        seek  = fpos - (depth * DATA_CHAIN_SIZE);
-
-        if (chain == NULL) {
-                err = sys_zalloc(sizeof(data_chain_t), cast(void**, &chain));
-                if (!err) {
-                        node->data.data_chain_t = chain;
-                }
-        }
-
-        // travel to selected chain
-        while (!err && depth) {
-                if (chain->next == NULL) {
-                        err = sys_zalloc(sizeof(data_chain_t),
-                                         cast(void**, &chain->next));
-                }
-
-                chain = chain->next;
-                depth--;
-        }
+        int err = ESUCC;
 
-        // at position
         while (!err && count) {
-                size_t tocpy = min(DATA_CHAIN_SIZE - seek, count);
-                memcpy(&chain->buf[seek], src, tocpy);
-                src    += tocpy;
-                fpos   += tocpy;
-                *wrcnt += tocpy;
-                count  -= tocpy;
-                seek    = 0;
-
-                if (count) {
-                        if (chain->next == NULL) {
-                                err = sys_zalloc(sizeof(data_chain_t),
-                                                 cast(void**, &chain->next));
-                        }
+                size_t seek = fpos % CHUNK_SIZE;
 
-                        chain = chain->next;
+                u8_t *chunk;
+                err = get_chunk(node, fpos / CHUNK_SIZE, true, &chunk);
+                if (!err) {
+                        size_t tocpy = min(CHUNK_SIZE - seek, count);
+                        memcpy(&chunk[seek], src, tocpy);
+                        src    += tocpy;
+                        fpos   += tocpy;
+                        *wrcnt += tocpy;
+                        count  -= tocpy;
                 }
         }
 
         // calculate file size
-        if (depth == 0) {
-                node->size = max(node->size, fpos);
-        }
+        node->size = max(node->size, fpos);
 
         return err;
 }
 
 //==============================================================================
 /**
- * @brief Function read data from regular file.
+ * @brief Function read data from regular file. Not allocated chunks (holes)
+ *        are read as zeros.
  *
  * @param node                  node to read
  * @param dst                   destination buffer
@@ -1509,24 +1834,25 @@ static int read_regular_file(node_t *node, u8_t *dst,
 {
         int err = ESUCC;
 
-        data_chain_t *chain = node->data.data_chain_t;
-        size_t        depth = fpos / DATA_CHAIN_SIZE;
-        size_t        seek  = fpos - (depth * DATA_CHAIN_SIZE);
-
-        for (; chain && depth; chain = chain->next, depth--);
-
-        while (chain && count && fpos < node->size) {
-                size_t tocpy = min(DATA_CHAIN_SIZE - seek, count);
+        while (!err && count && fpos < node->size) {
+                size_t seek  = fpos % CHUNK_SIZE;
+                size_t tocpy = min(CHUNK_SIZE - seek, count);
                        tocpy = min(tocpy, node->size - fpos);
 
-                memcpy(dst, &chain->buf[seek], tocpy);
-                dst    += tocpy;
-                fpos   += tocpy;
-                *rdcnt += tocpy;
-                count  -= tocpy;
-                seek    = 0;
+                u8_t *chunk;
+                err = get_chunk(node, fpos / CHUNK_SIZE, false, &chunk);
+                if (!err) {
+                        if (chunk) {
+                                memcpy(dst, &chunk[seek], tocpy);
+                        } else {
+                                memset(dst, 0, tocpy);
+                        }
 
-                chain = chain->next;
+                        dst    += tocpy;
+                        fpos   += tocpy;
+                        *rdcnt += tocpy;
+                        count  -= tocpy;
+                }
         }
 
         return err;
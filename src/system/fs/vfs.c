@@ -34,6 +34,7 @@
 #include <errno.h>
 #include <string.h>
 #include "fs/vfs.h"
+#include "fs/bcache.h"
 #include "lib/llist.h"
 #include "kernel/kwrapper.h"
 #include "kernel/process.h"
@@ -44,18 +45,46 @@
 ==============================================================================*/
 #undef errno
 #define PATH_MAX_LEN             256
+#define PATH_SCRATCH_LEN         64
+#define DIRTY_AGE_LIMIT_MS       (1000 * __OS_SYSTEM_CACHE_SYNC_PERIOD__)
+#define DIRTY_HIGH_WATER         __OS_SYSTEM_DIRTY_HIGH_WATER__
 
 /*==============================================================================
   Local types, enums definitions
 ==============================================================================*/
 typedef struct FS_entry {
         const char         *mount_point;
+        size_t              mount_point_len;
         struct FS_entry    *parent;
         void               *handle;
         const vfs_FS_itf_t *interface;
         u8_t                children_cnt;
+        bool                backed;             //!< file system has backing storage
+        bool                dirty;              //!< data not synchronized with storage
+        u32_t               dirty_bytes;        //!< number of bytes written since last sync
+        u64_t               dirty_since;        //!< time of first write since last sync [ms]
 } FS_entry_t;
 
+/*
+ * Mount table snapshot used by path resolution. Table is rebuilt at each
+ * mount/umount and swapped atomically, so readers do not lock VFS mutex.
+ * Replaced table is released by last reader.
+ */
+typedef struct {
+        u32_t               readers;            //!< number of readers that use table
+        size_t              count;              //!< number of entries
+        FS_entry_t         *entry[];            //!< entries sorted by mount point length (longest first)
+} mnt_table_t;
+
+/*
+ * Absolute path resolved in bounded scratch buffer located on the caller's
+ * stack. Heap is used only if path does not fit in the scratch buffer.
+ */
+typedef struct {
+        char               *path;               //!< resolved path (scratch or heap)
+        char                scratch[PATH_SCRATCH_LEN];
+} abs_path_t;
+
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
@@ -68,13 +97,35 @@ static int  parse_flags      (const char *str, u32_t *flags);
 static int  get_path_FS      (const char *path, size_t len, int *position, FS_entry_t **fs_entry);
 static int  get_path_base_FS (const char *path, const char **extPath, FS_entry_t **fs_entry);
 static int  new_absolute_path(const struct vfs_path *path, enum path_correction corr, char **new_path);
+static int  abs_path_resolve (const struct vfs_path *path, enum path_correction corr, abs_path_t *abspath);
+static void abs_path_release (abs_path_t *abspath);
+static int  file_write       (FILE *file, const u8_t *src, size_t size, size_t *wrcnt);
+static int  file_read        (FILE *file, u8_t *dst, size_t size, size_t *rdcnt);
+static int  file_writev      (FILE *file, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *wrcnt);
+static int  file_readv       (FILE *file, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *rdcnt);
+static bool is_iov_valid     (const struct iovec *iov, int iovcnt, size_t *size);
+static bool stream_buf_alloc (FILE *file);
+static int  stream_flush     (FILE *file);
+static int  stream_sync      (FILE *file);
+static int  stream_write     (FILE *file, const u8_t *src, size_t size, size_t *wrcnt);
+static int  stream_read      (FILE *file, u8_t *dst, size_t size, size_t *rdcnt);
+static int  stream_lock      (FILE *file);
+static void stream_unlock    (FILE *file);
+static int  mnt_table_rebuild(void);
+static mnt_table_t *mnt_table_acquire(void);
+static void mnt_table_release(mnt_table_t *table);
+static void mark_dirty       (FS_entry_t *fs, size_t bytes);
+static int  sync_FS          (FS_entry_t *fs);
 
 /*==============================================================================
   Local object definitions
 ==============================================================================*/
 static struct {
-        llist_t *mnt_list;
-        mutex_t *resource_mtx;
+        llist_t     *mnt_list;
+        mutex_t     *resource_mtx;
+        mnt_table_t *mnt_table;
+        u32_t        dirty_bytes;               //!< bytes written to all file systems since sync
+        _vfs_stats_t stats;
 } VFS;
 
 /*==============================================================================
@@ -222,10 +273,19 @@ int _vfs_mount(const struct vfs_path   *src_path,
                  * mount FS if created
                  */
                 if (!err) {
-                        if (!_llist_push_back(VFS.mnt_list, new_fs)) {
-                                delete_FS_entry(new_fs);
+                        if (_llist_push_back(VFS.mnt_list, new_fs)) {
+                                err = mnt_table_rebuild();
+                                if (err) {
+                                        _llist_take_back(VFS.mnt_list);
+                                }
+                        } else {
                                 err = ENOMEM;
                         }
+
+                        if (err) {
+                                new_fs->mount_point = NULL;
+                                delete_FS_entry(new_fs);
+                        }
                 }
 
                 _mutex_unlock(VFS.resource_mtx);
@@ -258,21 +318,33 @@ int _vfs_umount(const struct vfs_path *path)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, ADD_SLASH, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, ADD_SLASH, &cwd_path);
         if (not err) {
                 err = _mutex_lock(VFS.resource_mtx, MAX_DELAY_MS);
                 if (not err) {
 
                         int         position;
                         FS_entry_t *mount_fs;
-                        err = get_path_FS(cwd_path, PATH_MAX_LEN, &position, &mount_fs);
+                        err = get_path_FS(cwd_path.path, PATH_MAX_LEN, &position, &mount_fs);
 
                         if (not err) {
                                 if (mount_fs->children_cnt == 0) {
-                                        err = delete_FS_entry(mount_fs);
+                                        /*
+                                         * file system is removed from mount
+                                         * table before release, so new path
+                                         * lookups cannot find it
+                                         */
+                                        _llist_take(VFS.mnt_list, position);
+
+                                        err = mnt_table_rebuild();
                                         if (not err) {
-                                                _llist_take(VFS.mnt_list, position);
+                                                err = delete_FS_entry(mount_fs);
+                                        }
+
+                                        if (err) {
+                                                _llist_insert(VFS.mnt_list, position, mount_fs);
+                                                mnt_table_rebuild();
                                         }
                                 } else {
                                         err = EBUSY;
@@ -282,7 +354,7 @@ int _vfs_umount(const struct vfs_path *path)
                         _mutex_unlock(VFS.resource_mtx);
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -351,18 +423,21 @@ int _vfs_mknod(const struct vfs_path *path, dev_t dev)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, NO_SLASH_ACTION, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, NO_SLASH_ACTION, &cwd_path);
         if (!err) {
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_mknod(fs->handle, external_path, dev);
+                        if (!err) {
+                                mark_dirty(fs, 0);
+                        }
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -385,18 +460,21 @@ int _vfs_mkdir(const struct vfs_path *path, mode_t mode)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, SUB_SLASH, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, SUB_SLASH, &cwd_path);
         if (!err) {
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_mkdir(fs->handle, external_path, S_IPMT(mode));
+                        if (!err) {
+                                mark_dirty(fs, 0);
+                        }
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -420,18 +498,21 @@ int _vfs_mkfifo(const struct vfs_path *path, mode_t mode)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, NO_SLASH_ACTION, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, NO_SLASH_ACTION, &cwd_path);
         if (!err) {
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_mkfifo(fs->handle, external_path, S_IPMT(mode));
+                        if (!err) {
+                                mark_dirty(fs, 0);
+                        }
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -456,13 +537,15 @@ int _vfs_opendir(const struct vfs_path *path, DIR **dir)
 
         int err = _kmalloc(_MM_KRN, sizeof(DIR), NULL, 0, 0, cast(void**, dir));
         if (!err) {
-                char *cwd_path;
-                err = new_absolute_path(path, ADD_SLASH, &cwd_path);
+                VFS.stats.heap_allocs++;
+
+                abs_path_t cwd_path;
+                err = abs_path_resolve(path, ADD_SLASH, &cwd_path);
                 if (!err) {
 
                         const char *external_path;
                         FS_entry_t *fs;
-                        err = get_path_base_FS(cwd_path, &external_path, &fs);
+                        err = get_path_base_FS(cwd_path.path, &external_path, &fs);
 
                         if (!err) {
                                 (*dir)->FS_hdl = fs->handle;
@@ -471,7 +554,7 @@ int _vfs_opendir(const struct vfs_path *path, DIR **dir)
                                 err = fs->interface->fs_opendir(fs->handle, external_path, *dir);
                         }
 
-                        _kfree(_MM_KRN, cast(void**, &cwd_path));
+                        abs_path_release(&cwd_path);
                 }
 
                 if (!err) {
@@ -593,36 +676,35 @@ int _vfs_remove(const struct vfs_path *path)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, ADD_SLASH, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, ADD_SLASH, &cwd_path);
         if (!err) {
 
                 const char *external_path;
-                FS_entry_t *mount_fs;
                 FS_entry_t *base_fs;
 
-                err = _mutex_lock(VFS.resource_mtx, MAX_DELAY_MS);
+                err = get_path_base_FS(cwd_path.path, &external_path, &base_fs);
                 if (!err) {
-
-                        err = get_path_FS(cwd_path, PATH_MAX_LEN, NULL, &mount_fs);
-                        if (err == ENOENT) {
+                        if (base_fs->mount_point_len == strlen(cwd_path.path)) {
+                                // path is a mount point
+                                err = EBUSY;
+                        } else {
                                 // remove slash at the end
-                                LAST_CHARACTER(cwd_path) = '\0';
+                                LAST_CHARACTER(cwd_path.path) = '\0';
 
                                 // get parent FS
-                                err = get_path_base_FS(cwd_path, &external_path, &base_fs);
-                        } else {
-                                err = EBUSY;
+                                err = get_path_base_FS(cwd_path.path, &external_path, &base_fs);
                         }
-
-                        _mutex_unlock(VFS.resource_mtx);
                 }
 
                 if (!err) {
                         err = base_fs->interface->fs_remove(base_fs->handle, external_path);
+                        if (!err) {
+                                mark_dirty(base_fs, 0);
+                        }
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -648,12 +730,12 @@ int _vfs_rename(const struct vfs_path *old_name, const struct vfs_path *new_name
                 return EINVAL;
         }
 
-        char *cwd_old_name = NULL;
-        char *cwd_new_name = NULL;
+        abs_path_t cwd_old_name = {.path = NULL};
+        abs_path_t cwd_new_name = {.path = NULL};
 
-        int err = new_absolute_path(old_name, NO_SLASH_ACTION, &cwd_old_name);
+        int err = abs_path_resolve(old_name, NO_SLASH_ACTION, &cwd_old_name);
         if (!err) {
-                err = new_absolute_path(new_name, NO_SLASH_ACTION, &cwd_new_name);
+                err = abs_path_resolve(new_name, NO_SLASH_ACTION, &cwd_new_name);
         }
 
         if (!err) {
@@ -662,13 +744,9 @@ int _vfs_rename(const struct vfs_path *old_name, const struct vfs_path *new_name
                 const char *old_extern_path;
                 const char *new_extern_path;
 
-                err = _mutex_lock(VFS.resource_mtx, MAX_DELAY_MS);
+                err = get_path_base_FS(cwd_old_name.path, &old_extern_path, &old_fs);
                 if (!err) {
-                        err = get_path_base_FS(cwd_old_name, &old_extern_path, &old_fs);
-                        if (!err) {
-                                err = get_path_base_FS(cwd_new_name, &new_extern_path, &new_fs);
-                        }
-                        _mutex_unlock(VFS.resource_mtx);
+                        err = get_path_base_FS(cwd_new_name.path, &new_extern_path, &new_fs);
                 }
 
                 if (!err) {
@@ -677,19 +755,17 @@ int _vfs_rename(const struct vfs_path *old_name, const struct vfs_path *new_name
                                 err = old_fs->interface->fs_rename(old_fs->handle,
                                                                    old_extern_path,
                                                                    new_extern_path);
+                                if (!err) {
+                                        mark_dirty(old_fs, 0);
+                                }
                         } else {
                                 err = ENOTSUP;
                         }
                 }
         }
 
-        if (cwd_old_name) {
-                _kfree(_MM_KRN, cast(void**, &cwd_old_name));
-        }
-
-        if (cwd_new_name) {
-                _kfree(_MM_KRN, cast(void**, &cwd_new_name));
-        }
+        abs_path_release(&cwd_old_name);
+        abs_path_release(&cwd_new_name);
 
         return err;
 }
@@ -712,18 +788,21 @@ int _vfs_chmod(const struct vfs_path *path, mode_t mode)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, NO_SLASH_ACTION, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, NO_SLASH_ACTION, &cwd_path);
         if (!err) {
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_chmod(fs->handle, external_path, S_IPMT(mode));
+                        if (!err) {
+                                mark_dirty(fs, 0);
+                        }
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -748,18 +827,21 @@ int _vfs_chown(const struct vfs_path *path, uid_t owner, gid_t group)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, NO_SLASH_ACTION, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, NO_SLASH_ACTION, &cwd_path);
         if (!err) {
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_chown(fs->handle, external_path, owner, group);
+                        if (!err) {
+                                mark_dirty(fs, 0);
+                        }
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -783,18 +865,18 @@ int _vfs_stat(const struct vfs_path *path, struct stat *stat)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, NO_SLASH_ACTION, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, NO_SLASH_ACTION, &cwd_path);
         if (!err) {
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_stat(fs->handle, external_path, stat);
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -818,17 +900,17 @@ int _vfs_statfs(const struct vfs_path *path, struct statfs *statfs)
                 return EINVAL;
         }
 
-        char *cwd_path;
-        int err = new_absolute_path(path, ADD_SLASH, &cwd_path);
+        abs_path_t cwd_path;
+        int err = abs_path_resolve(path, ADD_SLASH, &cwd_path);
         if (!err) {
 
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, NULL, &fs);
+                err = get_path_base_FS(cwd_path.path, NULL, &fs);
                 if (!err) {
                         err = fs->interface->fs_statfs(fs->handle, statfs);
                 }
 
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
+                abs_path_release(&cwd_path);
         }
 
         return err;
@@ -869,8 +951,8 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
         f_flags.wr     = (o_flags & (O_RDWR | O_WRONLY));
         f_flags.append = (o_flags & (O_APPEND));
 
-        char *cwd_path = NULL;
-        err = new_absolute_path(path, NO_SLASH_ACTION, &cwd_path);
+        abs_path_t cwd_path;
+        err = abs_path_resolve(path, NO_SLASH_ACTION, &cwd_path);
         if (err) {
                 return err;
         }
@@ -878,10 +960,11 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
         FILE *file_obj = NULL;
         err = _kzalloc(_MM_KRN, sizeof(FILE), NULL, 0, 0, cast(void**, &file_obj));
         if (!err && file_obj) {
+                VFS.stats.heap_allocs++;
 
                 const char *external_path;
                 FS_entry_t *fs;
-                err = get_path_base_FS(cwd_path, &external_path, &fs);
+                err = get_path_base_FS(cwd_path.path, &external_path, &fs);
                 if (!err) {
                         err = fs->interface->fs_open(fs->handle,
                                                      &file_obj->f_hdl,
@@ -890,6 +973,16 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
                                                      o_flags);
 
                         struct stat stat;
+                        if (!err) {
+                                err = _mutex_create(MUTEX_TYPE_RECURSIVE,
+                                                    &file_obj->f_mtx);
+                                if (err) {
+                                        fs->interface->fs_close(fs->handle,
+                                                                file_obj->f_hdl,
+                                                                true);
+                                }
+                        }
+
                         if (!err) {
                                 err = fs->interface->fs_fstat(fs->handle,
                                                               file_obj->f_hdl,
@@ -909,23 +1002,35 @@ int _vfs_fopen(const struct vfs_path *path, const char *mode, FILE **file)
                                         file_obj->f_lseek = stat.st_size;
                                 }
 
+                                // stream is not buffered until caller select buffer mode
+                                file_obj->f_buf.mode  = VFS_IONBF;
+                                file_obj->f_buf.size  = __OS_STREAM_BUFFER_LENGTH__;
+
                                 file_obj->FS_hdl      = fs->handle;
                                 file_obj->FS_if       = fs->interface;
+                                file_obj->FS_ent      = fs;
                                 file_obj->f_flag      = f_flags;
                                 file_obj->header.self = file_obj;
                                 file_obj->header.type = RES_TYPE_FILE;
+
+                                // create, truncate and write open modify file system
+                                if (o_flags & (O_WRONLY | O_RDWR | O_CREAT | O_TRUNC)) {
+                                        mark_dirty(fs, 0);
+                                }
                         }
                 }
         }
 
-        if (cwd_path) {
-                _kfree(_MM_KRN, cast(void**, &cwd_path));
-        }
+        abs_path_release(&cwd_path);
 
         if (file_obj) {
                 if (file_obj->header.type == RES_TYPE_FILE) {
                         *file = file_obj;
                 } else {
+                        if (file_obj->f_mtx) {
+                                _mutex_destroy(file_obj->f_mtx);
+                        }
+
                         _kfree(_MM_KRN, cast(void**, &file_obj));
                 }
         }
@@ -948,12 +1053,36 @@ int _vfs_fclose(FILE *file, bool force)
         int err = EINVAL;
 
         if (is_file_valid(file) && file->FS_if->fs_close) {
-                err = file->FS_if->fs_close(file->FS_hdl, file->f_hdl, force);
+                err = stream_lock(file);
+                if (err) {
+                        return err;
+                }
+
+                err = stream_flush(file);
+                if (!err || force) {
+                        err = file->FS_if->fs_close(file->FS_hdl, file->f_hdl, force);
+                }
+
                 if (!err) {
+                        // file system can update metadata on close
+                        if (file->f_flag.wr) {
+                                mark_dirty(file->FS_ent, 0);
+                        }
+
+                        if (file->f_buf.own) {
+                                _kfree(_MM_KRN, cast(void**, &file->f_buf.data));
+                        }
+
                         file->header.self = NULL;
                         file->header.type = RES_TYPE_UNKNOWN;
                         file->FS_hdl      = NULL;
+                        file->FS_ent      = NULL;
+
+                        stream_unlock(file);
+                        _mutex_destroy(file->f_mtx);
                         _kfree(_MM_KRN, cast(void**, &file));
+                } else {
+                        stream_unlock(file);
                 }
         }
 
@@ -980,30 +1109,28 @@ int _vfs_fwrite(const void *ptr, size_t size, size_t *wrcnt, FILE *file)
                 *wrcnt = 0;
 
                 if (file->f_flag.wr) {
+                        err = stream_lock(file);
+                        if (err) {
+                                return err;
+                        }
+
                         // move seek to the end of file if "a+" (wr+rd+app) mode is using
                         if (file->f_flag.append && file->f_flag.rd && file->f_flag.seekmod) {
                                 _vfs_fseek(file, 0, VFS_SEEK_END);
                                 file->f_flag.seekmod = false;
                         }
 
-                        err = file->FS_if->fs_write(file->FS_hdl,
-                                                    file->f_hdl,
-                                                    ptr,
-                                                    size,
-                                                    &file->f_lseek,
-                                                    wrcnt,
-                                                    file->f_flag.fattr);
-
-                        if (!err) {
-                                if ((*wrcnt < size) && !file->f_flag.fattr.non_blocking_wr) {
-                                        file->f_flag.eof = true;
-                                }
-
-                                if (cast(ssize_t, *wrcnt) >= 0) {
-                                        file->f_lseek += cast(u64_t, *wrcnt);
-                                }
+                        if (stream_buf_alloc(file)) {
+                                err = stream_write(file, ptr, size, wrcnt);
+                                stream_unlock(file);
                         } else {
-                                file->f_flag.error = true;
+                                // unbuffered write may block, lock is not held
+                                stream_unlock(file);
+                                err = file_write(file, ptr, size, wrcnt);
+                        }
+
+                        if (!err && (*wrcnt < size) && !file->f_flag.fattr.non_blocking_wr) {
+                                file->f_flag.eof = true;
                         }
                 } else {
                         file->f_flag.error = true;
@@ -1034,24 +1161,144 @@ int _vfs_fread(void *ptr, size_t size, size_t *rdcnt, FILE *file)
                 *rdcnt = 0;
 
                 if (file->f_flag.rd) {
-                        err = file->FS_if->fs_read(file->FS_hdl,
-                                                   file->f_hdl,
-                                                   ptr,
-                                                   size,
-                                                   &file->f_lseek,
-                                                   rdcnt,
-                                                   file->f_flag.fattr);
+                        err = stream_lock(file);
+                        if (err) {
+                                return err;
+                        }
+
+                        // data buffered for write is stored before read
+                        if (file->f_buf.state == VFS_BUF_WR) {
+                                err = stream_sync(file);
+                        }
+
+                        // only fully buffered streams use read buffer
+                        if (!err && (file->f_buf.mode == VFS_IOFBF) && stream_buf_alloc(file)) {
+                                err = stream_read(file, ptr, size, rdcnt);
+                                stream_unlock(file);
+
+                        } else {
+                                // unbuffered read may block, lock is not held
+                                stream_unlock(file);
+
+                                if (!err) {
+                                        err = file_read(file, ptr, size, rdcnt);
+                                }
+                        }
+
+                        if (!err && (*rdcnt < size) && !file->f_flag.fattr.non_blocking_rd) {
+                                file->f_flag.eof = true;
+                        }
+                } else {
+                        file->f_flag.error = true;
+                        err = EPERM;
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function write data from multiple buffers to file. Stream buffer is
+ *        flushed before, and vector is passed directly to file system.
+ *
+ * @param[in]  iov              buffers
+ * @param[in]  iovcnt           number of buffers
+ * @param[in]  offset           file offset (NULL: current file position is used and moved)
+ * @param[out] wrcnt            number of written bytes
+ * @param[in]  file             pointer to file object
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_fwritev(const struct iovec *iov, int iovcnt, const fpos_t *offset, size_t *wrcnt, FILE *file)
+{
+        int    err  = EINVAL;
+        size_t size = 0;
+
+        if (is_iov_valid(iov, iovcnt, &size) && wrcnt && is_file_valid(file)) {
+                *wrcnt = 0;
+
+                if (file->f_flag.wr) {
+                        err = stream_lock(file);
+                        if (err) {
+                                return err;
+                        }
+
+                        // move seek to the end of file if "a+" (wr+rd+app) mode is using
+                        if (!offset && file->f_flag.append && file->f_flag.rd && file->f_flag.seekmod) {
+                                _vfs_fseek(file, 0, VFS_SEEK_END);
+                                file->f_flag.seekmod = false;
+                        }
+
+                        err = stream_sync(file);
+                        stream_unlock(file);
 
                         if (!err) {
-                                if ((*rdcnt < size) && !file->f_flag.fattr.non_blocking_rd) {
-                                        file->f_flag.eof = true;
+                                fpos_t fpos = offset ? *offset : file->f_lseek;
+
+                                err = file_writev(file, iov, iovcnt, &fpos, wrcnt);
+
+                                if (!err && !offset) {
+                                        file->f_lseek += cast(u64_t, *wrcnt);
+
+                                        if ((*wrcnt < size) && !file->f_flag.fattr.non_blocking_wr) {
+                                                file->f_flag.eof = true;
+                                        }
                                 }
+                        }
+                } else {
+                        file->f_flag.error = true;
+                        err = EPERM;
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function read data from file to multiple buffers. Stream buffer is
+ *        synchronized before, and vector is passed directly to file system.
+ *
+ * @param[in]  iov              buffers
+ * @param[in]  iovcnt           number of buffers
+ * @param[in]  offset           file offset (NULL: current file position is used and moved)
+ * @param[out] rdcnt            number of read bytes
+ * @param[in]  file             pointer to file object
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_freadv(const struct iovec *iov, int iovcnt, const fpos_t *offset, size_t *rdcnt, FILE *file)
+{
+        int    err  = EINVAL;
+        size_t size = 0;
+
+        if (is_iov_valid(iov, iovcnt, &size) && rdcnt && is_file_valid(file)) {
+                *rdcnt = 0;
+
+                if (file->f_flag.rd) {
+                        err = stream_lock(file);
+                        if (err) {
+                                return err;
+                        }
+
+                        err = stream_sync(file);
+                        stream_unlock(file);
+
+                        if (!err) {
+                                fpos_t fpos = offset ? *offset : file->f_lseek;
 
-                                if (cast(ssize_t, *rdcnt) >= 0) {
+                                err = file_readv(file, iov, iovcnt, &fpos, rdcnt);
+
+                                if (!err && !offset) {
                                         file->f_lseek += cast(u64_t, *rdcnt);
+
+                                        if ((*rdcnt < size) && !file->f_flag.fattr.non_blocking_rd) {
+                                                file->f_flag.eof = true;
+                                        }
                                 }
-                        } else {
-                                file->f_flag.error = true;
                         }
                 } else {
                         file->f_flag.error = true;
@@ -1077,16 +1324,26 @@ int _vfs_fseek(FILE *file, i64_t offset, int mode)
 {
         struct stat stat;
 
-        if (is_file_valid(file) && mode <= VFS_SEEK_END) {
+        if (is_file_valid(file) && (mode >= VFS_SEEK_SET) && (mode <= VFS_SEEK_END)) {
                 if (file->f_flag.append && file->f_flag.wr && !file->f_flag.rd) {
                         return ESUCC;
                 }
 
+                int err = stream_lock(file);
+                if (err) {
+                        return err;
+                }
+
+                err = stream_sync(file);
+                if (err) {
+                        goto finish;
+                }
+
                 if (mode == VFS_SEEK_END) {
                         stat.st_size = 0;
-                        int err = _vfs_fstat(file, &stat);
+                        err = _vfs_fstat(file, &stat);
                         if (err) {
-                                return err;
+                                goto finish;
                         }
                 }
 
@@ -1094,7 +1351,7 @@ int _vfs_fseek(FILE *file, i64_t offset, int mode)
                 case VFS_SEEK_SET: file->f_lseek  = offset; break;
                 case VFS_SEEK_CUR: file->f_lseek += offset; break;
                 case VFS_SEEK_END: file->f_lseek  = stat.st_size + offset; break;
-                default: return EINVAL;
+                default          : err = EINVAL; goto finish;
                 }
 
                 file->f_flag.eof     = false;
@@ -1104,7 +1361,9 @@ int _vfs_fseek(FILE *file, i64_t offset, int mode)
                         file->f_flag.error = false;
                 }
 
-                return ESUCC;
+                finish:
+                stream_unlock(file);
+                return err;
         }
 
         return EINVAL;
@@ -1123,7 +1382,21 @@ int _vfs_fseek(FILE *file, i64_t offset, int mode)
 int _vfs_ftell(FILE *file, i64_t *lseek)
 {
         if (is_file_valid(file) && lseek) {
+                int err = stream_lock(file);
+                if (err) {
+                        return err;
+                }
+
                 *lseek = file->f_lseek;
+
+                if (file->f_buf.state == VFS_BUF_WR) {
+                        *lseek += file->f_buf.level;
+                } else if (file->f_buf.state == VFS_BUF_RD) {
+                        *lseek -= file->f_buf.level - file->f_buf.rdpos;
+                }
+
+                stream_unlock(file);
+
                 return ESUCC;
         } else {
                 return EINVAL;
@@ -1170,6 +1443,12 @@ int _vfs_vfioctl(FILE *file, int rq, va_list arg)
                         return ESUCC;
                 }
 
+                // buffered data is stored before device control
+                if (stream_lock(file) == ESUCC) {
+                        stream_sync(file);
+                        stream_unlock(file);
+                }
+
                 return file->FS_if->fs_ioctl(file->FS_hdl,
                                              file->f_hdl,
                                              rq, va_arg(arg, void*));
@@ -1213,7 +1492,15 @@ int _vfs_fflush(FILE *file)
         int err = EINVAL;
 
         if (is_file_valid(file)) {
-                err = file->FS_if->fs_flush(file->FS_hdl, file->f_hdl);
+                err = stream_lock(file);
+                if (!err) {
+                        err = stream_sync(file);
+                        stream_unlock(file);
+                }
+
+                if (!err) {
+                        err = file->FS_if->fs_flush(file->FS_hdl, file->f_hdl);
+                }
         }
 
         return err;
@@ -1221,89 +1508,361 @@ int _vfs_fflush(FILE *file)
 
 //==============================================================================
 /**
- * @brief Function check end of file
+ * @brief Function examines file readiness. Files of file systems that do not
+ *        support IOCTL_VFS__POLL request are always ready.
  *
- * @param[in]  *file    file
- * @param[out] *eof     EOF indicator
+ * @param[in]     *file         file
+ * @param[in,out] *poll         readiness request
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-int _vfs_feof(FILE *file, int *eof)
+int _vfs_fpoll(FILE *file, struct vfs_poll *poll)
 {
-        if (is_file_valid(file) && eof) {
-                *eof = file->f_flag.eof ? EOF : 0;
-                return ESUCC;
-        } else {
-                return EINVAL;
+        int err = EINVAL;
+
+        if (is_file_valid(file) && poll) {
+                poll->revents = 0;
+                poll->object  = NULL;
+
+                err = file->FS_if->fs_ioctl(file->FS_hdl, file->f_hdl,
+                                            IOCTL_VFS__POLL, poll);
+
+                if ((err == EBADRQC) || (err == ENOTSUP)) {
+                        poll->revents = poll->events & (POLLIN | POLLOUT);
+                        err = ESUCC;
+
+                } else if (err) {
+                        poll->revents = POLLERR;
+                }
+
+                if (stream_lock(file) == ESUCC) {
+                        if (  (file->f_buf.state == VFS_BUF_RD)
+                           && (file->f_buf.rdpos < file->f_buf.level) ) {
+                                poll->revents |= POLLIN;
+                        }
+
+                        stream_unlock(file);
+                }
         }
+
+        return err;
 }
 
 //==============================================================================
 /**
- * @brief Function clear file's error
+ * @brief Function set stream buffer. Buffered data is stored before change.
  *
  * @param[in] *file     file
+ * @param[in] *buffer   user buffer (NULL: buffer is allocated at first use)
+ * @param[in]  mode     buffer mode (VFS_IOFBF, VFS_IOLBF, VFS_IONBF)
+ * @param[in]  size     buffer size (0: default size if buffer is not set)
  *
  * @return One of errno value (errno.h)
  */
 //==============================================================================
-int _vfs_clearerr(FILE *file)
+int _vfs_setvbuf(FILE *file, char *buffer, int mode, size_t size)
 {
-        if (is_file_valid(file)) {
-                file->f_flag.eof   = false;
-                file->f_flag.error = false;
-                return ESUCC;
-        } else {
-                return EINVAL;
+        int err = EINVAL;
+
+        if (  is_file_valid(file)
+           && (mode >= VFS_IOFBF) && (mode <= VFS_IONBF)
+           && !(buffer && (size == 0)) ) {
+
+                err = stream_lock(file);
+                if (err) {
+                        return err;
+                }
+
+                err = stream_sync(file);
+                if (!err) {
+                        if (file->f_buf.own) {
+                                _kfree(_MM_KRN, cast(void**, &file->f_buf.data));
+                        }
+
+                        file->f_buf.data  = cast(u8_t*, buffer);
+                        file->f_buf.size  = size ? size : __OS_STREAM_BUFFER_LENGTH__;
+                        file->f_buf.level = 0;
+                        file->f_buf.rdpos = 0;
+                        file->f_buf.mode  = mode;
+                        file->f_buf.state = VFS_BUF_IDLE;
+                        file->f_buf.own   = false;
+                }
+
+                stream_unlock(file);
         }
+
+        return err;
 }
 
 //==============================================================================
 /**
- * @brief Function check that file has no errors
+ * @brief Function put character to stream buffer. Character is stored only if
+ *        stream is in write state and there is free space in buffer, so
+ *        file system is never called. Otherwise caller should use fwrite().
  *
- * @param[in]  file     file
- * @param[out] error    error indicator (1 for error, 0 no error)
+ * @param[in] *file     file
+ * @param[in]  c        character
  *
- * @return One of errno value (errno.h)
+ * @return On success true is returned, otherwise false.
  */
 //==============================================================================
-int _vfs_ferror(FILE *file, int *error)
+bool _vfs_fputc_buffered(FILE *file, int c)
 {
-        if (is_file_valid(file) && error) {
-                *error = file->f_flag.error ? 1 : 0;
-                return ESUCC;
-        } else {
-                return EINVAL;
+        bool ok = false;
+
+        if (is_file_valid(file) && (stream_lock(file) == ESUCC)) {
+                vfs_file_buf_t *buf = &file->f_buf;
+
+                if (  file->f_flag.wr
+                   && !(file->f_flag.append && file->f_flag.rd && file->f_flag.seekmod)
+                   && (buf->state == VFS_BUF_WR)
+                   && (buf->level < buf->size)
+                   && !((buf->mode == VFS_IOLBF) && (c == '\n')) ) {
+
+                        buf->data[buf->level++] = c;
+                        ok = true;
+                }
+
+                stream_unlock(file);
         }
+
+        return ok;
 }
 
 //==============================================================================
 /**
- * @brief Synchronize internal buffers of mounted file systems
+ * @brief Function get character from stream buffer. Character is taken only if
+ *        stream is in read state and buffer is not empty, so file system is
+ *        never called. Otherwise caller should use fread().
  *
- * @param None
+ * @param[in]  *file    file
+ * @param[out] *c       character
  *
- * @return None
+ * @return On success true is returned, otherwise false.
  */
 //==============================================================================
-void _vfs_sync(void)
+bool _vfs_fgetc_buffered(FILE *file, char *c)
 {
-        if (_mutex_lock(VFS.resource_mtx, MAX_DELAY_MS) == ESUCC) {
+        bool ok = false;
 
-                _llist_foreach(FS_entry_t*, fs, VFS.mnt_list) {
-                        fs->interface->fs_sync(fs->handle);
+        if (is_file_valid(file) && c && (stream_lock(file) == ESUCC)) {
+                vfs_file_buf_t *buf = &file->f_buf;
+
+                if (  file->f_flag.rd
+                   && !file->f_flag.eof
+                   && !file->f_flag.error
+                   && (buf->state == VFS_BUF_RD)
+                   && (buf->rdpos < buf->level) ) {
+
+                        *c = buf->data[buf->rdpos++];
+                        ok = true;
                 }
 
-                _mutex_unlock(VFS.resource_mtx);
+                stream_unlock(file);
         }
+
+        return ok;
 }
 
 //==============================================================================
 /**
- * @brief  Function check if selected mount point and current mount path
- *         allow to mount this file system as root.
+ * @brief Function lock stream for current thread. Lock is recursive, so stream
+ *        can be used by locking thread (e.g. several writes are not mixed with
+ *        output of other threads).
+ *
+ * @param[in] *file     file
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_flockfile(FILE *file)
+{
+        return is_file_valid(file) ? stream_lock(file) : EINVAL;
+}
+
+//==============================================================================
+/**
+ * @brief Function unlock stream locked by _vfs_flockfile().
+ *
+ * @param[in] *file     file
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_funlockfile(FILE *file)
+{
+        if (is_file_valid(file)) {
+                stream_unlock(file);
+                return ESUCC;
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function check end of file
+ *
+ * @param[in]  *file    file
+ * @param[out] *eof     EOF indicator
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_feof(FILE *file, int *eof)
+{
+        if (is_file_valid(file) && eof) {
+                *eof = file->f_flag.eof ? EOF : 0;
+                return ESUCC;
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function clear file's error
+ *
+ * @param[in] *file     file
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_clearerr(FILE *file)
+{
+        if (is_file_valid(file)) {
+                file->f_flag.eof   = false;
+                file->f_flag.error = false;
+                return ESUCC;
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function check that file has no errors
+ *
+ * @param[in]  file     file
+ * @param[out] error    error indicator (1 for error, 0 no error)
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+int _vfs_ferror(FILE *file, int *error)
+{
+        if (is_file_valid(file) && error) {
+                *error = file->f_flag.error ? 1 : 0;
+                return ESUCC;
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Synchronize internal buffers of mounted file systems
+ *
+ * @param None
+ *
+ * @return None
+ */
+//==============================================================================
+void _vfs_sync(void)
+{
+        if (_mutex_lock(VFS.resource_mtx, MAX_DELAY_MS) == ESUCC) {
+
+                _llist_foreach(FS_entry_t*, fs, VFS.mnt_list) {
+                        sync_FS(fs);
+                }
+
+                _mutex_unlock(VFS.resource_mtx);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Write back file systems that have data older than age limit. If
+ *        amount of not synchronized data exceeds high-water mark then all
+ *        dirty file systems are written back. Clean file systems are skipped.
+ *        Function is called periodically by kworker.
+ *
+ * @return Time to next write-back [ms] (MAX_DELAY_MS if all file systems are
+ *         clean).
+ */
+//==============================================================================
+u32_t _vfs_writeback(void)
+{
+        u32_t next = MAX_DELAY_MS;
+
+        if (_mutex_lock(VFS.resource_mtx, MAX_DELAY_MS) == ESUCC) {
+
+                u64_t now = _kernel_get_time_ms();
+                bool  hwm = (DIRTY_HIGH_WATER > 0) && (VFS.dirty_bytes >= DIRTY_HIGH_WATER);
+
+                _llist_foreach(FS_entry_t*, fs, VFS.mnt_list) {
+
+                        if (!fs->dirty) {
+                                VFS.stats.wb_skipped += fs->backed ? 1 : 0;
+                                continue;
+                        }
+
+                        u64_t age = now - fs->dirty_since;
+
+                        if (age >= DIRTY_AGE_LIMIT_MS) {
+                                sync_FS(fs);
+
+                        } else if (hwm) {
+                                VFS.stats.wb_hwm_syncs++;
+                                sync_FS(fs);
+
+                        } else {
+                                next = min(next, cast(u32_t, DIRTY_AGE_LIMIT_MS - age));
+                        }
+
+                        // file system is still dirty if sync failed or new data arrived
+                        if (fs->dirty) {
+                                next = min(next, cast(u32_t, DIRTY_AGE_LIMIT_MS));
+                        }
+                }
+
+                _mutex_unlock(VFS.resource_mtx);
+        }
+
+        return next;
+}
+
+//==============================================================================
+/**
+ * @brief Function returns VFS statistics. Counters are not synchronized, so
+ *        values are approximate if VFS is used by many threads at a time.
+ *
+ * @param[out] stats            statistics
+ */
+//==============================================================================
+void _vfs_get_stats(_vfs_stats_t *stats)
+{
+        if (stats) {
+                *stats = VFS.stats;
+                stats->dirty_bytes = VFS.dirty_bytes;
+
+                _bcache_stats_t bc;
+                _bcache_get_stats(NULL, &bc);
+
+                stats->bcache_hits       = bc.hits;
+                stats->bcache_misses     = bc.misses;
+                stats->bcache_writebacks = bc.writebacks;
+                stats->bcache_evictions  = bc.evictions;
+                stats->bcache_readahead  = bc.readahead;
+                stats->bcache_blocks     = bc.blocks;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function check if selected mount point and current mount path
+ *         allow to mount this file system as root.
  *
  * @param  mount_point          mount point path
  *
@@ -1340,13 +1899,20 @@ static int new_FS_entry(FS_entry_t         *parent_FS,
         FS_entry_t *new_FS = NULL;
         int err = _kmalloc(_MM_KRN, sizeof(FS_entry_t), NULL, 0, 0, cast(void**, &new_FS));
         if (!err) {
+                VFS.stats.heap_allocs++;
+
                 err = fs_interface->fs_init(&new_FS->handle, fs_src_file, opts);
                 if (!err) {
-                        new_FS->interface     = fs_interface;
-                        new_FS->mount_point   = fs_mount_point;
-                        new_FS->parent        = parent_FS;
-                        new_FS->children_cnt  = 0;
-                        *fs_entry             = new_FS;
+                        new_FS->interface       = fs_interface;
+                        new_FS->mount_point     = fs_mount_point;
+                        new_FS->mount_point_len = strlen(fs_mount_point);
+                        new_FS->parent          = parent_FS;
+                        new_FS->children_cnt    = 0;
+                        new_FS->backed          = !isstrempty(fs_src_file);
+                        new_FS->dirty           = false;
+                        new_FS->dirty_bytes     = 0;
+                        new_FS->dirty_since     = 0;
+                        *fs_entry               = new_FS;
                 } else {
                         _kfree(_MM_KRN, cast(void**, &new_FS));
                 }
@@ -1355,6 +1921,81 @@ static int new_FS_entry(FS_entry_t         *parent_FS,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Mark file system as dirty (not synchronized with storage). Kworker
+ *         is woken up to schedule write-back when file system becomes dirty
+ *         or when dirty data reaches high-water mark.
+ *
+ * @param  fs           file system entry (can be NULL)
+ * @param  bytes        number of written bytes (0 for metadata change)
+ */
+//==============================================================================
+static void mark_dirty(FS_entry_t *fs, size_t bytes)
+{
+        if (fs && fs->backed) {
+                _kernel_scheduler_lock();
+
+                u32_t level = VFS.dirty_bytes;
+
+                bool wake = !fs->dirty
+                          || (  (DIRTY_HIGH_WATER > 0)
+                             && (level < DIRTY_HIGH_WATER)
+                             && (level + bytes >= DIRTY_HIGH_WATER) );
+
+                if (!fs->dirty) {
+                        fs->dirty       = true;
+                        fs->dirty_since = _kernel_get_time_ms();
+                }
+
+                fs->dirty_bytes += bytes;
+                VFS.dirty_bytes += bytes;
+
+                _kernel_scheduler_unlock();
+
+                if (wake) {
+                        _process_wake_up_kworker();
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Synchronize file system with storage and clear dirty state. If
+ *         synchronization fails then file system stays dirty.
+ *
+ * @param  fs           file system entry
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int sync_FS(FS_entry_t *fs)
+{
+        _kernel_scheduler_lock();
+
+        bool  dirty = fs->dirty;
+        u32_t bytes = fs->dirty_bytes;
+
+        fs->dirty        = false;
+        fs->dirty_bytes  = 0;
+        VFS.dirty_bytes -= bytes;
+
+        _kernel_scheduler_unlock();
+
+        int err = fs->interface->fs_sync(fs->handle);
+
+        if (dirty) {
+                if (err) {
+                        mark_dirty(fs, bytes);
+                } else {
+                        VFS.stats.wb_syncs++;
+                        VFS.stats.wb_bytes += bytes;
+                }
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Delete created file system entry. Function try release mounted file system.
@@ -1369,7 +2010,7 @@ static int delete_FS_entry(FS_entry_t *this)
         int err = EINVAL;
 
         if (this) {
-                err = this->interface->fs_sync(this->handle);
+                err = sync_FS(this);
                 if (err) {
                         printk("VFS: unable to sync '%s' (%d)", this->mount_point, err);
                 }
@@ -1503,46 +2144,137 @@ static int get_path_FS(const char *path, size_t len, int *position, FS_entry_t *
 //==============================================================================
 /**
  * @brief Function returned the base file system of selected path. The external
- *        path is passed by pointer ext_path.
- *        Function is thread safe.
+ *        path is passed by pointer ext_path. The longest mount point that is
+ *        a prefix of path is found in single pass of the mount table.
+ *        Function is thread safe and does not lock VFS mutex.
  *
  * @param[in]  path           path to FS
  * @param[out] ext_path       pointer to external part of path (can be NULL)
  * @param[out] fs_entry       file system entry
  *
- * @return On success base file system entry is returned, otherwise NULL.
+ * @return One of errno value (errno.h)
  */
 //==============================================================================
 static int get_path_base_FS(const char *path, const char **ext_path, FS_entry_t **fs_entry)
 {
-        const char *path_tail = path + strlen(path);
+        int err = ENOENT;
 
-        if (*(path_tail - 1) == '/') {
-                path_tail--;
-        }
+        mnt_table_t *table = mnt_table_acquire();
+        if (table) {
+                size_t path_len = strlen(path);
 
-        int err = _mutex_lock(VFS.resource_mtx, MAX_DELAY_MS);
-        if (!err) {
+                for (size_t i = 0; i < table->count; i++) {
+                        FS_entry_t *entry = table->entry[i];
 
-                while (path_tail >= path) {
-                        err = get_path_FS(path, path_tail - path + 1, NULL, fs_entry);
-                        if (!err) {
+                        // mount point always ends with slash so match is
+                        // always on path component boundary
+                        if (  path_len >= entry->mount_point_len
+                           && strncmp(path, entry->mount_point, entry->mount_point_len) == 0) {
+
+                                *fs_entry = entry;
+
+                                if (ext_path) {
+                                        *ext_path = path + entry->mount_point_len - 1;
+                                }
+
+                                err = ESUCC;
                                 break;
-                        } else {
-                                while (*(--path_tail) != '/' && path_tail >= path);
                         }
                 }
 
-                _mutex_unlock(VFS.resource_mtx);
+                mnt_table_release(table);
         }
 
-        if (!err && ext_path) {
-                *ext_path = path_tail;
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief Function create new mount table snapshot from mount list and swap
+ *        it with current one. Function must be called with locked VFS mutex.
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int mnt_table_rebuild(void)
+{
+        size_t count = _llist_size(VFS.mnt_list);
+
+        mnt_table_t *table;
+        int err = _kmalloc(_MM_KRN, sizeof(mnt_table_t) + count * sizeof(FS_entry_t*),
+                           NULL, 0, 0, cast(void**, &table));
+        if (!err) {
+                VFS.stats.heap_allocs++;
+
+                table->readers = 0;
+                table->count   = 0;
+
+                // insertion sort, longest mount point first
+                _llist_foreach(FS_entry_t*, fs, VFS.mnt_list) {
+                        size_t i = table->count++;
+
+                        while (i > 0 && table->entry[i - 1]->mount_point_len < fs->mount_point_len) {
+                                table->entry[i] = table->entry[i - 1];
+                                i--;
+                        }
+
+                        table->entry[i] = fs;
+                }
+
+                _critical_section_begin();
+                mnt_table_t *old = VFS.mnt_table;
+                VFS.mnt_table = table;
+                bool release = old && (old->readers == 0);
+                _critical_section_end();
+
+                if (release) {
+                        _kfree(_MM_KRN, cast(void**, &old));
+                }
         }
 
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief Function return current mount table snapshot. Table must be released
+ *        by mnt_table_release().
+ *
+ * @return Mount table or NULL if nothing mounted.
+ */
+//==============================================================================
+static mnt_table_t *mnt_table_acquire(void)
+{
+        _critical_section_begin();
+        mnt_table_t *table = VFS.mnt_table;
+        if (table) {
+                table->readers++;
+        }
+        _critical_section_end();
+
+        return table;
+}
+
+//==============================================================================
+/**
+ * @brief Function release mount table snapshot. Table is freed if was replaced
+ *        and this is the last reader.
+ *
+ * @param table         table to release
+ */
+//==============================================================================
+static void mnt_table_release(mnt_table_t *table)
+{
+        _critical_section_begin();
+        table->readers--;
+        bool release = (table->readers == 0) && (table != VFS.mnt_table);
+        _critical_section_end();
+
+        if (release) {
+                _kfree(_MM_KRN, cast(void**, &table));
+        }
+}
+
 //==============================================================================
 /**
  * @brief Function create new path with slash and CWD correction.
@@ -1570,6 +2302,8 @@ static int new_absolute_path(const struct vfs_path *path, enum path_correction c
         char *abspath;
         int err = _kzalloc(_MM_KRN, abslen, _CPUCTL_FAST_MEM, 0, 0, cast(void*, &abspath));
         if (!err) {
+                VFS.stats.heap_allocs++;
+
                 if (path->PATH[0] == '/') {
                         strcpy(abspath, path->PATH);
                 } else {
@@ -1588,6 +2322,7 @@ static int new_absolute_path(const struct vfs_path *path, enum path_correction c
 
                 if (_mm_align(plen) < _mm_align(abslen)) {
                         if (_kzalloc(_MM_KRN, plen, _CPUCTL_FAST_MEM, 0, 0, cast(void**, new_path)) == 0) {
+                                VFS.stats.heap_allocs++;
                                 strcpy(*new_path, abspath);
                                 _kfree(_MM_KRN, cast(void*, &abspath));
                                 abspath = *new_path;
@@ -1600,6 +2335,561 @@ static int new_absolute_path(const struct vfs_path *path, enum path_correction c
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function write data directly to file system.
+ *
+ * @param  file         file
+ * @param  src          source buffer
+ * @param  size         number of bytes to write
+ * @param  wrcnt        number of written bytes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int file_write(FILE *file, const u8_t *src, size_t size, size_t *wrcnt)
+{
+        *wrcnt = 0;
+
+        int err = file->FS_if->fs_write(file->FS_hdl,
+                                        file->f_hdl,
+                                        src,
+                                        size,
+                                        &file->f_lseek,
+                                        wrcnt,
+                                        file->f_flag.fattr);
+
+        if (!err) {
+                if (cast(ssize_t, *wrcnt) >= 0) {
+                        file->f_lseek += cast(u64_t, *wrcnt);
+                        mark_dirty(file->FS_ent, *wrcnt);
+                }
+        } else {
+                file->f_flag.error = true;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function read data directly from file system.
+ *
+ * @param  file         file
+ * @param  dst          destination buffer
+ * @param  size         number of bytes to read
+ * @param  rdcnt        number of read bytes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int file_read(FILE *file, u8_t *dst, size_t size, size_t *rdcnt)
+{
+        *rdcnt = 0;
+
+        int err = file->FS_if->fs_read(file->FS_hdl,
+                                       file->f_hdl,
+                                       dst,
+                                       size,
+                                       &file->f_lseek,
+                                       rdcnt,
+                                       file->f_flag.fattr);
+
+        if (!err) {
+                if (cast(ssize_t, *rdcnt) >= 0) {
+                        file->f_lseek += cast(u64_t, *rdcnt);
+                }
+        } else {
+                file->f_flag.error = true;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function write vector directly to file system. If file system does
+ *         not support vectored write then each buffer is written separately.
+ *         Writing is stopped at first short write.
+ *
+ * @param  file         file
+ * @param  iov          buffers
+ * @param  iovcnt       number of buffers
+ * @param  fpos         file position
+ * @param  wrcnt        number of written bytes
+ *
+ * @return One of errno value (errno.h). Error is not reported if part of data
+ *         was written.
+ */
+//==============================================================================
+static int file_writev(FILE *file, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *wrcnt)
+{
+        int err = ENOTSUP;
+
+        if (file->FS_if->fs_writev) {
+                err = file->FS_if->fs_writev(file->FS_hdl, file->f_hdl, iov, iovcnt,
+                                             fpos, wrcnt, file->f_flag.fattr);
+        }
+
+        if (err == ENOTSUP) {
+                err    = ESUCC;
+                *wrcnt = 0;
+
+                for (int i = 0; !err && (i < iovcnt); i++) {
+                        fpos_t pos = *fpos + *wrcnt;
+                        size_t n   = 0;
+
+                        if (iov[i].iov_len == 0) {
+                                continue;
+                        }
+
+                        err = file->FS_if->fs_write(file->FS_hdl, file->f_hdl,
+                                                    iov[i].iov_base, iov[i].iov_len,
+                                                    &pos, &n, file->f_flag.fattr);
+
+                        if (!err) {
+                                if (cast(ssize_t, n) <= 0) {
+                                        break;
+                                }
+
+                                *wrcnt += n;
+
+                                if (n < iov[i].iov_len) {
+                                        break;
+                                }
+                        }
+                }
+
+                if (*wrcnt > 0) {
+                        err = ESUCC;
+                }
+        }
+
+        if (err) {
+                file->f_flag.error = true;
+        } else {
+                mark_dirty(file->FS_ent, *wrcnt);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function read vector directly from file system. If file system does
+ *         not support vectored read then each buffer is read separately.
+ *         Reading is stopped at first short read.
+ *
+ * @param  file         file
+ * @param  iov          buffers
+ * @param  iovcnt       number of buffers
+ * @param  fpos         file position
+ * @param  rdcnt        number of read bytes
+ *
+ * @return One of errno value (errno.h). Error is not reported if part of data
+ *         was read.
+ */
+//==============================================================================
+static int file_readv(FILE *file, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *rdcnt)
+{
+        int err = ENOTSUP;
+
+        if (file->FS_if->fs_readv) {
+                err = file->FS_if->fs_readv(file->FS_hdl, file->f_hdl, iov, iovcnt,
+                                            fpos, rdcnt, file->f_flag.fattr);
+        }
+
+        if (err == ENOTSUP) {
+                err    = ESUCC;
+                *rdcnt = 0;
+
+                for (int i = 0; !err && (i < iovcnt); i++) {
+                        fpos_t pos = *fpos + *rdcnt;
+                        size_t n   = 0;
+
+                        if (iov[i].iov_len == 0) {
+                                continue;
+                        }
+
+                        err = file->FS_if->fs_read(file->FS_hdl, file->f_hdl,
+                                                   iov[i].iov_base, iov[i].iov_len,
+                                                   &pos, &n, file->f_flag.fattr);
+
+                        if (!err) {
+                                if (cast(ssize_t, n) <= 0) {
+                                        break;
+                                }
+
+                                *rdcnt += n;
+
+                                if (n < iov[i].iov_len) {
+                                        break;
+                                }
+                        }
+                }
+
+                if (*rdcnt > 0) {
+                        err = ESUCC;
+                }
+        }
+
+        if (err) {
+                file->f_flag.error = true;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function check I/O vector and calculate total size of buffers.
+ *
+ * @param  iov          buffers
+ * @param  iovcnt       number of buffers
+ * @param  size         total size
+ *
+ * @return If vector is correct then true is returned, otherwise false.
+ */
+//==============================================================================
+static bool is_iov_valid(const struct iovec *iov, int iovcnt, size_t *size)
+{
+        if (!iov || (iovcnt <= 0) || (iovcnt > IOV_MAX)) {
+                return false;
+        }
+
+        *size = 0;
+
+        for (int i = 0; i < iovcnt; i++) {
+                if ((iov[i].iov_base == NULL) && (iov[i].iov_len > 0)) {
+                        return false;
+                }
+
+                if (*size + iov[i].iov_len < *size) {
+                        return false;
+                }
+
+                *size += iov[i].iov_len;
+        }
+
+        return true;
+}
+
+//==============================================================================
+/**
+ * @brief  Function check if stream is buffered and allocate buffer if needed.
+ *         If buffer cannot be allocated then stream works as unbuffered.
+ *
+ * @param  file         file
+ *
+ * @return If stream buffer can be used then true is returned, otherwise false.
+ */
+//==============================================================================
+static bool stream_buf_alloc(FILE *file)
+{
+        vfs_file_buf_t *buf = &file->f_buf;
+
+        if ((buf->mode == VFS_IONBF) || (buf->size == 0)) {
+                return false;
+        }
+
+        if (buf->data == NULL) {
+                if (_kmalloc(_MM_KRN, buf->size, NULL, 0, 0, cast(void**, &buf->data)) == 0) {
+                        VFS.stats.heap_allocs++;
+                        buf->own = true;
+                } else {
+                        return false;
+                }
+        }
+
+        return true;
+}
+
+//==============================================================================
+/**
+ * @brief  Function write data stored in stream buffer. Data that was not
+ *         accepted by file system stays in buffer.
+ *
+ * @param  file         file
+ *
+ * @return One of errno value (errno.h). EAGAIN if file system accepted only
+ *         part of data.
+ */
+//==============================================================================
+static int stream_flush(FILE *file)
+{
+        vfs_file_buf_t *buf = &file->f_buf;
+        int             err = ESUCC;
+
+        if ((buf->state == VFS_BUF_WR) && (buf->level > 0)) {
+                size_t wrcnt = 0;
+                err = file_write(file, buf->data, buf->level, &wrcnt);
+
+                if (!err) {
+                        if ((cast(ssize_t, wrcnt) >= 0) && (wrcnt < buf->level)) {
+                                memmove(buf->data, &buf->data[wrcnt], buf->level - wrcnt);
+                                buf->level -= wrcnt;
+                                err = EAGAIN;
+                        } else {
+                                buf->level = 0;
+                        }
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function synchronize stream buffer with file system: data buffered
+ *         for write is stored, and data buffered for read is dropped (file
+ *         position is moved back to not consumed data).
+ *
+ * @param  file         file
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int stream_sync(FILE *file)
+{
+        vfs_file_buf_t *buf = &file->f_buf;
+        int             err = ESUCC;
+
+        if (buf->state == VFS_BUF_WR) {
+                err = stream_flush(file);
+
+        } else if (buf->state == VFS_BUF_RD) {
+                file->f_lseek -= buf->level - buf->rdpos;
+                buf->level     = 0;
+                buf->rdpos     = 0;
+        }
+
+        if (!err) {
+                buf->state = VFS_BUF_IDLE;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function write data to file by using stream buffer. Line buffered
+ *         stream is flushed if data contains new line character. Data larger
+ *         than buffer is written directly.
+ *
+ * @param  file         file
+ * @param  src          source buffer
+ * @param  size         number of bytes to write
+ * @param  wrcnt        number of written bytes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int stream_write(FILE *file, const u8_t *src, size_t size, size_t *wrcnt)
+{
+        vfs_file_buf_t *buf = &file->f_buf;
+
+        *wrcnt = 0;
+
+        if (buf->state == VFS_BUF_RD) {
+                stream_sync(file);
+        }
+
+        buf->state = VFS_BUF_WR;
+
+        if (size >= buf->size) {
+                int err = stream_flush(file);
+                if (!err) {
+                        err = file_write(file, src, size, wrcnt);
+                }
+
+                return (err == EAGAIN) ? ESUCC : err;
+        }
+
+        int err = ESUCC;
+
+        while (!err && (*wrcnt < size)) {
+                size_t n = min(buf->size - buf->level, size - *wrcnt);
+
+                if (n > 0) {
+                        memcpy(&buf->data[buf->level], &src[*wrcnt], n);
+                        buf->level += n;
+                        *wrcnt     += n;
+                } else {
+                        err = stream_flush(file);
+                }
+        }
+
+        if (!err && (buf->mode == VFS_IOLBF) && memchr(src, '\n', *wrcnt)) {
+                err = stream_flush(file);
+        }
+
+        // data is accepted by buffer, short write is reported by counter
+        return (err == EAGAIN) ? ESUCC : err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function read data from file by using stream buffer. Data larger
+ *         than buffer is read directly.
+ *
+ * @param  file         file
+ * @param  dst          destination buffer
+ * @param  size         number of bytes to read
+ * @param  rdcnt        number of read bytes
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int stream_read(FILE *file, u8_t *dst, size_t size, size_t *rdcnt)
+{
+        vfs_file_buf_t *buf = &file->f_buf;
+        int             err = ESUCC;
+
+        *rdcnt = 0;
+
+        if (buf->state != VFS_BUF_RD) {
+                buf->state = VFS_BUF_RD;
+                buf->level = 0;
+                buf->rdpos = 0;
+        }
+
+        while (!err && (*rdcnt < size)) {
+                size_t n = min(buf->level - buf->rdpos, size - *rdcnt);
+
+                if (n > 0) {
+                        memcpy(&dst[*rdcnt], &buf->data[buf->rdpos], n);
+                        buf->rdpos += n;
+                        *rdcnt     += n;
+
+                } else {
+                        size_t rdsz = 0;
+                        buf->level  = 0;
+                        buf->rdpos  = 0;
+
+                        if (size - *rdcnt >= buf->size) {
+                                err = file_read(file, &dst[*rdcnt], size - *rdcnt, &rdsz);
+                                if (!err && (cast(ssize_t, rdsz) > 0)) {
+                                        *rdcnt += rdsz;
+                                }
+                                break;
+
+                        } else {
+                                err = file_read(file, buf->data, buf->size, &rdsz);
+                                if (!err && (cast(ssize_t, rdsz) > 0)) {
+                                        buf->level = rdsz;
+                                } else {
+                                        break;
+                                }
+                        }
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function lock stream buffer and file position. Lock is recursive,
+ *         so VFS functions can be nested (e.g. fwrite() calls fseek()).
+ *
+ * @param  file         file
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int stream_lock(FILE *file)
+{
+        return _mutex_lock(file->f_mtx, MAX_DELAY_MS);
+}
+
+//==============================================================================
+/**
+ * @brief  Function unlock stream buffer and file position.
+ *
+ * @param  file         file
+ */
+//==============================================================================
+static void stream_unlock(FILE *file)
+{
+        _mutex_unlock(file->f_mtx);
+}
+
+//==============================================================================
+/**
+ * @brief  Function resolve absolute path (CWD + PATH) and correct it in place.
+ *         Path is created in scratch buffer of abspath object, so no heap is
+ *         used for typical paths. Heap is used only if path is too long. Path
+ *         object must be released by abs_path_release().
+ *
+ * @param[in]  path             path to correct
+ * @param[in]  corr             path correction kind
+ * @param[out] abspath          absolute path object
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int abs_path_resolve(const struct vfs_path *path, enum path_correction corr, abs_path_t *abspath)
+{
+        size_t cwdlen  = 0;
+        size_t pathlen = strlen(path->PATH);
+        bool   slash   = false;
+
+        if (path->PATH[0] != '/') {
+                cwdlen = strlen(path->CWD);
+                slash  = (cwdlen > 0) && (path->CWD[cwdlen - 1] != '/');
+        }
+
+        size_t abslen = cwdlen + slash + pathlen + 2; // additional slash (if needed) and nul
+
+        int err = ESUCC;
+
+        if (abslen <= sizeof(abspath->scratch)) {
+                abspath->path = abspath->scratch;
+        } else {
+                err = _kmalloc(_MM_KRN, abslen, _CPUCTL_FAST_MEM, 0, 0,
+                               cast(void**, &abspath->path));
+                if (!err) {
+                        VFS.stats.path_heap_allocs++;
+                        VFS.stats.heap_allocs++;
+                } else {
+                        abspath->path = NULL;
+                }
+        }
+
+        if (!err) {
+                VFS.stats.path_resolutions++;
+
+                memcpy(abspath->path, path->CWD, cwdlen);
+
+                if (slash) {
+                        abspath->path[cwdlen++] = '/';
+                }
+
+                memcpy(&abspath->path[cwdlen], path->PATH, pathlen + 1);
+
+                _vfs_realpath(abspath->path, corr);
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release absolute path object created by abs_path_resolve().
+ *         Function can be called for object that was not resolved successfully.
+ *
+ * @param  abspath              absolute path object
+ */
+//==============================================================================
+static void abs_path_release(abs_path_t *abspath)
+{
+        if (abspath->path && (abspath->path != abspath->scratch)) {
+                _kfree(_MM_KRN, cast(void**, &abspath->path));
+        }
+
+        abspath->path = NULL;
+}
+
 //==============================================================================
 /**
  * @brief Function reduce relative path elements from absolute path
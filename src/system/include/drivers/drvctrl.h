@@ -107,6 +107,8 @@ extern int         _driver_open                   (dev_t, u32_t);
 extern int         _driver_close                  (dev_t, bool);
 extern int         _driver_write                  (dev_t, const u8_t*, size_t, fpos_t*, size_t*, struct vfs_fattr);
 extern int         _driver_read                   (dev_t, u8_t*, size_t, fpos_t*, size_t*, struct vfs_fattr);
+extern int         _driver_writev                 (dev_t, const struct iovec*, int, fpos_t*, size_t*, struct vfs_fattr);
+extern int         _driver_readv                  (dev_t, const struct iovec*, int, fpos_t*, size_t*, struct vfs_fattr);
 extern int         _driver_ioctl                  (dev_t, int, void*);
 extern int         _driver_flush                  (dev_t);
 extern int         _driver_stat                   (dev_t, struct vfs_dev_stat*);
@@ -0,0 +1,96 @@
+/*=========================================================================*//**
+@file    bcache.h
+
+@author  Daniel Zorychta
+
+@brief   Block cache of file system backing devices.
+
+@note    Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+#ifndef _BCACHE_H_
+#define _BCACHE_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+typedef struct bcache bcache_t;
+
+/** Auxiliary cache release function: returns number of released bytes */
+typedef size_t (*_bcache_shrinker_t)(void *arg, size_t size);
+
+struct vfs_file;
+
+/** Block cache statistics */
+typedef struct {
+        u32_t hits;                     //!< number of blocks served from cache
+        u32_t misses;                   //!< number of blocks read from device
+        u32_t writebacks;               //!< number of dirty blocks written to device
+        u32_t evictions;                //!< number of blocks dropped from cache
+        u32_t readahead;                //!< number of blocks read ahead
+        u32_t blocks;                   //!< number of currently cached blocks
+} _bcache_stats_t;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern int    _bcache_create       (struct vfs_file*, size_t, size_t, bool, bcache_t**);
+extern int    _bcache_destroy      (bcache_t*);
+extern int    _bcache_set_readahead(bcache_t*, size_t);
+extern int    _bcache_read         (bcache_t*, u64_t, size_t, void*);
+extern int    _bcache_write        (bcache_t*, u64_t, size_t, const void*);
+extern int    _bcache_flush        (bcache_t*);
+extern void   _bcache_get_stats    (bcache_t*, _bcache_stats_t*);
+extern int    _bcache_register_shrinker  (_bcache_shrinker_t, void*);
+extern int    _bcache_unregister_shrinker(_bcache_shrinker_t, void*);
+extern size_t _bcache_shrink       (size_t);
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BCACHE_H_ */
+/*==============================================================================
+  End of file
+==============================================================================*/
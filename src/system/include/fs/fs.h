@@ -56,6 +56,7 @@ extern "C" {
 #include "kernel/sysfunc.h"
 #include "kernel/process.h"
 #include "fs/pipe.h"
+#include "fs/bcache.h"
 
 /*==============================================================================
   Exported symbolic constants/macros
@@ -225,6 +226,66 @@ enum SYS_FS_TYPE {
 #define API_FS_READ(fsname, ...)        _FS_EXTERN_C int _##fsname##_read(__VA_ARGS__)
 #endif
 
+#ifdef DOXYGEN
+/**
+ * @brief Macro creates unique name of vectored file write function.
+ *
+ * Function created by this macro is called by system when file system has to
+ * write multiple buffers to selected file at once (writev(), pwritev()).
+ * Buffers are written in array order starting from <i>fpos</i>. Function is
+ * optional; if it is not defined or returns @ref ENOTSUP then system writes
+ * each buffer by using function created by API_FS_WRITE(). Error shall not be
+ * returned if part of data was written.
+ *
+ * @note Macro can be used only by file system code.
+ *
+ * @param fsname        file system name
+ * @param fs_handle     [<b>void *</b>]         file system memory handler
+ * @param fhdl          [<b>void *</b>]         file handle (user defined)
+ * @param iov           [<b>const struct iovec *</b>] source buffers
+ * @param iovcnt        [<b>int</b>]            number of buffers
+ * @param fpos          [<b>fpos_t *</b>]       file position indicator (can be modified)
+ * @param wrcnt         [<b>size_t *</b>]       number of wrote bytes
+ * @param fattr         [<b>struct vfs_fattr</b>] file access attributes
+ * @return One of @ref errno value.
+ *
+ * @see struct vfs_fattr
+ */
+#define API_FS_WRITEV(fsname, fs_handle, fhdl, iov, iovcnt, fpos, wrcnt, fattr)
+#else
+#define API_FS_WRITEV(fsname, ...)      _FS_EXTERN_C int _##fsname##_writev(__VA_ARGS__)
+#endif
+
+#ifdef DOXYGEN
+/**
+ * @brief Macro creates unique name of vectored file read function.
+ *
+ * Function created by this macro is called by system when file system has to
+ * read selected file to multiple buffers at once (readv(), preadv()). Buffers
+ * are filled in array order starting from <i>fpos</i>. Function is optional;
+ * if it is not defined or returns @ref ENOTSUP then system reads each buffer
+ * by using function created by API_FS_READ(). Error shall not be returned if
+ * part of data was read.
+ *
+ * @note Macro can be used only by file system code.
+ *
+ * @param fsname        file system name
+ * @param fs_handle     [<b>void *</b>]         file system memory handler
+ * @param fhdl          [<b>void *</b>]         file handle (user defined)
+ * @param iov           [<b>const struct iovec *</b>] destination buffers
+ * @param iovcnt        [<b>int</b>]            number of buffers
+ * @param fpos          [<b>fpos_t *</b>]       file position indicator (can be modified)
+ * @param rdcnt         [<b>size_t *</b>]       number of read bytes
+ * @param fattr         [<b>struct vfs_fattr</b>] file access attributes
+ * @return One of @ref errno value.
+ *
+ * @see struct vfs_fattr
+ */
+#define API_FS_READV(fsname, fs_handle, fhdl, iov, iovcnt, fpos, rdcnt, fattr)
+#else
+#define API_FS_READV(fsname, ...)       _FS_EXTERN_C int _##fsname##_readv(__VA_ARGS__)
+#endif
+
 #ifdef DOXYGEN
 /**
  * @brief Macro creates unique name of file ioctl function.
@@ -815,6 +876,171 @@ static inline int sys_pipe_clear(pipe_t *pipe)
         return _pipe_clear(pipe);
 }
 
+//==============================================================================
+/**
+ * @brief  Examine pipe readiness (IOCTL_VFS__POLL request).
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  pipe         a pipe object
+ * @param  poll         readiness request
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_pipe_poll(pipe_t *pipe, struct vfs_poll *poll)
+{
+        return _pipe_poll(pipe, poll);
+}
+
+//==============================================================================
+/**
+ * @brief  Create block cache of file system backing device.
+ *
+ * Blocks are cached in kernel memory (accounted as cache) and released
+ * automatically when system is running out of memory.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  dev            backing device (file)
+ * @param  blksize        block size in bytes
+ * @param  max_blocks     cache capacity in blocks (0: requests go directly to device)
+ * @param  write_through  write blocks to device immediately
+ * @param  bcache         created cache
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_create(FILE *dev, size_t blksize, size_t max_blocks,
+                                    bool write_through, bcache_t **bcache)
+{
+        return _bcache_create(dev, blksize, max_blocks, write_through, bcache);
+}
+
+//==============================================================================
+/**
+ * @brief  Flush and destroy block cache. Backing device is not closed.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  bcache       a cache object
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_destroy(bcache_t *bcache)
+{
+        return _bcache_destroy(bcache);
+}
+
+//==============================================================================
+/**
+ * @brief  Set maximum read-ahead window of block cache. Sequential reads
+ *         are detected by cache and served by multi-block device requests.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  bcache       a cache object
+ * @param  max_blocks   maximum read-ahead window in blocks (0: disabled)
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_set_readahead(bcache_t *bcache, size_t max_blocks)
+{
+        return _bcache_set_readahead(bcache, max_blocks);
+}
+
+//==============================================================================
+/**
+ * @brief  Read blocks through block cache.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  bcache       a cache object
+ * @param  blk          first block number
+ * @param  count        number of blocks
+ * @param  dst          destination buffer
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_read(bcache_t *bcache, u64_t blk, size_t count, void *dst)
+{
+        return _bcache_read(bcache, blk, count, dst);
+}
+
+//==============================================================================
+/**
+ * @brief  Write blocks through block cache.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  bcache       a cache object
+ * @param  blk          first block number
+ * @param  count        number of blocks
+ * @param  src          source buffer
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_write(bcache_t *bcache, u64_t blk, size_t count, const void *src)
+{
+        return _bcache_write(bcache, blk, count, src);
+}
+
+//==============================================================================
+/**
+ * @brief  Write dirty blocks of block cache to device.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  bcache       a cache object
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_flush(bcache_t *bcache)
+{
+        return _bcache_flush(bcache);
+}
+
+//==============================================================================
+/**
+ * @brief  Register function that releases file system auxiliary cache (e.g.
+ *         maps, tables) when system is running out of memory. Function is
+ *         called from allocator context and must not block.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  fn           release function (returns number of released bytes)
+ * @param  arg          release function argument
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_register_shrinker(_bcache_shrinker_t fn, void *arg)
+{
+        return _bcache_register_shrinker(fn, arg);
+}
+
+//==============================================================================
+/**
+ * @brief  Unregister auxiliary cache release function.
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param  fn           release function
+ * @param  arg          release function argument
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_bcache_unregister_shrinker(_bcache_shrinker_t fn, void *arg)
+{
+        return _bcache_unregister_shrinker(fn, arg);
+}
+
 //==============================================================================
 /**
  * @brief  Function return size of programs table (number of programs)
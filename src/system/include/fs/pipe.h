@@ -48,6 +48,8 @@ extern "C" {
 ==============================================================================*/
 typedef struct pipe pipe_t;
 
+struct vfs_poll;
+
 /*==============================================================================
   Exported objects
 ==============================================================================*/
@@ -63,6 +65,7 @@ extern int  _pipe_write     (pipe_t*, const u8_t*, size_t, size_t*, bool);
 extern int  _pipe_close     (pipe_t*);
 extern int  _pipe_clear     (pipe_t*);
 extern int  _pipe_permanent (pipe_t*);
+extern int  _pipe_poll      (pipe_t*, struct vfs_poll*);
 
 /*==============================================================================
   Exported inline functions
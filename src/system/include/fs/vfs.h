@@ -139,6 +139,16 @@ extern "C" {
 #define ETX                                     0x03
 #define EOT                                     0x04
 
+/* stream buffer modes (compatible with _IOFBF, _IOLBF, and _IONBF) */
+#define VFS_IOFBF                               0
+#define VFS_IOLBF                               1
+#define VFS_IONBF                               2
+
+/* stream buffer states */
+#define VFS_BUF_IDLE                            0
+#define VFS_BUF_RD                              1
+#define VFS_BUF_WR                              2
+
 /* IO operations on files */
 #define IOCTL_PIPE__CLOSE                       _IO(PIPE, 0x00)
 #define IOCTL_PIPE__CLEAR                       _IO(PIPE, 0x01)
@@ -149,6 +159,7 @@ extern "C" {
 #define IOCTL_VFS__NON_BLOCKING_WR_MODE         _IO(VFS,  0x03)
 #define IOCTL_VFS__DEFAULT_WR_MODE              _IO(VFS,  0x04)
 #define IOCTL_VFS__IS_NON_BLOCKING_WR_MODE      _IO(VFS,  0x05)
+#define IOCTL_VFS__POLL                         _IOWR(VFS, 0x06, struct vfs_poll*)
 
 /* file system identifier */
 #define _VFS_FILE_SYSTEM_MAGIC_NO               0xD9EFD24F
@@ -172,6 +183,13 @@ struct vfs_fattr {
         bool non_blocking_wr:1;         /**< non-blocking file write access */
 };
 
+/** object readiness request (IOCTL_VFS__POLL) */
+struct vfs_poll {
+        u32_t       events;             /**< requested events (POLLIN, POLLOUT) */
+        u32_t       revents;            /**< returned events */
+        const void *object;             /**< object notified on state change */
+};
+
 /** file system interface */
 typedef struct vfs_FS_itf {
         int (*fs_init    )(void **fshdl, const char *path, const char *opts);
@@ -180,6 +198,8 @@ typedef struct vfs_FS_itf {
         int (*fs_close   )(void *fshdl, void  *fhdl, bool force);
         int (*fs_write   )(void *fshdl, void  *fhdl, const u8_t *src, size_t count, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr attr);
         int (*fs_read    )(void *fshdl, void  *fhdl, u8_t *dst, size_t count, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr attr);
+        int (*fs_writev  )(void *fshdl, void  *fhdl, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *wrcnt, struct vfs_fattr attr);
+        int (*fs_readv   )(void *fshdl, void  *fhdl, const struct iovec *iov, int iovcnt, fpos_t *fpos, size_t *rdcnt, struct vfs_fattr attr);
         int (*fs_ioctl   )(void *fshdl, void  *fhdl, int iroq, void *arg);
         int (*fs_fstat   )(void *fshdl, void  *fhdl, struct stat *stat);
         int (*fs_flush   )(void *fshdl, void  *fhdl);
@@ -226,14 +246,28 @@ typedef struct vfs_file_flags {
         struct vfs_fattr    fattr;
 } vfs_file_flags_t;
 
+/** file stream buffer */
+typedef struct vfs_file_buf {
+        u8_t               *data;               //!< buffer (allocated at first use if NULL)
+        size_t              size;               //!< buffer size
+        size_t              level;              //!< number of bytes in buffer
+        size_t              rdpos;              //!< read position (read state only)
+        u8_t                mode;               //!< buffer mode (VFS_IOFBF, VFS_IOLBF, VFS_IONBF)
+        u8_t                state;              //!< buffer state (VFS_BUF_IDLE, VFS_BUF_RD, VFS_BUF_WR)
+        bool                own;                //!< buffer allocated by VFS
+} vfs_file_buf_t;
+
 /** file type */
 struct vfs_file {
         res_header_t        header;
         void               *FS_hdl;
         const vfs_FS_itf_t *FS_if;
+        struct FS_entry    *FS_ent;             //!< mount entry (dirty tracking)
         void               *f_hdl;
-        fpos_t              f_lseek;
+        fpos_t              f_lseek;            //!< file system position (buffer not included)
         vfs_file_flags_t    f_flag;
+        vfs_file_buf_t      f_buf;
+        mutex_t            *f_mtx;              //!< stream buffer and position lock
 };
 
 typedef struct vfs_file FILE;
@@ -266,6 +300,24 @@ enum path_correction {
         NO_SLASH_ACTION,
 };
 
+/** VFS statistics */
+typedef struct {
+        u32_t path_resolutions;         //!< number of resolved paths
+        u32_t path_heap_allocs;         //!< number of resolved paths that did not fit in scratch buffer
+        u32_t heap_allocs;              //!< number of all VFS heap allocations
+        u32_t bcache_hits;              //!< number of blocks served from block cache
+        u32_t bcache_misses;            //!< number of blocks read from devices
+        u32_t bcache_writebacks;        //!< number of dirty blocks written to devices
+        u32_t bcache_evictions;         //!< number of blocks dropped from block cache
+        u32_t bcache_readahead;         //!< number of blocks read ahead by block cache
+        u32_t wb_syncs;                 //!< number of dirty file system synchronizations
+        u32_t wb_bytes;                 //!< number of written bytes synchronized
+        u32_t wb_hwm_syncs;             //!< number of synchronizations forced by dirty high-water mark
+        u32_t wb_skipped;               //!< number of clean file systems skipped by write-back
+        u32_t dirty_bytes;              //!< number of currently not synchronized bytes
+        u32_t bcache_blocks;            //!< number of currently cached blocks
+} _vfs_stats_t;
+
 /*==============================================================================
   Exported API functions
 ==============================================================================*/
@@ -292,15 +344,25 @@ extern int  _vfs_fopen      (const struct vfs_path*, const char*, FILE**);
 extern int  _vfs_fclose     (FILE*, bool);
 extern int  _vfs_fwrite     (const void*, size_t, size_t*, FILE*);
 extern int  _vfs_fread      (void*, size_t, size_t*, FILE*);
+extern int  _vfs_fwritev    (const struct iovec*, int, const fpos_t*, size_t*, FILE*);
+extern int  _vfs_freadv     (const struct iovec*, int, const fpos_t*, size_t*, FILE*);
 extern int  _vfs_fseek      (FILE*, i64_t, int);
 extern int  _vfs_ftell      (FILE*, i64_t*);
 extern int  _vfs_vfioctl    (FILE*, int, va_list);
 extern int  _vfs_fstat      (FILE*, struct stat*);
 extern int  _vfs_fflush     (FILE*);
+extern int  _vfs_fpoll      (FILE*, struct vfs_poll*);
+extern int  _vfs_setvbuf    (FILE*, char*, int, size_t);
+extern bool _vfs_fputc_buffered(FILE*, int);
+extern bool _vfs_fgetc_buffered(FILE*, char*);
+extern int  _vfs_flockfile  (FILE*);
+extern int  _vfs_funlockfile(FILE*);
 extern int  _vfs_feof       (FILE*, int*);
 extern int  _vfs_clearerr   (FILE*);
 extern int  _vfs_ferror     (FILE*, int*);
 extern void _vfs_sync       (void);
+extern u32_t _vfs_writeback (void);
+extern void _vfs_get_stats  (_vfs_stats_t*);
 
 /*==============================================================================
   Exported inline functions
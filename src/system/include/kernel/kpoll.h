@@ -0,0 +1,72 @@
+/*=========================================================================*//**
+@file    kpoll.h
+
+@author  Daniel Zorychta
+
+@brief   Readiness multiplexing of files and sockets.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+#ifndef _KPOLL_H_
+#define _KPOLL_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stdbool.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern int  _kpoll(struct pollfd*, nfds_t, int, int*);
+extern void _kpoll_notify(const void*);
+extern void _kpoll_notify_from_ISR(const void*, bool*);
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _KPOLL_H_ */
+/*==============================================================================
+  End of file
+==============================================================================*/
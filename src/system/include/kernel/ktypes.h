@@ -69,7 +69,9 @@ typedef enum {
 typedef struct res_header {
         void              *self;
         struct res_header *next;
-        res_type_t         type;
+        struct res_header *prev;        //!< previous resource in owner list
+        void              *owner;       //!< process that owns resource
+        res_type_t         type;        //!< must be the last field
 } res_header_t;
 
 /** KERNELSPACE: task type */
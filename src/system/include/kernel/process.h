@@ -194,7 +194,8 @@ extern const int                _prog_table_size;
 /*==============================================================================
   Exported function prototypes
 ==============================================================================*/
-extern void        _process_clean_up_killed_processes   (void);
+extern void        _process_clean_up_killed_processes   (u32_t timeout);
+extern void        _process_wake_up_kworker             (void);
 extern int         _process_create                      (const char*, const process_attr_t*, pid_t*);
 extern int         _process_kill                        (pid_t);
 extern void        _process_remove_zombie               (_process_t*, int*);
@@ -204,7 +205,9 @@ extern const char *_process_get_CWD                     (_process_t*);
 extern int         _process_set_CWD                     (_process_t*, const char*);
 extern int         _process_register_resource           (_process_t*, res_header_t*);
 extern int         _process_release_resource            (_process_t*, res_header_t*, res_type_t);
+extern FILE       *_process_get_stdout                  (_process_t*);
 extern FILE       *_process_get_stderr                  (_process_t*);
+extern void      **_process_get_mem_arena               (_process_t*);
 extern const char *_process_get_name                    (_process_t*);
 extern size_t      _process_get_count                   (void);
 extern _process_t *_process_get_active                  (void);
@@ -221,10 +224,10 @@ extern int         _process_thread_create               (_process_t*, thread_fun
 extern int         _process_thread_kill                 (_process_t*, tid_t);
 extern task_t     *_process_thread_get_task             (_process_t *proc, tid_t tid);
 extern int         _process_thread_get_stat             (pid_t, tid_t tid, thread_stat_t*);
-extern void        _process_syscall_stat_inc            (_process_t *proc, _process_t *kworker);
+extern void        _process_get_current                 (_process_t **proc, tid_t *tid);
+extern void        _process_syscall_enter               (_process_t *proc, tid_t tid, _process_t *kworker);
+extern void        _process_syscall_exit                (_process_t *proc, tid_t tid);
 extern bool        _process_is_consistent               (void);
-extern void        _process_enter_kernelspace           (_process_t *proc);
-extern void        _process_exit_kernelspace            (_process_t *proc);
 extern bool        _process_is_kernelspace              (_process_t *proc, tid_t thread);
 extern void        _task_switched_in                    (task_t *task, void *task_tag);
 extern void        _task_switched_out                   (task_t *task, void *task_tag);
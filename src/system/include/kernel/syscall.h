@@ -68,7 +68,7 @@ typedef enum {// NAME                      | RETURN TYPE    | ARG 1
         SYSCALL_SETCWD,                 // | int            | const char *cwd           |                                     |                           |                           |                                           |
     #endif
     #if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
-        SYSCALL_SYSLOGREAD,             // | size_t         | char *str                 | size_t *len                         | const struct timeval *from| struct timeval *current   |                                           |
+        SYSCALL_SYSLOGREAD,             // | size_t         | char *str                 | size_t *len                         | u32_t *seq                | struct timeval *msg_time  |                                           |
     #endif
         SYSCALL_THREADCREATE,           // | tid_t          | thread_func_t             | thread_attr_t *attr                 | void *arg                 |                           |                                           |
         SYSCALL_SEMAPHORECREATE,        // | sem_t*         | const size_t *cnt_max     | const size_t *cnt_init              |                           |                           |                                           |
@@ -124,10 +124,13 @@ typedef enum {// NAME                      | RETURN TYPE    | ARG 1
         SYSCALL_FCLOSE,                 // | int            | FILE *file                |                                     |                           |                           |                                           |
         SYSCALL_FWRITE,                 // | size_t         | const void *src           | size_t *size                        | size_t *count             | FILE *file                |                                           |
         SYSCALL_FREAD,                  // | size_t         | void *dst                 | size_t *size                        | size_t *count             | FILE *file                |                                           |
+        SYSCALL_WRITEV,                 // | ssize_t        | FILE *file                | const struct iovec *iov             | int *iovcnt               | const fpos_t *offset      |                                           |
+        SYSCALL_READV,                  // | ssize_t        | FILE *file                | const struct iovec *iov             | int *iovcnt               | const fpos_t *offset      |                                           |
         SYSCALL_FSEEK,                  // | int            | FILE *file                | i64_t  *seek                        | int    *origin            |                           |                                           |
         SYSCALL_IOCTL,                  // | int            | FILE *file                | int *request                        | va_list *arg              |                           |                                           |
         SYSCALL_FFLUSH,                 // | int            | FILE *file                |                                     |                           |                           |                                           |
         SYSCALL_SYNC,                   // | void           |                           |                                     |                           |                           |                                           |
+        SYSCALL_POLL,                   // | int            | struct pollfd *fds        | nfds_t *nfds                        | int *timeout              |                           |                                           |
     #if __OS_ENABLE_TIMEMAN__ == _YES_
         SYSCALL_GETTIME,                // | int            | struct timeval *          |                                     |                           |                           |                                           |
         SYSCALL_SETTIME,                // | int            | time_t *time              |                                     |                           |                           |                                           |
@@ -155,6 +158,8 @@ typedef enum {// NAME                      | RETURN TYPE    | ARG 1
         SYSCALL_NETSENDTO,              // | int            | SOCKET *socket            | const void *buf                     | size_t *len               | NET_flags_t *flags        | const NET_generic_sockaddr_t *to_sockaddr |
         SYSCALL_NETRECVFROM,            // | int            | SOCKET *socket            | void *buf                           | size_t *len               | NET_flags_t *flags        | NET_generic_sockaddr_t *from_sockaddr     |
         SYSCALL_NETGETADDRESS,          // | int            | SOCKET *socket            | NET_generic_sockaddr_t *addr        |                           |                           |                                           |
+        SYSCALL_NETPEEK,                // | int            | SOCKET *socket            | const void **data                   |                           |                           |                                           |
+        SYSCALL_NETCONSUME,             // | int            | SOCKET *socket            | size_t *len                         |                           |                           |                                           |
     #endif
 #define _SYSCALL_GROUP_1_BLOCKING       _SYSCALL_COUNT // network group ----------------+-------------------------------------+---------------------------+---------------------------+-------------------------------------------+
         _SYSCALL_COUNT
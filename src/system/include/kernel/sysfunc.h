@@ -53,9 +53,11 @@
 #include "lib/vfprintf.h"
 #include "lib/vsscanf.h"
 #include "lib/stropt.h"
+#include "lib/checksum.h"
 #include "kernel/errno.h"
 #include "kernel/printk.h"
 #include "kernel/kwrapper.h"
+#include "kernel/kpoll.h"
 #include "kernel/time.h"
 #include "kernel/process.h"
 #include "kernel/syscall.h"
@@ -3269,6 +3271,29 @@ static inline void sys_sync(void)
 static inline void printk(const char *format, ...);
 #endif
 
+#if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
+//==============================================================================
+/**
+ * @brief Function reads kernel log message selected by sequence number. The
+ *        sequence number is a cursor that is set to the next message. If
+ *        selected message was overwritten then the oldest one is read.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param str           destination buffer
+ * @param len           destination buffer length
+ * @param seq           message sequence number (cursor)
+ * @param msg_time      message time from system start
+ *
+ * @return Number of bytes copied to the buffer. 0 if there is no new message.
+ */
+//==============================================================================
+static inline size_t sys_printk_read(char *str, size_t len, u32_t *seq, struct timeval *msg_time)
+{
+        return _printk_read(str, len, seq, msg_time);
+}
+#endif
+
 //==============================================================================
 /**
  * @brief Function prints message according to format to buffer.
@@ -5392,6 +5417,41 @@ static inline void sys_critical_section_end(void)
         _critical_section_end();
 }
 
+//==============================================================================
+/**
+ * @brief Function notifies that readiness of object was changed. Threads that
+ *        wait in poll() for selected object are woken up.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param object        object reported by IOCTL_VFS__POLL request
+ *
+ * @see sys_poll_notify_from_ISR()
+ */
+//==============================================================================
+static inline void sys_poll_notify(const void *object)
+{
+        _kpoll_notify(object);
+}
+
+//==============================================================================
+/**
+ * @brief Function notifies that readiness of object was changed. Function
+ *        can be used in interrupt routine.
+ *
+ * @note Function can be used only by file system or driver code.
+ *
+ * @param object        object reported by IOCTL_VFS__POLL request
+ * @param task_woken    true if higher priority task woken, otherwise false (can be NULL)
+ *
+ * @see sys_poll_notify()
+ */
+//==============================================================================
+static inline void sys_poll_notify_from_ISR(const void *object, bool *task_woken)
+{
+        _kpoll_notify_from_ISR(object, task_woken);
+}
+
 //==============================================================================
 /**
  * @brief Function disable interrupts.
@@ -5878,6 +5938,53 @@ static inline bool sys_stropt_is_flag(const char *opts, const char *flag)
         return _stropt_is_flag(opts, flag);
 }
 
+//==============================================================================
+/**
+ * @brief  Function calculate Fletcher-16 checksum.
+ *
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ *
+ * @return Checksum.
+ */
+//==============================================================================
+static inline u16_t sys_fletcher16(const void *data, size_t bytes)
+{
+        return _fletcher16(data, bytes);
+}
+
+//==============================================================================
+/**
+ * @brief  Function calculate Fletcher-32 checksum.
+ *
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ *
+ * @return Checksum.
+ */
+//==============================================================================
+static inline u32_t sys_fletcher32(const void *data, size_t bytes)
+{
+        return _fletcher32(data, bytes);
+}
+
+//==============================================================================
+/**
+ * @brief  Function calculate CRC-32C checksum. Calculation can be continued
+ *         by passing previous result as crc argument.
+ *
+ * @param  crc          previous CRC value (0 at start)
+ * @param  data         buffer
+ * @param  bytes        buffer size
+ *
+ * @return CRC value.
+ */
+//==============================================================================
+static inline u32_t sys_crc32c(u32_t crc, const void *data, size_t bytes)
+{
+        return _crc32c(crc, data, bytes);
+}
+
 //==============================================================================
 /**
  * @brief Function find driver name and then initialize device
@@ -6000,6 +6107,58 @@ static inline int sys_driver_read(dev_t            id,
         return _driver_read(id, dst, count, fpos, rdcnt, fattr);
 }
 
+//==============================================================================
+/**
+ * @brief Function write multiple buffers to driver
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param id            module id
+ * @param iov           data sources
+ * @param iovcnt        number of buffers
+ * @param fpos          file position
+ * @param wrcnt         number of written bytes
+ * @param fattr         file attributes
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_driver_writev(dev_t               id,
+                                    const struct iovec *iov,
+                                    int                 iovcnt,
+                                    fpos_t             *fpos,
+                                    size_t             *wrcnt,
+                                    struct vfs_fattr    fattr)
+{
+        return _driver_writev(id, iov, iovcnt, fpos, wrcnt, fattr);
+}
+
+//==============================================================================
+/**
+ * @brief Function read driver to multiple buffers
+ *
+ * @note Function can be used only by file system code.
+ *
+ * @param id            module id
+ * @param iov           data destinations
+ * @param iovcnt        number of buffers
+ * @param fpos          file position
+ * @param rdcnt         number of read bytes
+ * @param fattr         file attributes
+ *
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+static inline int sys_driver_readv(dev_t               id,
+                                   const struct iovec *iov,
+                                   int                 iovcnt,
+                                   fpos_t             *fpos,
+                                   size_t             *rdcnt,
+                                   struct vfs_fattr    fattr)
+{
+        return _driver_readv(id, iov, iovcnt, fpos, rdcnt, fattr);
+}
+
 //==============================================================================
 /**
  * @brief IO control
@@ -0,0 +1,92 @@
+/*==============================================================================
+File     checksum.h
+
+Author   Daniel Zorychta
+
+Brief    Checksum library (Fletcher-16, Fletcher-32, CRC-32C).
+
+         Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+==============================================================================*/
+
+/**
+@defgroup CHECKSUM_H_ CHECKSUM_H_
+
+Checksum algorithms used by file systems and network stacks. All functions
+process data word-at-a-time when the buffer is aligned, unaligned head and
+tail bytes are processed one by one. Results do not depend on alignment nor on
+the way how data is split between update calls.
+*/
+/**@{*/
+
+#ifndef _CHECKSUM_H_
+#define _CHECKSUM_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+/** Fletcher-16 incremental calculation context. */
+typedef struct {
+        uint32_t sum1;          /*!< First sum (modulo 255) */
+        uint32_t sum2;          /*!< Second sum (modulo 255) */
+} _fletcher16_t;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern void     _fletcher16_init(_fletcher16_t *chks);
+extern void     _fletcher16_update(_fletcher16_t *chks, const void *data, size_t bytes);
+extern uint16_t _fletcher16_final(const _fletcher16_t *chks);
+extern uint16_t _fletcher16(const void *data, size_t bytes);
+extern uint32_t _fletcher32(const void *data, size_t bytes);
+extern uint32_t _crc32c(uint32_t crc, const void *data, size_t bytes);
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CHECKSUM_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
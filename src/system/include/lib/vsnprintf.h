@@ -48,6 +48,16 @@ extern "C" {
 /*==============================================================================
   Exported object types
 ==============================================================================*/
+/** formatter output function: returns 0 on success, other value breaks formatting */
+typedef int (*_vsnprintf_out_t)(void *ctx, const char *str, size_t len);
+
+/** packed formatter argument (see _vsnprintf_pack()) */
+typedef union {
+        int32_t   i;            //!< int and char arguments, string precision
+        int64_t   ll;           //!< long long arguments
+        uintptr_t p;            //!< pointers, offset of string in string buffer
+        double    d;            //!< floating point arguments
+} _vsnprintf_arg_t;
 
 /*==============================================================================
   Exported objects
@@ -57,7 +67,10 @@ extern "C" {
   Exported functions
 ==============================================================================*/
 extern int _vsnprintf(char *buf, size_t size, const char *format, va_list arg);
+extern int _vsnprintf_out(char *buf, size_t size, _vsnprintf_out_t out, void *ctx, const char *format, va_list arg);
 extern int _snprintf(char *bfr, size_t size, const char *format, ...);
+extern int _vsnprintf_pack(const char *format, va_list arg, _vsnprintf_arg_t *args, size_t max_args, char *str, size_t str_size);
+extern int _vsnprintf_unpack(char *buf, size_t size, const char *format, const _vsnprintf_arg_t *args, size_t argc, const char *str);
 
 /*==============================================================================
   Exported inline functions
@@ -557,6 +557,61 @@ static inline int socket_read(SOCKET *socket, void *buf, size_t len)
 #endif
 }
 
+//==============================================================================
+/**
+ * @brief  The function returns view of data received by socket without
+ *         copying. Data stays in socket buffer and is valid until it is
+ *         released by socket_consume(). Function is supported by SIPC
+ *         sockets only.
+ *
+ * @param  socket       The socket from which to receive the data.
+ * @param  data         Pointer to received data.
+ *
+ * @return Number of bytes available in view, or -1 on error and
+ *         @ref errno value is set appropriately.
+ *
+ * @see socket_consume(), socket_recv()
+ */
+//==============================================================================
+static inline int socket_peek(SOCKET *socket, const void **data)
+{
+#if __ENABLE_NETWORK__ == _YES_
+        int result = -1;
+        syscall(SYSCALL_NETPEEK, &result, socket, data);
+        return result;
+#else
+        UNUSED_ARG2(socket, data);
+        _errno = ENOTSUP;
+        return -1;
+#endif
+}
+
+//==============================================================================
+/**
+ * @brief  The function releases data returned by socket_peek().
+ *
+ * @param  socket       The socket from which the data is received.
+ * @param  len          Number of bytes to release.
+ *
+ * @return On success 0 is returned, otherwise -1 and @ref errno value is set
+ *         appropriately.
+ *
+ * @see socket_peek()
+ */
+//==============================================================================
+static inline int socket_consume(SOCKET *socket, size_t len)
+{
+#if __ENABLE_NETWORK__ == _YES_
+        int result = -1;
+        syscall(SYSCALL_NETCONSUME, &result, socket, &len);
+        return result;
+#else
+        UNUSED_ARG2(socket, len);
+        _errno = ENOTSUP;
+        return -1;
+#endif
+}
+
 //==============================================================================
 /**
  * @brief  The function is used to receive messages from another socket.
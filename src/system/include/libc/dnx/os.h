@@ -102,6 +102,36 @@ typedef struct {
 } avg_CPU_load_t;
 #endif
 
+#ifdef DOXYGEN
+/**
+ * @brief Virtual File System statistics
+ *
+ * The type contains counters of path resolutions and heap allocations
+ * done by VFS, counters of file system block cache, and counters of file
+ * system write-back since system start.
+ *
+ * @see get_VFS_statistics()
+ */
+typedef struct {
+        u32_t path_resolutions;         /*!< Number of resolved paths.*/
+        u32_t path_heap_allocs;         /*!< Number of resolved paths that required heap allocation.*/
+        u32_t heap_allocs;              /*!< Number of all VFS heap allocations (paths, files, directories).*/
+        u32_t bcache_hits;              /*!< Number of blocks served from block cache.*/
+        u32_t bcache_misses;            /*!< Number of blocks read from devices (cache miss).*/
+        u32_t bcache_writebacks;        /*!< Number of dirty blocks written to devices.*/
+        u32_t bcache_evictions;         /*!< Number of blocks dropped from block cache.*/
+        u32_t bcache_readahead;         /*!< Number of blocks read ahead by block cache (sequential reads).*/
+        u32_t wb_syncs;                 /*!< Number of synchronizations of dirty file systems.*/
+        u32_t wb_bytes;                 /*!< Number of written bytes synchronized with storage.*/
+        u32_t wb_hwm_syncs;             /*!< Number of synchronizations forced by dirty data high-water mark.*/
+        u32_t wb_skipped;               /*!< Number of clean file systems skipped by periodic write-back.*/
+        u32_t dirty_bytes;              /*!< Number of bytes written but not synchronized with storage yet.*/
+        u32_t bcache_blocks;            /*!< Number of currently cached blocks.*/
+} vfsstat_t;
+#else
+typedef _vfs_stats_t vfsstat_t;
+#endif
+
 /*==============================================================================
   Exported object declarations
 ==============================================================================*/
@@ -279,6 +309,42 @@ static inline i32_t get_module_memory_usage(uint module_number)
         return size;
 }
 
+//==============================================================================
+/**
+ * @brief Function returns Virtual File System statistics.
+ *
+ * The function get_VFS_statistics() return VFS counters pointed by
+ * <i>stat</i>. Counters can be used to check how many heap allocations are
+ * done by file operations.
+ *
+ * @param stat      VFS statistics
+ *
+ * @b Example
+ * @code
+        #include <dnx/os.h>
+        #include <sys/stat.h>
+
+        // ...
+
+        vfsstat_t before, after;
+        struct stat st;
+
+        get_VFS_statistics(&before);
+        stat("/dev/null", &st);
+        get_VFS_statistics(&after);
+
+        printf("Heap allocations: %u\n", after.heap_allocs - before.heap_allocs);
+
+        // ...
+
+   @endcode
+ */
+//==============================================================================
+static inline void get_VFS_statistics(vfsstat_t *stat)
+{
+        _builtinfunc(vfs_get_stats, stat);
+}
+
 //==============================================================================
 /**
  * @brief Function returns system uptime in seconds.
@@ -903,15 +969,18 @@ static inline void system_shutdown(void)
 /**
  * @brief Function raed system log.
  *
- * The function syslog_read() read system log messages. Read message is
- * deleted from system ring buffer.
+ * The function syslog_read() read system log message selected by sequence
+ * number. The sequence number is a cursor: it is set to the next message, so
+ * next call returns the next message. If selected message was overwritten
+ * then the oldest message is read. Messages are formatted at read.
  *
  * @param  str          message string
  * @param  len          maximum string size
- * @param  from_time    time from log is get (time from system start)
- * @param  curr_time    log current time (time from system start)
+ * @param  seq          message sequence number (0 to read from the oldest)
+ * @param  msg_time     message time (time from system start)
  *
- * @return String size. 0 if system log is empty.
+ * @return String size (at least 1 if message was read). 0 if there is no
+ *         new message.
  *
  * @b Example
  * @code
@@ -920,8 +989,9 @@ static inline void system_shutdown(void)
         // ...
 
         char msg[128];
-        struct timeval t = {0, 0};
-        while (syslog_read(msg, sizeof(msg), &t, &t) {
+        u32_t seq = 0;
+        struct timeval t;
+        while (syslog_read(msg, sizeof(msg), &seq, &t)) {
                 puts(msg);
         }
 
@@ -930,17 +1000,17 @@ static inline void system_shutdown(void)
    @endcode
  */
 //==============================================================================
-static inline size_t syslog_read(char *str, size_t len, const struct timeval *from_time, struct timeval *curr_time)
+static inline size_t syslog_read(char *str, size_t len, u32_t *seq, struct timeval *msg_time)
 {
 #if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
         size_t n = 0;
-        syscall(SYSCALL_SYSLOGREAD, &n, str, &len, from_time, curr_time);
+        syscall(SYSCALL_SYSLOGREAD, &n, str, &len, seq, msg_time);
         return n;
 #else
         (void)str;
         (void)len;
-        (void)from_time;
-        (void)curr_time;
+        (void)seq;
+        (void)msg_time;
         return 0;
 #endif
 }
@@ -0,0 +1,155 @@
+/*=========================================================================*//**
+@file    poll.h
+
+@author  Daniel Zorychta
+
+@brief   Wait for some event on a set of files and sockets.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/**
+\defgroup poll-h <poll.h>
+
+The library provides a function that waits for one of a set of files or
+sockets to become ready to perform I/O. The files and sockets can be mixed
+in a single request, so a single thread is able to serve many connections.
+
+*/
+/**@{*/
+
+#ifndef _POLL_H_
+#define _POLL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <sys/types.h>
+#include <kernel/syscall.h>
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+#ifdef DOXYGEN
+#define POLLIN          0x01    //!< Data may be read without blocking
+#define POLLOUT         0x04    //!< Data may be written without blocking
+#define POLLERR         0x08    //!< Error condition (revents only)
+#define POLLHUP         0x10    //!< Hang up (revents only)
+#define POLLNVAL        0x20    //!< Invalid object (revents only)
+#endif
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+#ifdef DOXYGEN
+/** @brief Number of poll descriptors. */
+typedef uint nfds_t;
+
+/** @brief Poll descriptor. */
+struct pollfd {
+        void  *fd;              //!< FILE or SOCKET object (NULL is ignored)
+        short  events;          //!< Requested events
+        short  revents;         //!< Returned events
+};
+#endif
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief Function waits for one of a set of files or sockets to become ready.
+ *
+ * Function examines objects pointed by <i>fds</i> (FILE or SOCKET). Each
+ * descriptor contains events that are requested by caller. When at least
+ * one object is ready the function returns and <i>revents</i> of each
+ * descriptor are set. The @ref POLLERR, @ref POLLHUP, and @ref POLLNVAL
+ * events are always reported. Descriptors with NULL object are ignored.
+ *
+ * The calling thread does not consume CPU time when waiting; objects wake
+ * it up when their state change.
+ *
+ * @param fds           array of descriptors
+ * @param nfds          number of descriptors
+ * @param timeout       timeout in milliseconds (0: no wait, -1: infinite)
+ *
+ * @exception | @ref EINVAL
+ * @exception | @ref ENOMEM
+ *
+ * @return Returns number of descriptors with non-zero <i>revents</i>,
+ * \b 0 on timeout. On error \b -1 is returned and <b>errno</b> is set
+ * appropriately.
+ *
+ * @b Example
+ * @code
+        #include <stdio.h>
+        #include <poll.h>
+
+        // ...
+
+        struct pollfd fds[2] = {
+                {.fd = file1, .events = POLLIN},
+                {.fd = file2, .events = POLLIN}
+        };
+
+        while (poll(fds, 2, -1) > 0) {
+                if (fds[0].revents & POLLIN) {
+                        // read file1
+                }
+
+                if (fds[1].revents & POLLIN) {
+                        // read file2
+                }
+        }
+
+        // ...
+   @endcode
+ */
+//==============================================================================
+static inline int poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+        int r = -1;
+        syscall(SYSCALL_POLL, &r, fds, &nfds, &timeout);
+        return r;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _POLL_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -890,15 +890,15 @@ extern void perror(const char *s);
 
 //==============================================================================
 /**
- * @brief Function sets stream buffer mode.
+ * @brief Function sets stream buffer.
  *
- * The routine exist in dnx RTOS only for compatible reasons. Function in this
- * case do nothing.
- *
- * @note Function not supported.
+ * The function setbuf() is equivalent to
+ * <b>setvbuf</b>(<i>file</i>, <i>buffer</i>, <i>buffer</i> ? @ref _IOFBF : @ref _IONBF, @ref BUFSIZ).
+ * If <i>buffer</i> is not @ref NULL then it must have at least @ref BUFSIZ
+ * bytes and must be valid until stream is closed.
  *
  * @param file      stream
- * @param buffer    buffer
+ * @param buffer    buffer (@ref NULL: stream is unbuffered)
  *
  * @b Example
  * @code
@@ -921,24 +921,38 @@ extern void perror(const char *s);
 //==============================================================================
 static inline void setbuf(FILE *file, char *buffer)
 {
-        (void) file;
-        (void) buffer;
+        _errno = _builtinfunc(vfs_setvbuf, file, buffer, buffer ? _IOFBF : _IONBF, BUFSIZ);
 }
 
 //==============================================================================
 /**
  * @brief Function sets stream buffer mode.
  *
- * The routine exist in dnx RTOS only for compatible reasons. Function in this
- * case do nothing.
+ * The function setvbuf() sets buffer mode of stream <i>file</i>:
+ * @ref _IONBF (unbuffered: data is written and read immediately),
+ * @ref _IOLBF (line buffered: output is written when new line character is
+ * written or buffer is full), or @ref _IOFBF (fully buffered: output is written
+ * when buffer is full, input is read in blocks). Buffered data is written when
+ * stream is flushed, closed, repositioned, or when program exits.
+ * Only fully buffered streams buffer input data.
  *
- * @note Function not supported.
+ * If <i>buffer</i> is @ref NULL then buffer of <i>size</i> bytes (or
+ * @ref BUFSIZ if <i>size</i> is 0) is allocated at first use. Otherwise
+ * <i>buffer</i> must be valid until stream is closed.
+ *
+ * By default regular files are fully buffered, standard streams connected to
+ * terminal are line buffered, other devices and pipes are unbuffered.
  *
  * @param file      stream
- * @param buffer    buffer
+ * @param buffer    buffer (can be @ref NULL)
  * @param mode      buffer mode (@ref _IONBF, @ref _IOLBF, @ref _IOFBF)
  * @param size      buffer size
  *
+ * @exception | @ref EINVAL
+ *
+ * @return Upon successful completion \b 0 is returned. Otherwise, other value
+ * is returned and @ref errno is set to indicate the error.
+ *
  * @b Example
  * @code
         #include <stdio.h>
@@ -960,12 +974,8 @@ static inline void setbuf(FILE *file, char *buffer)
 //==============================================================================
 static inline int setvbuf(FILE *file, char *buffer, int mode, size_t size)
 {
-        (void) file;
-        (void) buffer;
-        (void) mode;
-        (void) size;
-
-        return 0;
+        _errno = _builtinfunc(vfs_setvbuf, file, buffer, mode, size);
+        return _errno ? EOF : 0;
 }
 
 //==============================================================================
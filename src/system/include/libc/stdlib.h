@@ -461,12 +461,7 @@ extern void srand(unsigned int seed);
  * @see calloc(), realloc(), free()
  */
 //==============================================================================
-static inline void *malloc(size_t size)
-{
-        void *mem = NULL;
-        syscall(SYSCALL_MALLOC, &mem, &size);
-        return mem;
-}
+extern void *malloc(size_t size);
 
 //==============================================================================
 /**
@@ -496,13 +491,7 @@ static inline void *malloc(size_t size)
  * @see malloc(), realloc(), free()
  */
 //==============================================================================
-static inline void *calloc(size_t n, size_t size)
-{
-        void   *mem   = NULL;
-        size_t  bsize = n * size;
-        syscall(SYSCALL_ZALLOC, &mem, &bsize);
-        return mem;
-}
+extern void *calloc(size_t n, size_t size);
 
 //==============================================================================
 /**
@@ -534,12 +523,7 @@ static inline void *calloc(size_t n, size_t size)
  * @see malloc(), calloc(), realloc()
  */
 //==============================================================================
-static inline void free(void *ptr)
-{
-        if (ptr) {
-                syscall(SYSCALL_FREE, NULL, ptr);
-        }
-}
+extern void free(void *ptr);
 
 //==============================================================================
 /**
@@ -587,24 +571,7 @@ static inline void free(void *ptr)
  * @see malloc(), calloc(), free()
  */
 //==============================================================================
-static inline void *realloc(void *ptr, size_t size)
-{
-        extern void* memcpy(void* dest, const void* src, size_t n);
-
-        if (size) {
-                void *mem = malloc(size);
-                if (ptr == NULL)
-                        return mem;
-
-                if (mem) {
-                        memcpy(mem, ptr, size);
-                        free(ptr);
-                        return mem;
-                }
-        }
-
-        return NULL;
-}
+extern void *realloc(void *ptr, size_t size);
 
 //==============================================================================
 /**
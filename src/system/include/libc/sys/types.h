@@ -195,6 +195,34 @@ typedef struct dirent {
 } dirent_t;
 #endif
 
+#ifndef DOXYGEN // Doxygen documentation inserted in poll.h file
+#define POLLIN          0x01    //!< Data may be read without blocking
+#define POLLOUT         0x04    //!< Data may be written without blocking
+#define POLLERR         0x08    //!< Error condition (revents only)
+#define POLLHUP         0x10    //!< Hang up (revents only)
+#define POLLNVAL        0x20    //!< Invalid object (revents only)
+
+/** @brief Number of poll descriptors. */
+typedef uint nfds_t;
+
+/** @brief Poll descriptor. */
+struct pollfd {
+        void  *fd;              //!< FILE or SOCKET object (NULL is ignored)
+        short  events;          //!< Requested events
+        short  revents;         //!< Returned events
+};
+#endif
+
+#ifndef DOXYGEN // Doxygen documentation inserted in sys/uio.h file
+#define IOV_MAX         64      //!< Maximum number of I/O vector elements
+
+/** @brief I/O vector element. */
+struct iovec {
+        void   *iov_base;       //!< Buffer address
+        size_t  iov_len;        //!< Buffer size in bytes
+};
+#endif
+
 /** @brief File information. */
 struct stat {
         u64_t   st_size;        /*!< Total size, in bytes.*/
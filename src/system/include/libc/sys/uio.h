@@ -0,0 +1,250 @@
+/*=========================================================================*//**
+@file    uio.h
+
+@author  Daniel Zorychta
+
+@brief   Vectored I/O operations.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/**
+\defgroup sys-uio-h <sys/uio.h>
+
+The library provides functions that read or write multiple buffers in a single
+request (e.g. protocol header and payload, or many small records). Each request
+is a single system call and, if file system supports it, a single file system
+and driver call.
+
+*/
+/**@{*/
+
+#ifndef _UIO_H_
+#define _UIO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <sys/types.h>
+#include <kernel/syscall.h>
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+#ifdef DOXYGEN
+#define IOV_MAX         64      //!< Maximum number of I/O vector elements
+#endif
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+#ifdef DOXYGEN
+/** @brief I/O vector element. */
+struct iovec {
+        void   *iov_base;       //!< Buffer address
+        size_t  iov_len;        //!< Buffer size in bytes
+};
+#endif
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief Function reads data from file to multiple buffers.
+ *
+ * The function readv() reads <i>iovcnt</i> buffers from the file <i>file</i>
+ * into the buffers described by <i>iov</i>. Buffers are filled in array order.
+ * Data is read from current file position and the position is moved by the
+ * number of read bytes. Data buffered by stream is synchronized before read.
+ *
+ * @param file          file
+ * @param iov           array of buffers
+ * @param iovcnt        number of buffers (1..@ref IOV_MAX)
+ *
+ * @exception | @ref EINVAL
+ * @exception | @ref EPERM
+ * @exception | ...
+ *
+ * @return Returns number of read bytes. On error \b -1 is returned and
+ * <b>errno</b> is set appropriately.
+ *
+ * @b Example
+ * @code
+        #include <stdio.h>
+        #include <sys/uio.h>
+
+        // ...
+
+        struct header hdr;
+        u8_t          payload[64];
+
+        struct iovec iov[2] = {
+                {.iov_base = &hdr,    .iov_len = sizeof(hdr)    },
+                {.iov_base = payload, .iov_len = sizeof(payload)}
+        };
+
+        ssize_t n = readv(file, iov, 2);
+
+        // ...
+   @endcode
+ *
+ * @see writev(), preadv()
+ */
+//==============================================================================
+static inline ssize_t readv(FILE *file, const struct iovec *iov, int iovcnt)
+{
+        ssize_t r = -1;
+        syscall(SYSCALL_READV, &r, file, iov, &iovcnt, NULL);
+        return r;
+}
+
+//==============================================================================
+/**
+ * @brief Function writes data from multiple buffers to file.
+ *
+ * The function writev() writes <i>iovcnt</i> buffers described by <i>iov</i>
+ * to the file <i>file</i>. Buffers are written in array order. Data is written
+ * at current file position and the position is moved by the number of written
+ * bytes. Data buffered by stream is flushed before write.
+ *
+ * @param file          file
+ * @param iov           array of buffers
+ * @param iovcnt        number of buffers (1..@ref IOV_MAX)
+ *
+ * @exception | @ref EINVAL
+ * @exception | @ref EPERM
+ * @exception | ...
+ *
+ * @return Returns number of written bytes. On error \b -1 is returned and
+ * <b>errno</b> is set appropriately.
+ *
+ * @b Example
+ * @code
+        #include <stdio.h>
+        #include <sys/uio.h>
+
+        // ...
+
+        struct header hdr  = {.size = len};
+
+        struct iovec iov[2] = {
+                {.iov_base = &hdr, .iov_len = sizeof(hdr)},
+                {.iov_base = data, .iov_len = len        }
+        };
+
+        if (writev(file, iov, 2) != sizeof(hdr) + len) {
+                perror(NULL);
+        }
+
+        // ...
+   @endcode
+ *
+ * @see readv(), pwritev()
+ */
+//==============================================================================
+static inline ssize_t writev(FILE *file, const struct iovec *iov, int iovcnt)
+{
+        ssize_t r = -1;
+        syscall(SYSCALL_WRITEV, &r, file, iov, &iovcnt, NULL);
+        return r;
+}
+
+//==============================================================================
+/**
+ * @brief Function reads data from selected file offset to multiple buffers.
+ *
+ * The function preadv() works as readv() but data is read from file offset
+ * <i>offset</i>. The file position is not changed.
+ *
+ * @param file          file
+ * @param iov           array of buffers
+ * @param iovcnt        number of buffers (1..@ref IOV_MAX)
+ * @param offset        file offset
+ *
+ * @exception | @ref EINVAL
+ * @exception | @ref EPERM
+ * @exception | ...
+ *
+ * @return Returns number of read bytes. On error \b -1 is returned and
+ * <b>errno</b> is set appropriately.
+ *
+ * @see readv(), pwritev()
+ */
+//==============================================================================
+static inline ssize_t preadv(FILE *file, const struct iovec *iov, int iovcnt, fpos_t offset)
+{
+        ssize_t r = -1;
+        syscall(SYSCALL_READV, &r, file, iov, &iovcnt, &offset);
+        return r;
+}
+
+//==============================================================================
+/**
+ * @brief Function writes data from multiple buffers at selected file offset.
+ *
+ * The function pwritev() works as writev() but data is written at file offset
+ * <i>offset</i>. The file position is not changed.
+ *
+ * @param file          file
+ * @param iov           array of buffers
+ * @param iovcnt        number of buffers (1..@ref IOV_MAX)
+ * @param offset        file offset
+ *
+ * @exception | @ref EINVAL
+ * @exception | @ref EPERM
+ * @exception | ...
+ *
+ * @return Returns number of written bytes. On error \b -1 is returned and
+ * <b>errno</b> is set appropriately.
+ *
+ * @see writev(), preadv()
+ */
+//==============================================================================
+static inline ssize_t pwritev(FILE *file, const struct iovec *iov, int iovcnt, fpos_t offset)
+{
+        ssize_t r = -1;
+        syscall(SYSCALL_WRITEV, &r, file, iov, &iovcnt, &offset);
+        return r;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UIO_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/
@@ -74,6 +74,11 @@ extern "C" {
 /*==============================================================================
   Exported symbolic constants/macros
 ==============================================================================*/
+/** first fit search of the block list (lowest memory overhead) */
+#define _HEAP_MODE_FIRST_FIT            0
+
+/** segregated fit: free blocks kept in size class lists, O(1) allocation */
+#define _HEAP_MODE_SEGREGATED_FIT       1
 
 /*==============================================================================
   Exported types, enums definitions
@@ -96,6 +101,21 @@ typedef struct {
 
         /** heap amx usage */
         size_t used_max;
+
+        /** allocator mode (_HEAP_MODE_*) */
+        u8_t mode;
+
+        /** number of first level size classes (segregated fit) */
+        u8_t fl_count;
+
+        /** non-empty first level size classes (segregated fit) */
+        u32_t fl_bitmap;
+
+        /** non-empty second level size classes (segregated fit) */
+        u8_t *sl_bitmap;
+
+        /** free list heads of each size class (segregated fit) */
+        size_t *free_head;
 } _heap_t;
 
 /*==============================================================================
@@ -105,7 +125,7 @@ typedef struct {
 /*==============================================================================
   Exported function prototypes
 ==============================================================================*/
-extern int    _heap_init(_heap_t*, void*, size_t);
+extern int    _heap_init(_heap_t*, void*, size_t, u8_t);
 extern void   _heap_free(_heap_t*, void*, size_t*);
 extern void  *_heap_alloc(_heap_t*, size_t, size_t*);
 extern size_t _heap_get_free(_heap_t*);
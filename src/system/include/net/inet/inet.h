@@ -78,6 +78,8 @@ extern int   INET_socket_bind(INET_socket_t*, const NET_INET_sockaddr_t*);
 extern int   INET_socket_listen(INET_socket_t*);
 extern int   INET_socket_accept(INET_socket_t*, INET_socket_t*);
 extern int   INET_socket_recv(INET_socket_t*, void*, size_t, NET_flags_t, size_t*);
+extern int   INET_socket_peek(INET_socket_t*, const void**, size_t*);
+extern int   INET_socket_consume(INET_socket_t*, size_t);
 extern int   INET_socket_recvfrom(INET_socket_t*, void*, size_t, NET_flags_t, NET_INET_sockaddr_t*, size_t*);
 extern int   INET_socket_send(INET_socket_t*, const void*, size_t, NET_flags_t, size_t*);
 extern int   INET_socket_sendto(INET_socket_t*, const void*, size_t, NET_flags_t, const NET_INET_sockaddr_t*, size_t*);
@@ -87,6 +89,7 @@ extern int   INET_socket_set_send_timeout(INET_socket_t*, uint32_t);
 extern int   INET_socket_get_recv_timeout(INET_socket_t*, uint32_t*);
 extern int   INET_socket_get_send_timeout(INET_socket_t*, uint32_t*);
 extern int   INET_socket_getaddress(INET_socket_t*, NET_INET_sockaddr_t*);
+extern int   INET_socket_poll(INET_socket_t*, struct vfs_poll*);
 extern u16_t INET_hton_u16(u16_t);
 extern u32_t INET_hton_u32(u32_t);
 extern u64_t INET_hton_u64(u64_t);
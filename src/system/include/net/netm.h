@@ -211,6 +211,11 @@ typedef struct {
         u64_t            rx_bytes;              /*!< Number of received bytes.*/
         u64_t            tx_packets;            /*!< Number of transmitted packets.*/
         u64_t            rx_packets;            /*!< Number of received packets.*/
+        u64_t            tx_retries;            /*!< Number of retransmitted packets.*/
+        u64_t            packet_pool_allocs;    /*!< Packet buffers taken from pool.*/
+        u64_t            packet_heap_allocs;    /*!< Packet buffers allocated on heap (pool empty).*/
+        u64_t            desc_pool_allocs;      /*!< Packet descriptors taken from pool.*/
+        u64_t            desc_heap_allocs;      /*!< Packet descriptors allocated on heap (pool empty).*/
 } NET_SIPC_status_t;
 
 /** SIPC socket address. */
@@ -226,6 +231,8 @@ typedef struct {
   Exported functions
 ==============================================================================*/
 #ifndef DOXYGEN
+struct vfs_poll;
+
 extern int   _net_ifup(NET_family_t, const NET_generic_config_t*);
 extern int   _net_ifdown(NET_family_t);
 extern int   _net_ifstatus(NET_family_t, NET_generic_status_t*);
@@ -236,6 +243,8 @@ extern int   _net_socket_bind(SOCKET*, const NET_generic_sockaddr_t*);
 extern int   _net_socket_listen(SOCKET*);
 extern int   _net_socket_accept(SOCKET*, SOCKET**);
 extern int   _net_socket_recv(SOCKET*, void*, size_t, NET_flags_t, size_t*);
+extern int   _net_socket_peek(SOCKET*, const void**, size_t*);
+extern int   _net_socket_consume(SOCKET*, size_t);
 extern int   _net_socket_recvfrom(SOCKET*, void*, size_t, NET_flags_t, NET_generic_sockaddr_t*, size_t*);
 extern int   _net_socket_send(SOCKET*, const void*, size_t, NET_flags_t, size_t*);
 extern int   _net_socket_sendto(SOCKET*, const void*, size_t, NET_flags_t, const NET_generic_sockaddr_t*, size_t*);
@@ -247,6 +256,7 @@ extern int   _net_socket_connect(SOCKET*, const NET_generic_sockaddr_t*);
 extern int   _net_socket_disconnect(SOCKET*);
 extern int   _net_socket_shutdown(SOCKET*, NET_shut_t);
 extern int   _net_socket_getaddress(SOCKET*, NET_generic_sockaddr_t*);
+extern int   _net_socket_poll(SOCKET*, struct vfs_poll*);
 extern u16_t _net_hton_u16(NET_family_t, u16_t);
 extern u32_t _net_hton_u32(NET_family_t, u32_t);
 extern u64_t _net_hton_u64(NET_family_t, u64_t);
@@ -57,6 +57,7 @@ extern "C" {
 typedef struct SIPC_socket {
         queue_t *ansq;
         void    *rxbuf;
+        struct sipc_window *window;
         u32_t    recv_timeout;
         u32_t    send_timeout;
         u16_t    seq;
@@ -84,6 +85,8 @@ extern int   SIPC_socket_bind(SIPC_socket_t*, const NET_SIPC_sockaddr_t*);
 extern int   SIPC_socket_listen(SIPC_socket_t*);
 extern int   SIPC_socket_accept(SIPC_socket_t*, SIPC_socket_t*);
 extern int   SIPC_socket_recv(SIPC_socket_t*, void*, size_t, NET_flags_t, size_t*);
+extern int   SIPC_socket_peek(SIPC_socket_t*, const void**, size_t*);
+extern int   SIPC_socket_consume(SIPC_socket_t*, size_t);
 extern int   SIPC_socket_recvfrom(SIPC_socket_t*, void*, size_t, NET_flags_t, NET_SIPC_sockaddr_t*, size_t*);
 extern int   SIPC_socket_send(SIPC_socket_t*, const void*, size_t, NET_flags_t, size_t*);
 extern int   SIPC_socket_sendto(SIPC_socket_t*, const void*, size_t, NET_flags_t, const NET_SIPC_sockaddr_t*, size_t*);
@@ -93,6 +96,7 @@ extern int   SIPC_socket_set_send_timeout(SIPC_socket_t*, uint32_t);
 extern int   SIPC_socket_get_recv_timeout(SIPC_socket_t*, uint32_t*);
 extern int   SIPC_socket_get_send_timeout(SIPC_socket_t*, uint32_t*);
 extern int   SIPC_socket_getaddress(SIPC_socket_t*, NET_SIPC_sockaddr_t*);
+extern int   SIPC_socket_poll(SIPC_socket_t*, struct vfs_poll*);
 extern u16_t SIPC_hton_u16(u16_t);
 extern u32_t SIPC_hton_u32(u32_t);
 extern u64_t SIPC_hton_u64(u64_t);
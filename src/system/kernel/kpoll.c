@@ -0,0 +1,307 @@
+/*=========================================================================*//**
+@file    kpoll.c
+
+@author  Daniel Zorychta
+
+@brief   Readiness multiplexing of files and sockets.
+
+@note    Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+         This program is free software; you can redistribute it and/or modify
+         it under the terms of the GNU General Public License as published by
+         the Free Software Foundation and modified by the dnx RTOS exception.
+
+         NOTE: The modification  to the GPL is  included to allow you to
+               distribute a combined work that includes dnx RTOS without
+               being obliged to provide the source  code for proprietary
+               components outside of the dnx RTOS.
+
+         The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+         but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+         MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+         GNU General Public License for more details.
+
+         Full license text is available on the following file: doc/license.txt.
+
+
+*//*==========================================================================*/
+
+/*
+ * Each waiting thread registers a waiter that contains the list of objects
+ * (pipe, driver, connection) which readiness is examined. An object is
+ * reported by file system, driver, or network stack when the state change
+ * (new data, free space, hang up). Notification wakes up all waiters that
+ * wait for selected object; the waiter examines all descriptors again.
+ * The object is an opaque address, thus is not dereferenced here.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include "config.h"
+#include "kernel/kpoll.h"
+#include "kernel/kwrapper.h"
+#include "kernel/errno.h"
+#include "kernel/ktypes.h"
+#include "fs/vfs.h"
+#include "mm/mm.h"
+#include "net/netm.h"
+#include "lib/cast.h"
+#include "cpuctl.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define POLL_ALWAYS_REPORTED    (POLLERR | POLLHUP | POLLNVAL)
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct waiter {
+        struct waiter *next;            //!< next waiter
+        sem_t         *event;           //!< wake up semaphore
+        nfds_t         count;           //!< number of objects
+        const void    *object[];        //!< examined objects
+} waiter_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+static waiter_t *waiters;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+//==============================================================================
+/**
+ * @brief  Function examines readiness of single object.
+ *
+ * @param  fd           descriptor
+ * @param  object       returned object that is notified by object owner
+ *
+ * @return Returned events.
+ */
+//==============================================================================
+static short query_object(struct pollfd *fd, const void **object)
+{
+        struct vfs_poll poll = {
+                .events  = fd->events | POLL_ALWAYS_REPORTED,
+                .revents = 0,
+                .object  = NULL
+        };
+
+        res_header_t *res = fd->fd;
+
+        if (res == NULL) {
+                return 0;
+
+        } else if (!_mm_is_object_in_heap(res)) {
+                poll.revents = POLLNVAL;
+
+        } else if (res->type == RES_TYPE_FILE) {
+                _vfs_fpoll(cast(FILE*, res), &poll);
+
+#if __ENABLE_NETWORK__ == _YES_
+        } else if (res->type == RES_TYPE_SOCKET) {
+                _net_socket_poll(cast(SOCKET*, res), &poll);
+#endif
+        } else {
+                poll.revents = POLLNVAL;
+        }
+
+        *object = poll.object;
+
+        return poll.revents & (fd->events | POLL_ALWAYS_REPORTED);
+}
+
+//==============================================================================
+/**
+ * @brief  Function examines readiness of all descriptors.
+ *
+ * @param  fds          descriptors
+ * @param  waiter       waiter (objects are updated)
+ *
+ * @return Number of ready descriptors.
+ */
+//==============================================================================
+static int query(struct pollfd *fds, waiter_t *waiter)
+{
+        int ready = 0;
+
+        for (nfds_t i = 0; i < waiter->count; i++) {
+                fds[i].revents = query_object(&fds[i], &waiter->object[i]);
+
+                if (fds[i].revents) {
+                        ready++;
+                }
+        }
+
+        return ready;
+}
+
+//==============================================================================
+/**
+ * @brief  Function wakes up waiters that examine selected object.
+ *         Must be called in critical section or interrupt.
+ *
+ * @param  object       object
+ * @param  woken        task woken flag (ISR only, NULL otherwise)
+ */
+//==============================================================================
+static void wake_up(const void *object, bool *woken)
+{
+        for (waiter_t *w = waiters; w; w = w->next) {
+                for (nfds_t i = 0; i < w->count; i++) {
+                        if (w->object[i] == object) {
+                                if (woken) {
+                                        bool task_woken = false;
+                                        _semaphore_signal_from_ISR(w->event, &task_woken);
+                                        *woken |= task_woken;
+                                } else {
+                                        _semaphore_signal(w->event);
+                                }
+                                break;
+                        }
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function waits for readiness of selected files and sockets.
+ *
+ * @param  fds          descriptors
+ * @param  nfds         number of descriptors
+ * @param  timeout      timeout in milliseconds (0: no wait, <0: infinite)
+ * @param  ready        number of ready descriptors
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int _kpoll(struct pollfd *fds, nfds_t nfds, int timeout, int *ready)
+{
+        if (!fds || !nfds || !ready) {
+                return EINVAL;
+        }
+
+        waiter_t *waiter = NULL;
+        int err = _kzalloc(_MM_KRN, sizeof(waiter_t) + nfds * sizeof(void*),
+                           _CPUCTL_FAST_MEM, 0, 0, cast(void**, &waiter));
+        if (err) {
+                return err;
+        }
+
+        waiter->count = nfds;
+
+        *ready = query(fds, waiter);
+
+        if ((*ready == 0) && (timeout != 0)) {
+
+                err = _semaphore_create(1, 0, &waiter->event);
+                if (err) {
+                        goto finish;
+                }
+
+                _critical_section_begin();
+                {
+                        waiter->next = waiters;
+                        waiters      = waiter;
+                }
+                _critical_section_end();
+
+                u64_t tstart = _kernel_get_time_ms();
+
+                // examine again: objects might be notified before registration
+                while ((*ready = query(fds, waiter)) == 0) {
+
+                        u32_t tleft = MAX_DELAY_MS;
+
+                        if (timeout > 0) {
+                                u64_t elapsed = _kernel_get_time_ms() - tstart;
+                                if (elapsed >= cast(u64_t, timeout)) {
+                                        break;
+                                }
+
+                                tleft = timeout - elapsed;
+                        }
+
+                        if (_semaphore_wait(waiter->event, tleft) != ESUCC) {
+                                *ready = query(fds, waiter);
+                                break;
+                        }
+                }
+
+                _critical_section_begin();
+                {
+                        waiter_t **w = &waiters;
+                        while (*w && *w != waiter) {
+                                w = &(*w)->next;
+                        }
+
+                        if (*w) {
+                                *w = waiter->next;
+                        }
+                }
+                _critical_section_end();
+
+                _semaphore_destroy(waiter->event);
+        }
+
+        finish:
+        _kfree(_MM_KRN, cast(void**, &waiter));
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function notifies state change of selected object.
+ *
+ * @param  object       object
+ */
+//==============================================================================
+void _kpoll_notify(const void *object)
+{
+        if (waiters) {
+                _critical_section_begin();
+                wake_up(object, NULL);
+                _critical_section_end();
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function notifies state change of selected object from interrupt.
+ *
+ * @param  object       object
+ * @param  woken        set to true if task was woken
+ */
+//==============================================================================
+void _kpoll_notify_from_ISR(const void *object, bool *woken)
+{
+        bool task_woken = false;
+
+        if (waiters) {
+                wake_up(object, &task_woken);
+        }
+
+        if (woken) {
+                *woken |= task_woken;
+        }
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
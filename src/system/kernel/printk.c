@@ -37,25 +37,44 @@
 #include "mm/mm.h"
 #include "dnx/misc.h"
 #include "lib/vsnprintf.h"
+#include "lib/cast.h"
 #include "libc/errno.h"
 
 #if ((__OS_SYSTEM_MSG_ENABLE__ > 0) && (__OS_PRINTF_ENABLE__ > 0))
 
+/*
+ * Log is a ring of fixed-size records indexed by message sequence number.
+ * Writer reserves sequence number by atomic increment (no lock, callable
+ * from any context) and stores format pointer, packed arguments and
+ * timestamp. Text is formatted by reader. Record sequence field is cleared
+ * while record is written and set to sequence + 1 when record is complete,
+ * so reader detects incomplete and overwritten records without lock.
+ *
+ * NOTE: format string must exist until message is read (string literals).
+ */
+
 /*==============================================================================
   Local macros
 ==============================================================================*/
+#define RECORD_ARGS             8
+#define RECORD_STR_SIZE         __OS_SYSTEM_MSG_COLS__
 
 /*==============================================================================
   Local object types
 ==============================================================================*/
 typedef struct {
-        struct msg {
-                struct timeval timestamp;
-                char  str[__OS_SYSTEM_MSG_COLS__];
-        } msg[__OS_SYSTEM_MSG_ROWS__];
+        u32_t            seq;                   /*!< sequence + 1 (0: record in use) */
+        u8_t             argc;                  /*!< number of packed arguments */
+        u64_t            time_ms;               /*!< message time */
+        const char      *format;                /*!< message format */
+        _vsnprintf_arg_t arg[RECORD_ARGS];      /*!< packed arguments */
+        char             str[RECORD_STR_SIZE];  /*!< packed string arguments */
+} record_t;
 
-        uint16_t head;
-        uint16_t count;
+typedef struct {
+        u32_t    head;                          /*!< next sequence number */
+        u32_t    first;                         /*!< first sequence after clear */
+        record_t rec[__OS_SYSTEM_MSG_ROWS__];   /*!< records */
 } printk_log_t;
 
 /*==============================================================================
@@ -89,98 +108,93 @@ static printk_log_t logbuf;
 //==============================================================================
 void _printk(const char *format, ...)
 {
-        _kernel_scheduler_lock();
-        {
-                u16_t prev_head = logbuf.head;
-
-                if (logbuf.count < __OS_SYSTEM_MSG_ROWS__) {
-                        logbuf.count++;
-                }
+        u32_t     seq = __atomic_fetch_add(&logbuf.head, 1, __ATOMIC_RELAXED);
+        record_t *rec = &logbuf.rec[seq % __OS_SYSTEM_MSG_ROWS__];
 
-                if (++logbuf.head >= __OS_SYSTEM_MSG_ROWS__) {
-                        logbuf.head = 0;
-                }
-
-                va_list args;
-                va_start(args, format);
-                int len = _vsnprintf(logbuf.msg[logbuf.head].str,
-                                     __OS_SYSTEM_MSG_COLS__, format, args);
-                va_end(args);
+        __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
 
-                if (logbuf.msg[logbuf.head].str[len - 1] == '\n') {
-                        logbuf.msg[logbuf.head].str[len - 1] = '\0';
-                }
+        rec->time_ms = _kernel_get_time_ms();
+        rec->format  = format;
 
-                u64_t now = _kernel_get_time_ms();
-                logbuf.msg[logbuf.head].timestamp.tv_sec  = now / 1000;
-                logbuf.msg[logbuf.head].timestamp.tv_usec = (now % 1000) * 1000;
+        va_list args;
+        va_start(args, format);
+        rec->argc = _vsnprintf_pack(format, args, rec->arg, RECORD_ARGS,
+                                    rec->str, sizeof(rec->str));
+        va_end(args);
 
-                if (logbuf.msg[logbuf.head].timestamp.tv_sec == logbuf.msg[prev_head].timestamp.tv_sec) {
-                        if (logbuf.msg[prev_head].timestamp.tv_usec >= logbuf.msg[logbuf.head].timestamp.tv_usec) {
-                                logbuf.msg[logbuf.head].timestamp.tv_usec = logbuf.msg[prev_head].timestamp.tv_usec + 1;
-                        }
-                }
-        }
-        _kernel_scheduler_unlock();
+        __atomic_store_n(&rec->seq, seq + 1, __ATOMIC_RELEASE);
 }
 
 //==============================================================================
 /**
- * Function read log message.
+ * Function read log message. Message of selected sequence number is read or
+ * the oldest one if selected message was overwritten.
  *
  * @param str           destination buffer
  * @param len           destination buffer length
- * @param from_time     log search time starting from system start
+ * @param seq           message sequence number (cursor, 0 at begin), it is
+ *                      set to the next message sequence number
  * @param msg_time      current message time from system start
  *
- * @return Number of bytes copied to the buffer. 0 if message is empty.
+ * @return Number of bytes copied to the buffer (at least 1 if message was read,
+ *         even empty). 0 if there is no new message.
  */
 //==============================================================================
-size_t _printk_read(char *str, size_t len, const struct timeval *from_time, struct timeval *msg_time)
+size_t _printk_read(char *str, size_t len, u32_t *seq, struct timeval *msg_time)
 {
-        size_t n = 0;
+        if (!str || !len || !seq || !msg_time) {
+                return 0;
+        }
+
+        for (;;) {
+                u32_t head   = __atomic_load_n(&logbuf.head, __ATOMIC_ACQUIRE);
+                u32_t first  = __atomic_load_n(&logbuf.first, __ATOMIC_RELAXED);
+                u32_t oldest = (head - first > __OS_SYSTEM_MSG_ROWS__)
+                             ? head - __OS_SYSTEM_MSG_ROWS__ : first;
 
-        if (str && len && from_time && msg_time) {
-                _kernel_scheduler_lock();
-                {
-                        if (logbuf.count > 0) {
+                if (cast(i32_t, *seq - oldest) < 0) {
+                        *seq = oldest;
+                }
 
-                                i32_t idx = logbuf.head - logbuf.count + 1;
-                                      idx = idx < 0
-                                            ? cast(i32_t, ARRAY_SIZE(logbuf.msg)) + idx
-                                            : idx;
+                if (cast(i32_t, head - *seq) <= 0) {
+                        return 0;
+                }
 
-                                size_t msgs = logbuf.count;
+                record_t *rec = &logbuf.rec[*seq % __OS_SYSTEM_MSG_ROWS__];
+                u32_t     tag = __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE);
 
-                                while (msgs--) {
+                if (tag != *seq + 1) {
+                        if (tag != 0 && cast(i32_t, tag - (*seq + 1)) > 0) {
+                                continue;       // overwritten, cursor moved to oldest
+                        } else {
+                                return 0;       // message is being written
+                        }
+                }
 
-                                        struct msg *m = &logbuf.msg[idx];
+                record_t copy;
+                memcpy(&copy, rec, sizeof(copy));
 
-                                        if (  (m->timestamp.tv_sec > from_time->tv_sec)
-                                           || (  (m->timestamp.tv_sec == from_time->tv_sec)
-                                              && (m->timestamp.tv_usec > from_time->tv_usec)) ) {
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&rec->seq, __ATOMIC_RELAXED) != tag) {
+                        continue;               // overwritten while copying
+                }
 
-                                                strlcpy(str, logbuf.msg[idx].str, len);
+                int n = _vsnprintf_unpack(str, len, copy.format, copy.arg,
+                                          copy.argc, copy.str);
 
-                                                n = min(len, strnlen(logbuf.msg[idx].str,
-                                                                     __OS_SYSTEM_MSG_COLS__));
+                n = min(n, cast(int, len) - 1);
+                if ((n > 0) && (str[n - 1] == '\n')) {
+                        str[--n] = '\0';
+                }
 
-                                                *msg_time = m->timestamp;
+                msg_time->tv_sec  = copy.time_ms / 1000;
+                msg_time->tv_usec = (copy.time_ms % 1000) * 1000;
 
-                                                break;
+                (*seq)++;
 
-                                        } else {
-                                                if (++idx >= cast(i32_t, ARRAY_SIZE(logbuf.msg))) {
-                                                        idx = 0;
-                                                }
-                                        }
-                                }
-                        }
-                }
-                _kernel_scheduler_unlock();
+                return max(n, 1);
         }
-
-        return n;
 }
 
 //==============================================================================
@@ -190,11 +204,9 @@ size_t _printk_read(char *str, size_t len, const struct timeval *from_time, stru
 //==============================================================================
 void _printk_clear(void)
 {
-        _kernel_scheduler_lock();
-        {
-                memset(&logbuf, 0, sizeof(logbuf));
-        }
-        _kernel_scheduler_unlock();
+        __atomic_store_n(&logbuf.first,
+                         __atomic_load_n(&logbuf.head, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELEASE);
 }
 
 #endif
@@ -96,6 +96,7 @@ struct _process {
         void            *globals;       //!< address to global variables
         res_header_t    *res_list;      //!< list of used resources
         u32_t            res_list_size; //!< size of resources list
+        void            *mem_arena;     //!< user-space small block allocator state
         char            *cwd;           //!< current working path
         const pdata_t   *pdata;         //!< program data
         char            **argv;         //!< program arguments
@@ -119,11 +120,14 @@ static void process_code(void *mainfn);
 static void thread_code(void *args);
 static void process_destroy_all_resources(_process_t *proc);
 static int  resource_destroy(res_header_t *resource);
+static void resource_link(_process_t *proc, res_header_t *resource);
+static void resource_unlink(_process_t *proc, res_header_t *resource);
 static int  argtab_create(const char *str, u8_t *argc, char **argv[]);
 static void argtab_destroy(char **argv);
 static int  find_program(const char *name, const struct _prog_data **prog);
 static int  allocate_process_globals(_process_t *proc, const struct _prog_data *usrprog);
 static int  process_apply_attributes(_process_t *proc, const process_attr_t *attr);
+static void std_stream_set_buffer(FILE *file);
 static void process_get_stat(_process_t *proc, process_stat_t *stat);
 static void process_move_list(_process_t *proc, _process_t **list_from, _process_t **list_to);
 static int  get_pid(pid_t *pid);
@@ -146,6 +150,7 @@ static avg_CPU_load_t avg_CPU_load_calc;
 static avg_CPU_load_t avg_CPU_load_result;
 static mutex_t       *process_mtx;
 static mutex_t       *kworker_mtx;
+static sem_t         *cleanup_sem;
 
 /*==============================================================================
   Exported object definitions
@@ -200,6 +205,10 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
                 _assert(_mutex_create(MUTEX_TYPE_RECURSIVE, &kworker_mtx) == ESUCC);
         }
 
+        if (!cleanup_sem) {
+                _assert(_semaphore_create(1, 0, &cleanup_sem) == ESUCC);
+        }
+
         if (!cmd) {
                 return ENOENT;
         }
@@ -308,14 +317,34 @@ KERNELSPACE int _process_create(const char *cmd, const process_attr_t *attr, pid
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function wakes up kworker that waits for killed processes. Used to
+ *         schedule deferred work (e.g. file system write-back).
+ */
+//==============================================================================
+KERNELSPACE void _process_wake_up_kworker(void)
+{
+        if (cleanup_sem) {
+                _semaphore_signal(cleanup_sem);
+        }
+}
+
 //==============================================================================
 /**
  * Function clean up killed processes. If process has parent then is moved to
- * the zombie list. Only parent can remove zombie process.
+ * the zombie list. Only parent can remove zombie process. Function is called
+ * by kworker that is woken up when process is killed or finished.
+ *
+ * @param  timeout      time to wait for killed process [ms]
  */
 //==============================================================================
-KERNELSPACE void _process_clean_up_killed_processes(void)
+KERNELSPACE void _process_clean_up_killed_processes(u32_t timeout)
 {
+        if (timeout) {
+                _semaphore_wait(cleanup_sem, timeout);
+        }
+
         if (destroy_process_list) {
                 ATOMIC(process_mtx) {
                         while (destroy_process_list) {
@@ -375,6 +404,8 @@ KERNELSPACE int _process_kill(pid_t pid)
                                                   &active_process_list,
                                                   &destroy_process_list);
 
+                                _semaphore_signal(cleanup_sem);
+
                                 err = ESUCC;
                                 break;
                         }
@@ -396,6 +427,9 @@ KERNELSPACE void _process_remove_zombie(_process_t *proc, int *status)
 {
         _assert(is_proc_valid(proc));
 
+        // finished process can still wait for kworker clean up
+        _process_clean_up_killed_processes(0);
+
         ATOMIC(process_mtx) {
                 _process_t *prev = NULL;
                 foreach_process(p, zombie_process_list) {
@@ -437,6 +471,15 @@ KERNELSPACE void _process_exit(_process_t *proc, int status)
         if (is_proc_valid(proc) && proc->taskdata) {
                 proc->status = status;
 
+                // buffered output is stored before process exit
+                if (proc->f_stdout) {
+                        _vfs_fflush(proc->f_stdout);
+                }
+
+                if (proc->f_stderr && (proc->f_stderr != proc->f_stdout)) {
+                        _vfs_fflush(proc->f_stderr);
+                }
+
                 va_list none;
                 if (proc->f_stdin) {
                         _vfs_vfioctl(proc->f_stdin, IOCTL_VFS__DEFAULT_RD_MODE, none);
@@ -470,6 +513,8 @@ KERNELSPACE void _process_exit(_process_t *proc, int status)
                         process_move_list(proc, &active_process_list, &destroy_process_list);
 
                         proc->taskdata[0].task = NULL;
+
+                        _semaphore_signal(cleanup_sem);
                 }
 
                 _task_exit();
@@ -659,6 +704,45 @@ KERNELSPACE int _process_get_stat_pid(pid_t pid, process_stat_t *stat)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return stdout file of selected process.
+ *
+ * @param  proc         process container
+ *
+ * @return File pointer. Can be NULL if process does not exists or file not set.
+ */
+//==============================================================================
+KERNELSPACE FILE *_process_get_stdout(_process_t *proc)
+{
+        if (is_proc_valid(proc)) {
+                return proc->f_stdout;
+        } else {
+                return NULL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function return pointer to the memory arena slot of selected process.
+ *         The arena itself is managed by the user-space allocator (malloc()),
+ *         kernel only keeps the pointer and clears it when process resources
+ *         are released.
+ *
+ * @param  proc         process container
+ *
+ * @return Pointer to the arena slot. NULL if process does not exists.
+ */
+//==============================================================================
+KERNELSPACE void **_process_get_mem_arena(_process_t *proc)
+{
+        if (is_proc_valid(proc)) {
+                return &proc->mem_arena;
+        } else {
+                return NULL;
+        }
+}
+
 //==============================================================================
 /**
  * @brief  Function return stderr file of selected process.
@@ -965,14 +1049,7 @@ KERNELSPACE int _process_register_resource(_process_t *proc, res_header_t *resou
                 mutex_t *mtx = (proc == _kworker_proc) ? kworker_mtx : process_mtx;
 
                 ATOMIC(mtx) {
-                        if (proc->res_list == NULL) {
-                                proc->res_list = resource;
-                        } else {
-                                resource->next = proc->res_list;
-                                proc->res_list = resource;
-                        }
-
-                        proc->res_list_size++;
+                        resource_link(proc, resource);
                 }
 
                 return ESUCC;
@@ -1002,33 +1079,12 @@ KERNELSPACE int _process_release_resource(_process_t *proc, res_header_t *resour
                 mutex_t *mtx = (proc == _kworker_proc) ? kworker_mtx : process_mtx;
 
                 ATOMIC(mtx) {
-                        res_header_t *prev     = NULL;
-                        int           max_deep = proc->res_list_size + 1;
-
-                        foreach_resource(curr, proc->res_list) {
-                                if (curr == resource) {
-                                        if (curr->type == type) {
-                                                if (proc->res_list == curr) {
-                                                        proc->res_list = proc->res_list->next;
-                                                } else {
-                                                        prev->next = curr->next;
-                                                }
-
-                                                obj_to_destroy = curr;
-                                                proc->res_list_size--;
-                                        } else {
-                                                err = EFAULT;
-                                        }
-
-                                        break;
+                        if (resource->owner == proc) {
+                                if (resource->type == type) {
+                                        resource_unlink(proc, resource);
+                                        obj_to_destroy = resource;
                                 } else {
-
-                                        prev = curr;
-
-                                        if (--max_deep == 0) {
-                                                _assert(max_deep > 0);
-                                                _kernel_panic_report(_KERNEL_PANIC_DESC_CAUSE_INTERNAL_2);
-                                        }
+                                        err = EFAULT;
                                 }
                         }
                 }
@@ -1240,21 +1296,59 @@ KERNELSPACE int _process_thread_get_stat(pid_t pid, tid_t tid, thread_stat_t *st
 
 //==============================================================================
 /**
- * Function increase syscall request counter (stats).
+ * @brief  Function returns process and thread ID of the calling task. Active
+ *         process and thread are updated at context switch, thus the values
+ *         are always valid for calling task and no lock is required.
  *
- * @param proc          process
- * @param kworker       kworker process
+ * @param  proc         process container
+ * @param  tid          thread ID
  */
 //==============================================================================
-KERNELSPACE void _process_syscall_stat_inc(_process_t *proc, _process_t *kworker)
+KERNELSPACE void _process_get_current(_process_t **proc, tid_t *tid)
 {
-        if (is_proc_valid(proc) and is_proc_valid(kworker)) {
-                ATOMIC(process_mtx) {
-                        tid_t i = _process_get_active_thread(proc);
-                        proc->taskdata[i].syscalls_ctr++;
+        _process_t *p = active_process;
+
+        *proc = p;
+        *tid  = p ? p->curr_task : UINT8_MAX;
+}
+
+//==============================================================================
+/**
+ * @brief  Function mark thread that enter kernel space by syscall and increase
+ *         syscall request counters (stats). Process and thread shall be
+ *         obtained by _process_get_current().
+ *
+ * @param  proc         process
+ * @param  tid          thread ID
+ * @param  kworker      kworker process (syscall counter of entire system)
+ */
+//==============================================================================
+KERNELSPACE void _process_syscall_enter(_process_t *proc, tid_t tid, _process_t *kworker)
+{
+        _critical_section_begin();
+        {
+                proc->taskdata[tid].syscalls_ctr++;
+
+                if (kworker) {
                         kworker->taskdata[0].syscalls_ctr++;
                 }
         }
+        _critical_section_end();
+
+        proc->taskdata[tid].kernelspace = true;
+}
+
+//==============================================================================
+/**
+ * @brief  Function mark thread that exit kernel space after syscall.
+ *
+ * @param  proc         process
+ * @param  tid          thread ID
+ */
+//==============================================================================
+KERNELSPACE void _process_syscall_exit(_process_t *proc, tid_t tid)
+{
+        proc->taskdata[tid].kernelspace = (proc->flag & FLAG_KWORKER);
 }
 
 //==============================================================================
@@ -1457,11 +1551,14 @@ KERNELSPACE bool _process_is_consistent(void)
 
                         size_t n = 0;
                         size_t m = p->res_list_size;
-                        res_header_t *res = p->res_list;
+                        res_header_t *res  = p->res_list;
+                        res_header_t *prev = NULL;
                         while (res && m) {
 
                                 sanity_ok =  _mm_is_object_in_heap(res)
                                           && (res->self == res)
+                                          && (res->owner == p)
+                                          && (res->prev == prev)
                                           && (  (res->type == RES_TYPE_MUTEX)
                                              || (res->type == RES_TYPE_SEMAPHORE)
                                              || (res->type == RES_TYPE_QUEUE)
@@ -1474,7 +1571,8 @@ KERNELSPACE bool _process_is_consistent(void)
                                              || (res->type == RES_TYPE_FILE) );
                                 if (!sanity_ok) goto end;
 
-                                res = res->next;
+                                prev = res;
+                                res  = res->next;
                                 n++;
                                 m--;
                         }
@@ -1519,40 +1617,6 @@ KERNELSPACE bool _process_is_consistent(void)
         return sanity_ok;
 }
 
-//==============================================================================
-/**
- * @brief  Function mark thread that enter kernel space.
- *
- * @param  proc         process
- */
-//==============================================================================
-KERNELSPACE void _process_enter_kernelspace(_process_t *proc)
-{
-        if (is_proc_valid(proc)) {
-                ATOMIC(process_mtx) {
-                        tid_t i = _process_get_active_thread(proc);
-                        proc->taskdata[i].kernelspace = true;
-                }
-        }
-}
-
-//==============================================================================
-/**
- * @brief  Function mark thread that exit kernel space.
- *
- * @param  proc         process
- */
-//==============================================================================
-KERNELSPACE void _process_exit_kernelspace(_process_t *proc)
-{
-        if (is_proc_valid(proc)) {
-                ATOMIC(process_mtx) {
-                        tid_t i = _process_get_active_thread(proc);
-                        proc->taskdata[i].kernelspace = false;
-                }
-        }
-}
-
 //==============================================================================
 /**
  * @brief  Function get kernelspace indicator.
@@ -1694,7 +1758,6 @@ static void process_destroy_all_resources(_process_t *proc)
 
         // close files, directories, sockets, etc
         res_header_t *resource_curr = proc->res_list;
-        res_header_t *resource_prev = NULL;
         res_header_t *resource_next = NULL;
 
         while (resource_curr) {
@@ -1702,21 +1765,13 @@ static void process_destroy_all_resources(_process_t *proc)
 
                 if (resource_curr->type != RES_TYPE_MEMORY) {
 
-                        if (resource_curr == proc->res_list) {
-                                proc->res_list = resource_next;
-                        } else {
-                                if (resource_prev) {
-                                        resource_prev->next = resource_next;
-                                }
-                        }
+                        resource_unlink(proc, resource_curr);
 
                         int err = resource_destroy(resource_curr);
                         if (err != ESUCC) {
                                 printk("PROCESS: PID %d: unknown object %p\n",
                                        proc->pid, resource_curr);
                         }
-                } else {
-                        resource_prev = resource_curr;
                 }
 
                 resource_curr = resource_next;
@@ -1725,7 +1780,7 @@ static void process_destroy_all_resources(_process_t *proc)
         // free all other resources
         while (proc->res_list) {
                 res_header_t *resource = proc->res_list;
-                proc->res_list = resource->next;
+                resource_unlink(proc, resource);
 
                 int err = resource_destroy(resource);
                 if (err != ESUCC) {
@@ -1744,6 +1799,7 @@ static void process_destroy_all_resources(_process_t *proc)
 
         proc->res_list_size = 0;
         proc->res_list = NULL;
+        proc->mem_arena = NULL;
         proc->f_stdin  = NULL;
         proc->f_stdout = NULL;
         proc->f_stderr = NULL;
@@ -1866,6 +1922,7 @@ static int process_apply_attributes(_process_t *proc, const process_attr_t *attr
 
                         err = _vfs_fopen(&cpath, "a+", &proc->f_stdin);
                         if (!err) {
+                                std_stream_set_buffer(proc->f_stdin);
                                 _process_register_resource(proc, cast(res_header_t*, proc->f_stdin));
                         } else {
                                 goto finish;
@@ -1893,6 +1950,7 @@ static int process_apply_attributes(_process_t *proc, const process_attr_t *attr
 
                                 err = _vfs_fopen(&cpath, "a", &proc->f_stdout);
                                 if (!err) {
+                                        std_stream_set_buffer(proc->f_stdout);
                                         _process_register_resource(proc, cast(res_header_t*, proc->f_stdout));
                                 } else {
                                         goto finish;
@@ -1942,6 +2000,28 @@ static int process_apply_attributes(_process_t *proc, const process_attr_t *attr
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function set buffering of standard stream: device (terminal) is
+ *         line buffered, regular file is fully buffered. Other streams are
+ *         not buffered.
+ *
+ * @param  file         standard stream
+ */
+//==============================================================================
+static void std_stream_set_buffer(FILE *file)
+{
+        struct stat stat;
+        if (_vfs_fstat(file, &stat) == ESUCC) {
+                if (S_ISDEV(stat.st_mode)) {
+                        _vfs_setvbuf(file, NULL, VFS_IOLBF, 0);
+
+                } else if (S_ISREG(stat.st_mode)) {
+                        _vfs_setvbuf(file, NULL, VFS_IOFBF, 0);
+                }
+        }
+}
+
 //==============================================================================
 /**
  * @brief Function create PID number.
@@ -1994,6 +2074,56 @@ static int get_pid(pid_t *pid)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function insert resource at the head of process resource list.
+ *         Process list must be locked.
+ *
+ * @param  proc         process container
+ * @param  resource     resource to link
+ */
+//==============================================================================
+static void resource_link(_process_t *proc, res_header_t *resource)
+{
+        resource->owner = proc;
+        resource->prev  = NULL;
+        resource->next  = proc->res_list;
+
+        if (proc->res_list) {
+                proc->res_list->prev = resource;
+        }
+
+        proc->res_list = resource;
+        proc->res_list_size++;
+}
+
+//==============================================================================
+/**
+ * @brief  Function remove resource from process resource list.
+ *         Process list must be locked.
+ *
+ * @param  proc         process container
+ * @param  resource     resource to unlink
+ */
+//==============================================================================
+static void resource_unlink(_process_t *proc, res_header_t *resource)
+{
+        if (resource->prev) {
+                resource->prev->next = resource->next;
+        } else {
+                proc->res_list = resource->next;
+        }
+
+        if (resource->next) {
+                resource->next->prev = resource->prev;
+        }
+
+        resource->next  = NULL;
+        resource->prev  = NULL;
+        resource->owner = NULL;
+        proc->res_list_size--;
+}
+
 //==============================================================================
 /**
  * @brief  Function destroy (release) selected resource.
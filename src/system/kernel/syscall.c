@@ -41,6 +41,7 @@
 #include "kernel/errno.h"
 #include "kernel/time.h"
 #include "kernel/khooks.h"
+#include "kernel/kpoll.h"
 #include "kernel/sysfunc.h"
 #include "lib/cast.h"
 #include "lib/unarg.h"
@@ -55,8 +56,6 @@
 ==============================================================================*/
 #define SYSCALL_QUEUE_LENGTH            4
 
-#define FS_CACHE_SYNC_PERIOD_MS         (1000 * __OS_SYSTEM_CACHE_SYNC_PERIOD__)
-
 #define GETARG(type, var)               type var = va_arg(rq->args, type)
 #define LOADARG(type)                   va_arg(rq->args, type)
 #define GETRETURN(type, var)            type var = rq->retptr
@@ -68,7 +67,6 @@
 #define GETERRNO()                      rq->err
 #define UNUSED_RQ()                     UNUSED_ARG1(rq)
 
-#define is_proc_valid(proc)             (_mm_is_object_in_heap(proc) && ((res_header_t*)proc)->type == RES_TYPE_PROCESS)
 #define is_tid_in_range(proc, tid)      (tid < _process_get_max_threads(proc))
 
 /*==============================================================================
@@ -89,6 +87,7 @@ typedef void (*syscallfunc_t)(syscallrq_t*);
   Local function prototypes
 ==============================================================================*/
 static void syscall_do(void *rq);
+static void flush_stdout_before_read(syscallrq_t *rq, FILE *file);
 
 static void syscall_mount(syscallrq_t *rq);
 static void syscall_umount(syscallrq_t *rq);
@@ -130,10 +129,13 @@ static void syscall_fopen(syscallrq_t *rq);
 static void syscall_fclose(syscallrq_t *rq);
 static void syscall_fwrite(syscallrq_t *rq);
 static void syscall_fread(syscallrq_t *rq);
+static void syscall_writev(syscallrq_t *rq);
+static void syscall_readv(syscallrq_t *rq);
 static void syscall_fseek(syscallrq_t *rq);
 static void syscall_ioctl(syscallrq_t *rq);
 static void syscall_fflush(syscallrq_t *rq);
 static void syscall_sync(syscallrq_t *rq);
+static void syscall_poll(syscallrq_t *rq);
 #if __OS_ENABLE_TIMEMAN__ == _YES_
 static void syscall_gettime(syscallrq_t *rq);
 static void syscall_settime(syscallrq_t *rq);
@@ -188,6 +190,8 @@ static void syscall_netshutdown(syscallrq_t *rq);
 static void syscall_netsendto(syscallrq_t *rq);
 static void syscall_netrecvfrom(syscallrq_t *rq);
 static void syscall_netgetaddress(syscallrq_t *rq);
+static void syscall_netpeek(syscallrq_t *rq);
+static void syscall_netconsume(syscallrq_t *rq);
 #endif
 #if __OS_ENABLE_SHARED_MEMORY__ == _YES_
 static void syscall_shmcreate(syscallrq_t *rq);
@@ -250,10 +254,13 @@ static const syscallfunc_t syscalltab[] = {
         [SYSCALL_FCLOSE] = syscall_fclose,
         [SYSCALL_FWRITE] = syscall_fwrite,
         [SYSCALL_FREAD ] = syscall_fread,
+        [SYSCALL_WRITEV] = syscall_writev,
+        [SYSCALL_READV ] = syscall_readv,
         [SYSCALL_FSEEK ] = syscall_fseek,
         [SYSCALL_IOCTL ] = syscall_ioctl,
         [SYSCALL_FFLUSH] = syscall_fflush,
         [SYSCALL_SYNC  ] = syscall_sync,
+        [SYSCALL_POLL  ] = syscall_poll,
         #if __OS_ENABLE_TIMEMAN__ == _YES_
         [SYSCALL_GETTIME] = syscall_gettime,
         [SYSCALL_SETTIME] = syscall_settime,
@@ -308,6 +315,8 @@ static const syscallfunc_t syscalltab[] = {
         [SYSCALL_NETSENDTO        ] = syscall_netsendto,
         [SYSCALL_NETRECVFROM      ] = syscall_netrecvfrom,
         [SYSCALL_NETGETADDRESS    ] = syscall_netgetaddress,
+        [SYSCALL_NETPEEK          ] = syscall_netpeek,
+        [SYSCALL_NETCONSUME       ] = syscall_netconsume,
         #endif
 };
 
@@ -366,13 +375,11 @@ void syscall(syscall_t syscall, void *retptr, ...)
 {
         if (syscall < _SYSCALL_COUNT) {
                 _process_t *proc; tid_t tid;
-                _task_get_process_container(_THIS_TASK, &proc, &tid);
+                _process_get_current(&proc, &tid);
 
                 _assert(proc);
                 _assert(is_tid_in_range(proc, tid));
 
-                _process_clean_up_killed_processes();
-
                 syscallrq_t syscallrq = {
                         .syscall_no     = syscall,
                         .client_proc    = proc,
@@ -408,17 +415,18 @@ int _syscall_kworker_process(int argc, char *argv[])
         _task_get_process_container(_THIS_TASK, &_kworker_proc, NULL);
         _assert(_kworker_proc);
 
-        u64_t sync_period_ref = _kernel_get_time_ms();
+        u32_t writeback_delay = 1000;
 
         bool network_initialized = false;
 
         for (;;) {
-                _sleep_ms(1000);
+                /*
+                 * Kworker is woken up by killed process or by file system
+                 * that becomes dirty, otherwise sleeps until next write-back.
+                 */
+                _process_clean_up_killed_processes(writeback_delay);
 
-                if ( (_kernel_get_time_ms() - sync_period_ref) >= FS_CACHE_SYNC_PERIOD_MS) {
-                        _vfs_sync();
-                        sync_period_ref = _kernel_get_time_ms();
-                }
+                writeback_delay = _vfs_writeback();
 
                 if (not network_initialized) {
                         network_initialized = true;
@@ -444,20 +452,30 @@ static void syscall_do(void *rq)
 {
         syscallrq_t *sysrq = rq;
 
-        if (!is_proc_valid(sysrq->client_proc)) {
-                /*
-                 * This message means that during execution this syscall,
-                 * the client process does not exists anymore.
-                 */
-                printk("Invalid client process!");
-                return;
-        }
-
-        _process_syscall_stat_inc(sysrq->client_proc, _kworker_proc);
-
-        _process_enter_kernelspace(sysrq->client_proc);
+        /*
+         * Client process is the process of calling task, so it exists until
+         * syscall is finished (killed process' tasks are destroyed at once).
+         */
+        _process_syscall_enter(sysrq->client_proc, sysrq->client_thread, _kworker_proc);
         syscalltab[sysrq->syscall_no](sysrq);
-        _process_exit_kernelspace(sysrq->client_proc);
+        _process_syscall_exit(sysrq->client_proc, sysrq->client_thread);
+}
+
+//==============================================================================
+/**
+ * @brief  Function flush line buffered output of client process (e.g. prompt)
+ *         so it is shown before input is read.
+ *
+ * @param  rq           syscall request
+ * @param  file         file to read
+ */
+//==============================================================================
+static void flush_stdout_before_read(syscallrq_t *rq, FILE *file)
+{
+        FILE *out = _process_get_stdout(GETPROCESS());
+        if (out && (out != file) && (out->f_buf.mode == VFS_IOLBF) && (out->f_buf.level > 0)) {
+                _vfs_fflush(out);
+        }
 }
 
 //==============================================================================
@@ -813,6 +831,12 @@ static void syscall_fopen(syscallrq_t *rq)
         FILE *file = NULL;
         int   err  = _vfs_fopen(&path, mode, &file);
         if (err == ESUCC) {
+                // regular files opened by application are fully buffered
+                struct stat stat;
+                if ((_vfs_fstat(file, &stat) == ESUCC) && S_ISREG(stat.st_mode)) {
+                        _vfs_setvbuf(file, NULL, VFS_IOFBF, 0);
+                }
+
                 err = _process_register_resource(GETPROCESS(), cast(res_header_t*, file));
                 if (err != ESUCC) {
                         _vfs_fclose(file, true);
@@ -884,11 +908,53 @@ static void syscall_fread(syscallrq_t *rq)
         GETARG(size_t *, count);
         GETARG(FILE *, file);
 
+        flush_stdout_before_read(rq, file);
+
         size_t rdcnt = 0;
         SETERRNO(_vfs_fread(buf, (*count) * (*size), &rdcnt, file));
         SETRETURN(size_t, rdcnt / (*size));
 }
 
+//==============================================================================
+/**
+ * @brief  This syscall write data from multiple buffers to selected file.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_writev(syscallrq_t *rq)
+{
+        GETARG(FILE *, file);
+        GETARG(const struct iovec *, iov);
+        GETARG(int *, iovcnt);
+        GETARG(const fpos_t *, offset);
+
+        size_t wrcnt = 0;
+        SETERRNO(_vfs_fwritev(iov, *iovcnt, offset, &wrcnt, file));
+        SETRETURN(ssize_t, GETERRNO() == ESUCC ? cast(ssize_t, wrcnt) : -1);
+}
+
+//==============================================================================
+/**
+ * @brief  This syscall read data from selected file to multiple buffers.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_readv(syscallrq_t *rq)
+{
+        GETARG(FILE *, file);
+        GETARG(const struct iovec *, iov);
+        GETARG(int *, iovcnt);
+        GETARG(const fpos_t *, offset);
+
+        flush_stdout_before_read(rq, file);
+
+        size_t rdcnt = 0;
+        SETERRNO(_vfs_freadv(iov, *iovcnt, offset, &rdcnt, file));
+        SETRETURN(ssize_t, GETERRNO() == ESUCC ? cast(ssize_t, rdcnt) : -1);
+}
+
 //==============================================================================
 /**
  * @brief  This syscall move file pointer.
@@ -948,6 +1014,24 @@ static void syscall_sync(syscallrq_t *rq)
         _vfs_sync();
 }
 
+//==============================================================================
+/**
+ * @brief  This syscall waits for readiness of selected files and sockets.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_poll(syscallrq_t *rq)
+{
+        GETARG(struct pollfd *, fds);
+        GETARG(nfds_t *, nfds);
+        GETARG(int *, timeout);
+
+        int ready = -1;
+        SETERRNO(_kpoll(fds, *nfds, *timeout, &ready));
+        SETRETURN(int, GETERRNO() == ESUCC ? ready : -1);
+}
+
 #if __OS_ENABLE_TIMEMAN__ == _YES_
 //==============================================================================
 /**
@@ -1098,9 +1182,9 @@ static void syscall_syslogread(syscallrq_t *rq)
 {
         GETARG(char *, str);
         GETARG(size_t *, len);
-        GETARG(const struct timeval *, from_time);
-        GETARG(struct timeval *, curr_time);
-        SETRETURN(size_t, _printk_read(str, *len, from_time, curr_time));
+        GETARG(u32_t *, seq);
+        GETARG(struct timeval *, msg_time);
+        SETRETURN(size_t, _printk_read(str, *len, seq, msg_time));
 }
 #endif
 
@@ -1835,6 +1919,39 @@ static void syscall_netgetaddress(syscallrq_t *rq)
         SETERRNO(_net_socket_getaddress(socket, sockaddr));
         SETRETURN(int, GETERRNO() == ESUCC ? 0 : -1);
 }
+
+//==============================================================================
+/**
+ * @brief  This syscall return view of received data without copying.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_netpeek(syscallrq_t *rq)
+{
+        GETARG(SOCKET *, socket);
+        GETARG(const void **, data);
+
+        size_t len = 0;
+        SETERRNO(_net_socket_peek(socket, data, &len));
+        SETRETURN(int, GETERRNO() == ESUCC ? cast(int, len) : -1);
+}
+
+//==============================================================================
+/**
+ * @brief  This syscall release data returned by peek syscall.
+ *
+ * @param  rq                   syscall request
+ */
+//==============================================================================
+static void syscall_netconsume(syscallrq_t *rq)
+{
+        GETARG(SOCKET *, socket);
+        GETARG(size_t *, len);
+
+        SETERRNO(_net_socket_consume(socket, *len));
+        SETRETURN(int, GETERRNO() == ESUCC ? 0 : -1);
+}
 #endif
 
 #if __OS_ENABLE_SHARED_MEMORY__ == _YES_
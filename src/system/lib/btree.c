@@ -44,6 +44,7 @@ Brief    BTree library.
 #define parent(n)               (n->parent)
 #define left(n)                 (n->left)
 #define right(n)                (n->right)
+#define is_red(n)               ((n) && (n)->red)
 
 #define data(t,n)               (((char *)n) + node_size(t))
 #define data_copy(t, d, s)      memcpy(d, s, elem_size(t))
@@ -71,6 +72,7 @@ typedef struct node {
         struct node *parent;
         struct node *left;
         struct node *right;
+        bool         red;
 } btnode_t;
 
 /*==============================================================================
@@ -82,6 +84,11 @@ static btnode_t *node_maximum(btnode_t*);
 static btnode_t *node_search(btree_t*, btnode_t*, void *);
 static void      node_close(btree_t*, btnode_t*);
 static btnode_t *node_successor(btnode_t*);
+static btnode_t *node_predecessor(btnode_t*);
+static void      rotate_left(btree_t*, btnode_t*);
+static void      rotate_right(btree_t*, btnode_t*);
+static void      insert_fixup(btree_t*, btnode_t*);
+static void      remove_fixup(btree_t*, btnode_t*, btnode_t*);
 static btnode_t *node_make(btree_t *tree, void *data);
 static void     *malloc_usr(size_t size, void *allocctx);
 static void      free_usr(void *mem, void *freectx);
@@ -361,17 +368,7 @@ int _btree_predecessor(btree_t *tree, void *key, void *ret)
                 return ENOENT;
         }
 
-        if (left(node)) {
-                node = node_maximum(left(node));
-        } else {
-                btnode_t *node2 = parent(node);
-                while (node2 && node == left(node2)) {
-                        node  = node2;
-                        node2 = parent(node);
-                }
-                node = node2;
-        }
-
+        node = node_predecessor(node);
         if (node) {
                 data_copy(tree, ret, data(tree, node));
                 return ESUCC;
@@ -392,40 +389,37 @@ int _btree_predecessor(btree_t *tree, void *key, void *ret)
 //==============================================================================
 int _btree_insert(btree_t *tree, void *data)
 {
-        btnode_t *enode = node_search(tree, root(tree), data);
-        if (enode) {
-                return EEXIST;
-        }
-
-        btnode_t *newnode = node_make(tree, data);
-        if (!newnode) {
-                return ENOMEM;
-        }
-
         btnode_t *parent = NULL;
         btnode_t *node   = root(tree);
+        int       result = 0;
 
         while (node) {
-                parent = node;
-                if (data_compare(tree, data, data(tree, node)) < 0) {
-                        node = left(node);
-                } else {
-                        node = right(node);
+                result = data_compare(tree, data, data(tree, node));
+                if (result == 0) {
+                        return EEXIST;
                 }
+
+                parent = node;
+                node   = (result < 0) ? left(node) : right(node);
+        }
+
+        btnode_t *newnode = node_make(tree, data);
+        if (!newnode) {
+                return ENOMEM;
         }
 
         parent(newnode) = parent;
 
         if (!parent) {
                 root(tree) = newnode;
+        } else if (result < 0) {
+                left(parent) = newnode;
         } else {
-                if (data_compare(tree, data, data(tree, parent)) < 0) {
-                        left(parent) = newnode;
-                } else {
-                        right(parent) = newnode;
-                }
+                right(parent) = newnode;
         }
 
+        insert_fixup(tree, newnode);
+
         return ESUCC;
 }
 
@@ -445,49 +439,41 @@ int _btree_remove(btree_t *tree, void *key)
                 return ENOENT;
         }
 
-        btnode_t *remove;
-        btnode_t *other;
         btnode_t *node = node_search(tree, root(tree), key);
-
         if (!node) {
                 return ENOENT;
         }
 
-        if (!left(node) || !right(node)) {
-                remove = node;
-        } else {
-                remove = node_successor(node);
+        if (tree->node_dtor) {
+                tree->node_dtor(data(tree, node));
         }
 
-        if (left(remove)) {
-                other = left(remove);
-        } else {
-                other = right(remove);
-        }
+        // node with two children takes data of successor which is removed instead
+        btnode_t *remove  = (!left(node) || !right(node)) ? node : node_minimum(right(node));
+        btnode_t *other   = left(remove) ? left(remove) : right(remove);
+        btnode_t *oparent = parent(remove);
 
         if (other) {
-                parent(other) = parent(remove);
+                parent(other) = oparent;
         }
 
-        if (!parent(remove)) {
+        if (!oparent) {
                 root(tree) = other;
+        } else if (remove == left(oparent)) {
+                left(oparent) = other;
         } else {
-                if (remove == left(parent(remove))) {
-                        left(parent(remove)) = other;
-                } else {
-                        right(parent(remove)) = other;
-                }
+                right(oparent) = other;
         }
 
         if (node != remove) {
                 data_copy(tree, data(tree, node), data(tree, remove));
         }
 
-        if (tree->node_dtor) {
-                tree->node_dtor(data(tree, node));
+        if (!remove->red) {
+                remove_fixup(tree, other, oparent);
         }
 
-        tree->free(node, tree->freectx);
+        tree->free(remove, tree->freectx);
 
         return ESUCC;
 }
@@ -557,6 +543,231 @@ static btnode_t *node_successor(btnode_t *node)
         return node;
 }
 
+//==============================================================================
+/**
+ * @brief  Function get predecessor node.
+ *
+ * @param  node         node
+ *
+ * @return Predecessor node.
+ */
+//==============================================================================
+static btnode_t *node_predecessor(btnode_t *node)
+{
+        btnode_t *node2;
+
+        if (left(node)) {
+                node = node_maximum(left(node));
+        } else {
+                node2 = parent(node);
+                while (node2 && node == left(node2)) {
+                        node  = node2;
+                        node2 = parent(node);
+                }
+                node = node2;
+        }
+
+        return node;
+}
+
+//==============================================================================
+/**
+ * @brief  Function rotate subtree left (right child becomes subtree root).
+ *
+ * @param  tree         BTree object
+ * @param  node         subtree root
+ */
+//==============================================================================
+static void rotate_left(btree_t *tree, btnode_t *node)
+{
+        btnode_t *child = right(node);
+
+        right(node) = left(child);
+        if (left(child)) {
+                parent(left(child)) = node;
+        }
+
+        parent(child) = parent(node);
+
+        if (!parent(node)) {
+                root(tree) = child;
+        } else if (node == left(parent(node))) {
+                left(parent(node)) = child;
+        } else {
+                right(parent(node)) = child;
+        }
+
+        left(child)  = node;
+        parent(node) = child;
+}
+
+//==============================================================================
+/**
+ * @brief  Function rotate subtree right (left child becomes subtree root).
+ *
+ * @param  tree         BTree object
+ * @param  node         subtree root
+ */
+//==============================================================================
+static void rotate_right(btree_t *tree, btnode_t *node)
+{
+        btnode_t *child = left(node);
+
+        left(node) = right(child);
+        if (right(child)) {
+                parent(right(child)) = node;
+        }
+
+        parent(child) = parent(node);
+
+        if (!parent(node)) {
+                root(tree) = child;
+        } else if (node == right(parent(node))) {
+                right(parent(node)) = child;
+        } else {
+                left(parent(node)) = child;
+        }
+
+        right(child) = node;
+        parent(node) = child;
+}
+
+//==============================================================================
+/**
+ * @brief  Function restore red-black properties after insertion.
+ *
+ * @param  tree         BTree object
+ * @param  node         inserted (red) node
+ */
+//==============================================================================
+static void insert_fixup(btree_t *tree, btnode_t *node)
+{
+        btnode_t *par;
+
+        while ((par = parent(node)) && par->red) {
+                btnode_t *gpar = parent(par);
+
+                if (par == left(gpar)) {
+                        btnode_t *uncle = right(gpar);
+
+                        if (is_red(uncle)) {
+                                par->red   = false;
+                                uncle->red = false;
+                                gpar->red  = true;
+                                node       = gpar;
+                        } else {
+                                if (node == right(par)) {
+                                        node = par;
+                                        rotate_left(tree, node);
+                                        par  = parent(node);
+                                }
+
+                                par->red  = false;
+                                gpar->red = true;
+                                rotate_right(tree, gpar);
+                        }
+                } else {
+                        btnode_t *uncle = left(gpar);
+
+                        if (is_red(uncle)) {
+                                par->red   = false;
+                                uncle->red = false;
+                                gpar->red  = true;
+                                node       = gpar;
+                        } else {
+                                if (node == left(par)) {
+                                        node = par;
+                                        rotate_right(tree, node);
+                                        par  = parent(node);
+                                }
+
+                                par->red  = false;
+                                gpar->red = true;
+                                rotate_left(tree, gpar);
+                        }
+                }
+        }
+
+        root(tree)->red = false;
+}
+
+//==============================================================================
+/**
+ * @brief  Function restore red-black properties after black node removal.
+ *
+ * @param  tree         BTree object
+ * @param  node         node that replaced removed node (can be NULL)
+ * @param  par          parent of node
+ */
+//==============================================================================
+static void remove_fixup(btree_t *tree, btnode_t *node, btnode_t *par)
+{
+        while (node != root(tree) && !is_red(node)) {
+
+                if (node == left(par)) {
+                        btnode_t *sibling = right(par);
+
+                        if (is_red(sibling)) {
+                                sibling->red = false;
+                                par->red     = true;
+                                rotate_left(tree, par);
+                                sibling = right(par);
+                        }
+
+                        if (!is_red(left(sibling)) && !is_red(right(sibling))) {
+                                sibling->red = true;
+                                node = par;
+                                par  = parent(node);
+                        } else {
+                                if (!is_red(right(sibling))) {
+                                        left(sibling)->red = false;
+                                        sibling->red       = true;
+                                        rotate_right(tree, sibling);
+                                        sibling = right(par);
+                                }
+
+                                sibling->red        = par->red;
+                                par->red            = false;
+                                right(sibling)->red = false;
+                                rotate_left(tree, par);
+                                node = root(tree);
+                        }
+                } else {
+                        btnode_t *sibling = left(par);
+
+                        if (is_red(sibling)) {
+                                sibling->red = false;
+                                par->red     = true;
+                                rotate_right(tree, par);
+                                sibling = left(par);
+                        }
+
+                        if (!is_red(left(sibling)) && !is_red(right(sibling))) {
+                                sibling->red = true;
+                                node = par;
+                                par  = parent(node);
+                        } else {
+                                if (!is_red(left(sibling))) {
+                                        right(sibling)->red = false;
+                                        sibling->red        = true;
+                                        rotate_left(tree, sibling);
+                                        sibling = left(par);
+                                }
+
+                                sibling->red       = par->red;
+                                par->red           = false;
+                                left(sibling)->red = false;
+                                rotate_right(tree, par);
+                                node = root(tree);
+                        }
+                }
+        }
+
+        if (node) {
+                node->red = false;
+        }
+}
+
 //==============================================================================
 /**
  * @brief  Function return node with maximum value.
@@ -667,6 +878,7 @@ static btnode_t *node_make(btree_t *tree, void *data)
         if (node) {
                 data_copy(tree, data(tree, node), data);
                 parent(node) = left(node) = right(node) = NULL;
+                node->red = true;
         }
 
         return node;
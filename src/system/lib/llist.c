@@ -71,6 +71,8 @@ struct _llist {
         item_t              *tail;
         llist_t             *self;
         size_t               count;
+        item_t              *cursor;    //!< last accessed item (NULL if not valid)
+        size_t               cursor_pos;//!< position of last accessed item
 };
 
 /*==============================================================================
@@ -83,7 +85,7 @@ static int     append           (llist_t *this, const void *data);
 static int     insert_item      (llist_t *this, int index, const void *data);
 static item_t *get_item         (llist_t *this, int position);
 static int     remove_item      (llist_t *this, item_t *item, bool unlink);
-static void    quicksort        (llist_t *this, int left, int right);
+static void    merge_sort       (llist_t *this);
 static void   *usrmalloc        (size_t size, void *allocctx);
 static void    usrfree          (void *mem, void *freectx);
 static void   *krnmalloc        (size_t size, void *allocctx);
@@ -134,6 +136,8 @@ int _llist_create_usr(llist_malloc_t      malloc,
                         (*list)->head        = NULL;
                         (*list)->tail        = NULL;
                         (*list)->count       = 0;
+                        (*list)->cursor      = NULL;
+                        (*list)->cursor_pos  = 0;
                         (*list)->self        = *list;
 
                         err = ESUCC;
@@ -176,6 +180,8 @@ int _llist_create_krn(enum _mm_mem        mem,
                         (*list)->head        = NULL;
                         (*list)->tail        = NULL;
                         (*list)->count       = 0;
+                        (*list)->cursor      = NULL;
+                        (*list)->cursor_pos  = 0;
                         (*list)->self        = *list;
 
                         err = ESUCC;
@@ -216,6 +222,8 @@ int _llist_create_mod(size_t              modid,
                         (*list)->head        = NULL;
                         (*list)->tail        = NULL;
                         (*list)->count       = 0;
+                        (*list)->cursor      = NULL;
+                        (*list)->cursor_pos  = 0;
                         (*list)->self        = *list;
 
                         err = ESUCC;
@@ -552,9 +560,10 @@ int _llist_clear(llist_t *this)
                         remove_item(this, item_rm, false);
                 }
 
-                this->count = 0;
-                this->head  = NULL;
-                this->tail  = NULL;
+                this->count  = 0;
+                this->head   = NULL;
+                this->tail   = NULL;
+                this->cursor = NULL;
 
                 return 1;
         }
@@ -564,7 +573,8 @@ int _llist_clear(llist_t *this)
 
 //==============================================================================
 /**
- * @brief  Sort elements of the list
+ * @brief  Sort elements of the list. Sort is stable, equal elements keep
+ *         their order
  * @param  this         list object
  * @return None
  */
@@ -573,7 +583,7 @@ void _llist_sort(llist_t *this)
 {
         if (is_llist_valid(this)) {
                 if (this->cmp_functor) {
-                        quicksort(this, 0, this->count - 1);
+                        merge_sort(this);
                 }
         }
 }
@@ -589,7 +599,7 @@ void _llist_unique(llist_t *this)
 {
         if (is_llist_valid(this)) {
                 if (this->cmp_functor) {
-                        quicksort(this, 0, this->count - 1);
+                        merge_sort(this);
 
                         item_t *item = this->head;
                         while (item && item->next) {
@@ -633,7 +643,8 @@ void _llist_reverse(llist_t *this)
 
 //==============================================================================
 /**
- * @brief  Get element from the list at selected position
+ * @brief  Get element from the list at selected position. Last accessed
+ *         position is cached, thus access to neighbour position is fast
  * @param  this         list object
  * @param  position     begin position
  * @return Pointer to data, or NULL on error
@@ -692,6 +703,8 @@ int _llist_find_begin(llist_t *this, const void *object)
                         int cnt = 0;
                         for (item_t *item = this->head; item; item = item->next, cnt++) {
                                 if (this->cmp_functor(item->data, object) == 0) {
+                                        this->cursor     = item;
+                                        this->cursor_pos = cnt;
                                         return cnt;
                                 }
                         }
@@ -716,6 +729,8 @@ int _llist_find_end(llist_t *this, const void *object)
                         int cnt = this->count - 1;
                         for (item_t *item = this->tail; item; item = item->prev, cnt--) {
                                 if (this->cmp_functor(item->data, object) == 0) {
+                                        this->cursor     = item;
+                                        this->cursor_pos = cnt;
                                         return cnt;
                                 }
                         }
@@ -1046,26 +1061,43 @@ static item_t *get_item(llist_t *this, int position)
         } else {
                 enum direction dir;
                 item_t        *item;
+                size_t         pos  = position;
+                size_t         dist = pos;
 
-                if (cast(size_t, position) <= this->count / 2) {
-                        dir      = DIR_FORWARD;
-                        item     = this->head;
-                } else {
-                        dir      = DIR_BACKWARD;
-                        item     = this->tail;
-                        position = this->count - position - 1;
+                dir  = DIR_FORWARD;
+                item = this->head;
+
+                if (this->count - pos - 1 < dist) {
+                        dir  = DIR_BACKWARD;
+                        item = this->tail;
+                        dist = this->count - pos - 1;
                 }
 
-                while (item) {
-                        if (position-- == 0) {
-                                return item;
-                        } else {
-                                item = dir == DIR_FORWARD ? item->next : item->prev;
+                /* sequential access starts from last accessed item */
+                if (this->cursor) {
+                        if (pos >= this->cursor_pos && pos - this->cursor_pos < dist) {
+                                dir  = DIR_FORWARD;
+                                item = this->cursor;
+                                dist = pos - this->cursor_pos;
+
+                        } else if (pos < this->cursor_pos && this->cursor_pos - pos < dist) {
+                                dir  = DIR_BACKWARD;
+                                item = this->cursor;
+                                dist = this->cursor_pos - pos;
                         }
                 }
-        }
 
-        return NULL;
+                while (item && dist--) {
+                        item = dir == DIR_FORWARD ? item->next : item->prev;
+                }
+
+                if (item) {
+                        this->cursor     = item;
+                        this->cursor_pos = pos;
+                }
+
+                return item;
+        }
 }
 
 //==============================================================================
@@ -1080,6 +1112,16 @@ static item_t *get_item(llist_t *this, int position)
 static int remove_item(llist_t *this, item_t *item, bool unlink)
 {
         if (item) {
+                if (this->cursor) {
+                        if (item == this->cursor) {
+                                this->cursor = NULL;
+                        } else if (item == this->head) {
+                                this->cursor_pos--;
+                        } else if (item != this->tail) {
+                                this->cursor = NULL;
+                        }
+                }
+
                 if (item->prev == NULL) {
                         this->head = item->next;
                 } else {
@@ -1147,6 +1189,8 @@ static int insert_item(llist_t *this, int index, const void *data)
                                 item->prev->next = new_item;
                                 item->prev       = new_item;
 
+                                // get_item() set cursor to item that was moved
+                                this->cursor_pos++;
                                 this->count++;
 
                                 return 1;
@@ -1186,6 +1230,7 @@ static int prepend(llist_t *this, const void *data)
                         this->head       = new_item;
                 }
 
+                this->cursor_pos++;
                 this->count++;
 
                 return 1;
@@ -1230,52 +1275,79 @@ static int append(llist_t *this, const void *data)
 
 //==============================================================================
 /**
- * @brief  Quicksort algorithm
+ * @brief  Merge sort algorithm (stable, bottom-up). Items are relinked, data
+ *         pointers stay in their items.
  * @param  this         list object
- * @param  left         left position (sort border)
- * @param  right        right position (sort border)
  * @return None
  */
 //==============================================================================
-static void quicksort(llist_t *this, int left, int right)
+static void merge_sort(llist_t *this)
 {
-        int     i, j;
-        void   *pivot;
-        item_t *item_i, *item_j, *item_r, *item_l;
+        item_t *list = this->head;
+
+        for (size_t width = 1; list && width < this->count; width *= 2) {
+                item_t  *result = NULL;
+                item_t **tail   = &result;
 
-        i = (left + right) / 2;
+                while (list) {
+                        /* split two runs of selected width */
+                        item_t *left  = list;
+                        item_t *right = list;
+                        size_t  lsize = 0;
 
-        item_i = get_item(this, i);
-        item_r = get_item(this, right);
-        item_l = get_item(this, left);
-        pivot  = item_i->data;
+                        while (right && lsize < width) {
+                                right = right->next;
+                                lsize++;
+                        }
 
-        item_i->data = item_r->data;
+                        size_t rsize = width;
 
-        item_j = item_i = item_l;
-        for (i = j = left; i < right; item_i = item_i->next, i++) {
+                        /* merge runs, on equal keys left item goes first */
+                        while (lsize > 0 || (rsize > 0 && right)) {
+                                item_t *item;
 
-                if (this->cmp_functor(item_i->data, pivot) < 0) {
+                                if (lsize == 0) {
+                                        item  = right;
+                                        right = right->next;
+                                        rsize--;
 
-                        void *data   = item_j->data;
-                        item_j->data = item_i->data;
-                        item_i->data = data;
+                                } else if (rsize == 0 || right == NULL) {
+                                        item = left;
+                                        left = left->next;
+                                        lsize--;
 
-                        item_j = item_j->next;
-                        j++;
-                }
-        }
+                                } else if (this->cmp_functor(left->data, right->data) <= 0) {
+                                        item = left;
+                                        left = left->next;
+                                        lsize--;
 
-        item_r->data = item_j->data;
-        item_j->data = pivot;
+                                } else {
+                                        item  = right;
+                                        right = right->next;
+                                        rsize--;
+                                }
+
+                                *tail = item;
+                                tail  = &item->next;
+                        }
 
-        if (left < j - 1) {
-                quicksort(this, left, j - 1);
+                        list = right;
+                }
+
+                *tail = NULL;
+                list  = result;
         }
 
-        if (j + 1 < right) {
-                quicksort(this, j + 1, right);
+        /* restore backward links */
+        item_t *prev = NULL;
+        for (item_t *item = list; item; item = item->next) {
+                item->prev = prev;
+                prev       = item;
         }
+
+        this->head   = list;
+        this->tail   = prev;
+        this->cursor = NULL;
 }
 
 //==============================================================================
@@ -34,11 +34,12 @@
 #include "lib/vfprintf.h"
 #include "lib/vsnprintf.h"
 #include "lib/cast.h"
-#include "mm/mm.h"
+#include "libc/errno.h"
 
 /*==============================================================================
   Local macros
 ==============================================================================*/
+#define CHUNK_SIZE              64
 
 /*==============================================================================
   Local object types
@@ -47,6 +48,7 @@
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
+static int write_chunk(void *file, const char *str, size_t len);
 
 /*==============================================================================
   Local objects
@@ -81,23 +83,14 @@ int _vfprintf(FILE *file, const char *format, va_list arg)
 
 #if (__OS_PRINTF_ENABLE__ > 0)
 
-        if (file && format) {
-                va_list carg;
-                va_copy(carg, arg);
-                u32_t size = _vsnprintf(NULL, 0, format, carg) + 1;
-                va_end(carg);
-
-                char *str = NULL;
-                int err = _kzalloc(_MM_KRN, size, NULL, _MM_FLAG__DMA_CAPABLE,
-                                   _MM_FLAG__DMA_CAPABLE, cast(void*, &str));
-                if (!err && str) {
-                        n = _vsnprintf(str, size, format, arg);
-
-                        size_t wrcnt;
-                        _vfs_fwrite(str, n, &wrcnt, file);
-
-                        _kfree(_MM_KRN, cast(void*, &str));
-                }
+        /*
+         * Text is formatted in single pass and written in chunks. Stream is
+         * locked, so output is not mixed with other writers.
+         */
+        if (file && format && (_vfs_flockfile(file) == ESUCC)) {
+                char chunk[CHUNK_SIZE];
+                n = _vsnprintf_out(chunk, sizeof(chunk), write_chunk, file, format, arg);
+                _vfs_funlockfile(file);
         }
 
 #else
@@ -106,6 +99,23 @@ int _vfprintf(FILE *file, const char *format, va_list arg)
         return n;
 }
 
+//==============================================================================
+/**
+ * @brief Function write formatted chunk to file
+ *
+ * @param file                file
+ * @param str                 chunk
+ * @param len                 chunk length
+ *
+ * @return One of errno value (errno.h)
+ */
+//==============================================================================
+static int write_chunk(void *file, const char *str, size_t len)
+{
+        size_t wrcnt = 0;
+        return _vfs_fwrite(str, len, &wrcnt, file);
+}
+
 /*==============================================================================
   End of file
 ==============================================================================*/
@@ -45,10 +45,30 @@
 /*==============================================================================
   Local object types
 ==============================================================================*/
+typedef struct {
+        va_list                *va;     //!< variadic arguments (NULL: packed arguments)
+        const _vsnprintf_arg_t *packed; //!< packed arguments
+        size_t                  count;  //!< number of packed arguments
+        const char             *str;    //!< packed strings
+} args_t;
+
+typedef struct {
+        int                     arg_size;       //!< argument size (-1: not set)
+        bool                    arg_size_str;   //!< argument size set by '.'
+        bool                    arg_size_arg;   //!< argument size is an argument ('.*')
+        bool                    leading_zero;   //!< leading zero enabled
+        bool                    long_long;      //!< long long value
+        char                    conv;           //!< conversion character
+} spec_t;
 
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
+static int format_args(char *buf, size_t size, _vsnprintf_out_t out, void *ctx,
+                       const char *format, args_t *args);
+#if (__OS_PRINTF_ENABLE__ > 0)
+static const char *parse_spec(const char *format, spec_t *spec);
+#endif
 
 /*==============================================================================
   Local objects
@@ -77,6 +97,29 @@
  * @param[in]  arg           argument list
  *
  * @return number of printed characters
+ */
+//==============================================================================
+int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
+{
+        return _vsnprintf_out(buf, size, NULL, NULL, format, arg);
+}
+
+//==============================================================================
+/**
+ * @brief Function convert arguments to stream. If output function is set then
+ *        buffer is used as a chunk: when chunk is full then it is passed to
+ *        output function and filled again, so text of any length is formatted
+ *        in single pass without allocation. Otherwise text is written to
+ *        buffer and terminated by nul character (vsnprintf() behavior).
+ *
+ * @param[in] *buf           buffer for stream (chunk if output function is set)
+ * @param[in]  size          buffer size
+ * @param[in]  out           output function (can be NULL)
+ * @param[in] *ctx           output function context
+ * @param[in] *format        message format
+ * @param[in]  arg           argument list
+ *
+ * @return number of printed characters
  *
  * Supported flags:
  *   %%         - print % character
@@ -119,17 +162,252 @@
  *                printf("Pointer: %p", main); => Pointer: 0x4028B4
  */
 //==============================================================================
-int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
+int _vsnprintf_out(char *buf, size_t size, _vsnprintf_out_t out, void *ctx,
+                   const char *format, va_list arg)
+{
+        va_list va;
+        va_copy(va, arg);
+
+        args_t args = {.va = &va};
+        int n = format_args(buf, size, out, ctx, format, &args);
+
+        va_end(va);
+
+        return n;
+}
+
+//==============================================================================
+/**
+ * @brief Function pack arguments of format to the array, so message can be
+ *        formatted later by _vsnprintf_unpack() (e.g. by log reader). Strings
+ *        (%s) are copied to the string buffer because pointed memory can be
+ *        released before formatting. Conversions are recognized in the same
+ *        way as by _vsnprintf_out().
+ *
+ * @param[in]  *format       message format
+ * @param[in]   arg          argument list
+ * @param[out] *args         packed arguments
+ * @param[in]   max_args     maximum number of packed arguments
+ * @param[out] *str          buffer for strings
+ * @param[in]   str_size     string buffer size
+ *
+ * @return Number of packed arguments. Arguments that exceed array are dropped
+ *         and formatted as zero, strings that exceed buffer are truncated.
+ */
+//==============================================================================
+int _vsnprintf_pack(const char *format, va_list arg, _vsnprintf_arg_t *args,
+                    size_t max_args, char *str, size_t str_size)
+{
+#if (__OS_PRINTF_ENABLE__ > 0)
+        size_t argc    = 0;
+        size_t str_len = 0;
+
+        if (!format || !args) {
+                return 0;
+        }
+
+        /// @brief  Copy string to the string buffer
+        /// @param  src         string to copy (can be NULL)
+        /// @param  max_len     maximum string length (-1 for entire string)
+        /// @return None
+        void put_string(const char *src, int max_len)
+        {
+                if (!src || !str || (str_len >= str_size)) {
+                        args[argc++].p = UINTPTR_MAX;
+                        return;
+                }
+
+                size_t len = strlen(src);
+                if ((max_len >= 0) && (len > cast(size_t, max_len))) {
+                        len = max_len;
+                }
+
+                if (len > str_size - str_len - 1) {
+                        len = str_size - str_len - 1;
+                }
+
+                memcpy(&str[str_len], src, len);
+                str[str_len + len] = '\0';
+
+                args[argc++].p = str_len;
+                str_len += len + 1;
+        }
+
+        while ((argc < max_args) && (*format != '\0')) {
+
+                if (*format++ != '%') {
+                        continue;
+                }
+
+                spec_t spec;
+                format = parse_spec(format, &spec);
+                if (!format) {
+                        break;
+                }
+
+                if (spec.arg_size_arg) {
+                        spec.arg_size = va_arg(arg, int);
+                        args[argc++].i = spec.arg_size;
+
+                        if (argc >= max_args) {
+                                break;
+                        }
+                }
+
+                switch (spec.conv) {
+                case 'c':
+                        args[argc++].i = va_arg(arg, int);
+                        break;
+
+                case 's':
+                        put_string(va_arg(arg, const char*),
+                                   (spec.arg_size_str && (spec.arg_size > 0))
+                                   ? spec.arg_size : -1);
+                        break;
+
+                case 'd': case 'i': case 'u': case 'x': case 'X':
+                        if (spec.long_long) {
+                                args[argc++].ll = va_arg(arg, i64_t);
+                        } else {
+                                args[argc++].i = va_arg(arg, i32_t);
+                        }
+                        break;
+
+                case 'f': case 'F':
+                        args[argc++].d = va_arg(arg, double);
+                        break;
+
+                case 'p':
+                        args[argc++].p = va_arg(arg, uintptr_t);
+                        break;
+
+                default:
+                        break;
+                }
+        }
+
+        return argc;
+#else
+        UNUSED_ARG6(format, arg, args, max_args, str, str_size);
+        return 0;
+#endif
+}
+
+//==============================================================================
+/**
+ * @brief Function convert packed arguments (see _vsnprintf_pack()) to stream.
+ *
+ * @param[in] *buf           buffer for stream
+ * @param[in]  size          buffer size
+ * @param[in] *format        message format (the same as used to pack)
+ * @param[in] *args          packed arguments
+ * @param[in]  argc          number of packed arguments
+ * @param[in] *str           buffer with packed strings
+ *
+ * @return number of printed characters
+ */
+//==============================================================================
+int _vsnprintf_unpack(char *buf, size_t size, const char *format,
+                      const _vsnprintf_arg_t *args, size_t argc, const char *str)
+{
+        args_t packed = {.va = NULL, .packed = args, .count = argc, .str = str};
+        return format_args(buf, size, NULL, NULL, format, &packed);
+}
+
+//==============================================================================
+/**
+ * @brief Function convert arguments to stream. Arguments are taken from
+ *        variadic list or from packed arguments.
+ *
+ * @param[in] *buf           buffer for stream (chunk if output function is set)
+ * @param[in]  size          buffer size
+ * @param[in]  out           output function (can be NULL)
+ * @param[in] *ctx           output function context
+ * @param[in] *format        message format
+ * @param[in] *args          argument source
+ *
+ * @return number of printed characters
+ */
+//==============================================================================
+static int format_args(char *buf, size_t size, _vsnprintf_out_t out, void *ctx,
+                       const char *format, args_t *args)
 {
 #if (__OS_PRINTF_ENABLE__ > 0)
         char   chr;
         int    arg_size;
         size_t scan_len     = 1;
+        size_t chunk_len    = 0;
         bool   leading_zero = false;
         bool   loop_break   = false;
         bool   long_long    = false;
         bool   arg_size_str = false;
 
+        size_t packed_idx   = 0;
+
+        if (out && (!buf || (size == 0))) {
+                return 0;
+        }
+
+        /// @brief  Get next packed argument
+        /// @param  None
+        /// @return Packed argument (zero if all arguments are used)
+        _vsnprintf_arg_t get_packed()
+        {
+                _vsnprintf_arg_t val = {.ll = 0};
+
+                if (packed_idx < args->count) {
+                        val = args->packed[packed_idx++];
+                }
+
+                return val;
+        }
+
+        /// @brief  Get int argument
+        /// @param  None
+        /// @return Argument value
+        i32_t get_int()
+        {
+                return args->va ? va_arg(*args->va, i32_t) : get_packed().i;
+        }
+
+        /// @brief  Get long long argument
+        /// @param  None
+        /// @return Argument value
+        i64_t get_long_long()
+        {
+                return args->va ? va_arg(*args->va, i64_t) : get_packed().ll;
+        }
+
+        /// @brief  Get pointer argument
+        /// @param  None
+        /// @return Argument value
+        uintptr_t get_pointer()
+        {
+                return args->va ? va_arg(*args->va, uintptr_t) : get_packed().p;
+        }
+
+        /// @brief  Get double argument
+        /// @param  None
+        /// @return Argument value
+        double get_double()
+        {
+                return args->va ? va_arg(*args->va, double) : get_packed().d;
+        }
+
+        /// @brief  Get string argument
+        /// @param  None
+        /// @return Argument value (can be NULL)
+        char *get_string()
+        {
+                if (args->va) {
+                        return va_arg(*args->va, char*);
+                } else {
+                        uintptr_t offset = get_packed().p;
+                        return (args->str && (offset != UINTPTR_MAX))
+                             ? const_cast(char*, args->str + offset) : NULL;
+                }
+        }
+
         /// @brief  Function break loop
         /// @param  None
         /// @return None
@@ -143,7 +421,19 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
         /// @return On success true is returned, otherwise false and loop is break
         bool put_char(const char c)
         {
-                if (buf) {
+                if (out) {
+                        if (chunk_len == size) {
+                                if (out(ctx, buf, chunk_len) != 0) {
+                                        break_loop();
+                                        return false;
+                                }
+
+                                chunk_len = 0;
+                        }
+
+                        buf[chunk_len++] = c;
+
+                } else if (buf) {
                         if (scan_len < size) {
                                 *buf++ = c;
                         } else {
@@ -171,77 +461,6 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                 }
         }
 
-        /// @brief  Analyze modifiers (%0, %.*, %<num>, %xxlx)
-        /// @param  None
-        /// @return If modifiers are set or not then true is returned. On error false.
-        bool check_modifiers()
-        {
-                arg_size     = -1;
-                leading_zero = false;
-                arg_size_str = false;
-
-                // check leading zero enable
-                if (chr == '0') {
-                        leading_zero = true;
-                        if (!get_format_char()) {
-                                return false;
-                        }
-                }
-
-                // check argument size modifier
-                if (chr == '.') {
-                        if (!get_format_char()) {
-                                return false;
-                        }
-
-                        if (chr == '*') {
-                                arg_size     = va_arg(arg, int);
-                                arg_size_str = true;
-
-                                if (!get_format_char()) {
-                                        return false;
-                                }
-                        } else if (chr >= '0' && chr <= '9') {
-                                arg_size     = 0;
-                                arg_size_str = true;
-                                while (chr >= '0' && chr <= '9') {
-                                        arg_size *= 10;
-                                        arg_size += chr - '0';
-
-                                        if (!get_format_char()) {
-                                                return false;
-                                        }
-                                }
-                        } else {
-                                break_loop();
-                                return false;
-                        }
-
-                // check numeric size modifier
-                } else {
-                        arg_size = 0;
-                        while (chr >= '0' && chr <= '9') {
-                                arg_size *= 10;
-                                arg_size += chr - '0';
-
-                                if (!get_format_char()) {
-                                        return false;
-                                }
-                        }
-                }
-
-                // check long long values
-                if (chr == 'l') {
-                        long_long = true;
-
-                        if (!get_format_char()) {
-                                return false;
-                        }
-                }
-
-                return true;
-        }
-
         /// @brief  Put percent or character
         /// @param  None
         /// @return If format was found then true is returned, otherwise false.
@@ -249,7 +468,7 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
         {
                 if (chr == '%' || chr == 'c') {
                         if (chr == 'c') {
-                                chr = va_arg(arg, int);
+                                chr = get_int();
                                 if (chr != '\0') {
                                         put_char(chr);
                                 }
@@ -269,7 +488,7 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
         bool put_string()
         {
                 if (chr == 's') {
-                        char *str = va_arg(arg, char*);
+                        char *str = get_string();
                         if (!str) {
                                 str = "";
                         }
@@ -335,10 +554,10 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
 
                         i64_t val;
                         if (long_long) {
-                                val = va_arg(arg, i64_t);
+                                val = get_long_long();
 
                         } else {
-                                val = va_arg(arg, i32_t);
+                                val = get_int();
 
                                 if (unsign) {
                                         val &= 0xFFFFFFFFUL;
@@ -387,14 +606,14 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                         char result[65];
                         int  prec = (arg_size <= 0) ? 0 : arg_size;
                         if (prec) {
-                                int len = _dtoa(va_arg(arg, double), result, prec, sizeof(result));
+                                int len = _dtoa(get_double(), result, prec, sizeof(result));
                                 for (int i = 0; i < len; i++) {
                                         if (!put_char(result[i])) {
                                                 break;
                                         }
                                 }
                         } else {
-                                double val = va_arg(arg, double);
+                                double val = get_double();
                                 char *result_ptr = _itoa(val, result, 10, false, 0);
                                 while ((chr = *result_ptr++)) {
                                         if (!put_char(chr)) {
@@ -403,7 +622,7 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                                 }
                         }
 #else
-                        double val = va_arg(arg, double);
+                        double val = get_double();
                         (void)val;
                         put_char('0');
 #endif
@@ -419,7 +638,7 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
         bool put_pointer()
         {
                 if (chr == 'p') {
-                        i64_t val = va_arg(arg, uintptr_t);
+                        i64_t val = get_pointer();
                         val &= UINTPTR_MAX;
                         char  result[16];
                         char *result_ptr = _itoa(val, result, 16, true, 0);
@@ -453,11 +672,18 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                         continue;
 
                 } else {
-                        if (!get_format_char())
+                        spec_t spec;
+                        format = parse_spec(format, &spec);
+                        if (!format) {
+                                break_loop();
                                 continue;
+                        }
 
-                        if (!check_modifiers())
-                                continue;
+                        arg_size     = spec.arg_size_arg ? get_int() : spec.arg_size;
+                        arg_size_str = spec.arg_size_str;
+                        leading_zero = spec.leading_zero;
+                        long_long    = spec.long_long;
+                        chr          = spec.conv;
 
                         if (put_percent_or_char())
                                 continue;
@@ -476,19 +702,106 @@ int _vsnprintf(char *buf, size_t size, const char *format, va_list arg)
                 }
         }
 
-        if (buf)
+        if (out) {
+                if (chunk_len > 0) {
+                        out(ctx, buf, chunk_len);
+                }
+
+        } else if (buf && size) {
                 *buf = 0;
+        }
 
         return (scan_len - 1);
 #else
         UNUSED_ARG1(buf);
         UNUSED_ARG1(size);
+        UNUSED_ARG1(out);
+        UNUSED_ARG1(ctx);
         UNUSED_ARG1(format);
-        UNUSED_ARG1(arg);
+        UNUSED_ARG1(args);
         return 0;
 #endif
 }
 
+#if (__OS_PRINTF_ENABLE__ > 0)
+//==============================================================================
+/**
+ * @brief Function parse conversion specification (%0, %.*, %.<num>, %<num>,
+ *        %l and conversion character). The same parser is used to format and
+ *        to pack arguments, so both recognize the same arguments. Argument
+ *        size given by argument ('.*') is not read, caller takes it before
+ *        argument of conversion.
+ *
+ * @param[in]  *format       format string after '%' character
+ * @param[out] *spec         parsed specification
+ *
+ * @return Format string after conversion character, or NULL if format string
+ *         ends or specification is not valid.
+ */
+//==============================================================================
+static const char *parse_spec(const char *format, spec_t *spec)
+{
+        char chr = *format++;
+
+        spec->arg_size     = -1;
+        spec->arg_size_str = false;
+        spec->arg_size_arg = false;
+        spec->leading_zero = false;
+        spec->long_long    = false;
+        spec->conv         = '\0';
+
+        // check leading zero enable
+        if (chr == '0') {
+                spec->leading_zero = true;
+                chr = *format++;
+        }
+
+        // check argument size modifier
+        if (chr == '.') {
+                spec->arg_size_str = true;
+                chr = *format++;
+
+                if (chr == '*') {
+                        spec->arg_size_arg = true;
+                        chr = *format++;
+
+                } else if (chr >= '0' && chr <= '9') {
+                        spec->arg_size = 0;
+                        while (chr >= '0' && chr <= '9') {
+                                spec->arg_size *= 10;
+                                spec->arg_size += chr - '0';
+                                chr = *format++;
+                        }
+                } else {
+                        return NULL;
+                }
+
+        // check numeric size modifier
+        } else {
+                spec->arg_size = 0;
+                while (chr >= '0' && chr <= '9') {
+                        spec->arg_size *= 10;
+                        spec->arg_size += chr - '0';
+                        chr = *format++;
+                }
+        }
+
+        // check long long values
+        if (chr == 'l') {
+                spec->long_long = true;
+                chr = *format++;
+        }
+
+        if (chr == '\0') {
+                return NULL;
+        }
+
+        spec->conv = chr;
+
+        return format;
+}
+#endif
+
 //==============================================================================
 /**
  * @brief Function convert arguments to stream.
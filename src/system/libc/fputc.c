@@ -74,6 +74,11 @@
 int fputc(int c, FILE *stream)
 {
 #if (__OS_PRINTF_ENABLE__ > 0)
+        // character is stored directly in stream buffer without syscall
+        if (_builtinfunc(vfs_fputc_buffered, stream, c)) {
+                return c;
+        }
+
         char ch = (char)c;
         if (fwrite(&ch, sizeof(char), 1, stream) == 1) {
                 return c;
@@ -78,6 +78,12 @@ int getc(FILE *stream)
         }
 
         char chr = 0;
+
+        // character is taken directly from stream buffer without syscall
+        if (_builtinfunc(vfs_fgetc_buffered, stream, &chr)) {
+                return chr;
+        }
+
         if (fread(&chr, sizeof(char), 1, stream) != 0) {
                 if (ferror(stream) || feof(stream)) {
                         return EOF;
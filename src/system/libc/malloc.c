@@ -0,0 +1,383 @@
+/*==============================================================================
+File    malloc.c
+
+Author  Daniel Zorychta
+
+Brief   Program memory allocation functions.
+
+        Copyright (C) 2017 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*
+ * Small blocks are carved from chunks that are allocated by SYSCALL_MALLOC,
+ * so chunks are still process resources: they are accounted to the program
+ * and released by the kernel when the program exits. Freed small blocks are
+ * kept in per size class lists and are reused without entering the kernel.
+ * Large blocks are allocated directly by the kernel, as before.
+ *
+ * Each small block is preceded by a tag word that holds a magic value and
+ * the size class. Class sizes are 8n + 4 bytes, so tag and payload take a
+ * multiple of 8 bytes and each payload is 8-byte aligned (e.g. for double and
+ * 64-bit values). Blocks allocated by the kernel are preceded by a resource
+ * header which type field never matches the tag magic, thus free() is able
+ * to select the correct path. A block freed twice has a free tag and is
+ * passed to the kernel which reports corruption.
+ */
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <config.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dnx/misc.h>
+#include <kernel/process.h>
+#include <mm/mm.h>
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+#define CHUNK_SIZE              __OS_MALLOC_CHUNK_SIZE__
+#define TAG_MAGIC               0xA110C000
+#define TAG_MAGIC_MASK          0xFFFFFF00
+#define TAG_FREE                0xA110CFEE
+#define TAG_CLASS(tag)          ((tag) & ~TAG_MAGIC_MASK)
+#define CLASS_COUNT             9
+#define BLOCK_TAG(ptr)          (cast(u32_t*, ptr)[-1])
+#define BLOCK_ALIGN             8
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct {
+        void   *free[CLASS_COUNT];      //!< free block lists (one per size class)
+        u8_t   *bump;                   //!< next unused byte in current chunk
+        size_t  bump_left;              //!< unused bytes in current chunk
+} arena_t;
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+#if CHUNK_SIZE > 0
+static const u16_t class_size[CLASS_COUNT] = {12, 20, 28, 36, 52, 68, 100, 132, 196};
+#endif
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+#if CHUNK_SIZE > 0
+//==============================================================================
+/**
+ * @brief  Function returns arena slot of current process.
+ *
+ * @return Arena slot, NULL if called outside of process.
+ */
+//==============================================================================
+static arena_t **arena_slot(void)
+{
+        struct _process *proc = _builtinfunc(task_get_tag, _THIS_TASK);
+
+        return cast(arena_t**, _builtinfunc(process_get_mem_arena, proc));
+}
+
+//==============================================================================
+/**
+ * @brief  Function returns size class that fit selected size.
+ *
+ * @param  size         requested size
+ *
+ * @return Class index, CLASS_COUNT if block should be allocated by kernel.
+ */
+//==============================================================================
+static uint size_to_class(size_t size)
+{
+        uint cls = 0;
+
+        while ((cls < CLASS_COUNT) && (class_size[cls] < size)) {
+                cls++;
+        }
+
+        if (  (size == 0)
+           || (cls == CLASS_COUNT)
+           || (sizeof(u32_t) + class_size[cls] > CHUNK_SIZE / 2) ) {
+                cls = CLASS_COUNT;
+        }
+
+        return cls;
+}
+
+//==============================================================================
+/**
+ * @brief  Function takes block from free list or current chunk.
+ *         Must be called with scheduler locked.
+ *
+ * @param  arena        arena
+ * @param  cls          size class
+ *
+ * @return Block payload, NULL if arena has no space for block.
+ */
+//==============================================================================
+static void *arena_take(arena_t *arena, uint cls)
+{
+        void  *mem    = arena->free[cls];
+        size_t stride = sizeof(u32_t) + class_size[cls];
+
+        if (mem) {
+                arena->free[cls] = *cast(void**, mem);
+
+        } else if (arena->bump_left >= stride) {
+                mem = arena->bump + sizeof(u32_t);
+                arena->bump      += stride;
+                arena->bump_left -= stride;
+        }
+
+        if (mem) {
+                BLOCK_TAG(mem) = TAG_MAGIC | cls;
+        }
+
+        return mem;
+}
+
+//==============================================================================
+/**
+ * @brief  Function allocates small block from process arena.
+ *
+ * @param  cls          size class
+ *
+ * @return Block payload, NULL on error.
+ */
+//==============================================================================
+static void *arena_alloc(uint cls)
+{
+        arena_t **slot = arena_slot();
+        if (slot == NULL) {
+                return NULL;
+        }
+
+        _builtinfunc(kernel_scheduler_lock);
+        void *mem = *slot ? arena_take(*slot, cls) : NULL;
+        _builtinfunc(kernel_scheduler_unlock);
+
+        if (mem == NULL) {
+                size_t size  = CHUNK_SIZE;
+                u8_t  *chunk = NULL;
+                syscall(SYSCALL_MALLOC, &chunk, &size);
+
+                if (chunk) {
+                        _builtinfunc(kernel_scheduler_lock);
+                        {
+                                if (*slot == NULL) {
+                                        *slot = cast(arena_t*, chunk);
+                                        memset(*slot, 0, sizeof(arena_t));
+                                        chunk += sizeof(arena_t);
+                                        size  -= sizeof(arena_t);
+                                }
+
+                                // first payload (after tag) is aligned
+                                size_t pad = (BLOCK_ALIGN - ((cast(uintptr_t, chunk) + sizeof(u32_t))
+                                                             % BLOCK_ALIGN)) % BLOCK_ALIGN;
+                                pad = min(pad, size);
+
+                                // remaining part of previous chunk is abandoned
+                                (*slot)->bump      = chunk + pad;
+                                (*slot)->bump_left = size - pad;
+
+                                mem = arena_take(*slot, cls);
+                        }
+                        _builtinfunc(kernel_scheduler_unlock);
+                }
+        }
+
+        return mem;
+}
+#endif
+
+//==============================================================================
+/**
+ * @brief Function allocates memory block.
+ *
+ * @param size      block size
+ *
+ * @return Pointer to allocated block or @ref NULL on error.
+ *
+ * @see stdlib.h
+ */
+//==============================================================================
+void *malloc(size_t size)
+{
+        void *mem = NULL;
+
+#if CHUNK_SIZE > 0
+        uint cls = size_to_class(size);
+        if (cls < CLASS_COUNT) {
+                mem = arena_alloc(cls);
+                if (mem) {
+                        return mem;
+                }
+        }
+#endif
+
+        syscall(SYSCALL_MALLOC, &mem, &size);
+        return mem;
+}
+
+//==============================================================================
+/**
+ * @brief Function allocates memory block and clears it.
+ *
+ * @param n         number of elements
+ * @param size      size of elements
+ *
+ * @return Pointer to allocated block or @ref NULL on error.
+ *
+ * @see stdlib.h
+ */
+//==============================================================================
+void *calloc(size_t n, size_t size)
+{
+        void   *mem   = NULL;
+        size_t  bsize = n * size;
+
+#if CHUNK_SIZE > 0
+        uint cls = size_to_class(bsize);
+        if (cls < CLASS_COUNT) {
+                mem = arena_alloc(cls);
+                if (mem) {
+                        memset(mem, 0, bsize);
+                        return mem;
+                }
+        }
+#endif
+
+        syscall(SYSCALL_ZALLOC, &mem, &bsize);
+        return mem;
+}
+
+//==============================================================================
+/**
+ * @brief Function frees allocated memory block.
+ *
+ * @param ptr       pointer to memory space to be freed
+ *
+ * @see stdlib.h
+ */
+//==============================================================================
+void free(void *ptr)
+{
+        if (ptr == NULL) {
+                return;
+        }
+
+#if CHUNK_SIZE > 0
+        u32_t tag = BLOCK_TAG(ptr);
+
+        if (  ((tag & TAG_MAGIC_MASK) == TAG_MAGIC)
+           && (TAG_CLASS(tag) < CLASS_COUNT) ) {
+
+                arena_t **slot = arena_slot();
+
+                if (slot && *slot) {
+                        _builtinfunc(kernel_scheduler_lock);
+                        {
+                                uint cls = TAG_CLASS(tag);
+                                BLOCK_TAG(ptr)          = TAG_FREE;
+                                *cast(void**, ptr)      = (*slot)->free[cls];
+                                (*slot)->free[cls]      = ptr;
+                        }
+                        _builtinfunc(kernel_scheduler_unlock);
+                        return;
+                }
+        }
+#endif
+
+        syscall(SYSCALL_FREE, NULL, ptr);
+}
+
+//==============================================================================
+/**
+ * @brief Function changes the size of allocated memory block.
+ *
+ * @param ptr       pointer to memory space
+ * @param size      size of new memory space
+ *
+ * @return Pointer to the new block or @ref NULL on error.
+ *
+ * @see stdlib.h
+ */
+//==============================================================================
+void *realloc(void *ptr, size_t size)
+{
+        if (size == 0) {
+                free(ptr);
+                return NULL;
+        }
+
+        if (ptr == NULL) {
+                return malloc(size);
+        }
+
+        size_t old_size = size;
+
+#if CHUNK_SIZE > 0
+        u32_t tag = BLOCK_TAG(ptr);
+
+        if (  ((tag & TAG_MAGIC_MASK) == TAG_MAGIC)
+           && (TAG_CLASS(tag) < CLASS_COUNT) ) {
+
+                old_size = class_size[TAG_CLASS(tag)];
+
+                if (size <= old_size) {
+                        return ptr;
+                }
+        } else
+#endif
+        {
+                res_header_t *hdr   = cast(res_header_t*, ptr) - 1;
+                size_t        bsize = _builtinfunc(mm_get_block_size, hdr);
+
+                if (bsize > sizeof(res_header_t)) {
+                        old_size = bsize - sizeof(res_header_t);
+                }
+        }
+
+        void *mem = malloc(size);
+        if (mem) {
+                memcpy(mem, ptr, min(old_size, size));
+                free(ptr);
+        }
+
+        return mem;
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
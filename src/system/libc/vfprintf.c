@@ -31,7 +31,6 @@
 ==============================================================================*/
 #include <config.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <stdarg.h>
 #include <lib/vsnprintf.h>
 #include <dnx/misc.h>
@@ -39,6 +38,7 @@
 /*==============================================================================
   Local macros
 ==============================================================================*/
+#define CHUNK_SIZE              64
 
 /*==============================================================================
   Local object types
@@ -47,6 +47,7 @@
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
+static int write_chunk(void *file, const char *str, size_t len);
 
 /*==============================================================================
   Local objects
@@ -80,18 +81,15 @@ int vfprintf(FILE *file, const char *format, va_list arg)
         int n = 0;
 
 #if (__OS_PRINTF_ENABLE__ > 0)
-        va_list carg;
-        va_copy(carg, arg);
-        u32_t size = vsnprintf(NULL, 0, format, carg) + 1;
-        va_end(carg);
-
-        char *str = calloc(1, size);
-        if (str) {
-                n = vsnprintf(str, size, format, arg);
-                fwrite(str, sizeof(char), n, file);
-                int err = _errno;
-                free(str);
-                _errno = err;
+        /*
+         * Text is formatted in single pass and written in chunks. Stream is
+         * locked, so output is not mixed with other writers.
+         */
+        if (_builtinfunc(vfs_flockfile, file) == ESUCC) {
+                char chunk[CHUNK_SIZE];
+                n = _builtinfunc(vsnprintf_out, chunk, sizeof(chunk),
+                                 write_chunk, file, format, arg);
+                _builtinfunc(vfs_funlockfile, file);
         }
 #else
         UNUSED_ARG3(file, format, arg);
@@ -100,6 +98,22 @@ int vfprintf(FILE *file, const char *format, va_list arg)
         return n;
 }
 
+//==============================================================================
+/**
+ * @brief Function write formatted chunk to stream
+ *
+ * @param file                stream
+ * @param str                 chunk
+ * @param len                 chunk length
+ *
+ * @return 0 on success, otherwise EOF
+ */
+//==============================================================================
+static int write_chunk(void *file, const char *str, size_t len)
+{
+        return (fwrite(str, sizeof(char), len, file) == len) ? 0 : EOF;
+}
+
 /*==============================================================================
   End of file
 ==============================================================================*/
@@ -99,6 +99,20 @@
 
 #define HEAP_ASSERT(_cond, _msg, _fail_var)        if (!(_cond)) {_fail_var = true; _assert_msg(_cond, _msg);}
 
+/*
+ * Segregated fit size classes (TLSF like). Size range [2^n, 2^(n+1)) is
+ * split to SEG_SL_COUNT second level classes. Blocks smaller than
+ * SEG_SMALL_BLOCK are mapped linearly to the first level class 0.
+ */
+#define SEG_SL_LOG2                     2
+#define SEG_SL_COUNT                    (1 << SEG_SL_LOG2)
+#define SEG_FL_SHIFT                    (SEG_SL_LOG2 + 2)
+#define SEG_SMALL_BLOCK                 (1 << SEG_FL_SHIFT)
+#define SEG_FL_MAX                      31
+#define SEG_MIN_BLOCK                   MEM_ALIGN_SIZE(sizeof(struct free_link))
+#define SEG_NIL(heap)                   ((heap)->size)
+#define IS_SEG(heap)                    ((heap)->mode == _HEAP_MODE_SEGREGATED_FIT)
+
 /*==============================================================================
   Local types, enums definitions
 ==============================================================================*/
@@ -116,6 +130,14 @@ struct mem {
 #endif
 };
 
+/**
+ * Segregated fit: free list links placed in data area of unused block.
+ */
+struct free_link {
+        size_t next;            /**< index of the next free block in class  */
+        size_t prev;            /**< index of the previous free block in class */
+};
+
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
@@ -162,6 +184,284 @@ static size_t mem_to_ptr(_heap_t *heap, volatile void *mem)
         return (size_t)((u8_t *)mem - heap->ram);
 }
 
+//==============================================================================
+/**
+ * @brief  Function return data area size of selected block.
+ *
+ * @param  heap         heap instance
+ * @param  mem          block
+ *
+ * @return Data area size.
+ */
+//==============================================================================
+static size_t block_data_size(_heap_t *heap, struct mem *mem)
+{
+        return mem->next - (mem_to_ptr(heap, mem) + SIZEOF_STRUCT_MEM);
+}
+
+//==============================================================================
+/**
+ * @brief  Function return minimal data size of block in selected heap.
+ *
+ * @param  heap         heap instance
+ *
+ * @return Minimal block data size.
+ */
+//==============================================================================
+static size_t block_min_size(_heap_t *heap)
+{
+        if (IS_SEG(heap) && (BLOCK_MIN_SIZE_ALIGNED < SEG_MIN_BLOCK)) {
+                return SEG_MIN_BLOCK;
+        } else {
+                return BLOCK_MIN_SIZE_ALIGNED;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function return index of the most significant set bit.
+ *
+ * @param  size         value (must be non-zero)
+ *
+ * @return Bit index.
+ */
+//==============================================================================
+static inline uint fls_size(size_t size)
+{
+        return (sizeof(unsigned long) * 8 - 1) - __builtin_clzl(size);
+}
+
+//==============================================================================
+/**
+ * @brief  Function return free link of unused block.
+ *
+ * @param  heap         heap instance
+ * @param  ptr          block index
+ *
+ * @return Free link.
+ */
+//==============================================================================
+static struct free_link *seg_link(_heap_t *heap, size_t ptr)
+{
+        return (struct free_link *)(void *)&heap->ram[ptr + SIZEOF_STRUCT_MEM];
+}
+
+//==============================================================================
+/**
+ * @brief  Function calculate size class that contains selected block size.
+ *
+ * @param  size         block data size
+ * @param  fl           first level index
+ * @param  sl           second level index
+ */
+//==============================================================================
+static void seg_mapping(size_t size, uint *fl, uint *sl)
+{
+        if (size < SEG_SMALL_BLOCK) {
+                *fl = 0;
+                *sl = size / (SEG_SMALL_BLOCK / SEG_SL_COUNT);
+        } else {
+                uint f = fls_size(size);
+                *sl = (size >> (f - SEG_SL_LOG2)) & (SEG_SL_COUNT - 1);
+                *fl = f - (SEG_FL_SHIFT - 1);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function insert unused block to size class list.
+ *
+ * @param  heap         heap instance
+ * @param  mem          unused block
+ */
+//==============================================================================
+static void seg_insert(_heap_t *heap, struct mem *mem)
+{
+        uint fl, sl;
+        seg_mapping(block_data_size(heap, mem), &fl, &sl);
+
+        size_t  ptr  = mem_to_ptr(heap, mem);
+        size_t *head = &heap->free_head[fl * SEG_SL_COUNT + sl];
+
+        seg_link(heap, ptr)->prev = SEG_NIL(heap);
+        seg_link(heap, ptr)->next = *head;
+
+        if (*head != SEG_NIL(heap)) {
+                seg_link(heap, *head)->prev = ptr;
+        }
+
+        *head = ptr;
+
+        heap->sl_bitmap[fl] |= (1 << sl);
+        heap->fl_bitmap     |= (1 << fl);
+}
+
+//==============================================================================
+/**
+ * @brief  Function remove unused block from size class list. Must be called
+ *         before block size is changed.
+ *
+ * @param  heap         heap instance
+ * @param  mem          unused block
+ */
+//==============================================================================
+static void seg_remove(_heap_t *heap, struct mem *mem)
+{
+        uint fl, sl;
+        seg_mapping(block_data_size(heap, mem), &fl, &sl);
+
+        size_t            ptr  = mem_to_ptr(heap, mem);
+        size_t           *head = &heap->free_head[fl * SEG_SL_COUNT + sl];
+        struct free_link *link = seg_link(heap, ptr);
+
+        if (link->prev != SEG_NIL(heap)) {
+                seg_link(heap, link->prev)->next = link->next;
+        } else {
+                *head = link->next;
+        }
+
+        if (link->next != SEG_NIL(heap)) {
+                seg_link(heap, link->next)->prev = link->prev;
+        }
+
+        if (*head == SEG_NIL(heap)) {
+                heap->sl_bitmap[fl] &= ~(1 << sl);
+
+                if (heap->sl_bitmap[fl] == 0) {
+                        heap->fl_bitmap &= ~(1 << fl);
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function find unused block that is at least size bytes long and
+ *         remove it from size class list. Request size is rounded up to the
+ *         next size class, thus each block of found class fit and search is
+ *         made by using bitmaps only. If there is no such class then the
+ *         class of request size is searched (near full heap).
+ *
+ * @param  heap         heap instance
+ * @param  size         requested data size
+ *
+ * @return Found block or NULL if not found.
+ */
+//==============================================================================
+static struct mem *seg_find(_heap_t *heap, size_t size)
+{
+        size_t ptr = SEG_NIL(heap);
+        uint   fl, sl;
+
+        size_t rsize = size;
+        if (rsize >= SEG_SMALL_BLOCK) {
+                rsize += (1 << (fls_size(rsize) - SEG_SL_LOG2)) - 1;
+        }
+
+        seg_mapping(rsize, &fl, &sl);
+
+        if (fl < heap->fl_count) {
+                u32_t sl_map = heap->sl_bitmap[fl] & (~0U << sl);
+
+                if (sl_map == 0) {
+                        u32_t fl_map = heap->fl_bitmap & (~0U << (fl + 1));
+
+                        if (fl_map) {
+                                fl     = __builtin_ctz(fl_map);
+                                sl_map = heap->sl_bitmap[fl];
+                        }
+                }
+
+                if (sl_map) {
+                        sl  = __builtin_ctz(sl_map);
+                        ptr = heap->free_head[fl * SEG_SL_COUNT + sl];
+                }
+        }
+
+        if (ptr == SEG_NIL(heap)) {
+                seg_mapping(size, &fl, &sl);
+
+                if (fl < heap->fl_count) {
+                        ptr = heap->free_head[fl * SEG_SL_COUNT + sl];
+
+                        while (  (ptr != SEG_NIL(heap))
+                              && (block_data_size(heap, ptr_to_mem(heap, ptr)) < size) ) {
+                                ptr = seg_link(heap, ptr)->next;
+                        }
+                }
+        }
+
+        if (ptr != SEG_NIL(heap)) {
+                struct mem *mem = ptr_to_mem(heap, ptr);
+                seg_remove(heap, mem);
+                return mem;
+        } else {
+                return NULL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function check size class lists of segregated fit heap.
+ *
+ * @param  heap         heap instance
+ *
+ * @return Return true if lists are correct, otherwise false.
+ */
+//==============================================================================
+static bool seg_sanity(_heap_t *heap)
+{
+        size_t free_blocks = 0;
+
+        for (struct mem *mem = (struct mem *)heap->ram;
+             mem < heap->ram_end; mem = ptr_to_mem(heap, mem->next)) {
+
+                if (mem->used == 0) {
+                        free_blocks++;
+                }
+        }
+
+        size_t listed = 0;
+
+        for (uint fl = 0; fl < heap->fl_count; fl++) {
+                for (uint sl = 0; sl < SEG_SL_COUNT; sl++) {
+
+                        size_t ptr  = heap->free_head[fl * SEG_SL_COUNT + sl];
+                        size_t prev = SEG_NIL(heap);
+
+                        bool bit = (heap->sl_bitmap[fl] & (1 << sl));
+                        if (bit != (ptr != SEG_NIL(heap))) {
+                                return false;
+                        }
+
+                        while (ptr != SEG_NIL(heap)) {
+                                if ((ptr > heap->size) || (++listed > free_blocks)) {
+                                        return false;
+                                }
+
+                                struct mem *mem = ptr_to_mem(heap, ptr);
+
+                                uint mfl, msl;
+                                seg_mapping(block_data_size(heap, mem), &mfl, &msl);
+
+                                if (  (mem->used != 0)
+                                   || (mfl != fl) || (msl != sl)
+                                   || (seg_link(heap, ptr)->prev != prev) ) {
+                                        return false;
+                                }
+
+                                prev = ptr;
+                                ptr  = seg_link(heap, ptr)->next;
+                        }
+                }
+
+                if (((heap->fl_bitmap >> fl) & 1) != (heap->sl_bitmap[fl] != 0)) {
+                        return false;
+                }
+        }
+
+        return listed == free_blocks;
+}
+
 //==============================================================================
 /**
  * @brief  "Plug holes" by combining adjacent empty struct mems.
@@ -323,6 +623,11 @@ static bool sanity(_heap_t *heap)
         HEAP_ASSERT(mem->next == heap->size, "HEAP: element next ptr invalid", fail);
         if (fail) return false;
 
+        if (IS_SEG(heap)) {
+                HEAP_ASSERT(seg_sanity(heap), "HEAP: size class list invalid", fail);
+                if (fail) return false;
+        }
+
         return true;
 }
 
@@ -417,17 +722,43 @@ static void overflow_check_element(struct mem *mem)
 * @param  heap          heap object
 * @param  start         memory start address
 * @param  size          memory size
+* @param  mode          allocator mode (_HEAP_MODE_*)
 *
 * @return One of errno value.
 */
 //==============================================================================
-int _heap_init(_heap_t *heap, void *start, size_t size)
+int _heap_init(_heap_t *heap, void *start, size_t size, u8_t mode)
 {
         int err = EINVAL;
 
         if (heap && start && size) {
                 heap->used     = 0;
                 heap->used_max = 0;
+                heap->mode     = mode;
+
+                if (IS_SEG(heap)) {
+                        /* size class table is placed at the end of the region */
+                        uint fl_count = 1;
+                        if (size >= SEG_SMALL_BLOCK) {
+                                fl_count = fls_size(size) - (SEG_FL_SHIFT - 1) + 1;
+                                fl_count = (fl_count > SEG_FL_MAX) ? SEG_FL_MAX : fl_count;
+                        }
+
+                        size_t tbl_size = (fl_count * SEG_SL_COUNT * sizeof(size_t)) + fl_count;
+                        if (size < (tbl_size + 2 * SIZEOF_STRUCT_MEM + MEM_SANITY_OVERHEAD
+                                    + SEG_MIN_BLOCK + 2 * _HEAP_ALIGN_)) {
+                                return ENOMEM;
+                        }
+
+                        uintptr_t tbl = ((uintptr_t)start + size - tbl_size) & ~(uintptr_t)(_HEAP_ALIGN_ - 1);
+
+                        heap->fl_count  = fl_count;
+                        heap->fl_bitmap = 0;
+                        heap->free_head = (size_t *)tbl;
+                        heap->sl_bitmap = (u8_t *)&heap->free_head[fl_count * SEG_SL_COUNT];
+
+                        size = tbl - (uintptr_t)start;
+                }
 
                 /* align the heap */
                 heap->ram = start;
@@ -447,6 +778,16 @@ int _heap_init(_heap_t *heap, void *start, size_t size)
                 heap->ram_end->next = heap->size;
                 heap->ram_end->prev = heap->size;
 
+                if (IS_SEG(heap)) {
+                        for (uint i = 0; i < heap->fl_count * SEG_SL_COUNT; i++) {
+                                heap->free_head[i] = SEG_NIL(heap);
+                        }
+
+                        memset(heap->sl_bitmap, 0, heap->fl_count);
+
+                        seg_insert(heap, mem);
+                }
+
                 #if __OS_HEAP_SANITY_CHECK__ == _YES_
                 sanity(heap);
                 #endif
@@ -522,7 +863,26 @@ void _heap_free(_heap_t *heap, void *rmem, size_t *freed)
         heap->used -= blksize;
         if (freed) *freed = blksize;
 
-        plug_holes(heap, mem);
+        if (IS_SEG(heap)) {
+                /* neighbours merged by plug_holes() change size class */
+                struct mem *nmem   = ptr_to_mem(heap, mem->next);
+                struct mem *pmem   = ptr_to_mem(heap, mem->prev);
+                struct mem *merged = mem;
+
+                if (mem != nmem && nmem->used == 0 && nmem != heap->ram_end) {
+                        seg_remove(heap, nmem);
+                }
+
+                if (pmem != mem && pmem->used == 0) {
+                        seg_remove(heap, pmem);
+                        merged = pmem;
+                }
+
+                plug_holes(heap, mem);
+                seg_insert(heap, merged);
+        } else {
+                plug_holes(heap, mem);
+        }
 
         #if __OS_HEAP_SANITY_CHECK__ == _YES_
         sanity(heap);
@@ -554,10 +914,11 @@ void *_heap_alloc(_heap_t *heap, size_t size_in, size_t *allocated)
         }
 
         /* Expand the size of the allocated memory region so that we can adjust for alignment. */
+        size_t block_min = block_min_size(heap);
         size = MEM_ALIGN_SIZE(size_in);
-        if (size < BLOCK_MIN_SIZE_ALIGNED) {
-                /* every data block must be at least BLOCK_MIN_SIZE_ALIGNED long */
-                size = BLOCK_MIN_SIZE_ALIGNED;
+        if (size < block_min) {
+                /* every data block must be at least block_min long */
+                size = block_min;
         }
 
         size += MEM_SANITY_REGION_BEFORE_ALIGNED + MEM_SANITY_REGION_AFTER_ALIGNED;
@@ -569,90 +930,104 @@ void *_heap_alloc(_heap_t *heap, size_t size_in, size_t *allocated)
         /* protect the heap from concurrent access */
         PROTECT();
 
-        /*
-         * Scan through the heap searching for a free block that is big enough,
-         * beginning with the lowest free block.
-         */
-        for (ptr = mem_to_ptr(heap, heap->lfree); ptr < heap->size - size; ptr = ptr_to_mem(heap, ptr)->next) {
+        mem = NULL;
+
+        if (IS_SEG(heap)) {
+                mem = seg_find(heap, size);
 
-                mem = ptr_to_mem(heap, ptr);
+        } else {
+                /*
+                 * Scan through the heap searching for a free block that is big enough,
+                 * beginning with the lowest free block.
+                 */
+                for (ptr = mem_to_ptr(heap, heap->lfree); ptr < heap->size - size; ptr = ptr_to_mem(heap, ptr)->next) {
 
-                if ((!mem->used) && (mem->next - (ptr + SIZEOF_STRUCT_MEM)) >= size) {
                         /*
                          * mem is not used and at least perfect fit is possible:
                          * mem->next - (ptr + SIZEOF_STRUCT_MEM) gives us the 'user data size' of mem
                          */
+                        if (!ptr_to_mem(heap, ptr)->used && block_data_size(heap, ptr_to_mem(heap, ptr)) >= size) {
+                                mem = ptr_to_mem(heap, ptr);
+                                break;
+                        }
+                }
+        }
 
-                        if (mem->next - (ptr + SIZEOF_STRUCT_MEM)
-                           >= (size + SIZEOF_STRUCT_MEM + BLOCK_MIN_SIZE_ALIGNED)) {
-                                /* (in addition to the above, we test if another struct mem
-                                * (SIZEOF_STRUCT_MEM) containing
-                                * at least BLOCK_MIN_SIZE_ALIGNED of data also fits in the 'user
-                                * data space' of 'mem')
-                                * -> split large block, create empty remainder,
-                                * remainder must be large enough to contain BLOCK_MIN_SIZE_ALIGNED data: if
-                                * mem->next - (ptr + (2*SIZEOF_STRUCT_MEM)) == size,
-                                * struct mem would fit in but no data between mem2 and mem2->next
-                                * @todo we could leave out BLOCK_MIN_SIZE_ALIGNED. We would create an empty
-                                *       region that couldn't hold data, but when mem->next gets freed,
-                                *       the 2 regions would be combined, resulting in more free memory
-                                */
-                                ptr2 = ptr + SIZEOF_STRUCT_MEM + size;
-
-                                /* create mem2 struct */
-                                mem2 = ptr_to_mem(heap, ptr2);
-                                mem2->used = 0;
-                                mem2->next = mem->next;
-                                mem2->prev = ptr;
-                                /* and insert it between mem and mem->next */
-                                mem->next = ptr2;
-                                mem->used = 1;
-
-                                if (mem2->next != heap->size) {
-                                        ptr_to_mem(heap, mem2->next)->prev = ptr2;
-                                }
+        if (mem) {
+                ptr = mem_to_ptr(heap, mem);
+
+                if (block_data_size(heap, mem) >= (size + SIZEOF_STRUCT_MEM + block_min)) {
+                        /* (in addition to the above, we test if another struct mem
+                        * (SIZEOF_STRUCT_MEM) containing
+                        * at least block_min of data also fits in the 'user
+                        * data space' of 'mem')
+                        * -> split large block, create empty remainder,
+                        * remainder must be large enough to contain block_min data: if
+                        * mem->next - (ptr + (2*SIZEOF_STRUCT_MEM)) == size,
+                        * struct mem would fit in but no data between mem2 and mem2->next
+                        * @todo we could leave out block_min. We would create an empty
+                        *       region that couldn't hold data, but when mem->next gets freed,
+                        *       the 2 regions would be combined, resulting in more free memory
+                        */
+                        ptr2 = ptr + SIZEOF_STRUCT_MEM + size;
+
+                        /* create mem2 struct */
+                        mem2 = ptr_to_mem(heap, ptr2);
+                        mem2->used = 0;
+                        mem2->next = mem->next;
+                        mem2->prev = ptr;
+                        /* and insert it between mem and mem->next */
+                        mem->next = ptr2;
+                        mem->used = 1;
+
+                        if (mem2->next != heap->size) {
+                                ptr_to_mem(heap, mem2->next)->prev = ptr2;
+                        }
 
-                                used = (size + SIZEOF_STRUCT_MEM);
-                        } else {
-                                /* (a mem2 struct does no fit into the user data space of
-                                 *  mem and mem->next will always
-                                 * be used at this point: if not we have 2 unused structs
-                                 * in a row, plug_holes should have
-                                 * take care of this).
-                                 * -> near fit or excact fit: do not split, no mem2 creation
-                                 * also can't move mem->next directly behind mem, since mem->next
-                                 * will always be used at this point!
-                                 */
-                                mem->used = 1;
-
-                                used = (mem->next - mem_to_ptr(heap, mem));
+                        if (IS_SEG(heap)) {
+                                seg_insert(heap, mem2);
                         }
 
-                        if (mem == heap->lfree) {
-                                volatile struct mem *cur = heap->lfree;
+                        used = (size + SIZEOF_STRUCT_MEM);
+                } else {
+                        /* (a mem2 struct does no fit into the user data space of
+                         *  mem and mem->next will always
+                         * be used at this point: if not we have 2 unused structs
+                         * in a row, plug_holes should have
+                         * take care of this).
+                         * -> near fit or excact fit: do not split, no mem2 creation
+                         * also can't move mem->next directly behind mem, since mem->next
+                         * will always be used at this point!
+                         */
+                        mem->used = 1;
 
-                                /* Find next free block after mem and update lowest free pointer */
-                                while (cur->used && cur != heap->ram_end) {
-                                        cur = ptr_to_mem(heap, cur->next);
-                                }
+                        used = (mem->next - mem_to_ptr(heap, mem));
+                }
+
+                if (!IS_SEG(heap) && (mem == heap->lfree)) {
+                        volatile struct mem *cur = heap->lfree;
 
-                                heap->lfree = cur;
+                        /* Find next free block after mem and update lowest free pointer */
+                        while (cur->used && cur != heap->ram_end) {
+                                cur = ptr_to_mem(heap, cur->next);
                         }
 
-                        heap->used    += used;
-                        heap->used_max = heap->used_max < heap->used ? heap->used : heap->used_max;
-                        if (allocated) *allocated = used;
+                        heap->lfree = cur;
+                }
+
+                heap->used    += used;
+                heap->used_max = heap->used_max < heap->used ? heap->used : heap->used_max;
+                if (allocated) *allocated = used;
 
-                        overflow_init_element(mem, size_in);
+                overflow_init_element(mem, size_in);
 
-                        #if __OS_HEAP_SANITY_CHECK__ == _YES_
-                        sanity(heap);
-                        #endif
+                #if __OS_HEAP_SANITY_CHECK__ == _YES_
+                sanity(heap);
+                #endif
 
-                        UNPROTECT();
+                UNPROTECT();
 
-                        return (u8_t *)mem + SIZEOF_STRUCT_MEM + MEM_SANITY_OFFSET;
-                }
+                return (u8_t *)mem + SIZEOF_STRUCT_MEM + MEM_SANITY_OFFSET;
         }
 
         UNPROTECT();
@@ -41,6 +41,7 @@
 #include "kernel/kwrapper.h"
 #include "kernel/sysfunc.h"
 #include "kernel/kpanic.h"
+#include "fs/bcache.h"
 
 /*==============================================================================
   Local macros
@@ -88,6 +89,9 @@ static const char  *REGISTERED_REGION_STR  = "Registered %s region @ 0x%X of siz
 static const char  *REGISTRATION_ERROR_STR = "Memory %s registration error (%d) @ 0x%X of size %d bytes";
 #endif
 static _mm_region_t *regions;
+static uintptr_t     heap_lo;           //!< lowest address of all regions
+static uintptr_t     heap_hi;           //!< highest address of all regions
+static bool          heap_gaps;         //!< more than one region registered
 static i32_t         memory_usage[_MM_COUNT - 1];
 static i32_t         module_memory_usage[_drvreg_number_of_modules];
 
@@ -143,7 +147,7 @@ int _mm_register_region(_mm_region_t *region, void *start, size_t size, u32_t fl
         if (region && start && size && name) {
                 if (regions == NULL) {
                         regions = region;
-                        err = _heap_init(&region->heap, start, size);
+                        err = _heap_init(&region->heap, start, size, __OS_HEAP_ALLOCATOR__);
                         if (!err) {
                                 region->flags = flags;
                                 region->name_ref = name;
@@ -162,7 +166,7 @@ int _mm_register_region(_mm_region_t *region, void *start, size_t size, u32_t fl
                         for (_mm_region_t *r = regions; r; r = r->next) {
                                 if (r->next == NULL) {
                                         region->next = NULL;
-                                        err = _heap_init(&region->heap, start, size);
+                                        err = _heap_init(&region->heap, start, size, __OS_HEAP_ALLOCATOR__);
                                         if (!err) {
                                                 region->flags = flags;
                                                 region->name_ref = name;
@@ -175,6 +179,18 @@ int _mm_register_region(_mm_region_t *region, void *start, size_t size, u32_t fl
 
                 finish:
                 if (!err) {
+                        uintptr_t lo = cast(uintptr_t, region->heap.ram);
+                        uintptr_t hi = cast(uintptr_t, region->heap.ram_end);
+
+                        if (region == regions) {
+                                heap_lo = lo;
+                                heap_hi = hi;
+                        } else {
+                                heap_lo   = (lo < heap_lo) ? lo : heap_lo;
+                                heap_hi   = (hi > heap_hi) ? hi : heap_hi;
+                                heap_gaps = true;
+                        }
+
                         printk(REGISTERED_REGION_STR, name, start, size);
                 } else {
                         printk(REGISTRATION_ERROR_STR, name, err, start, size);
@@ -207,7 +223,14 @@ int _kzalloc(enum _mm_mem mpur, size_t size, const char *prefreg,
         void *arg = va_arg(vaarg, void*);
         va_end(vaarg);
 
-        return kalloc(mpur, size, true, prefreg, required, required_mask, mem, arg);
+        int err = kalloc(mpur, size, true, prefreg, required, required_mask, mem, arg);
+
+        // release clean cache blocks and try again
+        if ((err == ENOMEM) && (mpur != _MM_CACHE) && _bcache_shrink(size)) {
+                err = kalloc(mpur, size, true, prefreg, required, required_mask, mem, arg);
+        }
+
+        return err;
 }
 
 //==============================================================================
@@ -233,7 +256,14 @@ int _kmalloc(enum _mm_mem mpur, size_t size, const char *prefreg,
         void *arg = va_arg(vaarg, void*);
         va_end(vaarg);
 
-        return kalloc(mpur, size, false, prefreg, required, required_mask, mem, arg);
+        int err = kalloc(mpur, size, false, prefreg, required, required_mask, mem, arg);
+
+        // release clean cache blocks and try again
+        if ((err == ENOMEM) && (mpur != _MM_CACHE) && _bcache_shrink(size)) {
+                err = kalloc(mpur, size, false, prefreg, required, required_mask, mem, arg);
+        }
+
+        return err;
 }
 
 //==============================================================================
@@ -273,8 +303,10 @@ int _kfree(enum _mm_mem mpur, void **mem, ...)
                         if ((*cast(res_header_t**, mem))->type == RES_TYPE_MEMORY) {
                                 usage = &memory_usage[mpur];
                                 err   = ESUCC;
-                                (*cast(res_header_t**, mem))->next = NULL;
-                                (*cast(res_header_t**, mem))->self = NULL;
+                                (*cast(res_header_t**, mem))->next  = NULL;
+                                (*cast(res_header_t**, mem))->prev  = NULL;
+                                (*cast(res_header_t**, mem))->owner = NULL;
+                                (*cast(res_header_t**, mem))->self  = NULL;
                                 (*cast(res_header_t**, mem))->type = RES_TYPE_UNKNOWN;
                         } else {
                                 err = EFAULT;
@@ -456,8 +488,13 @@ size_t _mm_get_mem_size(void)
 //==============================================================================
 bool _mm_is_object_in_heap(void *ptr)
 {
-        if (ptr == NULL) {
+        uintptr_t addr = cast(uintptr_t, ptr);
+
+        if ((addr < heap_lo) || (addr > heap_hi) || (ptr == NULL)) {
                 return false;
+
+        } else if (!heap_gaps) {
+                return true;
         }
 
         for (_mm_region_t *r = regions; r; r = r->next) {
@@ -714,9 +751,11 @@ static int kalloc(enum _mm_mem mpur, size_t size, bool clear, const char *prefre
                         }
 
                         if (mpur == _MM_PROG) {
-                                 cast(res_header_t*, blk)->next = NULL;
-                                 cast(res_header_t*, blk)->self = blk;
-                                 cast(res_header_t*, blk)->type = RES_TYPE_MEMORY;
+                                 cast(res_header_t*, blk)->next  = NULL;
+                                 cast(res_header_t*, blk)->prev  = NULL;
+                                 cast(res_header_t*, blk)->owner = NULL;
+                                 cast(res_header_t*, blk)->self  = blk;
+                                 cast(res_header_t*, blk)->type  = RES_TYPE_MEMORY;
                         }
 
                         *mem = blk;
@@ -36,6 +36,7 @@ Brief    Network management.
 #include "lwip/netif.h"
 #include "lwip/ip_addr.h"
 #include "lwip/tcpip.h"
+#include "lwip/tcp.h"
 #include "lwip/dhcp.h"
 #include "lwip/prot/dhcp.h"
 #include "netif/etharp.h"
@@ -62,6 +63,7 @@ static dhcp_state_enum_t DHCP_get_state(void);
 static void  restore_configuration();
 static int   DHCP_start_client();
 static err_t netif_configure(struct netif *netif);
+static void  netconn_event(struct netconn *conn, enum netconn_evt evt, u16_t len);
 static int   apply_static_IP_configuration(const ip_addr_t *ip_address, const ip_addr_t *net_mask, const ip_addr_t *gateway);
 
 /*==============================================================================
@@ -660,6 +662,22 @@ int INET_ifstatus(NET_INET_status_t *status)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function is called by lwIP core when state of connection was changed
+ *         (data received or sent, error). Connections accepted by listening
+ *         connection inherit this callback.
+ * @param  conn         connection
+ * @param  evt          event
+ * @param  len          event data length
+ */
+//==============================================================================
+static void netconn_event(struct netconn *conn, enum netconn_evt evt, u16_t len)
+{
+        UNUSED_ARG2(evt, len);
+        sys_poll_notify(conn);
+}
+
 //==============================================================================
 /**
  * @brief  Function create socket container.
@@ -676,9 +694,10 @@ int INET_socket_create(NET_protocol_t prot, INET_socket_t *inet_sock)
 
                 _errno = 0;
 
-                inet_sock->netconn = netconn_new(prot == NET_PROTOCOL__TCP
-                                                       ? NETCONN_TCP
-                                                       : NETCONN_UDP);
+                inet_sock->netconn = netconn_new_with_callback(prot == NET_PROTOCOL__TCP
+                                                               ? NETCONN_TCP
+                                                               : NETCONN_UDP,
+                                                               netconn_event);
 
                 if (inet_sock->netconn) {
                         err = ESUCC;
@@ -845,6 +864,35 @@ int INET_socket_recv(INET_socket_t *inet_sock,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return view of received data. Not supported.
+ * @param  inet_sock    socket
+ * @param  data         view of data
+ * @param  len          view length
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int INET_socket_peek(INET_socket_t *inet_sock, const void **data, size_t *len)
+{
+        UNUSED_ARG3(inet_sock, data, len);
+        return ENOTSUP;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release data returned by INET_socket_peek(). Not supported.
+ * @param  inet_sock    socket
+ * @param  len          number of bytes to release
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int INET_socket_consume(INET_socket_t *inet_sock, size_t len)
+{
+        UNUSED_ARG2(inet_sock, len);
+        return ENOTSUP;
+}
+
 //==============================================================================
 /**
  * @brief  Function receive data from selected address.
@@ -1121,6 +1169,63 @@ int INET_socket_getaddress(INET_socket_t *inet_sock, NET_INET_sockaddr_t *sockad
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function examines socket readiness. Connection object is notified
+ *         by lwIP core (see netconn_event()). Connection state is read under
+ *         TCPIP core lock, because it is modified by lwIP core.
+ * @param  inet_sock    inet socket
+ * @param  poll         readiness request
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int INET_socket_poll(INET_socket_t *inet_sock, struct vfs_poll *poll)
+{
+        struct netconn *conn = inet_sock->netconn;
+        size_t          rcv  = 0;
+        size_t          acpt = 0;
+
+        poll->object  = conn;
+        poll->revents = 0;
+
+        LOCK_TCPIP_CORE();
+
+        if (sys_mbox_valid(&conn->recvmbox)) {
+                sys_queue_get_number_of_items(conn->recvmbox, &rcv);
+        }
+
+        if (sys_mbox_valid(&conn->acceptmbox)) {
+                sys_queue_get_number_of_items(conn->acceptmbox, &acpt);
+        }
+
+        if (inet_sock->netbuf || rcv || acpt) {
+                poll->revents |= POLLIN;
+        }
+
+        if (conn->pending_err != ERR_OK) {
+                poll->revents |= POLLERR;
+        }
+
+        if (NETCONNTYPE_GROUP(conn->type) == NETCONN_TCP) {
+                struct tcp_pcb *pcb = conn->pcb.tcp;
+
+                if (pcb == NULL) {
+                        poll->revents |= POLLHUP;
+
+                } else if ((pcb->state != LISTEN) && (tcp_sndbuf(pcb) > 0)) {
+                        poll->revents |= POLLOUT;
+                }
+        } else {
+                poll->revents |= POLLOUT;
+        }
+
+        UNLOCK_TCPIP_CORE();
+
+        poll->revents &= poll->events;
+
+        return ESUCC;
+}
+
 //==============================================================================
 /**
  * @brief  Function convert value for host/network purpose.
@@ -37,6 +37,8 @@
 /*==============================================================================
   Local macros
 ==============================================================================*/
+/* maximum number of chained pbufs sent without linearization */
+#define TX_SEGMENTS             8
 
 /*==============================================================================
   Local object types
@@ -193,22 +195,51 @@ void _inetdrv_handle_input(inet_t *inet, u32_t timeout)
 //==============================================================================
 err_t _inetdrv_handle_output(struct netif *netif, struct pbuf *p)
 {
-      inet_t *inet = netif->state;
-
-      LWIP_DEBUGF(INET_DEBUG, ("_inetdrv_handle_output: packet size %d\n", p->tot_len));
-
-      ETH_packet_t pkt;
-      pkt.payload = p->payload;
-      pkt.payload_size = p->len;
-
-      if (sys_ioctl(inet->if_file, IOCTL_ETH__SEND_PACKET, &pkt) == 0) {
-              inet->tx_packets++;
-              inet->tx_bytes += pkt.payload_size;
-              return ERR_OK;
-      } else {
-              LWIP_DEBUGF(LWIP_DBG_LEVEL_SERIOUS, ("_inetdrv_handle_output: packet send error\n"));
-              return ERR_IF;
-      }
+        inet_t *inet = netif->state;
+
+        LWIP_DEBUGF(INET_DEBUG, ("_inetdrv_handle_output: packet size %d\n", p->tot_len));
+
+        ETH_packet_t    seg[TX_SEGMENTS];
+        ETH_packet_sg_t pkt = {.segment = seg, .segments = 0};
+        struct pbuf    *lin = NULL;
+        struct pbuf    *q   = p;
+
+        for (; q && (pkt.segments < TX_SEGMENTS); q = q->next) {
+                if (q->len > 0) {
+                        seg[pkt.segments].payload      = q->payload;
+                        seg[pkt.segments].payload_size = q->len;
+                        pkt.segments++;
+                }
+        }
+
+        if (q) {
+                /* chain longer than segment table, packet is linearized */
+                lin = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+                if (!lin) {
+                        LWIP_DEBUGF(INET_DEBUG, ("_inetdrv_handle_output: not enough free memory\n"));
+                        return ERR_MEM;
+                }
+
+                seg[0].payload      = lin->payload;
+                seg[0].payload_size = lin->len;
+                pkt.segments        = 1;
+        }
+
+        err_t err = ERR_OK;
+
+        if (sys_ioctl(inet->if_file, IOCTL_ETH__SEND_PACKET_SG, &pkt) == 0) {
+                inet->tx_packets++;
+                inet->tx_bytes += p->tot_len;
+        } else {
+                LWIP_DEBUGF(LWIP_DBG_LEVEL_SERIOUS, ("_inetdrv_handle_output: packet send error\n"));
+                err = ERR_IF;
+        }
+
+        if (lin) {
+                pbuf_free(lin);
+        }
+
+        return err;
 }
 
 //==============================================================================
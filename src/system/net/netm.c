@@ -59,6 +59,8 @@ Brief    Network management.
 #define PROXY_socket_accept(_family)            PROXY_FUNCTION(_family, socket_accept)
 #define PROXY_socket_recv(_family)              PROXY_FUNCTION(_family, socket_recv)
 #define PROXY_socket_recvfrom(_family)          PROXY_FUNCTION(_family, socket_recvfrom)
+#define PROXY_socket_peek(_family)              PROXY_FUNCTION(_family, socket_peek)
+#define PROXY_socket_consume(_family)           PROXY_FUNCTION(_family, socket_consume)
 #define PROXY_socket_send(_family)              PROXY_FUNCTION(_family, socket_send)
 #define PROXY_socket_sendto(_family)            PROXY_FUNCTION(_family, socket_sendto)
 #define PROXY_socket_set_recv_timeout(_family)  PROXY_FUNCTION(_family, socket_set_recv_timeout)
@@ -69,6 +71,7 @@ Brief    Network management.
 #define PROXY_socket_disconnect(_family)        PROXY_FUNCTION(_family, socket_disconnect)
 #define PROXY_socket_shutdown(_family)          PROXY_FUNCTION(_family, socket_shutdown)
 #define PROXY_socket_getaddress(_family)        PROXY_FUNCTION(_family, socket_getaddress)
+#define PROXY_socket_poll(_family)              PROXY_FUNCTION(_family, socket_poll)
 #define PROXY_hton_u16(_family)                 PROXY_FUNCTION_U16(_family, hton_u16)
 #define PROXY_hton_u32(_family)                 PROXY_FUNCTION_U32(_family, hton_u32)
 #define PROXY_hton_u64(_family)                 PROXY_FUNCTION_U64(_family, hton_u64)
@@ -437,6 +440,61 @@ int _net_socket_recv(SOCKET *socket, void *buf, size_t len, NET_flags_t flags, s
         }
 }
 
+//==============================================================================
+/**
+ * @brief Function return view of data received by selected socket without
+ *        copying. Data stays in socket buffer until it is released by
+ *        _net_socket_consume().
+ * @param socket        socket to receive
+ * @param data          view of received data
+ * @param len           view length
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int _net_socket_peek(SOCKET *socket, const void **data, size_t *len)
+{
+        PROXY_TABLE = {
+                #if __ENABLE_TCPIP_STACK__ > 0
+                PROXY_socket_peek(INET),
+                #endif
+                #if __ENABLE_SIPC_STACK__ > 0
+                PROXY_socket_peek(SIPC),
+                #endif
+        };
+
+        if (is_socket_valid(socket) && data && len) {
+                return call_proxy_function(socket->family, socket->ctx, data, len);
+        } else {
+                return EINVAL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief Function release data returned by _net_socket_peek().
+ * @param socket        socket
+ * @param len           number of bytes to release
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int _net_socket_consume(SOCKET *socket, size_t len)
+{
+        PROXY_TABLE = {
+                #if __ENABLE_TCPIP_STACK__ > 0
+                PROXY_socket_consume(INET),
+                #endif
+                #if __ENABLE_SIPC_STACK__ > 0
+                PROXY_socket_consume(SIPC),
+                #endif
+        };
+
+        if (is_socket_valid(socket)) {
+                return call_proxy_function(socket->family, socket->ctx, len);
+        } else {
+                return EINVAL;
+        }
+}
+
 //==============================================================================
 /**
  * @brief Function receive bytes from selected socket and obtain sender address.
@@ -746,6 +804,32 @@ int _net_socket_getaddress(SOCKET *socket, NET_generic_sockaddr_t *sockaddr)
         }
 }
 
+//==============================================================================
+/**
+ * @brief Function examines socket readiness.
+ * @param socket        socket
+ * @param poll          readiness request
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int _net_socket_poll(SOCKET *socket, struct vfs_poll *poll)
+{
+        PROXY_TABLE = {
+                #if __ENABLE_TCPIP_STACK__ > 0
+                PROXY_socket_poll(INET),
+                #endif
+                #if __ENABLE_SIPC_STACK__ > 0
+                PROXY_socket_poll(SIPC),
+                #endif
+        };
+
+        if (is_socket_valid(socket) && poll) {
+                return call_proxy_function(socket->family, socket->ctx, poll);
+        } else {
+                return EINVAL;
+        }
+}
+
 //==============================================================================
 /**
  * @brief Function return address of host by name.
@@ -57,6 +57,23 @@ DATA      -----------> checksum incorrect
 DATA      -----------> store data
 (ok)      <----------- ACK
 
+Windowed transfer (negotiated by HANDSHAKE payload, old peers answer without
+payload and transfer falls back to the stop-and-wait mode shown above):
+HANDSHAKE -----------> [window]
+(ok)      <----------- ACK [accepted window]
+
+DATA n    ----------->
+DATA n+1  ----------->  (lost)
+DATA n+2  ----------->  store out of order
+(ok)      <----------- ACK n+1 [bitmap: n+2]  (seq: next expected packet)
+(timeout)
+DATA n+1  ----------->  store n+1 and n+2
+(ok)      <----------- ACK n+3 [bitmap: -]
+
+Sequence numbers of DATA packets are counted per socket from 0 after the
+handshake. BUSY carries the same acknowledge as ACK and stops the transmitter
+until the next ACK or the retransmission timeout.
+
 */
 
 /*==============================================================================
@@ -65,7 +82,9 @@ DATA      -----------> store data
 #include <stdbool.h>
 #include "net/sipc/sipc.h"
 #include "sipcbuf.h"
+#include "sipcpool.h"
 #include "cpuctl.h"
+#include "lib/checksum.h"
 
 /*==============================================================================
   Local macros
@@ -79,6 +98,14 @@ DATA      -----------> store data
 #define PACKET_TYPE_BIND                6
 #define _PACKET_TYPE_COUNT              7
 
+#define WINDOW_SIZE                     __NETWORK_SIPC_WINDOW_SIZE__
+#define ANSWER_QUEUE_LEN                (WINDOW_SIZE + 1)
+#define FRAME_BUF_SIZE                  __NETWORK_SIPC_FRAME_BUF_SIZE__
+
+#if (WINDOW_SIZE < 1) || (WINDOW_SIZE > 32)
+#error "SIPC window size must be in range 1..32 (acknowledge bitmap size)"
+#endif
+
 #define zalloc(_size, _pptr) _kzalloc(_MM_NET, _size, NULL, true, _pptr)
 #define kalloc(_size, _pptr) _kmalloc(_MM_NET, _size, NULL, true, _pptr)
 #define zfree(_pptr) _kfree(_MM_NET, _pptr)
@@ -102,6 +129,40 @@ typedef struct {
         u8_t  payload[];        /*!< Payload */
 } sipc_packet_t;
 
+typedef struct {
+        u8_t  type;             /*!< Answer packet type */
+        u8_t  window;           /*!< Accepted window (HANDSHAKE answer) */
+        u16_t seq;              /*!< Answer sequence */
+        u32_t sack;             /*!< Selective acknowledge bitmap */
+} sipc_answer_t;
+
+typedef struct {
+        u16_t seq;              /*!< Reply sequence */
+        u8_t  port;             /*!< Reply port */
+        u8_t  type;             /*!< Reply packet type */
+        u8_t  plen;             /*!< Reply payload size */
+        u8_t  payload[4];       /*!< Reply payload (window size or acknowledge bitmap) */
+} sipc_reply_t;
+
+struct sipc_window {
+        u8_t  size;             /*!< Negotiated window size */
+        u16_t tx_seq;           /*!< Next DATA sequence to send */
+        u16_t rx_seq;           /*!< Next DATA sequence expected */
+        u32_t rx_map;           /*!< Received packets bitmap (bit 0: rx_seq) */
+
+        struct {
+                u8_t  *payload;
+                u16_t  plen;
+        } rx[WINDOW_SIZE];       /*!< Packets not delivered yet (0: rx_seq) */
+
+        struct {
+                const u8_t *data;
+                u64_t       tref;
+                u16_t       plen;
+                bool        acked;
+        } tx[WINDOW_SIZE];       /*!< Packets in flight (0: oldest) */
+};
+
 typedef struct {
         struct {
                 u16_t MTU;
@@ -112,9 +173,18 @@ typedef struct {
                 u64_t tx_packets;
                 u64_t rx_bytes;
                 u64_t tx_bytes;
+                u64_t tx_retries;
         } stats;
 
+        struct {
+                u8_t  *buf;     /*!< Interface receive ring */
+                size_t head;    /*!< First byte in ring */
+                size_t count;   /*!< Number of bytes in ring */
+        } rx;
+
         FILE *if_file;
+        sipcpool_t *pool;
+        sipcpool_t *desc_pool;
         tid_t if_thread;
         NET_SIPC_state_t state;
         mutex_t *packet_send_mtx;
@@ -133,6 +203,7 @@ static int  register_socket(SIPC_socket_t *socket);
 static bool is_socket_registered(SIPC_socket_t *socket);
 static int  send_packet(u16_t seq, u8_t port, u8_t type, const u8_t *payload, u16_t plen);
 static SIPC_socket_t *get_socket_by_port(u8_t port);
+static int  window_setup(SIPC_socket_t *socket, u8_t size);
 
 /*==============================================================================
   External function prototypes
@@ -174,6 +245,7 @@ static void clear_transfer_counters(void)
         sipc->stats.tx_bytes   = 0;
         sipc->stats.rx_packets = 0;
         sipc->stats.tx_packets = 0;
+        sipc->stats.tx_retries = 0;
 }
 
 //==============================================================================
@@ -204,78 +276,180 @@ static int list_cmp_functor(const void *a, const void *b)
 
 //==============================================================================
 /**
- * @brief  Function calculate fletcher 16 checksum.
+ * @brief  Function return byte from receive ring.
  *
- * @param  data         buffer
- * @param  bytes        buffer size
+ * @param  offset       offset from ring head
  *
- * @return Checksum.
+ * @return Byte value.
  */
 //==============================================================================
-static uint16_t fletcher16(uint8_t const *data, size_t bytes)
+static inline u8_t rx_byte(size_t offset)
 {
-        uint16_t sum1 = 0xff, sum2 = 0xff;
-        size_t tlen;
-
-        while (bytes) {
-                tlen = ((bytes >= 20) ? 20 : bytes);
-                bytes -= tlen;
-                do {
-                        sum2 += sum1 += *data++;
-                        tlen--;
-                } while (tlen);
-
-                sum1 = (sum1 & 0xff) + (sum1 >> 8);
-                sum2 = (sum2 & 0xff) + (sum2 >> 8);
+        return sipc->rx.buf[(sipc->rx.head + offset) % FRAME_BUF_SIZE];
+}
+
+//==============================================================================
+/**
+ * @brief  Function call selected function for each contiguous part of data
+ *         stored in receive ring.
+ *
+ * @param  offset       offset from ring head
+ * @param  len          data length
+ * @param  func         function called for each part
+ * @param  arg          function argument
+ */
+//==============================================================================
+static void rx_foreach(size_t offset, size_t len,
+                       void (*func)(void *arg, const u8_t *data, size_t len), void *arg)
+{
+        size_t pos = (sipc->rx.head + offset) % FRAME_BUF_SIZE;
+
+        while (len) {
+                size_t part = min(len, FRAME_BUF_SIZE - pos);
+                func(arg, &sipc->rx.buf[pos], part);
+                len -= part;
+                pos  = 0;
         }
+}
 
-        /* Second reduction step to reduce sums to 8 bits */
-        sum1 = (sum1 & 0xff) + (sum1 >> 8);
-        sum2 = (sum2 & 0xff) + (sum2 >> 8);
+//==============================================================================
+/**
+ * @brief  Function remove selected number of bytes from receive ring.
+ *
+ * @param  len          number of bytes
+ */
+//==============================================================================
+static inline void rx_skip(size_t len)
+{
+        sipc->rx.head   = (sipc->rx.head + len) % FRAME_BUF_SIZE;
+        sipc->rx.count -= len;
+}
+
+//==============================================================================
+/**
+ * @brief  Function read interface data to receive ring. All data available
+ *         in interface is read at once (non-blocking mode), if there is no
+ *         data then function waits for one byte.
+ */
+//==============================================================================
+static void rx_fill(void)
+{
+        size_t tail  = (sipc->rx.head + sipc->rx.count) % FRAME_BUF_SIZE;
+        size_t space = (tail >= sipc->rx.head) ? (FRAME_BUF_SIZE - tail)
+                                               : (sipc->rx.head - tail);
 
-        return (sum2 << 8) | sum1;
+        size_t rdcnt = 0;
+        sys_fread(&sipc->rx.buf[tail], space, &rdcnt, sipc->if_file);
+
+        if (rdcnt == 0) {
+                sys_ioctl(sipc->if_file, IOCTL_VFS__DEFAULT_RD_MODE);
+                sys_fread(&sipc->rx.buf[tail], 1, &rdcnt, sipc->if_file);
+                sys_ioctl(sipc->if_file, IOCTL_VFS__NON_BLOCKING_RD_MODE);
+        }
+
+        sipc->rx.count += rdcnt;
 }
 
 //==============================================================================
 /**
- * @brief  Function receive incoming packet.
+ * @brief  Function receive incoming packet. Interface data is read in chunks
+ *         to receive ring, preamble is searched and checksum is calculated
+ *         on ring data. Frames longer than ring are dropped as noise. Payload
+ *         of valid packet is copied to buffer allocated from packet pool,
+ *         after invalid frame the preamble is searched again inside the frame.
  *
- * @param  packet       packet container
+ * @param  phdr         packet header
+ * @param  payload      packet payload (NULL if packet has no payload or
+ *                      packet is not valid)
  *
- * @return On success return allocated data.
+ * @return If packet checksum is correct then true is returned, otherwise false.
  */
 //==============================================================================
-static void receive_packet(sipc_packet_t *phdr, u8_t **payload)
+static bool receive_packet(sipc_packet_t *phdr, u8_t **payload)
 {
+        void update_checksum(void *arg, const u8_t *data, size_t len)
+        {
+                _fletcher16_update(arg, data, len);
+        }
+
+        void copy_payload(void *arg, const u8_t *data, size_t len)
+        {
+                u8_t **dst = arg;
+                memcpy(*dst, data, len);
+                *dst += len;
+        }
+
+        *payload = NULL;
+
         while (true) {
-                size_t rdcnt;
+                /* search preamble in buffered data */
+                while (  (sipc->rx.count > 0)
+                      && (  (rx_byte(0) != PACKET_PREABLE[0])
+                         || ((sipc->rx.count > 1) && (rx_byte(1) != PACKET_PREABLE[1])) ) ) {
 
-                if (sys_fread(&phdr->preamble[0], 1, &rdcnt, sipc->if_file) != 0) continue;
-                if (phdr->preamble[0] != PACKET_PREABLE[0]) continue;
+                        rx_skip(1);
+                }
 
-                if (sys_fread(&phdr->preamble[1], 1, &rdcnt, sipc->if_file) != 0) continue;
-                if (phdr->preamble[1] != PACKET_PREABLE[1]) continue;
+                if (sipc->rx.count < sizeof(sipc_packet_t)) {
+                        rx_fill();
+                        continue;
+                }
 
-                // check sum + rest of header
-                if (sys_fread(&phdr->checksum, 8, &rdcnt, sipc->if_file) != 0) continue;
+                u8_t *hdr = cast(u8_t*, phdr);
+                for (size_t i = 0; i < sizeof(sipc_packet_t); i++) {
+                        hdr[i] = rx_byte(i);
+                }
 
-                if (phdr->plen > 0) {
-                        u8_t *buf = NULL;
-                        int err = zalloc(phdr->plen, (void*)&buf);
-                        if (!err) {
-                                if (  (sys_fread(buf, phdr->plen, &rdcnt, sipc->if_file) == 0)
-                                   && (rdcnt == phdr->plen)) {
+                if (phdr->plen > (FRAME_BUF_SIZE - sizeof(sipc_packet_t))) {
+                        DEBUG("frame too long: %u", phdr->plen);
+                        rx_skip(1);
+                        continue;
+                }
 
-                                        *payload = buf;
-                                        return;
-                                } else {
-                                        zfree((void*)&buf);
-                                }
+                if (sipc->rx.count < (sizeof(sipc_packet_t) + phdr->plen)) {
+                        rx_fill();
+                        continue;
+                }
+
+                _fletcher16_t chks;
+                _fletcher16_init(&chks);
+                rx_foreach(sizeof(sipc_packet_t), phdr->plen, update_checksum, &chks);
+
+                u16_t pktchks = _fletcher16(cast(u8_t*, &phdr->plen), sizeof(sipc_packet_t)
+                                            - sizeof(phdr->preamble)
+                                            - sizeof(phdr->checksum));
+
+                u16_t checksum = pktchks ^ (phdr->plen ? _fletcher16_final(&chks) : 0);
+
+                bool is_valid = checksum == cast(u16_t, (phdr->checksum[0] | (phdr->checksum[1] << 8)));
+
+                if (is_valid && phdr->plen) {
+                        if (sipcpool__alloc(sipc->pool, phdr->plen, payload) == 0) {
+                                u8_t *dst = *payload;
+                                rx_foreach(sizeof(sipc_packet_t), phdr->plen, copy_payload, &dst);
+                        } else {
+                                /* try again when memory is available */
+                                sys_sleep_ms(10);
+                                continue;
                         }
+                }
+
+                if (is_valid) {
+                        rx_skip(sizeof(sipc_packet_t) + phdr->plen);
+
                 } else {
-                        *payload = NULL;
-                        return;
+                        if (not __NETWORK_SIPC_DEBUG_ON__) {
+                                printk("SIPC: invalid checksum");
+                        }
+
+                        DEBUG("packet checksum: %04Xh:%04Xh->INVALID", checksum,
+                               cast(u16_t, (phdr->checksum[0] | (phdr->checksum[1] << 8))));
+
+                        /* frame can be a noise, search next preamble in frame */
+                        rx_skip(sizeof(phdr->preamble));
                 }
+
+                return is_valid;
         }
 }
 
@@ -317,11 +491,11 @@ static int send_packet(u16_t seq, u8_t port, u8_t type, const u8_t *payload, u16
         packet.plen        = plen;
 
 
-        u16_t pktchks = fletcher16(cast(u8_t*, &packet.plen), sizeof(sipc_packet_t)
-                                   - sizeof(packet.preamble)
-                                   - sizeof(packet.checksum));
+        u16_t pktchks = _fletcher16(cast(u8_t*, &packet.plen), sizeof(sipc_packet_t)
+                                    - sizeof(packet.preamble)
+                                    - sizeof(packet.checksum));
 
-        u16_t datachks = payload ? fletcher16(payload, plen) : 0;
+        u16_t datachks = payload ? _fletcher16(payload, plen) : 0;
 
         u16_t checksum = pktchks ^ datachks;
 
@@ -352,74 +526,231 @@ static int send_packet(u16_t seq, u8_t port, u8_t type, const u8_t *payload, u16
 
 //==============================================================================
 /**
- * @brief  Function check if packet is valid (checksum valid)
+ * @brief  Function return registered socket. If socket is found then socket
+ *         list stays locked and must be unlocked by caller when socket is not
+ *         used anymore. This way socket cannot be unregistered and its window
+ *         released while packet is handled.
  *
- * @param  packet       packet to examine (packet header)
- * @param  data         packet data
+ * @param  port         finding socket with port
  *
- * @return If packet consistency is OK then true is returned, otherwise false.
+ * @return Socket object.
  */
 //==============================================================================
-static bool is_packet_valid(sipc_packet_t *packet, u8_t *payload)
+static SIPC_socket_t *get_socket_by_port(u8_t port)
 {
-        u16_t pktchks = fletcher16(cast(u8_t*, &packet->plen), sizeof(sipc_packet_t)
-                                   - sizeof(packet->preamble)
-                                   - sizeof(packet->checksum));
+        SIPC_socket_t *socket = NULL;
 
-        u16_t datachks = payload ? fletcher16(payload, packet->plen) : 0;
+        if (sys_mutex_lock(sipc->socket_list_mtx, MAX_DELAY_MS) == 0) {
 
-        u16_t checksum = pktchks ^ datachks;
+                SIPC_socket_t find_socket;
+                find_socket.port = port;
 
-        bool is_valid = checksum == cast(u16_t, (packet->checksum[0] | (packet->checksum[1] << 8)));
+                int pos = sys_llist_find_begin(sipc->socket_list, &find_socket);
 
-        if (not is_valid) {
-                if (not __NETWORK_SIPC_DEBUG_ON__) {
-                        printk("SIPC: invalid checksum");
+                if (pos >= 0) {
+                        socket = sys_llist_at(sipc->socket_list, pos);
                 }
 
-                DEBUG("packet checksum: %04Xh:%04Xh->%s", checksum,
-                       cast(u16_t, (packet->checksum[0] | (packet->checksum[1] << 8))),
-                       is_valid ? "VALID" : "INVALID");
+                if (!socket) {
+                        sys_mutex_unlock(sipc->socket_list_mtx);
+                }
         }
 
-        return is_valid;
+        return socket;
 }
 
 //==============================================================================
 /**
- * @brief  Function return registered socket.
+ * @brief  Function check if socket transfers data in windowed mode.
  *
- * @param  port         finding socket with port
+ * @param  socket       socket
  *
- * @return Socket object.
+ * @return If windowed mode is negotiated then true is returned, otherwise false.
  */
 //==============================================================================
-static SIPC_socket_t *get_socket_by_port(u8_t port)
+static inline bool is_windowed(SIPC_socket_t *socket)
 {
-        SIPC_socket_t *socket = NULL;
+        return socket->window && (socket->window->size > 1);
+}
 
-        if (sys_mutex_lock(sipc->socket_list_mtx, MAX_DELAY_MS) == 0) {
+//==============================================================================
+/**
+ * @brief  Function drop packets held by window of selected socket.
+ *
+ * @param  win          socket window
+ */
+//==============================================================================
+static void window_drop_packets(struct sipc_window *win)
+{
+        for (size_t i = 0; i < ARRAY_SIZE(win->rx); i++) {
+                if (win->rx[i].payload) {
+                        sipcpool__free(&win->rx[i].payload);
+                }
+        }
+}
 
-                SIPC_socket_t find_socket;
-                find_socket.port = port;
+//==============================================================================
+/**
+ * @brief  Function setup windowed transfer of selected socket. Window size
+ *         lower than 2 selects stop-and-wait transfer. Sequence counters are
+ *         reset and not delivered packets are dropped. Window object is kept
+ *         until the socket is disconnected because transmitter can use it.
+ *
+ * @param  socket       socket
+ * @param  size         window size (limited to configured size)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int window_setup(SIPC_socket_t *socket, u8_t size)
+{
+        int err = ESUCC;
 
-                int pos = sys_llist_find_begin(sipc->socket_list, &find_socket);
+        size = min(size, WINDOW_SIZE);
 
-                if (pos >= 0) {
-                        socket = sys_llist_at(sipc->socket_list, pos);
+        if (!socket->window && (size > 1)) {
+                err = zalloc(sizeof(struct sipc_window), (void*)&socket->window);
+        }
+
+        if (!err && socket->window) {
+                window_drop_packets(socket->window);
+                memset(socket->window, 0, sizeof(struct sipc_window));
+                socket->window->size = size;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release window of selected socket. Socket must not be
+ *         registered, or socket list must be locked.
+ *
+ * @param  socket       socket
+ */
+//==============================================================================
+static void window_release(SIPC_socket_t *socket)
+{
+        if (socket->window) {
+                window_drop_packets(socket->window);
+                zfree((void*)&socket->window);
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function prepare answer to DATA packet of windowed socket. Answer
+ *         sequence is the next expected packet and payload contains bitmap
+ *         of packets received out of order.
+ *
+ * @param  socket       socket
+ * @param  type         answer type (ACK or BUSY)
+ * @param  reply        prepared reply
+ */
+//==============================================================================
+static void window_answer(SIPC_socket_t *socket, u8_t type, sipc_reply_t *reply)
+{
+        struct sipc_window *win = socket->window;
+
+        reply->seq        = win->rx_seq;
+        reply->port       = socket->port;
+        reply->type       = type;
+        reply->plen       = sizeof(reply->payload);
+        reply->payload[0] = (win->rx_map >>  0) & 0xFF;
+        reply->payload[1] = (win->rx_map >>  8) & 0xFF;
+        reply->payload[2] = (win->rx_map >> 16) & 0xFF;
+        reply->payload[3] = (win->rx_map >> 24) & 0xFF;
+}
+
+//==============================================================================
+/**
+ * @brief  Function send prepared reply.
+ *
+ * @param  reply        reply to send
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int send_reply(const sipc_reply_t *reply)
+{
+        return send_packet(reply->seq, reply->port, reply->type,
+                           reply->plen ? reply->payload : NULL, reply->plen);
+}
+
+//==============================================================================
+/**
+ * @brief  Function store received DATA packet of windowed socket. Packets
+ *         received in order are moved to the socket buffer, other packets
+ *         are held until the missing ones are repeated.
+ *
+ * @param  socket       socket
+ * @param  packet       packet header
+ * @param  payload      packet payload (ownership is taken)
+ * @param  reply        answer to send
+ */
+//==============================================================================
+static void window_receive(SIPC_socket_t *socket, sipc_packet_t *packet,
+                           u8_t *payload, sipc_reply_t *reply)
+{
+        struct sipc_window *win = socket->window;
+
+        u16_t offset = packet->seq - win->rx_seq;
+
+        if ((offset < win->size) && !(win->rx_map & (1UL << offset))) {
+                win->rx[offset].payload = payload;
+                win->rx[offset].plen    = packet->plen;
+                win->rx_map |= (1UL << offset);
+
+        } else {
+                DEBUG("duplicated or out of window packet: %u", packet->seq);
+
+                if (payload) {
+                        sipcpool__free(&payload);
+                }
+        }
+
+        bool delivered = false;
+
+        while (win->rx_map & 1) {
+                if (win->rx[0].payload) {
+                        int err = sipcbuf__write(socket->rxbuf, win->rx[0].payload,
+                                                 win->rx[0].plen, false);
+                        if (err) {
+                                DEBUG("buffer error: %d", err);
+                                break;
+                        }
+
+                        delivered = true;
                 }
 
-                sys_mutex_unlock(sipc->socket_list_mtx);
+                memmove(&win->rx[0], &win->rx[1], (win->size - 1) * sizeof(win->rx[0]));
+                win->rx[win->size - 1].payload = NULL;
+                win->rx[win->size - 1].plen    = 0;
+                win->rx_map >>= 1;
+                win->rx_seq++;
         }
 
-        return socket;
+        u8_t ptype = PACKET_TYPE_ACK;
+
+        if (sipcbuf__is_full(socket->rxbuf)) {
+                socket->busy = true;
+                ptype = PACKET_TYPE_BUSY;
+        }
+
+        window_answer(socket, ptype, reply);
+
+        if (delivered) {
+                sys_poll_notify(socket);
+        }
 }
 
 //==============================================================================
 /**
  * @brief Network interface thread
  *
- * Thread handle receiving of incoming packets.
+ * Thread handle receiving of incoming packets. Packet is handled while socket
+ * list is locked, so socket cannot be unregistered meanwhile. Answer packet
+ * is prepared and sent after socket list is unlocked, because send can block.
  *
  * @param arg   thread argument
  */
@@ -442,20 +773,24 @@ static void input_thread(void *arg)
                 sys_sleep_ms(1000);
         }
 
+        sys_ioctl(sipc->if_file, IOCTL_VFS__NON_BLOCKING_RD_MODE);
+
         while (true) {
                 sipc_packet_t packet;
                 u8_t *payload;
-                receive_packet(&packet, &payload);
+                bool is_valid = receive_packet(&packet, &payload);
 
                 if (sipc->state == NET_SIPC_STATE__DOWN) {
 
+                        sipcpool__free(&payload);
+
                         clear_transfer_counters();
 
                         if (sys_mutex_lock(sipc->socket_list_mtx, MAX_DELAY_MS) == 0) {
 
                                 sys_llist_foreach(SIPC_socket_t*, socket, sipc->socket_list) {
-                                        u8_t type = PACKET_TYPE_NACK;
-                                        sys_queue_send(socket->ansq, &type, 0);
+                                        sipc_answer_t answer = {.type = PACKET_TYPE_NACK};
+                                        sys_queue_send(socket->ansq, &answer, 0);
                                 }
 
                                 sys_mutex_unlock(sipc->socket_list_mtx);
@@ -469,7 +804,7 @@ static void input_thread(void *arg)
                                                            ? TYPE_STR[packet.type]
                                                            : "UNKNOWN", packet.plen);
 
-                if (is_packet_valid(&packet, payload)) {
+                if (is_valid) {
 
                         sipc->stats.rx_packets++;
                         sipc->stats.rx_bytes += sizeof(sipc_packet_t) + packet.plen;
@@ -477,31 +812,54 @@ static void input_thread(void *arg)
                         SIPC_socket_t *socket = get_socket_by_port(packet.port);
 
                         if (socket) {
-                                socket->seq = packet.seq;
+                                sipc_answer_t answer      = {.type = packet.type, .seq = packet.seq};
+                                sipc_reply_t  reply       = {.seq = packet.seq, .port = packet.port};
+                                bool          reply_ready = false;
+
+                                if (payload && (packet.plen == 1)) {
+                                        answer.window = payload[0];
+
+                                } else if (payload && (packet.plen == sizeof(answer.sack))) {
+                                        answer.sack = (cast(u32_t, payload[0]) <<  0)
+                                                    | (cast(u32_t, payload[1]) <<  8)
+                                                    | (cast(u32_t, payload[2]) << 16)
+                                                    | (cast(u32_t, payload[3]) << 24);
+                                }
+
+                                if (packet.type != PACKET_TYPE_DATA || !is_windowed(socket)) {
+                                        socket->seq = packet.seq;
+                                }
 
                                 if (  (packet.type == PACKET_TYPE_ACK )
                                    || (packet.type == PACKET_TYPE_NACK) ) {
 
                                         if (payload) {
-                                                DEBUG("ACK/NACK with data - freeing");
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
                                         }
 
-                                        sys_queue_send(socket->ansq, &packet.type, 0);
+                                        sys_queue_send(socket->ansq, &answer, 0);
 
                                 } else if ((packet.type == PACKET_TYPE_BUSY)) {
                                         if (payload) {
-                                                DEBUG("BUSY with data - freeing");
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
+                                        }
+
+                                        if (is_windowed(socket)) {
+                                                sys_queue_send(socket->ansq, &answer, 0);
                                         }
 
                                 } else if ((packet.type) == PACKET_TYPE_REPEAT) {
                                         if (payload) {
                                                 DEBUG("REPEAT with data - freeing");
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
                                         }
 
-                                        sys_queue_send(socket->ansq, &packet.type, 0);
+                                        sys_queue_send(socket->ansq, &answer, 0);
+
+                                } else if (packet.type == PACKET_TYPE_DATA && is_windowed(socket)) {
+
+                                        window_receive(socket, &packet, payload, &reply);
+                                        reply_ready = true;
 
                                 } else if (packet.type == PACKET_TYPE_DATA) {
 
@@ -512,7 +870,7 @@ static void input_thread(void *arg)
 
                                         if (err && payload) {
                                                 DEBUG("buffer error: %d", err);
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
                                                 ptype = PACKET_TYPE_NACK;
 
                                         } else if (sipcbuf__is_full(socket->rxbuf)) {
@@ -520,44 +878,61 @@ static void input_thread(void *arg)
                                                 ptype = PACKET_TYPE_BUSY;
                                         }
 
-                                        send_packet(packet.seq, packet.port, ptype, NULL, 0);
+                                        reply.type  = ptype;
+                                        reply_ready = true;
+
+                                        if (!err) {
+                                                sys_poll_notify(socket);
+                                        }
 
                                 } else if (packet.type == PACKET_TYPE_BIND) {
 
                                         if (payload) {
                                                 DEBUG("BIND with data - freeing");
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
                                         }
 
                                         if (socket->waiting_for_data_ack) {
-                                                sys_queue_send(socket->ansq, &packet.type, 0);
+                                                sys_queue_send(socket->ansq, &answer, 0);
                                         }
 
                                 } else if (packet.type == PACKET_TYPE_HANDSHAKE) {
 
                                         if (payload) {
-                                                DEBUG("HANDSHAKE with data - freeing");
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
                                         }
 
-                                        send_packet(packet.seq, packet.port, PACKET_TYPE_ACK, NULL, 0);
+                                        reply.type  = PACKET_TYPE_ACK;
+                                        reply_ready = true;
+
+                                        if ((window_setup(socket, answer.window) == 0) && is_windowed(socket)) {
+                                                reply.payload[0] = socket->window->size;
+                                                reply.plen       = 1;
+                                        }
 
                                         if (socket->waiting_for_data_ack) {
-                                                sys_queue_send(socket->ansq, &packet.type, 0);
+                                                sys_queue_send(socket->ansq, &answer, 0);
                                         }
 
                                 } else {
                                         if (payload) {
-                                                zfree((void*)&payload);
+                                                sipcpool__free(&payload);
                                         }
 
                                         DEBUG("ignoring answer for unknown packet");
                                 }
+
+                                sys_mutex_unlock(sipc->socket_list_mtx);
+
+                                if (reply_ready) {
+                                        send_reply(&reply);
+                                }
+
                         } else {
                                 DEBUG("socket for incoming port not registered");
 
                                 if (payload) {
-                                        zfree((void*)&payload);
+                                        sipcpool__free(&payload);
                                 }
 
                                 send_packet(packet.seq, packet.port, PACKET_TYPE_NACK, NULL, 0);
@@ -566,11 +941,283 @@ static void input_thread(void *arg)
                 } else {
                         DEBUG("received inconsistent packet");
 
-                        if (payload) {
-                                zfree((void*)&payload);
+                        send_packet(packet.seq, packet.port, PACKET_TYPE_REPEAT, NULL, 0);
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function retransmit selected packet of transmit window.
+ *
+ * @param  socket       socket
+ * @param  base         sequence of the oldest packet in window
+ * @param  slot         packet slot in window
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int window_retransmit(SIPC_socket_t *socket, u16_t base, u8_t slot)
+{
+        struct sipc_window *win = socket->window;
+
+        DEBUG("retransmit: %u", cast(u16_t, base + slot));
+
+        sipc->stats.tx_retries++;
+        win->tx[slot].tref = sys_time_get_reference();
+
+        return send_packet(base + slot, socket->port, PACKET_TYPE_DATA,
+                           win->tx[slot].data, win->tx[slot].plen);
+}
+
+//==============================================================================
+/**
+ * @brief  Function send data in windowed mode. Up to window size packets are
+ *         sent without waiting for acknowledge. Packets not acknowledged in
+ *         retransmission timeout are sent again. BUSY answer stops
+ *         transmission of new packets until ACK is received or retransmission
+ *         timeout expires. Function returns error if no progress is made in
+ *         socket send timeout.
+ *
+ * @param  socket       socket
+ * @param  buf          data to send
+ * @param  len          data length
+ * @param  sent         number of acknowledged bytes
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int window_send(SIPC_socket_t *socket, const u8_t *buf, size_t len, size_t *sent)
+{
+        if (len == 0) {
+                return EINVAL;
+        }
+
+        struct sipc_window *win = socket->window;
+
+        int    err      = ESUCC;
+        u16_t  base     = win->tx_seq;
+        u8_t   inflight = 0;
+        size_t offset   = 0;
+        bool   stalled  = false;
+        u64_t  tstall   = 0;
+        u64_t  tref     = sys_time_get_reference();
+
+        while (*sent < len) {
+
+                /* fill window */
+                while (!stalled && (inflight < win->size) && (offset < len)) {
+                        win->tx[inflight].data  = &buf[offset];
+                        win->tx[inflight].plen  = min(len - offset, sipc->conf.MTU);
+                        win->tx[inflight].acked = false;
+                        win->tx[inflight].tref  = sys_time_get_reference();
+
+                        err = send_packet(base + inflight, socket->port, PACKET_TYPE_DATA,
+                                          win->tx[inflight].data, win->tx[inflight].plen);
+                        if (err) {
+                                goto finish;
                         }
 
-                        send_packet(packet.seq, packet.port, PACKET_TYPE_REPEAT, NULL, 0);
+                        offset += win->tx[inflight].plen;
+                        inflight++;
+                }
+
+                /* wait for answer up to the nearest retransmission */
+                u32_t timeout = __NETWORK_SIPC_RETRANSMIT_TIMEOUT__;
+
+                for (u8_t i = 0; i < inflight; i++) {
+                        if (!win->tx[i].acked) {
+                                u64_t elapsed = sys_time_get_reference() - win->tx[i].tref;
+                                u32_t left    = 1;
+
+                                if (elapsed < __NETWORK_SIPC_RETRANSMIT_TIMEOUT__) {
+                                        left = __NETWORK_SIPC_RETRANSMIT_TIMEOUT__ - elapsed;
+                                }
+
+                                timeout = min(timeout, left);
+                        }
+                }
+
+                sipc_answer_t answer;
+                if (sys_queue_receive(socket->ansq, &answer, timeout) == 0) {
+
+                        switch (answer.type) {
+                        case PACKET_TYPE_ACK:
+                        case PACKET_TYPE_BUSY: {
+                                u16_t acked = answer.seq - base;
+
+                                if (acked > inflight) {
+                                        DEBUG("answer out of window: %u", answer.seq);
+                                        break;
+                                }
+
+                                for (u8_t i = 0; i < acked; i++) {
+                                        *sent += win->tx[i].plen;
+                                }
+
+                                if (acked) {
+                                        memmove(&win->tx[0], &win->tx[acked],
+                                                (inflight - acked) * sizeof(win->tx[0]));
+                                        base     += acked;
+                                        inflight -= acked;
+                                        tref      = sys_time_get_reference();
+                                }
+
+                                for (u8_t i = 1; i < inflight; i++) {
+                                        if (answer.sack & (1UL << i)) {
+                                                win->tx[i].acked = true;
+                                        }
+                                }
+
+                                stalled = (answer.type == PACKET_TYPE_BUSY);
+                                tstall  = sys_time_get_reference();
+                                break;
+                        }
+
+                        case PACKET_TYPE_REPEAT:
+                                for (u8_t i = 0; i < inflight; i++) {
+                                        if (!win->tx[i].acked) {
+                                                err = window_retransmit(socket, base, i);
+                                                break;
+                                        }
+                                }
+                                break;
+
+                        case PACKET_TYPE_NACK:
+                                err = ECONNREFUSED;
+                                goto finish;
+
+                        case PACKET_TYPE_BIND:
+                        case PACKET_TYPE_HANDSHAKE:
+                                err = ECONNRESET;
+                                goto finish;
+
+                        default:
+                                err = EFAULT;
+                                goto finish;
+                        }
+                }
+
+                /* retransmit expired packets */
+                for (u8_t i = 0; !err && (i < inflight); i++) {
+                        if (  !win->tx[i].acked
+                           && sys_time_is_expired(win->tx[i].tref, __NETWORK_SIPC_RETRANSMIT_TIMEOUT__)) {
+
+                                err = window_retransmit(socket, base, i);
+                        }
+                }
+
+                /* persist: probe receiver if ACK after BUSY was lost */
+                if (stalled && sys_time_is_expired(tstall, __NETWORK_SIPC_RETRANSMIT_TIMEOUT__)) {
+                        stalled = false;
+                }
+
+                if (err) {
+                        goto finish;
+                }
+
+                if (sys_time_is_expired(tref, socket->send_timeout)) {
+                        err = ETIME;
+                        goto finish;
+                }
+        }
+
+        /*
+         * Not acknowledged packets are sent again with the same sequence in
+         * the next transfer, so receiver window stays in sync. Window is
+         * reset by handshake when connection is reset.
+         */
+        finish:
+        if (err != ECONNRESET) {
+                win->tx_seq = base;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function send data in stop-and-wait mode. Each packet is sent
+ *         when previous one is acknowledged.
+ *
+ * @param  socket       socket
+ * @param  buf          data to send
+ * @param  len          data length
+ * @param  sent         number of acknowledged bytes
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+static int stop_and_wait_send(SIPC_socket_t *socket, const u8_t *buf, size_t len, size_t *sent)
+{
+        int err = EINVAL;
+
+        while (len) {
+
+                u16_t plen = min(len, sipc->conf.MTU);
+                socket->seq = sipc->seq_ctr;
+
+                err = send_packet(socket->seq, socket->port, PACKET_TYPE_DATA, buf, plen);
+                if (!err) {
+                        sipc_answer_t answer;
+                        err = sys_queue_receive(socket->ansq, &answer, socket->send_timeout);
+                        if (!err) {
+                                switch (answer.type) {
+                                case PACKET_TYPE_ACK:
+                                        buf   += plen;
+                                        *sent += plen;
+                                        len   -= plen;
+                                        break;
+
+                                case PACKET_TYPE_NACK:
+                                        err = ECONNREFUSED;
+                                        len = 0;
+                                        break;
+
+                                case PACKET_TYPE_REPEAT:
+                                        break;
+
+                                case PACKET_TYPE_BIND:
+                                case PACKET_TYPE_HANDSHAKE:
+                                        err = ECONNRESET;
+                                        len = 0;
+                                        break;
+
+                                default:
+                                        err = EFAULT;
+                                        len = 0;
+                                        break;
+                                }
+                        } else {
+                                break;
+                        }
+                } else {
+                        break;
+                }
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function inform transmitter that socket buffer has free space after
+ *         BUSY answer.
+ *
+ * @param  socket       socket
+ */
+//==============================================================================
+static void release_busy(SIPC_socket_t *socket)
+{
+        if (socket->busy && !sipcbuf__is_full(socket->rxbuf)) {
+                socket->busy = false;
+
+                if (is_windowed(socket)) {
+                        sipc_reply_t reply;
+                        window_answer(socket, PACKET_TYPE_ACK, &reply);
+                        send_reply(&reply);
+                } else {
+                        send_packet(socket->seq, socket->port, PACKET_TYPE_ACK, NULL, 0);
                 }
         }
 }
@@ -673,8 +1320,9 @@ static int stack_init(void)
                 int merr  = sys_mutex_create(MUTEX_TYPE_NORMAL, &sipc->socket_list_mtx);
                 int serr  = sys_mutex_create(MUTEX_TYPE_NORMAL, &sipc->packet_send_mtx);
                 int lerr  = _llist_create_krn(_MM_NET, list_cmp_functor, NULL, &sipc->socket_list);
+                int rerr  = kalloc(FRAME_BUF_SIZE, (void*)&sipc->rx.buf);
 
-                if (tierr || merr || lerr || serr) {
+                if (tierr || merr || lerr || serr || rerr) {
                         if (!tierr) {
                                 sys_thread_destroy(sipc->if_thread);
                         }
@@ -691,6 +1339,10 @@ static int stack_init(void)
                                 sys_llist_destroy(sipc->socket_list);
                         }
 
+                        if (!rerr) {
+                                zfree((void*)&sipc->rx.buf);
+                        }
+
                         zfree((void*)&sipc);
 
                         printk("SIPC: stack initialization error");
@@ -698,6 +1350,12 @@ static int stack_init(void)
                         err = ENOMEM;
                 } else {
                         printk("SIPC: thread ID: %u", sipc->if_thread);
+
+                        if (sipcpool__create(&sipc->desc_pool,
+                                             2 * __NETWORK_SIPC_PACKET_POOL_SIZE__,
+                                             sipcbuf__descriptor_size()) != 0) {
+                                DEBUG("descriptor pool not created");
+                        }
                 }
         }
 
@@ -717,7 +1375,16 @@ int SIPC_ifup(const NET_SIPC_config_t *cfg)
         if (!err) {
                 if (cfg) {
                         sipc->conf.MTU = max(64, cfg->MTU);
+                        sipc->conf.MTU = min(sipc->conf.MTU, FRAME_BUF_SIZE - sizeof(sipc_packet_t));
                         sipc->state = NET_SIPC_STATE__UP;
+
+                        if (!sipc->pool && (__NETWORK_SIPC_PACKET_POOL_SIZE__ > 0)) {
+                                if (sipcpool__create(&sipc->pool,
+                                                     __NETWORK_SIPC_PACKET_POOL_SIZE__,
+                                                     sipc->conf.MTU) != 0) {
+                                        DEBUG("packet pool not created");
+                                }
+                        }
                 } else {
                         sipc->conf.MTU = 64;
                         sipc->state = NET_SIPC_STATE__DOWN;
@@ -764,6 +1431,16 @@ int SIPC_ifstatus(NET_SIPC_status_t *status)
                 status->rx_bytes   = sipc->stats.rx_bytes;
                 status->tx_packets = sipc->stats.tx_packets;
                 status->tx_bytes   = sipc->stats.tx_bytes;
+                status->tx_retries = sipc->stats.tx_retries;
+
+                sipcpool_stats_t stats;
+                sipcpool__get_stats(sipc->pool, &stats);
+                status->packet_pool_allocs = stats.pool_allocs;
+                status->packet_heap_allocs = stats.heap_allocs;
+
+                sipcpool__get_stats(sipc->desc_pool, &stats);
+                status->desc_pool_allocs = stats.pool_allocs;
+                status->desc_heap_allocs = stats.heap_allocs;
                 status->state      = sipc->state;
 
                 return ESUCC;
@@ -789,13 +1466,15 @@ int SIPC_socket_create(NET_protocol_t prot, SIPC_socket_t *socket)
                 socket->port         = 0;
                 socket->recv_timeout = MAX_DELAY_MS;
                 socket->send_timeout = MAX_DELAY_MS;
+                socket->window       = NULL;
 
-                err = sipcbuf__create((void*)&socket->rxbuf, __NETWORK_SIPC_RECV_BUF_SIZE__);
+                err = sipcbuf__create((void*)&socket->rxbuf, __NETWORK_SIPC_RECV_BUF_SIZE__,
+                                      sipc ? sipc->desc_pool : NULL);
                 if (err) {
                         goto finish;
                 }
 
-                err = sys_queue_create(1, sizeof(((sipc_packet_t*)NULL)->type), &socket->ansq);
+                err = sys_queue_create(ANSWER_QUEUE_LEN, sizeof(sipc_answer_t), &socket->ansq);
                 if (err) {
                         goto finish;
                 }
@@ -831,6 +1510,7 @@ int SIPC_socket_destroy(SIPC_socket_t *socket)
         socket->send_timeout = 0;
 
         sipcbuf__destroy(socket->rxbuf);
+        window_release(socket);
 
         return sys_queue_destroy(socket->ansq);
 }
@@ -851,8 +1531,17 @@ int SIPC_socket_connect(SIPC_socket_t *socket, const NET_SIPC_sockaddr_t *addr)
 
         socket->port = addr->port;
 
-        int err = register_socket(socket);
+        /*
+         * window is created before socket is visible for input thread,
+         * size is reduced to accepted one when handshake is answered
+         */
+        int err = window_setup(socket, WINDOW_SIZE);
+        if (!err) {
+                err = register_socket(socket);
+        }
+
         if (err) {
+                window_release(socket);
                 socket->port = 0;
                 return err;
         }
@@ -861,13 +1550,22 @@ int SIPC_socket_connect(SIPC_socket_t *socket, const NET_SIPC_sockaddr_t *addr)
 
         socket->seq = sipc->seq_ctr;
 
-        err = send_packet(socket->seq, socket->port, PACKET_TYPE_HANDSHAKE, NULL, 0);
+        u8_t window = WINDOW_SIZE;
+
+        err = send_packet(socket->seq, socket->port, PACKET_TYPE_HANDSHAKE,
+                          (window > 1) ? &window : NULL, (window > 1) ? 1 : 0);
         if (!err) {
-                u8_t type;
-                err = sys_queue_receive(socket->ansq, &type, CONNECTION_TIMEOUT);
+                sipc_answer_t answer;
+                err = sys_queue_receive(socket->ansq, &answer, CONNECTION_TIMEOUT);
                 if (!err) {
-                        switch (type) {
+                        switch (answer.type) {
                         case PACKET_TYPE_ACK:
+                                DEBUG("accepted window: %u", answer.window);
+                                err = sys_mutex_lock(sipc->socket_list_mtx, MAX_DELAY_MS);
+                                if (!err) {
+                                        err = window_setup(socket, answer.window);
+                                        sys_mutex_unlock(sipc->socket_list_mtx);
+                                }
                                 break;
 
                         case PACKET_TYPE_NACK:
@@ -885,6 +1583,7 @@ int SIPC_socket_connect(SIPC_socket_t *socket, const NET_SIPC_sockaddr_t *addr)
 
         if (err) {
                 unregister_socket(socket);
+                window_release(socket);
                 socket->port = 0;
         }
 
@@ -903,6 +1602,7 @@ int SIPC_socket_disconnect(SIPC_socket_t *socket)
         unregister_socket(socket);
         sipcbuf__clear(socket->rxbuf);
         sys_queue_reset(socket->ansq);
+        window_release(socket);
         socket->port = 0;
 
         return ESUCC;
@@ -1014,10 +1714,7 @@ int SIPC_socket_recv(SIPC_socket_t *socket,
                                 sys_sleep_ms(5);
                                 continue;
                         } else {
-                                if (socket->busy && !sipcbuf__is_full(socket->rxbuf)) {
-                                        socket->busy = false;
-                                        send_packet(socket->seq, socket->port, PACKET_TYPE_ACK, NULL, 0);
-                                }
+                                release_busy(socket);
                         }
                 }
 
@@ -1031,6 +1728,62 @@ int SIPC_socket_recv(SIPC_socket_t *socket,
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return view of received data without copying. View is
+ *         valid until data is released by SIPC_socket_consume(), only one
+ *         reader of socket can use it. View contains data of single packet,
+ *         function waits for data up to receive timeout.
+ * @param  socket       socket
+ * @param  data         pointer to data view
+ * @param  len          view size
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int SIPC_socket_peek(SIPC_socket_t *socket, const void **data, size_t *len)
+{
+        if (!is_socket_registered(socket)) {
+                return ECONNREFUSED;
+        }
+
+        int   err  = ETIME;
+        u64_t tref = sys_time_get_reference();
+
+        *len = 0;
+
+        while (!sys_time_is_expired(tref, socket->recv_timeout)) {
+
+                err = sipcbuf__peek(socket->rxbuf, (const u8_t**)data, len);
+                if (!err && (*len == 0)) {
+                        err = ETIME;
+                        sys_sleep_ms(5);
+                        continue;
+                }
+
+                break;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release data returned by SIPC_socket_peek().
+ * @param  socket       socket
+ * @param  len          number of bytes to release
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int SIPC_socket_consume(SIPC_socket_t *socket, size_t len)
+{
+        int err = sipcbuf__consume(socket->rxbuf, len);
+        if (!err) {
+                release_busy(socket);
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function receive data from selected address.
@@ -1095,49 +1848,12 @@ int SIPC_socket_send(SIPC_socket_t *socket,
 
         sys_queue_reset(socket->ansq);
 
-        while (len) {
-
-                u16_t plen = min(len, sipc->conf.MTU);
-                socket->seq = sipc->seq_ctr;
-                socket->waiting_for_data_ack = true;
-
-                err = send_packet(socket->seq, socket->port, PACKET_TYPE_DATA, buf, plen);
-                if (!err) {
-                        u8_t type;
-                        err = sys_queue_receive(socket->ansq, &type, socket->send_timeout);
-                        if (!err) {
-                                switch (type) {
-                                case PACKET_TYPE_ACK:
-                                        buf   += plen;
-                                        *sent += plen;
-                                        len   -= plen;
-                                        break;
-
-                                case PACKET_TYPE_NACK:
-                                        err = ECONNREFUSED;
-                                        len = 0;
-                                        break;
-
-                                case PACKET_TYPE_REPEAT:
-                                        break;
-
-                                case PACKET_TYPE_BIND:
-                                case PACKET_TYPE_HANDSHAKE:
-                                        err = ECONNRESET;
-                                        len = 0;
-                                        break;
+        socket->waiting_for_data_ack = true;
 
-                                default:
-                                        err = EFAULT;
-                                        len = 0;
-                                        break;
-                                }
-                        } else {
-                                break;
-                        }
-                } else {
-                        break;
-                }
+        if (is_windowed(socket)) {
+                err = window_send(socket, buf, len, sent);
+        } else {
+                err = stop_and_wait_send(socket, buf, len, sent);
         }
 
         socket->waiting_for_data_ack = false;
@@ -1257,6 +1973,24 @@ int SIPC_socket_getaddress(SIPC_socket_t *socket, NET_SIPC_sockaddr_t *sockaddr)
         return sockaddr->port = socket->port;
 }
 
+//==============================================================================
+/**
+ * @brief  Function examines socket readiness. Socket object is notified when
+ *         data is received. Data is always sent to the interface at once.
+ * @param  socket       socket
+ * @param  poll         readiness request
+ * @return One of @ref errno value.
+ */
+//==============================================================================
+int SIPC_socket_poll(SIPC_socket_t *socket, struct vfs_poll *poll)
+{
+        poll->object  = socket;
+        poll->revents = (sipcbuf__is_empty(socket->rxbuf) ? 0 : POLLIN) | POLLOUT;
+        poll->revents &= poll->events;
+
+        return ESUCC;
+}
+
 //==============================================================================
 /**
  * @brief  Function convert value for host/network purpose.
@@ -50,6 +50,7 @@ typedef struct data_chain {
 
 struct sipcbuf {
         mutex_t      *access;
+        sipcpool_t   *desc_pool;
         data_chain_t *begin;
         data_chain_t *end;
         size_t        total_size;
@@ -60,6 +61,7 @@ struct sipcbuf {
 /*==============================================================================
   Local function prototypes
 ==============================================================================*/
+static void consume(sipcbuf_t *sipcbuf, size_t size);
 
 /*==============================================================================
   Local objects
@@ -83,11 +85,12 @@ struct sipcbuf {
  *
  * @param  sipcbuf      pointer to destination pointer
  * @param  max_capacity maximum buffer capacity (can exceeds up to MTU)
+ * @param  desc_pool    pool of packet descriptors (can be NULL)
  *
  * @return One of errno value.
  */
 //==============================================================================
-int sipcbuf__create(sipcbuf_t **sipcbuf, size_t max_capacity)
+int sipcbuf__create(sipcbuf_t **sipcbuf, size_t max_capacity, sipcpool_t *desc_pool)
 {
         sipcbuf_t *this = NULL;
 
@@ -98,6 +101,7 @@ int sipcbuf__create(sipcbuf_t **sipcbuf, size_t max_capacity)
 
                 if (!err) {
                         this->soft_max_capacity = max(256, max_capacity);
+                        this->desc_pool = desc_pool;
                         *sipcbuf = this;
                 } else {
                         _kfree(_MM_NET, (void*)&this);
@@ -107,6 +111,18 @@ int sipcbuf__create(sipcbuf_t **sipcbuf, size_t max_capacity)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function return size of packet descriptor (for descriptor pool).
+ *
+ * @return Descriptor size.
+ */
+//==============================================================================
+size_t sipcbuf__descriptor_size(void)
+{
+        return sizeof(data_chain_t);
+}
+
 //==============================================================================
 /**
  * @brief  Destroy selected buffer.
@@ -137,7 +153,8 @@ void sipcbuf__destroy(sipcbuf_t *sipcbuf)
  * @param  sipcbuf      buffer instance
  * @param  data         data source pointer
  * @param  size         data size
- * @param  reference    buffer is reference (no copy)
+ * @param  reference    buffer is reference (not released), otherwise buffer
+ *                      allocated by sipcpool__alloc() is taken
  *
  * @return One of errno value.
  */
@@ -151,9 +168,11 @@ int sipcbuf__write(sipcbuf_t *sipcbuf, const u8_t *data, size_t size, bool refer
                 if (!err) {
                         data_chain_t *chain = NULL;
 
-                        err = _kzalloc(_MM_NET, sizeof(data_chain_t), NULL, false, (void*)&chain);
+                        err = sipcpool__alloc(sipcbuf->desc_pool, sizeof(data_chain_t),
+                                              (void*)&chain);
 
                         if (!err) {
+                                chain->next = NULL;
                                 chain->len = size;
                                 chain->reference = reference;
                                 chain->buf = data;
@@ -197,10 +216,9 @@ int sipcbuf__read(sipcbuf_t *sipcbuf, u8_t *data, size_t size, size_t *rdctr)
                 if (!err) {
 
                         *rdctr = 0;
-                        data_chain_t *chain = sipcbuf->begin;
 
-                        while (chain && size > 0) {
-                                data_chain_t *next = chain->next;
+                        while (sipcbuf->begin && size > 0) {
+                                data_chain_t *chain = sipcbuf->begin;
 
                                 size_t tocpy = chain->len - sipcbuf->seek;
                                        tocpy = min(tocpy, size);
@@ -210,27 +228,82 @@ int sipcbuf__read(sipcbuf_t *sipcbuf, u8_t *data, size_t size, size_t *rdctr)
                                 *rdctr += tocpy;
                                 size   -= tocpy;
 
-                                sipcbuf->seek += tocpy;
-                                sipcbuf->total_size -= tocpy;
+                                consume(sipcbuf, tocpy);
+                        }
+
+                        sys_mutex_unlock(sipcbuf->access);
+                }
+        }
+
+        return err;
+}
 
-                                if (sipcbuf->seek >= chain->len) {
+//==============================================================================
+/**
+ * @brief  Function release selected number of bytes from the first packets.
+ *         Access mutex must be locked.
+ *
+ * @param  sipcbuf      buffer instance
+ * @param  size         number of bytes to release
+ */
+//==============================================================================
+static void consume(sipcbuf_t *sipcbuf, size_t size)
+{
+        while (sipcbuf->begin && size > 0) {
+                data_chain_t *chain = sipcbuf->begin;
 
-                                        sipcbuf->seek = 0;
+                size_t len = min(chain->len - sipcbuf->seek, size);
 
-                                        if (!chain->reference) {
-                                                _kfree(_MM_NET, (void*)&chain->buf);
-                                        }
+                size                -= len;
+                sipcbuf->seek       += len;
+                sipcbuf->total_size -= len;
 
-                                        _kfree(_MM_NET, (void*)&chain);
+                if (sipcbuf->seek >= chain->len) {
 
-                                        sipcbuf->begin = next;
+                        sipcbuf->seek  = 0;
+                        sipcbuf->begin = chain->next;
 
-                                        if (sipcbuf->begin == NULL) {
-                                                sipcbuf->end = NULL;
-                                        }
-                                }
+                        if (sipcbuf->begin == NULL) {
+                                sipcbuf->end = NULL;
+                        }
 
-                                chain = next;
+                        if (!chain->reference) {
+                                sipcpool__free((void*)&chain->buf);
+                        }
+
+                        sipcpool__free((void*)&chain);
+                }
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function return view of data of the first buffered packet without
+ *         copying. View is valid until the data is consumed or buffer is
+ *         cleared, so only one reader can use it.
+ *
+ * @param  sipcbuf      buffer instance
+ * @param  data         pointer to data view
+ * @param  size         view size (0 if buffer is empty)
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int sipcbuf__peek(sipcbuf_t *sipcbuf, const u8_t **data, size_t *size)
+{
+        int err = EINVAL;
+
+        if (sipcbuf && data && size) {
+                err = sys_mutex_lock(sipcbuf->access, MAX_DELAY_MS);
+                if (!err) {
+                        data_chain_t *chain = sipcbuf->begin;
+
+                        if (chain) {
+                                *data = &chain->buf[sipcbuf->seek];
+                                *size = chain->len - sipcbuf->seek;
+                        } else {
+                                *data = NULL;
+                                *size = 0;
                         }
 
                         sys_mutex_unlock(sipcbuf->access);
@@ -240,6 +313,31 @@ int sipcbuf__read(sipcbuf_t *sipcbuf, u8_t *data, size_t size, size_t *rdctr)
         return err;
 }
 
+//==============================================================================
+/**
+ * @brief  Function release data returned by sipcbuf__peek().
+ *
+ * @param  sipcbuf      buffer instance
+ * @param  size         number of bytes to release
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int sipcbuf__consume(sipcbuf_t *sipcbuf, size_t size)
+{
+        int err = EINVAL;
+
+        if (sipcbuf) {
+                err = sys_mutex_lock(sipcbuf->access, MAX_DELAY_MS);
+                if (!err) {
+                        consume(sipcbuf, size);
+                        sys_mutex_unlock(sipcbuf->access);
+                }
+        }
+
+        return err;
+}
+
 //==============================================================================
 /**
  * @brief  Function clear data in buffer.
@@ -258,10 +356,10 @@ void sipcbuf__clear(sipcbuf_t *sipcbuf)
                                 data_chain_t *next = data->next;
 
                                 if (!data->reference) {
-                                        _kfree(_MM_NET, (void*)&data->buf);
+                                        sipcpool__free((void*)&data->buf);
                                 }
 
-                                _kfree(_MM_NET, (void*)&data);
+                                sipcpool__free((void*)&data);
 
                                 data = next;
                         }
@@ -300,6 +398,30 @@ bool sipcbuf__is_full(sipcbuf_t *sipcbuf)
         return is_full;
 }
 
+//==============================================================================
+/**
+ * @brief  Function check if buffer is empty
+ *
+ * @param  sipcbuf      buffer instance
+ *
+ * @return If buffer is empty then true is returned, otherwise false.
+ */
+//==============================================================================
+bool sipcbuf__is_empty(sipcbuf_t *sipcbuf)
+{
+        bool is_empty = true;
+
+        if (sipcbuf) {
+                int err = sys_mutex_lock(sipcbuf->access, MAX_DELAY_MS);
+                if (!err) {
+                        is_empty = sipcbuf->total_size == 0;
+                        sys_mutex_unlock(sipcbuf->access);
+                }
+        }
+
+        return is_empty;
+}
+
 /*==============================================================================
   End of file
 ==============================================================================*/
@@ -42,6 +42,7 @@ Detailed Doxygen description.
 #include <stdint.h>
 #include <stdbool.h>
 #include "kernel/ktypes.h"
+#include "sipcpool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,12 +64,16 @@ typedef struct sipcbuf sipcbuf_t;
 /*==============================================================================
   Exported functions
 ==============================================================================*/
-extern int  sipcbuf__create(sipcbuf_t **sipcbuf, size_t max_capacity);
+extern int  sipcbuf__create(sipcbuf_t **sipcbuf, size_t max_capacity, sipcpool_t *desc_pool);
 extern void sipcbuf__destroy(sipcbuf_t *sipcbuf);
 extern int  sipcbuf__write(sipcbuf_t *sipcbuf, const u8_t *data, size_t size, bool reference);
 extern int  sipcbuf__read(sipcbuf_t *sipcbuf, u8_t *data, size_t size, size_t *rdctr);
+extern int  sipcbuf__peek(sipcbuf_t *sipcbuf, const u8_t **data, size_t *size);
+extern int  sipcbuf__consume(sipcbuf_t *sipcbuf, size_t size);
+extern size_t sipcbuf__descriptor_size(void);
 extern void sipcbuf__clear(sipcbuf_t *sipcbuf);
 extern bool sipcbuf__is_full(sipcbuf_t *sipcbuf);
+extern bool sipcbuf__is_empty(sipcbuf_t *sipcbuf);
 
 /*==============================================================================
   Exported inline functions
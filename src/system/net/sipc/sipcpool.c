@@ -0,0 +1,214 @@
+/*==============================================================================
+File    sipcpool.c
+
+Author  Daniel Zorychta
+
+Brief   SIPC Network management - packet pool.
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <string.h>
+#include "sipcpool.h"
+#include "kernel/errno.h"
+#include "dnx/misc.h"
+#include "kernel/sysfunc.h"
+
+/*==============================================================================
+  Local macros
+==============================================================================*/
+
+/*==============================================================================
+  Local object types
+==============================================================================*/
+typedef struct pool_buf {
+        sipcpool_t      *pool;          /*!< Owner pool, NULL for heap buffer */
+        struct pool_buf *next;          /*!< Next free buffer */
+        u8_t             data[];        /*!< Buffer data */
+} pool_buf_t;
+
+struct sipcpool {
+        pool_buf_t      *free;          /*!< List of free buffers */
+        size_t           buffer_size;   /*!< Size of single buffer */
+        sipcpool_stats_t stats;         /*!< Allocation counters */
+};
+
+/*==============================================================================
+  Local function prototypes
+==============================================================================*/
+
+/*==============================================================================
+  Local objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  External objects
+==============================================================================*/
+
+/*==============================================================================
+  Function definitions
+==============================================================================*/
+
+//==============================================================================
+/**
+ * @brief  Function create pool of buffers. Pool and buffers are allocated in
+ *         single memory block that is never released.
+ *
+ * @param  sipcpool     pointer to destination pointer
+ * @param  buffers      number of buffers
+ * @param  buffer_size  size of single buffer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int sipcpool__create(sipcpool_t **sipcpool, size_t buffers, size_t buffer_size)
+{
+        size_t stride = sizeof(pool_buf_t) + buffer_size;
+        stride = (stride + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+        sipcpool_t *this = NULL;
+
+        int err = _kmalloc(_MM_NET, sizeof(sipcpool_t) + (buffers * stride),
+                           NULL, 0, 0, (void*)&this);
+        if (!err) {
+                memset(this, 0, sizeof(sipcpool_t));
+                this->buffer_size = buffer_size;
+
+                u8_t *mem = cast(u8_t*, this) + sizeof(sipcpool_t);
+
+                for (size_t i = 0; i < buffers; i++) {
+                        pool_buf_t *pbuf = cast(pool_buf_t*, &mem[i * stride]);
+                        pbuf->pool = this;
+                        pbuf->next = this->free;
+                        this->free = pbuf;
+                }
+
+                *sipcpool = this;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function allocate buffer. If pool is empty or requested size is
+ *         bigger than pool buffer then buffer is allocated from heap.
+ *         Buffer content is not initialized.
+ *
+ * @param  sipcpool     pool instance (can be NULL)
+ * @param  size         requested size
+ * @param  buf          pointer to destination buffer pointer
+ *
+ * @return One of errno value.
+ */
+//==============================================================================
+int sipcpool__alloc(sipcpool_t *sipcpool, size_t size, u8_t **buf)
+{
+        int         err  = ESUCC;
+        pool_buf_t *pbuf = NULL;
+
+        if (sipcpool && (size <= sipcpool->buffer_size)) {
+                sys_critical_section_begin();
+
+                pbuf = sipcpool->free;
+                if (pbuf) {
+                        sipcpool->free = pbuf->next;
+                        sipcpool->stats.pool_allocs++;
+                }
+
+                sys_critical_section_end();
+        }
+
+        if (!pbuf) {
+                err = _kmalloc(_MM_NET, sizeof(pool_buf_t) + size, NULL, 0, 0, (void*)&pbuf);
+                if (!err) {
+                        pbuf->pool = NULL;
+
+                        if (sipcpool) {
+                                sys_critical_section_begin();
+                                sipcpool->stats.heap_allocs++;
+                                sys_critical_section_end();
+                        }
+                }
+        }
+
+        if (!err) {
+                *buf = pbuf->data;
+        }
+
+        return err;
+}
+
+//==============================================================================
+/**
+ * @brief  Function release buffer allocated by sipcpool__alloc(). Buffer is
+ *         returned to owner pool or released to heap.
+ *
+ * @param  buf          pointer to buffer pointer (cleared)
+ */
+//==============================================================================
+void sipcpool__free(u8_t **buf)
+{
+        if (buf && *buf) {
+                pool_buf_t *pbuf = cast(pool_buf_t*, *buf - offsetof(pool_buf_t, data));
+                sipcpool_t *pool = pbuf->pool;
+
+                if (pool) {
+                        sys_critical_section_begin();
+                        pbuf->next = pool->free;
+                        pool->free = pbuf;
+                        sys_critical_section_end();
+                } else {
+                        _kfree(_MM_NET, (void*)&pbuf);
+                }
+
+                *buf = NULL;
+        }
+}
+
+//==============================================================================
+/**
+ * @brief  Function return allocation counters of selected pool.
+ *
+ * @param  sipcpool     pool instance (can be NULL)
+ * @param  stats        counters
+ */
+//==============================================================================
+void sipcpool__get_stats(sipcpool_t *sipcpool, sipcpool_stats_t *stats)
+{
+        if (sipcpool) {
+                sys_critical_section_begin();
+                *stats = sipcpool->stats;
+                sys_critical_section_end();
+        } else {
+                memset(stats, 0, sizeof(sipcpool_stats_t));
+        }
+}
+
+/*==============================================================================
+  End of file
+==============================================================================*/
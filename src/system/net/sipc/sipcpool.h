@@ -0,0 +1,89 @@
+/*==============================================================================
+File    sipcpool.h
+
+Author  Daniel Zorychta
+
+Brief   SIPC Network management - packet pool.
+
+        Copyright (C) 2020 Daniel Zorychta <daniel.zorychta@gmail.com>
+
+        This program is free software; you can redistribute it and/or modify
+        it under the terms of the GNU General Public License as published by
+        the Free Software Foundation and modified by the dnx RTOS exception.
+
+        NOTE: The modification  to the GPL is  included to allow you to
+              distribute a combined work that includes dnx RTOS without
+              being obliged to provide the source  code for proprietary
+              components outside of the dnx RTOS.
+
+        The dnx RTOS  is  distributed  in the hope  that  it will be useful,
+        but WITHOUT  ANY  WARRANTY;  without  even  the implied  warranty of
+        MERCHANTABILITY  or  FITNESS  FOR  A  PARTICULAR  PURPOSE.  See  the
+        GNU General Public License for more details.
+
+        Full license text is available on the following file: doc/license.txt.
+
+==============================================================================*/
+
+/**
+@defgroup SIPCPOOL_H_ SIPCPOOL_H_
+
+Pool of preallocated packet payload buffers.
+*/
+/**@{*/
+
+#ifndef _SIPCPOOL_H_
+#define _SIPCPOOL_H_
+
+/*==============================================================================
+  Include files
+==============================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "kernel/ktypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================
+  Exported macros
+==============================================================================*/
+
+/*==============================================================================
+  Exported object types
+==============================================================================*/
+typedef struct sipcpool sipcpool_t;
+
+typedef struct {
+        u64_t pool_allocs;      /*!< Buffers taken from pool */
+        u64_t heap_allocs;      /*!< Buffers allocated from heap (pool empty) */
+} sipcpool_stats_t;
+
+/*==============================================================================
+  Exported objects
+==============================================================================*/
+
+/*==============================================================================
+  Exported functions
+==============================================================================*/
+extern int  sipcpool__create(sipcpool_t **sipcpool, size_t buffers, size_t buffer_size);
+extern int  sipcpool__alloc(sipcpool_t *sipcpool, size_t size, u8_t **buf);
+extern void sipcpool__free(u8_t **buf);
+extern void sipcpool__get_stats(sipcpool_t *sipcpool, sipcpool_stats_t *stats);
+
+/*==============================================================================
+  Exported inline functions
+==============================================================================*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SIPCPOOL_H_ */
+
+/**@}*/
+/*==============================================================================
+  End of file
+==============================================================================*/